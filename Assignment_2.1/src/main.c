@@ -14,34 +14,57 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <math.h>
 
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/pwm.h"
 #include "driverlib/adc.h"
+#include "driverlib/interrupt.h"
 
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
 #include "inc/hw_memmap.h"
 #include "utils/uartstdio.h"
-#include "drivers/buttons.h"
 #include "drivers/pinout.h"
 #include "../drivers/tm4c129_functions.h"
+#include "brightness.h"
+#include "button_events.h"
+#include "clock_profile.h"
+#include "idle.h"
+#include "profile.h"
+#include "uart_console.h"
 
 #define PWM_LED GPIO_PIN_2
 
-// on 100% The lowest is 10, where the led will turn off
-// This is to prevent the pwm cycle to reset and start counting down from 100%
+// Window over which the CPU active time is worked out
+#define IDLE_WINDOW_MS 1000
+// The LED is pulsed PWM_RATE times per second in every clock profile
+#define PWM_RATE 1000
 
-void pwm_width_calculator(volatile uint32_t *widthReturned,
-                          volatile uint32_t brightness_controller) {
-  // map values from 0-100 to (10 - 1000) as per lab description
-  // normalize brightness between 0 and 1
-  // float scale_brightness = (brightness_controller - 1) / (99.0 - 1);
-  // *widthReturned = 10 + (pow(scale_brightness, 0.5) * (1000 - 10));
-  *widthReturned = 10 + (brightness_controller * (1000 - 10) / 100);
+// USR_SW1 dims and USR_SW2 brightens the LED by BRIGHTNESS_STEP percent.
+// Held down they keep stepping, see button_events.h.
+#define BRIGHTNESS_STEP 10
+#define BUTTON_EVENTS 4
+enum { SW_DIM, SW_BRIGHTEN, SW_COUNT };
+static const tBtnPin g_psButtons[SW_COUNT] = {
+    {SYSCTL_PERIPH_GPIOJ, GPIO_PORTJ_BASE, GPIO_PIN_0},
+    {SYSCTL_PERIPH_GPIOJ, GPIO_PORTJ_BASE, GPIO_PIN_1}};
+
+//*****************************************************************************
+// The loop only has something to do when a character has come in or a
+// button was pressed
+static bool inputPending(void *argument) {
+  (void)argument;
+  return CONSOLE_rxPending() != 0 || BTN_pending();
 }
+
+//*****************************************************************************
+// The idle clock and the button time outs count at the system clock
+static void clockChanged(const tClockTiming *timing, void *argument) {
+  IDLE_setClock(argument, timing->system_clock);
+  BTN_setClock(timing->system_clock);
+}
+
 //*****************************************************************************
 //                      Main
 //*****************************************************************************
@@ -49,28 +72,39 @@ int main(void) {
 
   // Set to 0 for assignment 1, and set to 1 for assignment2
   char buf[4];
-  float pwm_word;
-  unsigned char ucDelta, ucState;
+  bool show_prompt = true;
   uint32_t brightness_controller = 50;
   volatile uint32_t systemClock = 0;
   volatile uint32_t old_brightness_value = 0;
-  volatile uint32_t pulseWidth = 0;
+  tBrightness led;
+  tIdle idle;
+  tClock clock;
+  // The LED and the console, no SysTick or ADC
+  tClockUsers clock_users = {PWM0_BASE, PWM_GEN_1, PWM_RATE, &led, 0, 0, 0};
+  uint32_t windows = 0;
+  tIdleLatency response = {0};
+  uint32_t woke;
+  tBtnEvent events[BUTTON_EVENTS];
+  uint32_t event_count;
+  uint32_t event;
+  bool stepped;
+  uint32_t step_time = 0;
+#ifdef PROFILE
+  // Typing p prints where the time goes, see profile.h
+  tProfDump profile_dump = {0};
+#endif
   volatile uint32_t i = 0;
   volatile uint32_t k = 0;
-  systemClock = SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN |
-                                    SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480),
-                                   16000);
-
-  // 10 000 000Hz/1000 = 10 000Hz
-  // Prescaler = (System Clock) / (Timer Frequency)
-  pwm_word = systemClock / 1000.0;
+  // Start on the PIOSC, the loop moves up to a faster profile if it gets
+  // busy. The PWM period and the rest are worked out for the clock by the
+  // profile manager.
+  CLOCK_init(&clock, &clock_users, CLOCK_LOW, clockChanged, &idle);
+  systemClock = clock.timing.system_clock;
   PinoutSet(false, false);
-  ButtonsInit();
 
   // Enable PWM
   SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
   SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-  SysCtlPWMClockSet(SYSCTL_PWMDIV_1);
   SysCtlPeripheralDisable(SYSCTL_PERIPH_PWM0);
   SysCtlPeripheralReset(SYSCTL_PERIPH_PWM0);
 
@@ -78,6 +112,7 @@ int main(void) {
   SysCtlPeripheralEnable(SYSCTL_PERIPH_PWM0);
   while (!SysCtlPeripheralReady(SYSCTL_PERIPH_PWM0)) {
   }
+  PWMClockSet(PWM0_BASE, CLOCK_pwmClock(&clock.timing));
   GPIOPinTypePWM(GPIO_PORTF_BASE, GPIO_PIN_2);
   GPIOPinConfigure(GPIO_PF2_M0PWM2);
 
@@ -89,49 +124,106 @@ int main(void) {
                       PWM_GEN_MODE_DBG_RUN);
 
   // Specifies the period for PWM signal measured in clock ticks
-  PWMGenPeriodSet(PWM0_BASE, PWM_GEN_1, pwm_word);
+  PWMGenPeriodSet(PWM0_BASE, PWM_GEN_1, clock.timing.pwm_load);
 
-  //  duty cycle 50%
-  //  PWMPulseWidthSet sets the pulse width for PWM_OUT_2, the width is defined
-  //  as the number of PWM clock ticks
-  pwm_width_calculator(&pulseWidth, 50);
-  PWMPulseWidthSet(PWM0_BASE, PWM_OUT_2, pulseWidth);
+  //  duty cycle 50%, the brightness engine sets the pulse width for PWM_OUT_2
+  //  in PWM clock ticks from a gamma corrected level
+  BRIGHT_init(&led, PWM0_BASE, PWM_OUT_2, GPIO_PORTF_BASE, PWM_LED,
+              clock.timing.pwm_load);
+  BRIGHT_set(&led, BRIGHT_FROM_PERCENT(50));
 
   // PWMGenEnable enables the timer for the specified PWM generator block
   PWMGenEnable(PWM0_BASE, PWM_GEN_1);
   PWMOutputState(PWM0_BASE, PWM_OUT_2_BIT, true);
 
   ConfigureUART();
+  // The console takes over the UART interrupt so that neither printing nor
+  // reading the percentage stalls the loop
+  CONSOLE_init(UART0_BASE);
+  IDLE_init(&idle, systemClock, IDLE_WINDOW_MS);
+  // The buttons are stamped with the idle clock, it keeps counting in sleep
+  BTN_init(g_psButtons, SW_COUNT, systemClock, IDLE_now);
+  woke = IDLE_now();
+  IntMasterEnable();
 
   while (1) {
-    ucState = ButtonsPoll(&ucDelta, 0);
-
     // Only print over UART if the value has changed to reduce spamming
     if (old_brightness_value != brightness_controller) {
-      UARTprintf("Brightness: %d%%\n", brightness_controller);
+      CONSOLE_printf("Brightness: %d%%\n", brightness_controller);
       old_brightness_value = brightness_controller;
     }
-    UARTprintf("Enter LED percentage: ");
-    UARTgets(buf, sizeof(buf));
+    if (show_prompt) {
+      CONSOLE_printf("Enter LED percentage: ");
+      show_prompt = false;
+    }
+#ifdef PROFILE
+    PROF_dump(&profile_dump);
+#endif
+    // Every press steps once, the long press and the repeats after it step
+    // again while the button is held
+    event_count = BTN_pop(events, BUTTON_EVENTS);
+    stepped = false;
+    for (event = 0; event < event_count; event++) {
+      if (events[event].type == BTN_RELEASE) {
+        continue;
+      }
+      if (events[event].button == SW_BRIGHTEN) {
+        brightness_controller += BRIGHTNESS_STEP;
+        if (brightness_controller > 100) {
+          brightness_controller = 100;
+        }
+      } else if (brightness_controller >= BRIGHTNESS_STEP) {
+        brightness_controller -= BRIGHTNESS_STEP;
+      } else {
+        brightness_controller = 0;
+      }
+      stepped = true;
+      step_time = events[event].time;
+    }
+    if (stepped) {
+      BRIGHT_set(&led, BRIGHT_FROM_PERCENT(brightness_controller));
+      // From the interrupt that found the last step until the pulse width
+      IDLE_latency(&response, step_time);
+      continue;
+    }
+    // Returns straight away until a whole line has been typed, until then
+    // the core sleeps and the UART interrupt wakes it for every character
+    PROF_BEGIN(uart);
+    if (!CONSOLE_getLine(buf, sizeof(buf))) {
+      PROF_END(uart);
+      IDLE_sleep(&idle, inputPending, 0);
+      // Once a window, the clock is picked for the load measured in it
+      if (idle.windows != windows) {
+        windows = idle.windows;
+        CLOCK_govern(&clock, idle.active_percent);
+      }
+      woke = IDLE_now();
+      continue;
+    }
+    PROF_END(uart);
+#ifdef PROFILE
+    if (buf[0] == 'p') {
+      PROF_dumpStart(&profile_dump);
+      continue;
+    }
+#endif
     brightness_controller = atoi(buf);
+    show_prompt = true;
 
-    // For percentages between 0<x<100, use the pwm to set brightness
-    if (brightness_controller > 0 && brightness_controller < 100) {
-      // Make the PWM control the LED
-      GPIOPinTypePWM(GPIO_PORTF_BASE, PWM_LED);
-      pwm_width_calculator(&pulseWidth, brightness_controller);
-      PWMPulseWidthSet(PWM0_BASE, PWM_OUT_2, pulseWidth);
-    } else if (brightness_controller <= 0) {
-
-      // Make the GPIO pin control the led
-      GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, PWM_LED);
-      GPIOPinWrite(GPIO_PORTF_BASE, PWM_LED, 0);
-    } else if (brightness_controller >= 100) {
-
-      // Make the GPIO pin control the led
-      GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, PWM_LED);
-      GPIOPinWrite(GPIO_PORTF_BASE, PWM_LED, PWM_LED);
+    // Anything above 100% (or a negative number wrapping around) is fully on
+    if (brightness_controller > 100) {
+      brightness_controller = 100;
     }
+    // The brightness engine only remuxes the pin when 0% or 100% is entered
+    // or left, in between only the pulse width changes
+    PROF_BEGIN(pwm);
+    BRIGHT_set(&led, BRIGHT_FROM_PERCENT(brightness_controller));
+    PROF_END(pwm);
+    // From the wake-up on the last character of the line until the new
+    // pulse width is set
+    IDLE_latency(&response, woke);
+    CONSOLE_printf("CPU active %u%%, response %u us\n", idle.active_percent,
+                   IDLE_microseconds(&idle, response.last));
   }
   return 0;
 }
@@ -14,29 +14,98 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <math.h>
 
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/pwm.h"
 #include "driverlib/adc.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
 
 #include "utils/uartstdio.c"
-#include "drivers/buttons.h"
 #include "drivers/pinout.h"
+#include "adc_average.h"
+#include "filter.h"
+#include "brightness.h"
+#include "button_events.h"
+#include "clock_profile.h"
+#include "idle.h"
+#include "joystick.h"
+#include "profile.h"
+#include "sample_queue.h"
+#include "uart_console.h"
 
 #define PWM_LED GPIO_PIN_2
-#define SAMPLES 50
-
-int moving_average(volatile uint32_t joystick_values[],
-                   volatile uint32_t size) {
-  float sum = 0;
-  uint32_t i = 0;
-  for (i = 0; i < size; i++) {
-    sum += joystick_values[i];
-  }
-  return round(sum / size);
+// Every reading goes through a median of the last MEDIAN_LENGTH readings,
+// which takes out single spikes, and is then averaged over the last 2^3 = 8.
+// The joystick axis maps the average to a position with a deadzone in the
+// middle for 50%, end stops for exactly 0% and 100%, and a hysteresis band
+// so that noise does not make the LED flicker.
+#define MEDIAN_LENGTH 5
+#define AVERAGE_LOG2 3
+// Each reading is itself an average of conversions. With the hardware
+// backend the ADC averages ADC_HARDWARE_FACTOR of them by itself, see
+// adc_average.h for the others. Timer 0 triggers a reading SAMPLE_RATE
+// times per second and the ADC interrupt queues it, so no reading is missed
+// while the main loop is busy printing.
+#define ADC_BACKEND ADC_AVERAGE_HARDWARE
+#define ADC_HARDWARE_FACTOR 16
+#define ADC_SOFTWARE_LOG2 0
+#define SAMPLE_RATE 1000
+// The queue holds 2^6 = 64 readings, 64 ms. The main loop takes up to
+// DRAIN_BATCH at a time.
+#define SAMPLE_QUEUE_LOG2 6
+#define DRAIN_BATCH 16
+// Window over which the CPU active time is worked out
+#define IDLE_WINDOW_MS 1000
+// The LED is pulsed PWM_RATE times per second in every clock profile
+#define PWM_RATE 1000
+#define UART_BAUD 115200
+// Holding USR_SW1 down for a long press takes where the stick rests as its
+// centre
+#define BUTTON_EVENTS 4
+static const tBtnPin g_sCentreButton = {SYSCTL_PERIPH_GPIOJ, GPIO_PORTJ_BASE,
+                                        GPIO_PIN_0};
+
+//***********************************************************************
+//                       Sample queue
+//***********************************************************************
+// One reading, with IDLE_now() when the interrupt took it. The cycle
+// counter stops while the core sleeps, timer 1 does not.
+typedef struct {
+  uint32_t cycles;
+  uint32_t value;
+} tJoystickSample;
+
+// Centre, deadzone, low and high stop, hysteresis. The stops are a little
+// inside the range of the ADC, the stick does not reach 0 or 4095 on every
+// board. The centre is moved with USR_SW1.
+static tJoyAxisConfig g_sJoystickConfig = {2048, 48, 60, 4035, 24};
+
+static tSampleQueue g_sSampleQueue;
+static tJoystickSample g_psSamples[1u << SAMPLE_QUEUE_LOG2];
+// Keeps count of the CPU cycles each reading costs the interrupt
+static tADCAverage g_sJoystickADC;
+
+// Sequencer 0 interrupt, a reading is complete. When the queue is full the
+// reading is dropped and g_sSampleQueue.overflows counts it.
+static void ADC0SS0IntHandler(void) {
+  tJoystickSample sample;
+  PROF_BEGIN(adc_isr);
+
+  ADCIntClear(ADC0_BASE, 0);
+  sample.value = ADC_averageTake(&g_sJoystickADC);
+  sample.cycles = IDLE_now();
+  QUEUE_push(&g_sSampleQueue, &sample, 1);
+  PROF_END(adc_isr);
+}
+
+// The loop only has something to do when a reading or a button is waiting
+static bool inputPending(void *argument) {
+  (void)argument;
+  return QUEUE_count(&g_sSampleQueue) != 0 || BTN_pending();
 }
+
 //***********************************************************************
 //                       Configurations
 //***********************************************************************
@@ -48,19 +117,17 @@ void ConfigureUART() {
   GPIOPinConfigure(GPIO_PA1_U0TX);
   GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
   UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
-  UARTStdioConfig(0, 115200, 16000000);
+  UARTStdioConfig(0, UART_BAUD, CLOCK_PIOSC);
+  // Printing goes through the interrupt driven console from here on
+  CONSOLE_init(UART0_BASE);
 }
-// on 100% The lowest is 10, where the led will turn off
-// This is to prevent the pwm cycle to reset and start counting down from 100%
-
-void pwm_width_calculator(volatile uint32_t *widthReturned,
-                          volatile uint32_t brightness_controller) {
-  // map values from 0-100 to (10 - 1000) as per lab description
-  // normalize brightness between 0 and 1
-  // float scale_brightness = (brightness_controller - 1) / (99.0 - 1);
-  // *widthReturned = 10 + (pow(scale_brightness, 0.5) * (1000 - 10));
-  *widthReturned = 10 + (brightness_controller * (1000 - 10) / 100);
+//*****************************************************************************
+// The idle clock and the button time outs count at the system clock
+static void clockChanged(const tClockTiming *timing, void *argument) {
+  IDLE_setClock(argument, timing->system_clock);
+  BTN_setClock(timing->system_clock);
 }
+
 //*****************************************************************************
 //                      Main
 //*****************************************************************************
@@ -69,50 +136,76 @@ int main(void) {
   // Set to 0 for assignment 1, and set to 1 for assignment2
   char buf[4];
   uint32_t assignment2 = 0;
-  float pwm_word;
-  unsigned char ucDelta, ucState;
   uint32_t brightness_controller = 50;
   volatile uint32_t systemClock = 0;
   volatile uint32_t old_brightness_value = 0;
-  volatile uint32_t pulseWidth = 0;
-  volatile uint32_t adc_value_arr[SAMPLES];
+  tBrightness led;
+  tJoystickSample samples[DRAIN_BATCH];
+  uint32_t sample_count;
+  // Cycles from the reading to the new pulse width
+  tIdleLatency response = {0};
+  tIdle idle;
+  tClock clock;
+  // The LED, the console and the timer that triggers the readings
+  tClockUsers clock_users = {PWM0_BASE, PWM_GEN_1,   PWM_RATE,   &led,
+                             0,         TIMER0_BASE, SAMPLE_RATE};
+  uint32_t windows = 0;
+  tBtnEvent events[BUTTON_EVENTS];
+  uint32_t event_count;
+#ifdef PROFILE
+  // Typing p prints where the time goes, see profile.h
+  tProfDump profile_dump = {0};
+#endif
+  uint32_t i;
+  uint32_t adc_average = 0;
+  uint32_t adc_window[FILTER_LENGTH(AVERAGE_LOG2)];
+  tFilterMovingAverage adc_filter;
+  uint32_t median_window[MEDIAN_LENGTH];
+  tFilterMedian median_filter;
+  tJoyAxis joystick;
+  uint32_t level;
   volatile float adc_reference_voltage = 3.3;
-  volatile uint32_t i = 0;
-  volatile uint32_t k = 0;
 
-  // Reset the array
-  for (i = 0; i < SAMPLES; i++) {
-    adc_value_arr[i] = 0;
-  }
-
-  systemClock = SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN |
-                                    SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480),
-                                   16000);
+  // The filter keeps a running sum, so every new sample costs the same no
+  // matter how long the window is
+  FILTER_movingAverageInit(&adc_filter, adc_window, AVERAGE_LOG2);
+  FILTER_medianInit(&median_filter, median_window, MEDIAN_LENGTH);
+  JOY_axisInit(&joystick, &g_sJoystickConfig);
 
-  // 10 000 000Hz/1000 = 10 000Hz
-  // Prescaler = (System Clock) / (Timer Frequency)
-  pwm_word = systemClock / 1000.0;
+  // Start on the PIOSC, the loop moves up to a faster profile if it gets
+  // busy. The PWM period, the sample timer and the rest are worked out for
+  // the clock by the profile manager.
+  CLOCK_init(&clock, &clock_users, CLOCK_LOW, clockChanged, &idle);
+  systemClock = clock.timing.system_clock;
 
   // Make the LEDs controlled by the user software
   PinoutSet(false, false);
-  ButtonsInit();
 
   // Enable the ADC0
   SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
   while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0)) {
   }
+  // The conversions run from the PIOSC, the PLL is off in the slowest
+  // profile
+  ADCClockConfigSet(ADC0_BASE, ADC_CLOCK_SRC_PIOSC | ADC_CLOCK_RATE_FULL, 1);
 
-  // Enable the first sample sequencer to capture the value of channel 0 when
-  // the processor trigger occurs.
-  ADCSequenceConfigure(ADC0_BASE, 0, ADC_TRIGGER_PROCESSOR, 0);
-  ADCSequenceStepConfigure(ADC0_BASE, 0, 0,
-                           ADC_CTL_IE | ADC_CTL_END | ADC_CTL_CH0);
-  ADCSequenceEnable(ADC0_BASE, 0);
+  // The first sample sequencer converts channel 0 every time timer 0 times
+  // out, averaged by ADC_BACKEND, and interrupts when the reading is done
+  ADC_averageInit(&g_sJoystickADC, ADC0_BASE, 0, ADC_CTL_CH0,
+                  ADC_TRIGGER_TIMER, ADC_BACKEND, ADC_HARDWARE_FACTOR,
+                  ADC_SOFTWARE_LOG2);
+  QUEUE_init(&g_sSampleQueue, g_psSamples, sizeof(tJoystickSample),
+             SAMPLE_QUEUE_LOG2);
+  IDLE_init(&idle, systemClock, IDLE_WINDOW_MS);
+  BTN_init(&g_sCentreButton, 1, systemClock, IDLE_now);
+  ADCIntRegister(ADC0_BASE, 0, ADC0SS0IntHandler);
+  ADCIntEnable(ADC0_BASE, 0);
+  // The joystick pin is an analog input for good, so it is set up once
+  GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_4);
 
   // Enable PWM
   SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
   SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-  SysCtlPWMClockSet(SYSCTL_PWMDIV_1);
   SysCtlPeripheralDisable(SYSCTL_PERIPH_PWM0);
   SysCtlPeripheralReset(SYSCTL_PERIPH_PWM0);
 
@@ -120,6 +213,7 @@ int main(void) {
   SysCtlPeripheralEnable(SYSCTL_PERIPH_PWM0);
   while (!SysCtlPeripheralReady(SYSCTL_PERIPH_PWM0)) {
   }
+  PWMClockSet(PWM0_BASE, CLOCK_pwmClock(&clock.timing));
   GPIOPinTypePWM(GPIO_PORTF_BASE, GPIO_PIN_2);
   GPIOPinConfigure(GPIO_PF2_M0PWM2);
 
@@ -131,70 +225,96 @@ int main(void) {
                       PWM_GEN_MODE_DBG_RUN);
 
   // Specifies the period for PWM signal measured in clock ticks
-  PWMGenPeriodSet(PWM0_BASE, PWM_GEN_1, pwm_word);
+  PWMGenPeriodSet(PWM0_BASE, PWM_GEN_1, clock.timing.pwm_load);
 
-  //  duty cycle 50%
-  //  PWMPulseWidthSet sets the pulse width for PWM_OUT_2, the width is defined
-  //  as the number of PWM clock ticks
-  pwm_width_calculator(&pulseWidth, 50);
-  PWMPulseWidthSet(PWM0_BASE, PWM_OUT_2, pulseWidth);
+  //  duty cycle 50%, the brightness engine sets the pulse width for PWM_OUT_2
+  //  in PWM clock ticks from a gamma corrected level
+  BRIGHT_init(&led, PWM0_BASE, PWM_OUT_2, GPIO_PORTF_BASE, PWM_LED,
+              clock.timing.pwm_load);
+  BRIGHT_set(&led, BRIGHT_FROM_PERCENT(50));
 
   // PWMGenEnable enables the timer for the specified PWM generator block
   PWMGenEnable(PWM0_BASE, PWM_GEN_1);
   PWMOutputState(PWM0_BASE, PWM_OUT_2_BIT, true);
 
   ConfigureUART();
+  IntMasterEnable();
 
-  while (1) {
-    ucState = ButtonsPoll(&ucDelta, 0);
+  // Start the readings only now that everything they feed is set up
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0)) {
+  }
+  TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+  // A new load from a clock switch starts after the interval that runs
+  TimerUpdateMode(TIMER0_BASE, TIMER_A, TIMER_UP_LOAD_TIMEOUT);
+  TimerLoadSet(TIMER0_BASE, TIMER_A, clock.timing.adc_timer_load);
+  TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+  TimerADCEventSet(TIMER0_BASE, TIMER_ADC_TIMEOUT_A);
+  TimerEnable(TIMER0_BASE, TIMER_A);
 
+  while (1) {
     // Only print over UART if the value has changed to reduce spamming
     if (old_brightness_value != brightness_controller) {
-      UARTprintf("Brightness: %d%%\n", brightness_controller);
+      PROF_BEGIN(uart);
+      CONSOLE_printf("Brightness: %d%% (CPU active %u%%, response %u us, "
+                     "%u cycles per reading)\n",
+                     brightness_controller, idle.active_percent,
+                     IDLE_microseconds(&idle, response.max),
+                     ADC_averageCyclesPerValue(&g_sJoystickADC));
+      PROF_END(uart);
       old_brightness_value = brightness_controller;
     }
-
-    // Read the value from the ADC.
-    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_4);
-    while (k < SAMPLES) {
-      // Start collecting values
-      ADCProcessorTrigger(ADC0_BASE, 0);
-      while (!ADCIntStatus(ADC0_BASE, 0, false)) {
+#ifdef PROFILE
+    if (CONSOLE_getLine(buf, sizeof(buf)) && buf[0] == 'p') {
+      PROF_dumpStart(&profile_dump);
+    }
+    PROF_dump(&profile_dump);
+#endif
+    // The stick should be let go of before the button is held down
+    event_count = BTN_pop(events, BUTTON_EVENTS);
+    for (i = 0; i < event_count; i++) {
+      if (events[i].type == BTN_LONG) {
+        g_sJoystickConfig.centre = (int32_t)adc_average;
+        CONSOLE_printf("Centre: %u\n", adc_average);
       }
-      // Read the values received
-      ADCSequenceDataGet(ADC0_BASE, 0, &brightness_controller);
+    }
 
-      // Save the values to calculate an average
-      adc_value_arr[k] = brightness_controller;
-      k++;
+    // Take the readings the interrupt has queued since the last time, a
+    // batch at a time. Every one goes into the average. With none waiting
+    // the core sleeps until the ADC interrupt queues the next one.
+    sample_count = QUEUE_pop(&g_sSampleQueue, samples, DRAIN_BATCH);
+    if (sample_count == 0) {
+      IDLE_sleep(&idle, inputPending, 0);
+      // Once a window, the clock is picked for the load measured in it
+      if (idle.windows != windows) {
+        windows = idle.windows;
+        CLOCK_govern(&clock, idle.active_percent);
+      }
+      continue;
     }
-    k = 0;
-    // Convert the bits to be between 0 and 100
-    // If we want voltage we would multiply with the adc_reference_voltage
-    // = 3.3V
-    brightness_controller =
-        roundf((moving_average(adc_value_arr, SAMPLES) / 4095.0) * 100.0);
-
-    // The joystick is really difficult to get exactly 100 on
-    if (brightness_controller > 0 && brightness_controller < 100) {
-      // Make pwm control the led
-      GPIOPinTypePWM(GPIO_PORTF_BASE, PWM_LED);
-
-      pwm_width_calculator(&pulseWidth, brightness_controller);
-      PWMPulseWidthSet(PWM0_BASE, PWM_OUT_2, pulseWidth);
-    } else if (brightness_controller <= 0) {
-
-      // Make the GPIO pin control the led
-      GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, PWM_LED);
-      GPIOPinWrite(GPIO_PORTF_BASE, PWM_LED, 0);
-    } else if (brightness_controller >= 100) {
-
-      // Make the GPIO pin control the led
-      GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, PWM_LED);
-      GPIOPinWrite(GPIO_PORTF_BASE, PWM_LED, PWM_LED);
-    } else {
-      ;
+    PROF_BEGIN(average);
+    for (i = 0; i < sample_count; i++) {
+      adc_average = FILTER_movingAveragePush(
+          &adc_filter, FILTER_medianPush(&median_filter, samples[i].value));
     }
+    PROF_END(average);
+    // Nothing to do until the stick has moved out of the hysteresis band
+    if (!JOY_axisUpdate(&joystick, adc_average)) {
+      continue;
+    }
+
+    // The position goes from -JOY_FULL to JOY_FULL, the level from 0 to
+    // 2 * JOY_FULL. Convert it to be between 0 and 100, rounded to nearest.
+    level = (uint32_t)(joystick.position + JOY_FULL);
+    brightness_controller = (level * 100 + JOY_FULL) / (2 * JOY_FULL);
+
+    // The LED gets the full resolution of the position, not only the
+    // percentage. The pin is only remuxed when 0% or 100% is entered or left.
+    PROF_BEGIN(pwm);
+    BRIGHT_set(&led, (level * BRIGHT_MAX + JOY_FULL) / (2 * JOY_FULL));
+    PROF_END(pwm);
+    // The oldest reading in the batch waited the longest
+    IDLE_latency(&response, samples[0].cycles);
   }
   return 0;
 }
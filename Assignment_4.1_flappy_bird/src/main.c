@@ -3,7 +3,9 @@
  * File: Lab2_4.1_flappy_bird.c
  * Author: Pontus Svensson
  * Date: 2023-09-11
- * Description: 
+ * Description: Flappy Bird, S1, S2 or the joystick button flaps. The LCD
+ * is turned a quarter turn so that its hardware scroll moves the picture
+ * sideways, the board is held on its side.
  *
  * License: This code is distributed under the MIT License. visit
  * https://opensource.org/licenses/MIT for more information.
@@ -13,6 +15,7 @@
 /*================================================================*/
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
 #include "driverlib/interrupt.h"
@@ -22,5 +25,324 @@
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "inc/tm4c129encpdt.h"
+//=============================================================================
+#include "tm4c129_functions.h"
+#include "game.h"
+#include "physics.h"
 
-int main(int argc, char *argv[]) { return 0; }
+//=============================================================================
+// The game state is updated at a fixed rate, drawing happens after the
+// updates that were due
+#define UPDATE_RATE 60
+#define DT PHYS_RATIO(1, UPDATE_RATE)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sizes in pixels, speeds in pixels per second and gravity in pixels per
+// second squared
+#define BIRD_X 30
+#define BIRD_SIZE 6
+#define GRAVITY 400
+#define FLAP_SPEED 130
+#define FALL_SPEED 250
+#define SCROLL_SPEED 40
+#define GROUND_Y 120
+#define PIPE_WIDTH 12
+#define PIPE_GAP 44
+#define PIPE_SPACING 56
+// The gap starts at least this far from the top and the ground
+#define PIPE_MARGIN 12
+// The camera is kept below this many pixels so that it never overflows. It
+// is a whole number of screens, which leaves the LCD columns where they are.
+#define CAMERA_WRAP (8 * GAME_WIDTH)
+#define FLAP_BUTTONS (GAME_BUTTON_S1 | GAME_BUTTON_S2 | GAME_BUTTON_SELECT)
+
+#define COLOR_SKY GAME_RGB(112, 192, 255)
+#define COLOR_GROUND GAME_RGB(222, 184, 135)
+#define COLOR_PIPE GAME_RGB(0, 160, 0)
+#define COLOR_BIRD GAME_RGB(255, 220, 0)
+
+//=============================================================================
+// Boxes tested against the bird, the pipes from the pool first
+enum { BOX_GROUND = PHYS_POOL_SIZE, BOX_CEILING, BOX_COUNT };
+
+typedef enum { READY, FLYING, DEAD } tPhase;
+
+typedef struct {
+  tPhysBody bird;
+  // Each pipe is two boxes, the part above the gap and the part below
+  tPhysPool pipes;
+  tQ16 next_pipe;
+  // Pipes the bird has passed, one bit per box in the pool
+  uint32_t passed;
+  tPhase phase;
+  uint32_t score;
+  uint32_t best;
+  uint32_t random;
+  // How far the pipes have moved since the start, the world x of the left
+  // edge of the screen
+  tQ16 camera;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // What the LCD shows
+  int32_t shown_camera;
+  int32_t shown_bird_y;
+  bool drawn;
+} tState;
+
+static tGame g_sGame;
+static tState g_sState;
+
+//=============================================================================
+static uint32_t nextRandom(tState *state) {
+  state->random = state->random * 1664525 + 1013904223;
+  return state->random >> 16;
+}
+
+// A pipe just right of the screen with the gap at a random height
+static void addPipe(tState *state) {
+  int32_t gap = PIPE_MARGIN + nextRandom(state) % (GROUND_Y - PIPE_GAP -
+                                                    2 * PIPE_MARGIN + 1);
+  tPhysBox box;
+  int32_t number;
+
+  box.x = PHYS_FROM_INT(GAME_WIDTH);
+  box.width = PHYS_FROM_INT(PIPE_WIDTH);
+  box.y = 0;
+  box.height = PHYS_FROM_INT(gap);
+  if ((number = PHYS_poolAdd(&state->pipes, &box)) >= 0) {
+    state->passed &= ~(1u << number);
+  }
+  box.y = PHYS_FROM_INT(gap + PIPE_GAP);
+  box.height = PHYS_FROM_INT(GROUND_Y - gap - PIPE_GAP);
+  if ((number = PHYS_poolAdd(&state->pipes, &box)) >= 0) {
+    state->passed &= ~(1u << number);
+  }
+}
+
+// The bird waiting in the middle, no pipes yet. The screen is drawn again.
+static void resetGame(tState *state) {
+  state->bird.box.x = PHYS_FROM_INT(BIRD_X);
+  state->bird.box.y = PHYS_FROM_INT((GROUND_Y - BIRD_SIZE) / 2);
+  state->bird.box.width = PHYS_FROM_INT(BIRD_SIZE);
+  state->bird.box.height = PHYS_FROM_INT(BIRD_SIZE);
+  state->bird.vx = 0;
+  state->bird.vy = 0;
+  PHYS_poolInit(&state->pipes);
+  state->next_pipe = 0;
+  state->passed = 0;
+  state->phase = READY;
+  state->score = 0;
+  state->camera = 0;
+  state->drawn = false;
+}
+
+//=============================================================================
+static void update(tGame *game, const tGameInput *input, void *argument) {
+  tState *state = argument;
+  tPhysBox boxes[BOX_COUNT];
+  tQ16 time = DT;
+  tQ16 scrolled;
+  tPhysHit hit;
+  int32_t box;
+  uint32_t i;
+
+  switch (state->phase) {
+  case READY:
+    if (!(input->pressed & FLAP_BUTTONS)) {
+      return;
+    }
+    state->phase = FLYING;
+    break;
+  case DEAD:
+    if (input->pressed & FLAP_BUTTONS) {
+      resetGame(state);
+    }
+    return;
+  default:
+    break;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (input->pressed & FLAP_BUTTONS) {
+    state->bird.vy = -PHYS_FROM_INT(FLAP_SPEED);
+  }
+  PHYS_accelerate(&state->bird, 0, PHYS_FROM_INT(GRAVITY), DT);
+  if (state->bird.vy > PHYS_FROM_INT(FALL_SPEED)) {
+    state->bird.vy = PHYS_FROM_INT(FALL_SPEED);
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The bird is swept in the frame of the pipes, where it also moves
+  // forward, and everything is then shifted back so that the bird stays at
+  // BIRD_X. A fast fall can not skip the edge of a pipe that way.
+  memcpy(boxes, state->pipes.box, sizeof(state->pipes.box));
+  boxes[BOX_GROUND].x = PHYS_FROM_INT(-GAME_WIDTH);
+  boxes[BOX_GROUND].y = PHYS_FROM_INT(GROUND_Y);
+  boxes[BOX_GROUND].width = PHYS_FROM_INT(3 * GAME_WIDTH);
+  boxes[BOX_GROUND].height = PHYS_FROM_INT(GAME_HEIGHT - GROUND_Y);
+  boxes[BOX_CEILING] = boxes[BOX_GROUND];
+  boxes[BOX_CEILING].y = PHYS_FROM_INT(-16);
+  boxes[BOX_CEILING].height = PHYS_FROM_INT(16);
+  state->bird.vx = PHYS_FROM_INT(SCROLL_SPEED);
+  box = PHYS_move(&state->bird, &time, boxes,
+                  state->pipes.active | 1u << BOX_GROUND | 1u << BOX_CEILING,
+                  &hit);
+  scrolled = state->bird.box.x - PHYS_FROM_INT(BIRD_X);
+  state->bird.box.x = PHYS_FROM_INT(BIRD_X);
+  PHYS_poolShift(&state->pipes, -scrolled, 0);
+  // The camera follows in the same update, also the one that crashes, or
+  // the world would move under the picture on the LCD
+  state->camera += scrolled;
+  if (state->camera >= PHYS_FROM_INT(CAMERA_WRAP)) {
+    state->camera -= PHYS_FROM_INT(CAMERA_WRAP);
+  }
+  if (box == BOX_CEILING) {
+    state->bird.vy = 0;
+  } else if (box >= 0) {
+    state->phase = DEAD;
+    if (state->score > state->best) {
+      state->best = state->score;
+    }
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A point for each pipe, counted on the box above the gap
+  for (i = 0; i < PHYS_POOL_SIZE; i++) {
+    if ((state->pipes.active & ~state->passed & (1u << i)) &&
+        state->pipes.box[i].y == 0 &&
+        state->pipes.box[i].x + state->pipes.box[i].width <
+            state->bird.box.x) {
+      state->passed |= 1u << i;
+      state->score++;
+    }
+  }
+  state->next_pipe -= scrolled;
+  if (state->next_pipe <= 0) {
+    addPipe(state);
+    state->next_pipe += PHYS_FROM_INT(PIPE_SPACING);
+  }
+}
+
+//=============================================================================
+// The world at column x and row y without the bird. Pipes do not move in
+// the world, so a column looks the same for as long as it is on screen.
+static uint16_t background(const tState *state, int32_t x, int32_t y) {
+  const tPhysBox *box;
+  int32_t left;
+  uint32_t i;
+
+  if (y >= GROUND_Y) {
+    return COLOR_GROUND;
+  }
+  for (i = 0; i < PHYS_POOL_SIZE; i++) {
+    box = &state->pipes.box[i];
+    left = PHYS_TO_INT(box->x + state->camera);
+    if ((state->pipes.active & (1u << i)) && x >= left &&
+        x < left + PIPE_WIDTH && y >= PHYS_TO_INT(box->y) &&
+        y < PHYS_TO_INT(box->y + box->height)) {
+      return COLOR_PIPE;
+    }
+  }
+  return COLOR_SKY;
+}
+
+//=============================================================================
+// Send the world columns x to x + width - 1, rows y to y + height - 1, with
+// the bird on top. World column x goes to LCD column x % GAME_WIDTH and the
+// scroll shows it in the right place, so a rectangle that wraps around the
+// end is sent in two parts.
+static void sendWorld(const tState *state, int32_t x, int32_t y,
+                      int32_t width, int32_t height) {
+  uint16_t line[GAME_WIDTH];
+  int32_t bird_x = PHYS_TO_INT(state->camera) + BIRD_X;
+  int32_t bird_y = PHYS_TO_INT(state->bird.box.y);
+  int32_t column = x % GAME_WIDTH;
+  int32_t part;
+  int32_t i;
+  int32_t j;
+
+  if (y < 0) {
+    height += y;
+    y = 0;
+  }
+  if (y + height > GAME_HEIGHT) {
+    height = GAME_HEIGHT - y;
+  }
+  while (width > 0 && height > 0) {
+    part = column + width > GAME_WIDTH ? GAME_WIDTH - column : width;
+    ST7735_setWindow(column, y, column + part - 1, y + height - 1);
+    for (j = y; j < y + height; j++) {
+      for (i = 0; i < part; i++) {
+        line[i] = x + i >= bird_x && x + i < bird_x + BIRD_SIZE &&
+                          j >= bird_y && j < bird_y + BIRD_SIZE
+                      ? COLOR_BIRD
+                      : background(state, x + i, j);
+      }
+      ST7735_writePixels(line, part);
+    }
+    x += part;
+    width -= part;
+    column = 0;
+  }
+}
+
+//=============================================================================
+// Nothing goes through the back buffer of the runtime. Each frame only the
+// columns that scroll into view and the pixels the bird left or covers are
+// sent, then the scroll is moved.
+static void render(tGame *game, void *argument) {
+  tState *state = argument;
+  int32_t camera = PHYS_TO_INT(state->camera);
+  int32_t bird_y = PHYS_TO_INT(state->bird.box.y);
+  int32_t y0;
+  int32_t y1;
+
+  if (!state->drawn) {
+    sendWorld(state, camera, 0, GAME_WIDTH, GAME_HEIGHT);
+    ST7735_scroll(camera);
+    state->shown_camera = camera;
+    state->shown_bird_y = bird_y;
+    state->drawn = true;
+    return;
+  }
+  if (camera < state->shown_camera) {
+    state->shown_camera -= CAMERA_WRAP;
+  }
+  if (camera == state->shown_camera && bird_y == state->shown_bird_y) {
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The new columns take the LCD columns of the ones that just left
+  sendWorld(state, state->shown_camera + GAME_WIDTH, 0,
+            camera - state->shown_camera, GAME_HEIGHT);
+  y0 = bird_y < state->shown_bird_y ? bird_y : state->shown_bird_y;
+  y1 = bird_y > state->shown_bird_y ? bird_y : state->shown_bird_y;
+  sendWorld(state, state->shown_camera + BIRD_X, y0,
+            camera - state->shown_camera + BIRD_SIZE, y1 - y0 + BIRD_SIZE);
+  if (camera != state->shown_camera) {
+    ST7735_scroll(camera);
+  }
+  state->shown_camera = camera;
+  state->shown_bird_y = bird_y;
+}
+
+//=============================================================================
+int main(int argc, char *argv[]) {
+  uint32_t systemClock =
+      SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_INT | SYSCTL_USE_PLL |
+                          SYSCTL_CFG_VCO_480),
+                         120000000);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  PERIPH_init(SYSCTL_PERIPH_ADC0);
+  SENSOR_enable(JOYSTICK);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The game is sent straight to the ST7735S, turned so that its scroll
+  // runs along x. grlib is not used.
+  ST7735_init(systemClock);
+  ST7735_setOrientation(ST7735_LEFT);
+  GAME_inputInit();
+  g_sState.random = 1;
+  resetGame(&g_sState);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The cycle counter runs at the system clock. g_sGame holds the frame
+  // time statistics, update_ticks_max the worst case of the physics.
+  GAME_init(&g_sGame, systemClock, UPDATE_RATE, update, render, &g_sState);
+  GAME_run(&g_sGame);
+  return 0;
+}
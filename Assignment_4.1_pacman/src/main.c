@@ -3,7 +3,8 @@
  * File: Lab2_4.1_pacman.c
  * Author: Pontus Svensson
  * Date: 2023-09-11
- * Description: 
+ * Description: Pac-Man on the tile renderer, the maze is a map of 8 x 8
+ * tiles and Pac-Man and the ghost are sprites.
  *
  * License: This code is distributed under the MIT License. visit
  * https://opensource.org/licenses/MIT for more information.
@@ -22,5 +23,399 @@
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "inc/tm4c129encpdt.h"
+//=============================================================================
+#include "tm4c129_functions.h"
+#include "game.h"
+#include "tiles.h"
 
-int main(int argc, char *argv[]) { return 0; }
+//=============================================================================
+// The game state is updated at a fixed rate, drawing happens after the
+// updates that were due
+#define UPDATE_RATE 60
+// The joystick has to be pushed this far from the middle to turn
+#define JOYSTICK_DEADZONE 1024
+#define LIVES 3
+// The ghost moves on three updates out of four
+#define GHOST_SPEED_MASK 3
+
+//=============================================================================
+// The maze, one character per tile: '#' wall, '.' dot, 'o' power pellet
+static const char *const g_ppcMaze[TILE_ROWS] = {
+    "################", "#......##......#", "#.##.#.##.#.##.#",
+    "#o##.#....#.##o#", "#....######....#", "#.##........##.#",
+    "#.##.##..##.##.#", "#....#....#....#", "####.#.##.#.####",
+    "#......##......#", "#.##.#....#.##.#", "#o.#.######.#.o#",
+    "##.#........#.##", "#....##..##....#", "#..............#",
+    "################"};
+
+// Tiles of the atlas
+enum { TILE_EMPTY, TILE_WALL, TILE_DOT, TILE_PELLET, TILE_COUNT };
+
+//=============================================================================
+// Colors used in the images below
+#define K GAME_RGB(0, 0, 0)
+#define B GAME_RGB(33, 33, 222)
+#define N GAME_RGB(0, 0, 96)
+#define W GAME_RGB(255, 184, 151)
+#define R GAME_RGB(255, 0, 0)
+#define E GAME_RGB(255, 255, 255)
+#define U GAME_RGB(33, 33, 222)
+#define T TILE_TRANSPARENT
+
+// The atlas is const, so it stays in flash
+static const tTileImage g_ppui16Atlas[TILE_COUNT] = {
+    // TILE_EMPTY
+    {K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K,
+     K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K,
+     K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K,
+     K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K},
+    // TILE_WALL
+    {B, B, B, B, B, B, B, B, B, N, N, N, N, N, N, B,
+     B, N, N, N, N, N, N, B, B, N, N, N, N, N, N, B,
+     B, N, N, N, N, N, N, B, B, N, N, N, N, N, N, B,
+     B, N, N, N, N, N, N, B, B, B, B, B, B, B, B, B},
+    // TILE_DOT
+    {K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K,
+     K, K, K, K, K, K, K, K, K, K, K, W, W, K, K, K,
+     K, K, K, W, W, K, K, K, K, K, K, K, K, K, K, K,
+     K, K, K, K, K, K, K, K, K, K, K, K, K, K, K, K},
+    // TILE_PELLET
+    {K, K, K, K, K, K, K, K, K, K, K, W, W, K, K, K,
+     K, K, W, W, W, W, K, K, K, W, W, W, W, W, W, K,
+     K, W, W, W, W, W, W, K, K, K, W, W, W, W, K, K,
+     K, K, K, W, W, K, K, K, K, K, K, K, K, K, K, K}};
+
+static const tTileImage g_pui16Ghost = {
+    T, T, R, R, R, R, T, T, T, R, R, R, R, R, R, T,
+    R, E, E, R, R, E, E, R, R, E, U, R, R, E, U, R,
+    R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R,
+    R, R, R, R, R, R, R, R, R, T, R, R, T, R, R, T};
+
+#undef K
+#undef B
+#undef N
+#undef W
+#undef R
+#undef E
+#undef U
+#undef T
+
+//=============================================================================
+typedef enum { RIGHT, DOWN, LEFT, UP, STILL } tDirection;
+
+static const int32_t g_pi32DX[5] = {1, 0, -1, 0, 0};
+static const int32_t g_pi32DY[5] = {0, 1, 0, -1, 0};
+
+typedef struct {
+  // Position of the top left corner in pixels
+  int32_t x;
+  int32_t y;
+  tDirection direction;
+  uint32_t sprite;
+} tActor;
+
+typedef struct {
+  tTileMap tiles;
+  tActor pacman;
+  tActor ghost;
+  tDirection wanted;
+  uint32_t dots;
+  uint32_t score;
+  uint32_t lives;
+  uint32_t updates;
+  uint32_t random;
+} tState;
+
+static tGame g_sGame;
+static tState g_sState;
+// Pac-Man facing each direction with the mouth open, and with it closed
+static tTileImage g_ppui16Pacman[5];
+
+//=============================================================================
+// A yellow disc with a wedge cut out on the side Pac-Man faces. The image is
+// worked out on a grid with twice the resolution so that the center falls
+// between pixels.
+static void pacmanImages(void) {
+  uint16_t yellow = GAME_RGB(255, 255, 0);
+  tDirection direction;
+  int32_t u;
+  int32_t v;
+  int32_t x;
+  int32_t y;
+  bool mouth;
+
+  for (direction = RIGHT; direction <= STILL; direction++) {
+    for (y = 0; y < TILE_SIZE; y++) {
+      for (x = 0; x < TILE_SIZE; x++) {
+        u = 2 * x + 1 - TILE_SIZE;
+        v = 2 * y + 1 - TILE_SIZE;
+        // Rotate so that the mouth is always checked on the right
+        switch (direction) {
+        case DOWN:
+          mouth = v > 0 && (u < 0 ? -u : u) <= v;
+          break;
+        case LEFT:
+          mouth = u < 0 && (v < 0 ? -v : v) <= -u;
+          break;
+        case UP:
+          mouth = v < 0 && (u < 0 ? -u : u) <= -v;
+          break;
+        case RIGHT:
+          mouth = u > 0 && (v < 0 ? -v : v) <= u;
+          break;
+        default:
+          mouth = false;
+          break;
+        }
+        g_ppui16Pacman[direction][y * TILE_SIZE + x] =
+            u * u + v * v <= 60 && !mouth ? yellow : TILE_TRANSPARENT;
+      }
+    }
+  }
+}
+
+//=============================================================================
+static uint32_t nextRandom(tState *state) {
+  state->random = state->random * 1664525 + 1013904223;
+  return state->random >> 16;
+}
+
+static bool aligned(const tActor *actor) {
+  return actor->x % TILE_SIZE == 0 && actor->y % TILE_SIZE == 0;
+}
+
+// Whether the tile next to the one an aligned actor is on is free
+static bool open(const tState *state, const tActor *actor,
+                 tDirection direction) {
+  return TILE_get(&state->tiles, actor->x / TILE_SIZE + g_pi32DX[direction],
+                  actor->y / TILE_SIZE + g_pi32DY[direction]) != TILE_WALL;
+}
+
+static void place(tActor *actor, uint32_t column, uint32_t row) {
+  actor->x = column * TILE_SIZE;
+  actor->y = row * TILE_SIZE;
+  actor->direction = STILL;
+}
+
+//=============================================================================
+static void resetActors(tState *state) {
+  place(&state->pacman, 7, 14);
+  place(&state->ghost, 7, 7);
+  state->wanted = STILL;
+  TILE_moveSprite(&state->tiles, state->pacman.sprite, state->pacman.x,
+                  state->pacman.y, g_ppui16Pacman[STILL]);
+  TILE_moveSprite(&state->tiles, state->ghost.sprite, state->ghost.x,
+                  state->ghost.y, g_pui16Ghost);
+}
+
+// Only the tiles that differ from what is shown are marked dirty, so a new
+// level redraws the eaten dots and nothing else
+static void resetLevel(tState *state) {
+  uint32_t column;
+  uint32_t row;
+  uint8_t tile;
+
+  state->dots = 0;
+  for (row = 0; row < TILE_ROWS; row++) {
+    for (column = 0; column < TILE_COLUMNS; column++) {
+      switch (g_ppcMaze[row][column]) {
+      case '#':
+        tile = TILE_WALL;
+        break;
+      case '.':
+        tile = TILE_DOT;
+        state->dots++;
+        break;
+      case 'o':
+        tile = TILE_PELLET;
+        state->dots++;
+        break;
+      default:
+        tile = TILE_EMPTY;
+        break;
+      }
+      TILE_set(&state->tiles, column, row, tile);
+    }
+  }
+  resetActors(state);
+}
+
+//=============================================================================
+static void movePacman(tState *state) {
+  tActor *pacman = &state->pacman;
+  uint32_t column = pacman->x / TILE_SIZE;
+  uint32_t row = pacman->y / TILE_SIZE;
+
+  if (aligned(pacman)) {
+    switch (TILE_get(&state->tiles, column, row)) {
+    case TILE_DOT:
+      state->score += 1;
+      state->dots--;
+      break;
+    case TILE_PELLET:
+      state->score += 5;
+      state->dots--;
+      break;
+    default:
+      break;
+    }
+    TILE_set(&state->tiles, column, row, TILE_EMPTY);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Turning is only possible on a tile, and running into a wall stops
+    if (state->wanted != STILL && open(state, pacman, state->wanted)) {
+      pacman->direction = state->wanted;
+    }
+    if (pacman->direction != STILL && !open(state, pacman, pacman->direction)) {
+      pacman->direction = STILL;
+    }
+  } else if (state->wanted != STILL &&
+             state->wanted == (pacman->direction + 2) % 4) {
+    // Turning around works anywhere
+    pacman->direction = state->wanted;
+  }
+  pacman->x += g_pi32DX[pacman->direction];
+  pacman->y += g_pi32DY[pacman->direction];
+}
+
+//=============================================================================
+// On each tile the ghost picks a way that does not turn back, half of the
+// time the one that brings it closest to Pac-Man and otherwise any of them
+static void moveGhost(tState *state) {
+  tActor *ghost = &state->ghost;
+  tDirection options[4];
+  tDirection direction;
+  uint32_t count = 0;
+  uint32_t best = 0;
+  int32_t distance;
+  int32_t best_distance = INT32_MAX;
+  int32_t dx;
+  int32_t dy;
+  uint32_t i;
+
+  if (aligned(ghost)) {
+    for (direction = RIGHT; direction <= UP; direction++) {
+      if (direction != (ghost->direction + 2) % 4 &&
+          open(state, ghost, direction)) {
+        options[count++] = direction;
+      }
+    }
+    if (count == 0) {
+      ghost->direction = (ghost->direction + 2) % 4;
+    } else if (nextRandom(state) & 1) {
+      ghost->direction = options[nextRandom(state) % count];
+    } else {
+      for (i = 0; i < count; i++) {
+        dx = ghost->x + g_pi32DX[options[i]] * TILE_SIZE - state->pacman.x;
+        dy = ghost->y + g_pi32DY[options[i]] * TILE_SIZE - state->pacman.y;
+        distance = dx * dx + dy * dy;
+        if (distance < best_distance) {
+          best_distance = distance;
+          best = i;
+        }
+      }
+      ghost->direction = options[best];
+    }
+  }
+  ghost->x += g_pi32DX[ghost->direction];
+  ghost->y += g_pi32DY[ghost->direction];
+}
+
+//=============================================================================
+static void update(tGame *game, const tGameInput *input, void *argument) {
+  tState *state = argument;
+  int32_t x = input->joystick_x;
+  int32_t y = input->joystick_y;
+  int32_t dx;
+  int32_t dy;
+  const uint16_t *image;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The axis pushed the furthest decides, up on the joystick reads high
+  if ((x < 0 ? -x : x) > (y < 0 ? -y : y)) {
+    if (x > JOYSTICK_DEADZONE) {
+      state->wanted = RIGHT;
+    } else if (x < -JOYSTICK_DEADZONE) {
+      state->wanted = LEFT;
+    }
+  } else if (y > JOYSTICK_DEADZONE) {
+    state->wanted = UP;
+  } else if (y < -JOYSTICK_DEADZONE) {
+    state->wanted = DOWN;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  state->updates++;
+  movePacman(state);
+  if (state->updates & GHOST_SPEED_MASK) {
+    moveGhost(state);
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  dx = state->pacman.x - state->ghost.x;
+  dy = state->pacman.y - state->ghost.y;
+  if ((dx < 0 ? -dx : dx) < TILE_SIZE - 2 &&
+      (dy < 0 ? -dy : dy) < TILE_SIZE - 2) {
+    if (--state->lives == 0) {
+      state->lives = LIVES;
+      state->score = 0;
+      resetLevel(state);
+    } else {
+      resetActors(state);
+    }
+    return;
+  }
+  if (state->dots == 0) {
+    resetLevel(state);
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The mouth opens and closes every four pixels
+  image = g_ppui16Pacman[STILL];
+  if (state->pacman.direction != STILL &&
+      ((state->pacman.x + state->pacman.y) / 4) % 2 == 0) {
+    image = g_ppui16Pacman[state->pacman.direction];
+  }
+  TILE_moveSprite(&state->tiles, state->pacman.sprite, state->pacman.x,
+                  state->pacman.y, image);
+  TILE_moveSprite(&state->tiles, state->ghost.sprite, state->ghost.x,
+                  state->ghost.y, g_pui16Ghost);
+}
+
+// Nothing is drawn into the back buffer of the runtime, so its present has
+// nothing to send. Only the tiles that changed go to the LCD, see
+// g_sState.tiles for how many per frame and how long it took.
+static void render(tGame *game, void *argument) {
+  tState *state = argument;
+
+  TILE_render(&state->tiles);
+}
+
+//=============================================================================
+int main(int argc, char *argv[]) {
+  uint32_t systemClock =
+      SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_INT | SYSCTL_USE_PLL |
+                          SYSCTL_CFG_VCO_480),
+                         120000000);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  PERIPH_init(SYSCTL_PERIPH_ADC0);
+  SENSOR_enable(JOYSTICK);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The tiles are sent straight to the ST7735S, grlib is not used
+  ST7735_init(systemClock);
+  GAME_inputInit();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  pacmanImages();
+  TILE_init(&g_sState.tiles, g_ppui16Atlas);
+  g_sState.pacman.sprite =
+      TILE_addSprite(&g_sState.tiles, g_ppui16Pacman[STILL]);
+  g_sState.ghost.sprite = TILE_addSprite(&g_sState.tiles, g_pui16Ghost);
+  g_sState.lives = LIVES;
+  g_sState.random = 1;
+  resetLevel(&g_sState);
+  TILE_showSprite(&g_sState.tiles, g_sState.pacman.sprite, true);
+  TILE_showSprite(&g_sState.tiles, g_sState.ghost.sprite, true);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The cycle counter runs at the system clock. g_sGame holds the frame
+  // time statistics.
+  GAME_init(&g_sGame, systemClock, UPDATE_RATE, update, render, &g_sState);
+  GAME_run(&g_sGame);
+  return 0;
+}
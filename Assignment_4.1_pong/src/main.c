@@ -3,7 +3,7 @@
  * File: Lab2_4.1_pong.c
  * Author: Pontus Svensson
  * Date: 2023-09-11
- * Description: 
+ * Description: Pong against the board, the left paddle is on the joystick.
  *
  * License: This code is distributed under the MIT License. visit
  * https://opensource.org/licenses/MIT for more information.
@@ -13,6 +13,7 @@
 /*================================================================*/
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
 #include "driverlib/interrupt.h"
@@ -22,5 +23,202 @@
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "inc/tm4c129encpdt.h"
+//=============================================================================
+#include "tm4c129_functions.h"
+#include "game.h"
+#include "physics.h"
 
-int main(int argc, char *argv[]) { return 0; }
+//=============================================================================
+// The game state is updated at a fixed rate, drawing happens after the
+// updates that were due
+#define UPDATE_RATE 60
+#define DT PHYS_RATIO(1, UPDATE_RATE)
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sizes in pixels, speeds in pixels per second
+#define PADDLE_WIDTH 3
+#define PADDLE_HEIGHT 20
+#define PADDLE_MARGIN 4
+#define PADDLE_SPEED 120
+// The board's paddle is slower, so that it can be beaten
+#define BOARD_SPEED 70
+#define BALL_SIZE 4
+#define SERVE_SPEED 80
+// Each hit on a paddle speeds the ball up by a sixteenth, up to this. At
+// the top speed the ball covers more than its own size in an update.
+#define MAX_SPEED 300
+// At the ends of a paddle the ball leaves at 45 degrees
+#define MAX_SLOPE PHYS_ONE
+// Bounces handled in one update, a ball stuck between a paddle and a wall
+// would otherwise keep bouncing
+#define MAX_BOUNCES 4
+
+#define COLOR_BACKGROUND GAME_RGB(0, 0, 0)
+#define COLOR_PADDLE GAME_RGB(255, 255, 255)
+#define COLOR_BALL GAME_RGB(255, 255, 0)
+
+//=============================================================================
+// The walls are outside the screen, above and below it
+enum { WALL_TOP, WALL_BOTTOM, PADDLE_PLAYER, PADDLE_BOARD, BOX_COUNT };
+
+typedef struct {
+  tPhysBox box[BOX_COUNT];
+  tPhysBody ball;
+  uint32_t serves;
+  uint32_t score_player;
+  uint32_t score_board;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Where the paddles and the ball are on the LCD
+  tGameRect shown[BOX_COUNT];
+  tGameRect shown_ball;
+  bool drawn;
+} tState;
+
+static tGame g_sGame;
+static tState g_sState;
+
+//=============================================================================
+// Ball in the middle, towards the side that lost the last point. The angle
+// changes from serve to serve.
+static void serve(tState *state, int32_t towards) {
+  static const int32_t slopes[4] = {-2, 1, -1, 2};
+
+  state->ball.box.x = PHYS_FROM_INT((GAME_WIDTH - BALL_SIZE) / 2);
+  state->ball.box.y = PHYS_FROM_INT((GAME_HEIGHT - BALL_SIZE) / 2);
+  state->ball.vx = towards * PHYS_FROM_INT(SERVE_SPEED);
+  state->ball.vy =
+      slopes[state->serves % 4] * PHYS_FROM_INT(SERVE_SPEED) / 4;
+  state->serves++;
+}
+
+static void resetGame(tState *state) {
+  static const tPhysBox start[BOX_COUNT] = {
+      {PHYS_FROM_INT(-GAME_WIDTH), PHYS_FROM_INT(-16),
+       PHYS_FROM_INT(3 * GAME_WIDTH), PHYS_FROM_INT(16)},
+      {PHYS_FROM_INT(-GAME_WIDTH), PHYS_FROM_INT(GAME_HEIGHT),
+       PHYS_FROM_INT(3 * GAME_WIDTH), PHYS_FROM_INT(16)},
+      {PHYS_FROM_INT(PADDLE_MARGIN),
+       PHYS_FROM_INT((GAME_HEIGHT - PADDLE_HEIGHT) / 2),
+       PHYS_FROM_INT(PADDLE_WIDTH), PHYS_FROM_INT(PADDLE_HEIGHT)},
+      {PHYS_FROM_INT(GAME_WIDTH - PADDLE_MARGIN - PADDLE_WIDTH),
+       PHYS_FROM_INT((GAME_HEIGHT - PADDLE_HEIGHT) / 2),
+       PHYS_FROM_INT(PADDLE_WIDTH), PHYS_FROM_INT(PADDLE_HEIGHT)}};
+
+  memcpy(state->box, start, sizeof(start));
+  state->ball.box.width = PHYS_FROM_INT(BALL_SIZE);
+  state->ball.box.height = PHYS_FROM_INT(BALL_SIZE);
+  state->serves = 0;
+  state->score_player = 0;
+  state->score_board = 0;
+  serve(state, -1);
+}
+
+//=============================================================================
+// Move a paddle by dy, keeping it on the screen
+static void movePaddle(tPhysBox *paddle, tQ16 dy) {
+  paddle->y += dy;
+  if (paddle->y < 0) {
+    paddle->y = 0;
+  } else if (paddle->y > PHYS_FROM_INT(GAME_HEIGHT - PADDLE_HEIGHT)) {
+    paddle->y = PHYS_FROM_INT(GAME_HEIGHT - PADDLE_HEIGHT);
+  }
+}
+
+//=============================================================================
+static void update(tGame *game, const tGameInput *input, void *argument) {
+  tState *state = argument;
+  tPhysBox *board = &state->box[PADDLE_BOARD];
+  tQ16 time = DT;
+  tQ16 step;
+  tQ16 target;
+  tQ16 speed;
+  tPhysHit hit;
+  int32_t box;
+  uint32_t i;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Up on the joystick reads high and moves the paddle up, the speed
+  // follows how far it is pushed. The speed is scaled down to a count first,
+  // the full speed times a count would not fit in 32 bits.
+  movePaddle(&state->box[PADDLE_PLAYER],
+             -PHYS_mul(PHYS_FROM_INT(PADDLE_SPEED) / 2048 * input->joystick_y,
+                       DT));
+  // The board follows the ball as fast as it is allowed to
+  step = PHYS_mul(PHYS_FROM_INT(BOARD_SPEED), DT);
+  target = state->ball.box.y + (state->ball.box.height - board->height) / 2 -
+           board->y;
+  movePaddle(board, target > step ? step : target < -step ? -step : target);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The ball is swept through the update, so at any speed it bounces off a
+  // paddle instead of passing through it
+  for (i = 0; i < MAX_BOUNCES && time > 0; i++) {
+    box = PHYS_move(&state->ball, &time, state->box, (1u << BOX_COUNT) - 1,
+                    &hit);
+    if (box < 0) {
+      break;
+    }
+    if (box == WALL_TOP || box == WALL_BOTTOM) {
+      PHYS_bounce(&state->ball, &hit);
+      continue;
+    }
+    PHYS_paddleBounce(&state->ball, &state->box[box], &hit, MAX_SLOPE);
+    speed = state->ball.vx < 0 ? -state->ball.vx : state->ball.vx;
+    if (speed + speed / 16 <= PHYS_FROM_INT(MAX_SPEED)) {
+      state->ball.vx += state->ball.vx / 16;
+      state->ball.vy += state->ball.vy / 16;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (state->ball.box.x + state->ball.box.width < 0) {
+    state->score_board++;
+    serve(state, -1);
+  } else if (state->ball.box.x > PHYS_FROM_INT(GAME_WIDTH)) {
+    state->score_player++;
+    serve(state, 1);
+  }
+}
+
+//=============================================================================
+static void render(tGame *game, void *argument) {
+  tState *state = argument;
+  const tPhysBox *box;
+  uint32_t i;
+
+  if (!state->drawn) {
+    GAME_clear(game, COLOR_BACKGROUND);
+    GAME_present(game);
+    state->drawn = true;
+  }
+  for (i = PADDLE_PLAYER; i <= PADDLE_BOARD; i++) {
+    box = &state->box[i];
+    GAME_moveRect(game, &state->shown[i], PHYS_TO_INT(box->x),
+                  PHYS_TO_INT(box->y), PADDLE_WIDTH, PADDLE_HEIGHT,
+                  COLOR_PADDLE, COLOR_BACKGROUND);
+  }
+  box = &state->ball.box;
+  GAME_moveRect(game, &state->shown_ball, PHYS_TO_INT(box->x),
+                PHYS_TO_INT(box->y), BALL_SIZE, BALL_SIZE, COLOR_BALL,
+                COLOR_BACKGROUND);
+}
+
+//=============================================================================
+int main(int argc, char *argv[]) {
+  uint32_t systemClock =
+      SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_INT | SYSCTL_USE_PLL |
+                          SYSCTL_CFG_VCO_480),
+                         120000000);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  PERIPH_init(SYSCTL_PERIPH_ADC0);
+  SENSOR_enable(JOYSTICK);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The game draws into its own framebuffer and sends it straight to the
+  // ST7735S, grlib is not used
+  ST7735_init(systemClock);
+  GAME_inputInit();
+  resetGame(&g_sState);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The cycle counter runs at the system clock. g_sGame holds the frame
+  // time statistics, update_ticks_max the worst case of the physics.
+  GAME_init(&g_sGame, systemClock, UPDATE_RATE, update, render, &g_sState);
+  GAME_run(&g_sGame);
+  return 0;
+}
@@ -3,7 +3,8 @@
  * File: main.c
  * Author: Pontus Svensson
  * Date: 2023-10-07
- * Description:
+ * Description: Snake on a grid of 4 x 4 pixel cells. Every step only draws
+ * the new head and erases the old tail.
  *
  * License: This code is distributed under the MIT License. visit
  * https://opensource.org/licenses/MIT for more information.
@@ -28,65 +29,310 @@
 //=============================================================================
 #include "grlib/grlib.h"
 #include "tm4c129_functions.h"
+#include "game.h"
 
 //=============================================================================
-#define MIC_SAMPLES 8
-#define JOY_SAMPLES 4
-#define ACC_SAMPLES 2
-#define BUFFER_SIZE 50
-#define PRINT_THRESHOLD 20
-#define OPAQUE_TEXT true
+// The game state is updated at a fixed rate, drawing happens after the
+// updates that were due
+#define UPDATE_RATE 60
+// The snake moves one cell every STEP_UPDATES updates, 10 cells a second
+#define STEP_UPDATES 6
+// The joystick has to be pushed this far from the middle to turn
+#define JOYSTICK_DEADZONE 1024
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#define CELL_SIZE 4
+#define GRID_COLUMNS (GAME_WIDTH / CELL_SIZE)
+#define GRID_ROWS (GAME_HEIGHT / CELL_SIZE)
+#define GRID_CELLS (GRID_COLUMNS * GRID_ROWS)
+#define START_LENGTH 4
+// Cells the snake grows by for each piece of food
+#define GROWTH 3
+// Random cells tried for the food before searching the grid for a free one
+#define FOOD_TRIES 8
+// Cells waiting to be drawn. Each step adds at most three, the head, the
+// tail and the food.
+#define PENDING_CELLS (3 * GAME_MAX_CATCH_UP)
 
-int main(void) {
-  tContext Context;
+// One 32-bit word of the occupancy grid holds a row, and the body can use
+// an index mask since it wraps at a power of two
+#if GRID_COLUMNS > 32 || (GRID_CELLS & (GRID_CELLS - 1)) != 0
+#error "The grid has to be at most 32 columns and a power of two cells"
+#endif
+
+#define COLOR_BOARD GAME_RGB(0, 0, 0)
+#define COLOR_SNAKE GAME_RGB(0, 200, 0)
+#define COLOR_FOOD GAME_RGB(255, 0, 0)
+
+//=============================================================================
+typedef enum { RIGHT, DOWN, LEFT, UP } tDirection;
+
+static const int32_t g_pi32DX[4] = {1, 0, -1, 0};
+static const int32_t g_pi32DY[4] = {0, 1, 0, -1};
+
+typedef struct {
+  uint16_t cell;
+  uint16_t color;
+} tCellDraw;
+
+typedef struct {
+  // The body is a ring of cell numbers (row * GRID_COLUMNS + column). The
+  // head is at body[head] and the tail length - 1 entries before it, so a
+  // step writes one entry and moves two indices whatever the length.
+  uint16_t body[GRID_CELLS];
+  uint32_t head;
+  uint32_t length;
+  uint32_t growth;
+  // One bit per cell covered by the body, for checking a cell without
+  // walking the body
+  uint32_t occupied[GRID_ROWS];
+  uint16_t food;
+  tDirection direction;
+  tDirection wanted;
+  uint32_t updates;
+  uint32_t score;
+  uint32_t random;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // What render has to draw. When redraw is set the whole board is drawn
+  // instead.
+  tCellDraw pending[PENDING_CELLS];
+  uint32_t pending_count;
+  bool redraw;
+  uint32_t cells_drawn;
+} tState;
+
+static tGame g_sGame;
+static tState g_sState;
+
+//=============================================================================
+static uint32_t nextRandom(tState *state) {
+  state->random = state->random * 1664525 + 1013904223;
+  return state->random >> 16;
+}
+
+static inline bool occupied(const tState *state, uint32_t cell) {
+  return state->occupied[cell / GRID_COLUMNS] & (1u << cell % GRID_COLUMNS);
+}
+
+// Index of the lowest set bit of a non-zero word. The Cortex-M4 does this
+// with RBIT and CLZ.
+static inline uint32_t lowestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(x);
+#else
+  uint32_t n = 0;
+  uint32_t step;
+
+  for (step = 16; step > 0; step >>= 1) {
+    if ((x & ((1u << step) - 1)) == 0) {
+      n += step;
+      x >>= step;
+    }
+  }
+  return n;
+#endif
+}
+
+static inline void occupy(tState *state, uint32_t cell, bool set) {
+  if (set) {
+    state->occupied[cell / GRID_COLUMNS] |= 1u << cell % GRID_COLUMNS;
+  } else {
+    state->occupied[cell / GRID_COLUMNS] &= ~(1u << cell % GRID_COLUMNS);
+  }
+}
+
+static void drawCell(tState *state, uint32_t cell, uint16_t color) {
+  if (state->pending_count == PENDING_CELLS) {
+    state->redraw = true;
+    return;
+  }
+  state->pending[state->pending_count].cell = cell;
+  state->pending[state->pending_count].color = color;
+  state->pending_count++;
+}
+
+//=============================================================================
+// A few random cells are nearly always enough. When they are not, each row
+// is checked a word at a time starting from a random one, so finding a free
+// cell never takes more than GRID_ROWS steps. Returns false when the board
+// is full.
+static bool placeFood(tState *state) {
+  uint32_t row = nextRandom(state) % GRID_ROWS;
+  uint32_t cell;
+  uint32_t free;
+  uint32_t i;
+
+  for (i = 0; i < FOOD_TRIES; i++) {
+    cell = nextRandom(state) % GRID_CELLS;
+    if (!occupied(state, cell)) {
+      state->food = cell;
+      drawCell(state, cell, COLOR_FOOD);
+      return true;
+    }
+  }
+  for (i = 0; i < GRID_ROWS; i++) {
+    free = ~state->occupied[row];
+#if GRID_COLUMNS < 32
+    free &= (1u << GRID_COLUMNS) - 1;
+#endif
+    if (free != 0) {
+      state->food = row * GRID_COLUMNS + lowestBit(free);
+      drawCell(state, state->food, COLOR_FOOD);
+      return true;
+    }
+    row = (row + 1) % GRID_ROWS;
+  }
+  return false;
+}
+
+//=============================================================================
+// A new snake in the middle of the board, heading right
+static void resetGame(tState *state) {
+  uint32_t cell = (GRID_ROWS / 2) * GRID_COLUMNS + GRID_COLUMNS / 4;
+  uint32_t i;
+
+  memset(state->occupied, 0, sizeof(state->occupied));
+  state->head = START_LENGTH - 1;
+  state->length = START_LENGTH;
+  state->growth = 0;
+  for (i = 0; i < START_LENGTH; i++) {
+    state->body[i] = cell + i;
+    occupy(state, cell + i, true);
+  }
+  state->direction = RIGHT;
+  state->wanted = RIGHT;
+  state->score = 0;
+  state->redraw = true;
+  placeFood(state);
+}
+
+//=============================================================================
+// Move the snake one cell. The tail leaves its cell before the head moves,
+// so the head may follow right behind the tail.
+static void step(tState *state) {
+  uint32_t cell = state->body[state->head];
+  int32_t x = cell % GRID_COLUMNS + g_pi32DX[state->direction];
+  int32_t y = cell / GRID_COLUMNS + g_pi32DY[state->direction];
+  uint32_t tail;
+
+  if (x < 0 || x >= GRID_COLUMNS || y < 0 || y >= GRID_ROWS) {
+    resetGame(state);
+    return;
+  }
+  cell = y * GRID_COLUMNS + x;
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t joystick_x_samples[JOY_SAMPLES];
-  uint32_t joystick_y_samples[JOY_SAMPLES];
+  if (state->growth > 0 && state->length < GRID_CELLS) {
+    state->growth--;
+    state->length++;
+  } else {
+    tail = state->body[(state->head - state->length + 1) & (GRID_CELLS - 1)];
+    occupy(state, tail, false);
+    drawCell(state, tail, COLOR_BOARD);
+  }
+  if (occupied(state, cell)) {
+    resetGame(state);
+    return;
+  }
+  occupy(state, cell, true);
+  state->head = (state->head + 1) & (GRID_CELLS - 1);
+  state->body[state->head] = cell;
+  drawCell(state, cell, COLOR_SNAKE);
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t joystick_x_average = 0;
-  uint32_t joystick_y_average = 0;
+  // A full board is won, and the game starts over
+  if (cell == state->food) {
+    state->score++;
+    state->growth += GROWTH;
+    if (!placeFood(state)) {
+      resetGame(state);
+    }
+  }
+}
+
+//=============================================================================
+static void update(tGame *game, const tGameInput *input, void *argument) {
+  tState *state = argument;
+  int32_t x = input->joystick_x;
+  int32_t y = input->joystick_y;
+  tDirection wanted = state->wanted;
+
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t samplesRead = 0;
+  // The axis pushed the furthest decides, up on the joystick reads high.
+  // Turning straight back is ignored.
+  if ((x < 0 ? -x : x) > (y < 0 ? -y : y)) {
+    if (x > JOYSTICK_DEADZONE) {
+      wanted = RIGHT;
+    } else if (x < -JOYSTICK_DEADZONE) {
+      wanted = LEFT;
+    }
+  } else if (y > JOYSTICK_DEADZONE) {
+    wanted = UP;
+  } else if (y < -JOYSTICK_DEADZONE) {
+    wanted = DOWN;
+  }
+  if (wanted != (state->direction + 2) % 4) {
+    state->wanted = wanted;
+  }
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (++state->updates % STEP_UPDATES == 0) {
+    state->direction = state->wanted;
+    step(state);
+  }
+}
+
+//=============================================================================
+// The cells are written straight to the LCD, the back buffer of the runtime
+// is not used. The whole board is only drawn at the start of a game.
+static void sendCell(tState *state, uint32_t cell, uint16_t color) {
+  uint32_t x = (cell % GRID_COLUMNS) * CELL_SIZE;
+  uint32_t y = (cell / GRID_COLUMNS) * CELL_SIZE;
+
+  ST7735_setWindow(x, y, x + CELL_SIZE - 1, y + CELL_SIZE - 1);
+  ST7735_writeColor(color, CELL_SIZE * CELL_SIZE);
+  state->cells_drawn++;
+}
+
+static void render(tGame *game, void *argument) {
+  tState *state = argument;
+  uint32_t i;
+
+  if (state->redraw) {
+    ST7735_setWindow(0, 0, GAME_WIDTH - 1, GAME_HEIGHT - 1);
+    ST7735_writeColor(COLOR_BOARD, GAME_WIDTH * GAME_HEIGHT);
+    for (i = 0; i < state->length; i++) {
+      sendCell(state, state->body[(state->head - i) & (GRID_CELLS - 1)],
+               COLOR_SNAKE);
+    }
+    sendCell(state, state->food, COLOR_FOOD);
+    state->redraw = false;
+    state->pending_count = 0;
+    return;
+  }
+  for (i = 0; i < state->pending_count; i++) {
+    sendCell(state, state->pending[i].cell, state->pending[i].color);
+  }
+  state->pending_count = 0;
+}
+
+//=============================================================================
+int main(void) {
   uint32_t systemClock =
       SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_INT | SYSCTL_USE_PLL |
                           SYSCTL_CFG_VCO_480),
                          120000000);
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   PERIPH_init(SYSCTL_PERIPH_ADC0);
-  SENSOR_enable(JOYSTICK | BUTTON_UP | BUTTON_DOWN);
+  SENSOR_enable(JOYSTICK);
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // Function to initialize the LCD using the TiwaWare peripheral driver library
-  CF128x128x16_ST7735SInit(systemClock);
+  // The cells are sent straight to the ST7735S, grlib is not used
+  ST7735_init(systemClock);
+  GAME_inputInit();
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // Set the background to be white
-  CF128x128x16_ST7735SClear(ClrWhite);
+  // Everything is in g_sState, nothing is allocated while playing
+  g_sState.random = 1;
+  resetGame(&g_sState);
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // All drawing operations take place in terms of a drawing contex. This
-  // context describes the display to which the operation occurs, the color and
-  // font to use, and the region of the display to which the operation should be
-  // limited (the clipping region). A drawing context must be initialized with
-  // GrContextInit() before it can be used to perform drawing operations.
-  // "TivaWare Graphics Library for C Series User's Guide (Rev. E)" p.15
-  GrContextInit(&Context, &g_sCF128x128x16_ST7735S);
-  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // Set the font size for the drawing
-  GrContextFontSet(&Context, &g_sFontCm14);
-  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // This function sets the background color to be used for drawing opertions in
-  // the specified drawing context. This will change the box behind the
-  // foreground drawing. p.44
-  GrContextBackgroundSet(&Context, ClrWhite);
-  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // This function sets the color to be used for drawing operation in the
-  // specified drawing context. This will change the text color. p.45
-  GrContextForegroundSet(&Context, ClrBlack);
-  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
-  GrFlush(&Context);
-
-  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  ADC_newSequence(ADC0_BASE, 0, ADC_CTL_CH9, JOY_SAMPLES);
-  while (1) {
-  }
+  // The cycle counter runs at the system clock. g_sGame holds the frame
+  // time statistics.
+  GAME_init(&g_sGame, systemClock, UPDATE_RATE, update, render, &g_sState);
+  GAME_run(&g_sGame);
+  return 0;
 }
@@ -14,15 +14,34 @@
  */
 
 /*================================================================*/
-#include <math.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 //=============================================================================
 #include "tm4c129_functions.h"
+#include "adc_average.h"
+#include "adc_pingpong.h"
+#include "button_events.h"
+#include "clock_profile.h"
+#include "fft.h"
+#include "filter.h"
+#include "fixed_db.h"
+#include "dashboard.h"
+#include "idle.h"
+#include "joystick.h"
+#include "orientation.h"
+#include "profile.h"
+#include "sample_queue.h"
+#include "scheduler.h"
+#include "sound_meter.h"
+#include "spectrum.h"
+#include "telemetry.h"
+#include "uart_console.h"
 //=============================================================================
 #include "driverlib/sysctl.h"
 #include "driverlib/adc.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
 //=============================================================================
 #include "inc/hw_memmap.h"
 //=============================================================================
@@ -31,12 +50,250 @@
 #include "grlib/grlib.h"
 
 //=============================================================================
-#define MIC_SAMPLES 8
-#define JOY_SAMPLES 4
-#define ACC_SAMPLES 2
-#define BUFFER_SIZE 50
+// Every trigger of the scan captures one frame, one sample of each sensor
+// channel. SCAN_FRAMES frames make up one ping-pong block.
+#define SCAN_MIC 0
+#define SCAN_JOY_X 1
+#define SCAN_JOY_Y 2
+#define SCAN_ACC_X 3
+#define SCAN_ACC_Y 4
+#define SCAN_ACC_Z 5
+#define SCAN_CHANNELS 6
+#define SCAN_FRAMES 8
+#define SCAN_RATE 8000
+// The ADC averages every conversion over 4 samples in hardware, at no CPU
+// cost. 6 channels at 8 kHz times 4 is 192 ksps, well below the 2 Msps of
+// the converter.
+#define SCAN_OVERSAMPLE 4
+// The interrupt moves every block into a queue of 2^SCAN_QUEUE_LOG2 frames,
+// 512 frames is 64 ms, so the tasks can be held up for that long before a
+// sample is lost
+#define SCAN_QUEUE_LOG2 9
+#if (1u << SCAN_QUEUE_LOG2) % SCAN_FRAMES != 0
+#error "The scan queue has to hold a whole number of blocks"
+#endif
+// Length of the moving averages as log2, 8 mic, 4 joystick and 2 accelerometer
+// samples
+#define MIC_AVERAGE_LOG2 3
+#define JOY_AVERAGE_LOG2 2
+#define ACC_AVERAGE_LOG2 1
 #define PRINT_THRESHOLD 20
-#define OPAQUE_TEXT true
+// The joystick samples first go through a median of JOY_MEDIAN_LENGTH, which
+// takes out single spikes. After the average each axis has a deadzone, end
+// stops and a hysteresis band instead of the PRINT_THRESHOLD, so the centre
+// and the ends read exactly and noise does not make the LCD redraw.
+#define JOY_MEDIAN_LENGTH 5
+// Every character the LCD lines use, these are drawn from the glyph cache
+#define LCD_CHARACTERS "0123456789 :-/,ABMXYZcdiJoyPRthlCarunk"
+// In orientation mode the accelerometer lines show the pitch and the roll in
+// degrees and whether the accelerometer is calibrated. Pressing S1 starts a
+// calibration: turn the board so that every side faces up once, then press
+// S1 again and the calibration is stored in the EEPROM.
+#define ORIENTATION_MODE 1
+// S1 of the BoosterPack (PL1) goes through the debounced button events, the
+// accelerometer task takes up to CALIBRATION_EVENTS of them per run
+#define CALIBRATION_EVENTS 4
+static const tBtnPin g_sCalibrationButton = {SYSCTL_PERIPH_GPIOL,
+                                             GPIO_PORTL_BASE, GPIO_PIN_1};
+// In telemetry mode every averaged frame is also streamed over the UART as
+// binary records, see telemetry.h. At 115200 baud the UART manages about 600
+// records per second, so the scan produces more than that; use a baud rate of
+// 460800 or more to get every frame out.
+#define TELEMETRY_MODE 1
+#define TELEMETRY_BAUD 921600
+// In sound meter mode the LCD shows the A-weighted RMS level of the mic over
+// METER_RMS_WINDOW samples and the peak over METER_PEAK_WINDOW samples,
+// instead of the dB of the averaged raw samples (which is mostly the bias).
+// The meter may spend at most 1 / METER_BUDGET_SHARE of a sample period per
+// sample.
+#define SOUND_METER_MODE 1
+#define METER_RMS_WINDOW 1000
+#define METER_PEAK_WINDOW 8000
+#define METER_BUDGET_SHARE 4
+#if SOUND_METER_MODE && SCAN_RATE != METER_SAMPLE_RATE
+#error "The A-weighting of the sound meter is designed for METER_SAMPLE_RATE"
+#endif
+// In spectrum mode the LCD shows the mic line at the top and the spectrum of
+// the mic below it as SPECTRUM_BARS bars. A spectrum is 2^FFT_LOG2 samples,
+// 256 samples at 8 kHz is 31 spectra per second. Each run of the LCD task
+// draws at most SPECTRUM_BARS_PER_RUN bars so it never holds up the
+// acquisition for long. The FFT buffers are only there in spectrum mode.
+// It can be set from the command line, the host build compiles both.
+#ifndef SPECTRUM_MODE
+#define SPECTRUM_MODE 0
+#endif
+#define FFT_LOG2 8
+#define FFT_POINTS (1u << FFT_LOG2)
+#define SPECTRUM_BARS 32
+#define SPECTRUM_BARS_PER_RUN 4
+
+//=============================================================================
+// Every stage of the superloop is a task of its own, with its own period in
+// SysTick ticks. The LCD no longer decides how often the mic is looked at.
+#define SCHED_TICK_RATE 1000
+// The uDMA fills a block every SCAN_FRAMES / SCAN_RATE = 1 ms
+#define ACQUISITION_PERIOD 1
+// 100 Hz
+#define JOYSTICK_PERIOD 10
+#define ACCELEROMETER_PERIOD 10
+// 25 Hz, or 200 Hz with a few bars at a time in spectrum mode
+#if SPECTRUM_MODE
+#define LCD_PERIOD 5
+#else
+#define LCD_PERIOD 40
+#endif
+// Often enough to pick up every spectrum well before the next is complete
+#define FFT_PERIOD 4
+// Built with PROFILE defined, typing p on the console prints where the time
+// goes, see profile.h
+#define CONSOLE_PERIOD 20
+// In sleep mode the core sleeps whenever no task is released, and the
+// SysTick, the ADC and the UART interrupts wake it. sensors->idle tells how
+// much of the time it was awake and joystick_response how long a joystick
+// movement took to reach the LCD.
+#define SLEEP_MODE 1
+#define IDLE_WINDOW_MS 1000
+
+//=============================================================================
+// One frame of the scan as the interrupt queues it. cycles is IDLE_now()
+// when the interrupt took the block, which unlike the cycle counter keeps
+// counting while the core sleeps. frame counts frames since the start.
+typedef struct {
+  uint32_t cycles;
+  uint32_t frame;
+  uint16_t value[SCAN_CHANNELS];
+} tScanFrame;
+
+//=============================================================================
+// Everything the tasks share. The tasks only run from the main loop, one at a
+// time, so nothing here needs protecting from each other.
+typedef struct {
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // All sensors are scanned by one sequencer and the uDMA moves the frames
+  // into two buffers, while one is filled the other one is processed.
+  tADCPingPong scan_acquisition;
+  uint32_t scan_ping[SCAN_FRAMES * SCAN_CHANNELS];
+  uint32_t scan_pong[SCAN_FRAMES * SCAN_CHANNELS];
+  tSampleQueue scan_queue;
+  tScanFrame scan_frames[1u << SCAN_QUEUE_LOG2];
+  // Most cycles from the interrupt to the acquisition task
+  uint32_t scan_latency_max;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Where each channel of the latest block ends up after de-interleaving,
+  // and when the interrupt took it
+  uint32_t samples[SCAN_CHANNELS][SCAN_FRAMES];
+  uint32_t samples_time;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tFilterMovingAverage microphone_filter;
+  uint32_t microphone_window[FILTER_LENGTH(MIC_AVERAGE_LOG2)];
+  uint32_t microphone_average;
+  tSoundMeter meter;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#if SPECTRUM_MODE
+  // The acquisition fills one of the FFT inputs while the FFT task works on
+  // the other, so the transform overlaps the capture of the next spectrum.
+  // A spectrum is dropped if the FFT task has not taken the last one yet.
+  int16_t fft_input[2][FFT_POINTS];
+  uint32_t fft_fill_buffer;
+  uint32_t fft_fill;
+  volatile bool fft_ready;
+  uint32_t fft_dropped;
+  uint32_t spectra;
+  tFFTComplex fft_data[FFT_POINTS];
+  uint16_t fft_magnitude[FFT_POINTS / 2];
+  tSpectrum spectrum;
+#endif
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tFilterMovingAverage joystick_x_filter;
+  tFilterMovingAverage joystick_y_filter;
+  uint32_t joystick_x_window[FILTER_LENGTH(JOY_AVERAGE_LOG2)];
+  uint32_t joystick_y_window[FILTER_LENGTH(JOY_AVERAGE_LOG2)];
+  uint32_t joystick_x_average;
+  uint32_t joystick_y_average;
+  tFilterMedian joystick_x_median;
+  tFilterMedian joystick_y_median;
+  uint32_t joystick_x_median_window[JOY_MEDIAN_LENGTH];
+  uint32_t joystick_y_median_window[JOY_MEDIAN_LENGTH];
+  tJoyAxis joystick_x;
+  tJoyAxis joystick_y;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tFilterMovingAverage accelerometer_x_filter;
+  tFilterMovingAverage accelerometer_y_filter;
+  tFilterMovingAverage accelerometer_z_filter;
+  uint32_t accelerometer_x_window[FILTER_LENGTH(ACC_AVERAGE_LOG2)];
+  uint32_t accelerometer_y_window[FILTER_LENGTH(ACC_AVERAGE_LOG2)];
+  uint32_t accelerometer_z_window[FILTER_LENGTH(ACC_AVERAGE_LOG2)];
+  uint32_t accelerometer_x_average;
+  uint32_t accelerometer_y_average;
+  uint32_t accelerometer_z_average;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#if ORIENTATION_MODE
+  tOrientCalibration calibration;
+  tOrientCapture capture;
+  tOrientation orientation;
+  bool calibrating;
+  const char *calibration_text;
+  int32_t pitch_previous;
+  int32_t roll_previous;
+#endif
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The previous values are used to compare if the values has changed
+  // indicating user input. This should avoid spam printing the values.
+  uint32_t microphone_previous;
+  uint32_t accelerometer_x_previous;
+  uint32_t accelerometer_y_previous;
+  uint32_t accelerometer_z_previous;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Set by the sensor tasks, cleared by the LCD task
+  uint32_t microphone_update;
+  uint32_t joystick_update;
+  uint32_t accelerometer_update;
+  // When the block with the joystick movement the LCD is to show was taken
+  uint32_t joystick_input_time;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tIdle idle;
+  // From the joystick movement to the end of the LCD frame showing it
+  tIdleLatency joystick_response;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tDashboard dashboard;
+  tDashGlyphs glyphs;
+  uint32_t microphone_field;
+  uint32_t joystick_field;
+  uint32_t accelerometer_x_field;
+  uint32_t accelerometer_y_field;
+  uint32_t accelerometer_z_field;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tTelemetry telemetry;
+#ifdef PROFILE
+  tProfDump profile_dump;
+#endif
+} tSensors;
+
+static tSensors g_sSensors;
+static tScheduler g_sScheduler;
+
+//=============================================================================
+// The idle clock, the button time outs and the meter budget count at the
+// system clock
+static void clockChanged(const tClockTiming *timing, void *argument) {
+  tSensors *sensors = argument;
+
+  IDLE_setClock(&sensors->idle, timing->system_clock);
+#if ORIENTATION_MODE
+  BTN_setClock(timing->system_clock);
+#endif
+#if SOUND_METER_MODE
+  sensors->meter.cycle_budget =
+      timing->system_clock / SCAN_RATE / METER_BUDGET_SHARE;
+#endif
+}
+
+#if SLEEP_MODE
+//=============================================================================
+// Called by IDLE_sleep() with interrupts masked, a tick that releases a task
+// after this still wakes the core
+static bool tasksPending(void *argument) { return SCHED_pending(argument); }
+#endif
 
 //=============================================================================
 // The error routine that is called if the driver library
@@ -50,58 +307,503 @@ void __error__(char *pcFilename, uint32_t ui32Line) {
 #endif
 
 //=============================================================================
-int main(void) {
-  tContext sContext;
+// ADC interrupt, takes every block the uDMA has filled as frames into the
+// queue. A block that does not fit is dropped whole and counted in
+// scan_queue.overflows.
+static void scanBlockHandler(const uint32_t *block, uint32_t index,
+                             void *argument) {
+  tSensors *sensors = argument;
+  tScanFrame frames[SCAN_FRAMES];
+  uint32_t cycles = IDLE_now();
+  uint32_t i;
+  uint32_t j;
+  PROF_BEGIN(scan_isr);
+
+  for (i = 0; i < SCAN_FRAMES; i++) {
+    frames[i].cycles = cycles;
+    frames[i].frame = index * SCAN_FRAMES + i;
+    for (j = 0; j < SCAN_CHANNELS; j++) {
+      frames[i].value[j] = block[i * SCAN_CHANNELS + j];
+    }
+  }
+  QUEUE_push(&sensors->scan_queue, frames, SCAN_FRAMES);
+  PROF_END(scan_isr);
+}
+
+//=============================================================================
+// Acquisition and microphone, every block the uDMA fills goes through here
+static void acquisitionTask(void *argument) {
+  tSensors *sensors = argument;
+  tScanFrame frames[SCAN_FRAMES];
+  uint32_t latency;
+  uint32_t i;
+  uint32_t j;
+#if TELEMETRY_MODE
+  uint16_t telemetry_values[TELEM_CHANNELS];
+  uint32_t telemetry_timestamp;
+#endif
+
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t microphone_samples[MIC_SAMPLES];
-  uint32_t microphone_average = 0;
-  uint32_t microphone_average_to_db = 0;
+  // Usually there is exactly one block waiting, after the task was held up
+  // there can be a whole queue of them. The interrupt pushes whole blocks,
+  // so every batch is one.
+  while (QUEUE_pop(&sensors->scan_queue, frames, SCAN_FRAMES) ==
+         SCAN_FRAMES) {
+    PROF_BEGIN(deinterleave);
+    latency = IDLE_now() - frames[0].cycles;
+    if (latency > sensors->scan_latency_max) {
+      sensors->scan_latency_max = latency;
+    }
+    for (i = 0; i < SCAN_FRAMES; i++) {
+      for (j = 0; j < SCAN_CHANNELS; j++) {
+        sensors->samples[j][i] = frames[i].value[j];
+      }
+    }
+    PROF_END(deinterleave);
+    sensors->samples_time = frames[0].cycles;
+#if TELEMETRY_MODE
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The timestamp counts scan frames since the start, 1 / SCAN_RATE s each
+    telemetry_timestamp = frames[0].frame;
+#endif
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Microphone
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The mic is the only sensor averaged over every sample, the others only
+    // look at the latest block when their task runs
+    PROF_BEGIN(average);
+    sensors->microphone_average = FILTER_movingAveragePushBlock(
+        &sensors->microphone_filter, sensors->samples[SCAN_MIC], SCAN_FRAMES);
+    PROF_END(average);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // I only want to update the values on the LCD if the change is big enough
+    // to indicate that the user has done some input to the sensors
+    PROF_BEGIN(level);
+#if SOUND_METER_MODE
+    // The level only changes at the end of an RMS window, and then a change
+    // of a whole dB is enough
+    if (METER_pushBlock(&sensors->meter, sensors->samples[SCAN_MIC],
+                        SCAN_FRAMES) &&
+        (uint32_t)DB_round(sensors->meter.rms_db) !=
+            sensors->microphone_previous) {
+      sensors->microphone_update = 1;
+      sensors->microphone_previous = DB_round(sensors->meter.rms_db);
+    }
+#else
+    if (abs_diff(sensors->microphone_average, sensors->microphone_previous) >=
+        PRINT_THRESHOLD) {
+      sensors->microphone_update = 1;
+      sensors->microphone_previous = sensors->microphone_average;
+    }
+#endif
+    PROF_END(level);
+
+#if SPECTRUM_MODE
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Spectrum
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The 12-bit samples are centered on the middle of the range and scaled
+    // to Q15
+    for (i = 0; i < SCAN_FRAMES; i++) {
+      sensors->fft_input[sensors->fft_fill_buffer][sensors->fft_fill++] =
+          (int16_t)(((int32_t)sensors->samples[SCAN_MIC][i] - 2048) << 4);
+    }
+    if (sensors->fft_fill == FFT_POINTS) {
+      if (sensors->fft_ready) {
+        sensors->fft_dropped++;
+      } else {
+        sensors->fft_ready = true;
+        sensors->fft_fill_buffer ^= 1;
+      }
+      sensors->fft_fill = 0;
+    }
+#endif
+
+#if TELEMETRY_MODE
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Telemetry
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Every block is streamed, no matter the print threshold. The joystick
+    // and accelerometer values are the latest their tasks produced. The
+    // records go out in batches of TELEM_BATCH.
+#ifdef PROFILE
+    // The profile tables would run into the frames, nothing is streamed
+    // while they are printed
+    if (sensors->profile_dump.active) {
+      continue;
+    }
+#endif
+    PROF_BEGIN(telemetry);
+    telemetry_values[SCAN_MIC] = sensors->microphone_average;
+    telemetry_values[SCAN_JOY_X] = sensors->joystick_x_average;
+    telemetry_values[SCAN_JOY_Y] = sensors->joystick_y_average;
+    telemetry_values[SCAN_ACC_X] = sensors->accelerometer_x_average;
+    telemetry_values[SCAN_ACC_Y] = sensors->accelerometer_y_average;
+    telemetry_values[SCAN_ACC_Z] = sensors->accelerometer_z_average;
+    TELEM_add(&sensors->telemetry, telemetry_timestamp, telemetry_values);
+    PROF_END(telemetry);
+#endif
+  }
+}
+
+#if SPECTRUM_MODE
+//=============================================================================
+// Transform the input the acquisition is not filling and hand the bins to
+// the bars, the LCD task draws them
+static void fftTask(void *argument) {
+  tSensors *sensors = argument;
+
+  if (!sensors->fft_ready) {
+    return;
+  }
+  FFT_hann(sensors->fft_data, sensors->fft_input[sensors->fft_fill_buffer ^ 1],
+           FFT_LOG2);
+  sensors->fft_ready = false;
+  FFT_transform(sensors->fft_data, FFT_LOG2);
+  FFT_magnitude(sensors->fft_data, sensors->fft_magnitude, FFT_POINTS / 2);
+  SPECTRUM_setBins(&sensors->spectrum, sensors->fft_magnitude, FFT_POINTS / 2);
+  sensors->spectra++;
+}
+#endif
+
+//=============================================================================
+// Centre, deadzone, low and high stop, hysteresis. The stops are a little
+// inside the range of the ADC, the stick does not reach 0 or 4095 on every
+// board.
+static const tJoyAxisConfig g_sJoystickXConfig = {2048, 48, 60, 4035, 24};
+static const tJoyAxisConfig g_sJoystickYConfig = {2048, 48, 60, 4035, 24};
+
+// Median and then average of the samples of one axis in the latest block
+static uint32_t joystickFilter(tFilterMedian *median,
+                               tFilterMovingAverage *average,
+                               const uint32_t *samples) {
+  uint32_t i;
+
+  for (i = 0; i < SCAN_FRAMES; i++) {
+    FILTER_movingAveragePush(average, FILTER_medianPush(median, samples[i]));
+  }
+  return FILTER_movingAverageGet(average);
+}
+
+//=============================================================================
+static void joystickTask(void *argument) {
+  tSensors *sensors = argument;
+  uint32_t update = sensors->joystick_update;
+
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // The previous values are used to compare if the values has changed
-  // indicating user input. This should avoid spam printing the values.
-  uint32_t microphone_previous = 0;
+  // Joystick-X
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t joystick_x_samples[JOY_SAMPLES];
-  uint32_t joystick_y_samples[JOY_SAMPLES];
+  sensors->joystick_x_average =
+      joystickFilter(&sensors->joystick_x_median, &sensors->joystick_x_filter,
+                     sensors->samples[SCAN_JOY_X]);
+  if (JOY_axisUpdate(&sensors->joystick_x, sensors->joystick_x_average)) {
+    sensors->joystick_update = 1;
+  }
+
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t joystick_x_average = 0;
-  uint32_t joystick_y_average = 0;
+  // Joystick-Y
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t joystick_x_previous = 0;
-  uint32_t joystick_y_previous = 0;
+  sensors->joystick_y_average =
+      joystickFilter(&sensors->joystick_y_median, &sensors->joystick_y_filter,
+                     sensors->samples[SCAN_JOY_Y]);
+  if (JOY_axisUpdate(&sensors->joystick_y, sensors->joystick_y_average)) {
+    sensors->joystick_update = 1;
+  }
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t accelerometer_x_samples[ACC_SAMPLES];
-  uint32_t accelerometer_y_samples[ACC_SAMPLES];
-  uint32_t accelerometer_z_samples[ACC_SAMPLES];
+  // The response is timed from the first movement the LCD has not shown yet
+  if (update == 0 && sensors->joystick_update == 1) {
+    sensors->joystick_input_time = sensors->samples_time;
+  }
+}
+
+#if ORIENTATION_MODE
+//=============================================================================
+// Pitch and roll from the latest accelerometer averages. A press of S1
+// starts and ends the calibration.
+static void orientationUpdate(tSensors *sensors) {
+  uint32_t raw[ORIENT_AXES];
+  tBtnEvent events[CALIBRATION_EVENTS];
+  uint32_t count;
+  uint32_t i;
+
+  raw[0] = sensors->accelerometer_x_average;
+  raw[1] = sensors->accelerometer_y_average;
+  raw[2] = sensors->accelerometer_z_average;
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t accelerometer_x_average = 0;
-  uint32_t accelerometer_y_average = 0;
-  uint32_t accelerometer_z_average = 0;
+  // The events are debounced already, every press is one event however
+  // long the contacts bounce and wherever the task runs
+  count = BTN_pop(events, CALIBRATION_EVENTS);
+  for (i = 0; i < count; i++) {
+    if (events[i].type != BTN_PRESS) {
+      continue;
+    }
+    if (!sensors->calibrating) {
+      ORIENT_captureStart(&sensors->capture);
+      sensors->calibrating = true;
+      sensors->calibration_text = "run";
+    } else {
+      // Programming the EEPROM takes a few milliseconds, but this only
+      // happens once per calibration
+      sensors->calibrating = false;
+      if (ORIENT_captureFinish(&sensors->capture, &sensors->calibration) &&
+          ORIENT_save(&sensors->calibration)) {
+        sensors->calibration_text = "ok";
+      } else {
+        sensors->calibration_text = "no";
+      }
+    }
+    sensors->accelerometer_update = 1;
+  }
+  if (sensors->calibrating) {
+    ORIENT_captureAdd(&sensors->capture, raw);
+  }
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t accelerometer_x_previous = 0;
-  uint32_t accelerometer_y_previous = 0;
-  uint32_t accelerometer_z_previous = 0;
+  PROF_BEGIN(orientation);
+  ORIENT_update(&sensors->calibration, raw, &sensors->orientation);
+  PROF_END(orientation);
+  if (ORIENT_DEGREES(sensors->orientation.pitch) != sensors->pitch_previous ||
+      ORIENT_DEGREES(sensors->orientation.roll) != sensors->roll_previous) {
+    sensors->accelerometer_update = 1;
+    sensors->pitch_previous = ORIENT_DEGREES(sensors->orientation.pitch);
+    sensors->roll_previous = ORIENT_DEGREES(sensors->orientation.roll);
+  }
+}
+#endif
+
+//=============================================================================
+static void accelerometerTask(void *argument) {
+  tSensors *sensors = argument;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Accelerometer-X
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  sensors->accelerometer_x_average =
+      FILTER_movingAveragePushBlock(&sensors->accelerometer_x_filter,
+                                    sensors->samples[SCAN_ACC_X], SCAN_FRAMES);
+  if (abs_diff(sensors->accelerometer_x_average,
+               sensors->accelerometer_x_previous) >= PRINT_THRESHOLD) {
+    sensors->accelerometer_update = 1;
+    sensors->accelerometer_x_previous = sensors->accelerometer_x_average;
+  }
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Accelerometer-Y
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  sensors->accelerometer_y_average =
+      FILTER_movingAveragePushBlock(&sensors->accelerometer_y_filter,
+                                    sensors->samples[SCAN_ACC_Y], SCAN_FRAMES);
+  if (abs_diff(sensors->accelerometer_y_average,
+               sensors->accelerometer_y_previous) >= PRINT_THRESHOLD) {
+    sensors->accelerometer_update = 1;
+    sensors->accelerometer_y_previous = sensors->accelerometer_y_average;
+  }
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Accelerometer-Z
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  sensors->accelerometer_z_average =
+      FILTER_movingAveragePushBlock(&sensors->accelerometer_z_filter,
+                                    sensors->samples[SCAN_ACC_Z], SCAN_FRAMES);
+  if (abs_diff(sensors->accelerometer_z_average,
+               sensors->accelerometer_z_previous) >= PRINT_THRESHOLD) {
+    sensors->accelerometer_update = 1;
+    sensors->accelerometer_z_previous = sensors->accelerometer_z_average;
+  }
+#if ORIENTATION_MODE
+  orientationUpdate(sensors);
+#endif
+}
+
+//=============================================================================
+// If the values has changed indicating user input, I update the LCD on screen
+// values
+static void lcdTask(void *argument) {
+  tSensors *sensors = argument;
+  tDashLine line;
+  bool joystick_shown = false;
+  PROF_BEGIN(render);
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#if SOUND_METER_MODE
+  if (sensors->microphone_update == 1) {
+    // The levels are relative to one ADC count, there is no calibration to
+    // sound pressure
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Mic: ");
+    DASH_lineSigned(&line, DB_round(sensors->meter.rms_db));
+    DASH_lineText(&line, "/");
+    DASH_lineSigned(&line, DB_round(sensors->meter.peak_db));
+    DASH_lineText(&line, " dBA");
+    DASH_setText(&sensors->dashboard, sensors->microphone_field, line.text);
+    sensors->microphone_update = 0;
+  }
+#else
+  if (sensors->microphone_update == 1) {
+    uint32_t microphone_average_to_db;
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Convert the microphone value to dB, in integers so that neither
+    // double precision nor libm is needed
+    PROF_BEGIN(db);
+    microphone_average_to_db =
+        DB_round(DB_fromLinear(sensors->microphone_average));
+    PROF_END(db);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The line is put together piece by piece in a fixed buffer, which is
+    // much cheaper than snprintf() parsing a format string
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Mic: ");
+    DASH_lineUnsigned(&line, microphone_average_to_db);
+    DASH_lineText(&line, " dB");
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The dashboard compares the string with what is on the LCD and only
+    // redraws the characters that differ
+    DASH_setText(&sensors->dashboard, sensors->microphone_field, line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    sensors->microphone_update = 0;
+  }
+#endif
+#if SPECTRUM_MODE
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only the mic line and the bars are on the LCD in spectrum mode
+  SPECTRUM_draw(&sensors->spectrum, SPECTRUM_BARS_PER_RUN);
+#else
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (sensors->joystick_update == 1) {
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Joy: ");
+    // The positions are shown from 0 to 2 * JOY_FULL, the centre is
+    // JOY_FULL
+    DASH_lineUnsigned(&line, sensors->joystick_x.position + JOY_FULL);
+    DASH_lineText(&line, "-X, ");
+    DASH_lineUnsigned(&line, sensors->joystick_y.position + JOY_FULL);
+    DASH_lineText(&line, "-Y");
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // When the text gets shorter the dashboard clears what is left of
+    // the old text
+    DASH_setText(&sensors->dashboard, sensors->joystick_field, line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    sensors->joystick_update = 0;
+    joystick_shown = true;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#if ORIENTATION_MODE
+  if (sensors->accelerometer_update == 1) {
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Pitch: ");
+    DASH_lineSigned(&line, sensors->pitch_previous);
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_x_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Roll: ");
+    DASH_lineSigned(&line, sensors->roll_previous);
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_y_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Cal: ");
+    DASH_lineText(&line, sensors->calibration_text);
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_z_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    sensors->accelerometer_update = 0;
+  }
+#else
+  if (sensors->accelerometer_update == 1) {
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // To write all axis on the screen in one line, the font size has to be
+    // really small which I did not like
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Acc: ");
+    DASH_lineUnsigned(&line, sensors->accelerometer_x_average);
+    DASH_lineText(&line, "-X");
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_x_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Acc: ");
+    DASH_lineUnsigned(&line, sensors->accelerometer_y_average);
+    DASH_lineText(&line, "-Y");
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_y_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Acc: ");
+    DASH_lineUnsigned(&line, sensors->accelerometer_z_average);
+    DASH_lineText(&line, "-Z");
+    DASH_setText(&sensors->dashboard, sensors->accelerometer_z_field,
+                 line.text);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    sensors->accelerometer_update = 0;
+  }
+#endif
+#endif
+  PROF_END(render);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Flush the LCD screen, this does nothing if no field was redrawn.
+  // dashboard.pixels_last_frame tells how much was actually sent.
+  PROF_BEGIN(flush);
+  DASH_endFrame(&sensors->dashboard);
+  PROF_END(flush);
+  if (joystick_shown) {
+    IDLE_latency(&sensors->joystick_response, sensors->joystick_input_time);
+  }
+}
+
+#ifdef PROFILE
+//=============================================================================
+// A line starting with p prints the profile tables, a few lines every run
+static void consoleTask(void *argument) {
+  tSensors *sensors = argument;
+  char line[CONSOLE_LINE_MAX];
+
+  if (CONSOLE_getLine(line, sizeof(line)) && line[0] == 'p') {
+    PROF_dumpStart(&sensors->profile_dump);
+  }
+  PROF_dump(&sensors->profile_dump);
+}
+#endif
+
+//=============================================================================
+int main(void) {
+  tSensors *sensors = &g_sSensors;
+  tContext sContext;
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  char microphone[BUFFER_SIZE];
-  char joystick[BUFFER_SIZE];
-  char accelerometer_x[BUFFER_SIZE];
-  char accelerometer_y[BUFFER_SIZE];
-  char accelerometer_z[BUFFER_SIZE];
+  // Every pixel sent to the LCD passes through the counting display, and the
+  // dashboard only sends the rectangles of the text that changed
+  tDisplay sCountingDisplay;
+  tDashCounter lcd_counter;
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t samplesRead = 0;
+  // The order of the steps has to match the SCAN_ defines
+  const uint32_t scan_steps[SCAN_CHANNELS] = {ADC_CTL_CH8, ADC_CTL_CH9,
+                                              ADC_CTL_CH0, ADC_CTL_CH3,
+                                              ADC_CTL_CH2, ADC_CTL_CH1};
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t toPrintOrNotToPrint = 0;
-  uint32_t microphone_update = 0;
-  uint32_t joystick_update = 0;
-  uint32_t accelerometer_update = 0;
+  // The scheduler tick and the timer that triggers the scan
+  tClock clock;
+  tClockUsers clock_users = {0, 0, 0, 0, SCHED_TICK_RATE, TIMER0_BASE,
+                             SCAN_RATE};
+  uint32_t systemClock;
+#if SLEEP_MODE
+  uint32_t windows = 0;
+#endif
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  uint32_t systemClock =
-      SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_INT | SYSCTL_USE_PLL |
-                          SYSCTL_CFG_VCO_480),
-                         120000000);
+  // Start at the full clock, the loop drops to a slower profile when the
+  // core is mostly asleep. The LCD is set up at this clock, so its SPI
+  // divider keeps the bit rate in the controller's limit at every profile.
+  CLOCK_init(&clock, &clock_users, CLOCK_FULL, clockChanged, sensors);
+  systemClock = clock.timing.system_clock;
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   PERIPH_init(SYSCTL_PERIPH_ADC0);
+  // The conversions run off the PIOSC, which no clock switch touches
+  ADCClockConfigSet(ADC0_BASE, ADC_CLOCK_SRC_PIOSC | ADC_CLOCK_RATE_FULL, 1);
   SENSOR_enable(JOYSTICK | MICROPHONE | ACCELEROMETER);
+#if ORIENTATION_MODE
+  // A board calibrated before starts up calibrated
+  sensors->calibration_text =
+      ORIENT_load(&sensors->calibration) ? "ok" : "no";
+#endif
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   // Function to initialize the LCD using the TiwaWare peripheral driver library
   CF128x128x16_ST7735SInit(systemClock);
@@ -115,7 +817,9 @@ int main(void) {
   // limited (the clipping region). A drawing context must be initialized with
   // GrContextInit() before it can be used to perform drawing operations.
   // "TivaWare Graphics Library for C Series User's Guide (Rev. E)" p.15
-  GrContextInit(&sContext, &g_sCF128x128x16_ST7735S);
+  DASH_counterInit(&sCountingDisplay, &lcd_counter, &g_sCF128x128x16_ST7735S, 0,
+                   0, 0);
+  GrContextInit(&sContext, &sCountingDisplay);
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   // Set the font size for the drawing
   GrContextFontSet(&sContext, &g_sFontCm14);
@@ -133,164 +837,126 @@ int main(void) {
   GrFlush(&sContext);
 
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  // Set the sequence for sequence number 0, since it will only be utilized by
-  // the microphone and will not need to be reinitialized.
-  ADC_newSequence(ADC0_BASE, 0, ADC_CTL_CH8, MIC_SAMPLES);
-  while (1) {
-    samplesRead = 0;
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Microphone
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 0, ADC_CTL_CH8, MIC_SAMPLES, &samplesRead,
-               microphone_samples, 0);
-
-    calculate_average(MIC_SAMPLES, microphone_samples, &microphone_average);
-
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // I only want to update the values on the LCD if the change is big enough
-    // to indicate that the user has done some input to the sensors
-    if (abs_diff(microphone_average, microphone_previous) >= PRINT_THRESHOLD) {
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      // Enable printing
-      toPrintOrNotToPrint = 1;
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      // Enable printing to update the microphone values
-      microphone_update = 1;
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      // Update the previous value
-      microphone_previous = microphone_average;
-    }
-
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Joystick-X
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 1, ADC_CTL_CH9, JOY_SAMPLES, &samplesRead,
-               joystick_x_samples, 1);
-    calculate_average(JOY_SAMPLES, joystick_x_samples, &joystick_x_average);
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    if (abs_diff(joystick_x_average, joystick_x_previous) >= PRINT_THRESHOLD) {
-      toPrintOrNotToPrint = 1;
-      joystick_update = 1;
-      joystick_x_previous = joystick_x_average;
-    }
-
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Joystick-Y
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 1, ADC_CTL_CH0, JOY_SAMPLES, &samplesRead,
-               joystick_y_samples, 1);
-    calculate_average(JOY_SAMPLES, joystick_y_samples, &joystick_y_average);
-    if (abs_diff(joystick_y_average, joystick_y_previous) >= PRINT_THRESHOLD) {
-      toPrintOrNotToPrint = 1;
-      joystick_update = 1;
-      joystick_y_previous = joystick_y_average;
-    }
+  // One dashboard field per line of text on the LCD. The characters of the
+  // lines are rasterised once here, after that the text is sent from the
+  // cache and the font is not decoded again.
+  DASH_init(&sensors->dashboard, &sContext);
+  DASH_glyphsInit(&sensors->glyphs, &sContext, LCD_CHARACTERS);
+  DASH_useGlyphs(&sensors->dashboard, &sensors->glyphs);
+#if SPECTRUM_MODE
+  sensors->microphone_field = DASH_addField(&sensors->dashboard, 1, 1);
+  // The bars take up the rest of the LCD below the mic line
+  SPECTRUM_init(&sensors->spectrum, &sContext, 0, 20, 128, 108,
+                SPECTRUM_BARS);
+#else
+  sensors->microphone_field = DASH_addField(&sensors->dashboard, 1, 20);
+  sensors->joystick_field = DASH_addField(&sensors->dashboard, 1, 40);
+  sensors->accelerometer_x_field = DASH_addField(&sensors->dashboard, 1, 60);
+  sensors->accelerometer_y_field = DASH_addField(&sensors->dashboard, 1, 80);
+  sensors->accelerometer_z_field = DASH_addField(&sensors->dashboard, 1, 100);
+#endif
 
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Accelerometer-X
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 2, ADC_CTL_CH3, ACC_SAMPLES, &samplesRead,
-               accelerometer_x_samples, 1);
-    calculate_average(ACC_SAMPLES, accelerometer_x_samples,
-                      &accelerometer_x_average);
-    if (abs_diff(accelerometer_x_average, accelerometer_x_previous) >=
-        PRINT_THRESHOLD) {
-      toPrintOrNotToPrint = 1;
-      accelerometer_update = 1;
-      accelerometer_x_previous = accelerometer_x_average;
-    }
+#if TELEMETRY_MODE
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // ConfigureUART() clocks UART0 from the 16 MHz PIOSC, only the baud rate
+  // is changed here before the console takes over the interrupt
+  ConfigureUART();
+  UARTConfigSetExpClk(UART0_BASE, CLOCK_PIOSC, TELEMETRY_BAUD,
+                      UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+                          UART_CONFIG_PAR_NONE);
+  CONSOLE_init(UART0_BASE);
+  TELEM_init(&sensors->telemetry);
+#endif
+#if defined(PROFILE) && !TELEMETRY_MODE
+  // The profile tables need the console even without the telemetry
+  ConfigureUART();
+  CONSOLE_init(UART0_BASE);
+#endif
 
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Accelerometer-Y
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 2, ADC_CTL_CH2, ACC_SAMPLES, &samplesRead,
-               accelerometer_y_samples, 1);
-    calculate_average(ACC_SAMPLES, accelerometer_y_samples,
-                      &accelerometer_y_average);
-    if (abs_diff(accelerometer_y_average, accelerometer_y_previous) >=
-        PRINT_THRESHOLD) {
-      toPrintOrNotToPrint = 1;
-      accelerometer_update = 1;
-      accelerometer_y_previous = accelerometer_y_average;
-    }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The averages are moving averages over the sample stream, each new sample
+  // only updates a running sum
+  FILTER_movingAverageInit(&sensors->microphone_filter,
+                           sensors->microphone_window, MIC_AVERAGE_LOG2);
+  FILTER_movingAverageInit(&sensors->joystick_x_filter,
+                           sensors->joystick_x_window, JOY_AVERAGE_LOG2);
+  FILTER_movingAverageInit(&sensors->joystick_y_filter,
+                           sensors->joystick_y_window, JOY_AVERAGE_LOG2);
+  FILTER_medianInit(&sensors->joystick_x_median,
+                    sensors->joystick_x_median_window, JOY_MEDIAN_LENGTH);
+  FILTER_medianInit(&sensors->joystick_y_median,
+                    sensors->joystick_y_median_window, JOY_MEDIAN_LENGTH);
+  JOY_axisInit(&sensors->joystick_x, &g_sJoystickXConfig);
+  JOY_axisInit(&sensors->joystick_y, &g_sJoystickYConfig);
+  FILTER_movingAverageInit(&sensors->accelerometer_x_filter,
+                           sensors->accelerometer_x_window, ACC_AVERAGE_LOG2);
+  FILTER_movingAverageInit(&sensors->accelerometer_y_filter,
+                           sensors->accelerometer_y_window, ACC_AVERAGE_LOG2);
+  FILTER_movingAverageInit(&sensors->accelerometer_z_filter,
+                           sensors->accelerometer_z_window, ACC_AVERAGE_LOG2);
+#if SOUND_METER_MODE
+  // sensors->meter.cycles_per_sample_max and budget_overruns tell how the
+  // meter keeps up with the budget
+  METER_init(&sensors->meter, true, METER_RMS_WINDOW, METER_PEAK_WINDOW,
+             systemClock / SCAN_RATE / METER_BUDGET_SHARE);
+#endif
 
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // Accelerometer-Z
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    sampleData(ADC0_BASE, 2, ADC_CTL_CH1, ACC_SAMPLES, &samplesRead,
-               accelerometer_z_samples, 1);
-    calculate_average(ACC_SAMPLES, accelerometer_z_samples,
-                      &accelerometer_z_average);
-    if (abs_diff(accelerometer_z_average, accelerometer_z_previous) >=
-        PRINT_THRESHOLD) {
-      toPrintOrNotToPrint = 1;
-      accelerometer_update = 1;
-      accelerometer_z_previous = accelerometer_z_average;
-    }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The offsets keep the joystick, accelerometer and LCD tasks off the same
+  // tick. g_sScheduler.task[] holds the deadline misses and the cycle counts
+  // of every task.
+  SCHED_init(&g_sScheduler);
+  SCHED_addTask(&g_sScheduler, "acquisition", acquisitionTask, sensors,
+                ACQUISITION_PERIOD, 0);
+  SCHED_addTask(&g_sScheduler, "joystick", joystickTask, sensors,
+                JOYSTICK_PERIOD, 1);
+  SCHED_addTask(&g_sScheduler, "accelerometer", accelerometerTask, sensors,
+                ACCELEROMETER_PERIOD, 2);
+  SCHED_addTask(&g_sScheduler, "lcd", lcdTask, sensors, LCD_PERIOD, 3);
+#if SPECTRUM_MODE
+  SCHED_addTask(&g_sScheduler, "fft", fftTask, sensors, FFT_PERIOD, 0);
+#endif
+#ifdef PROFILE
+  SCHED_addTask(&g_sScheduler, "console", consoleTask, sensors,
+                CONSOLE_PERIOD, 4);
+#endif
 
-    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    // If the values has changed indicating user input, I update the LCD on
-    // screen values
-    if (toPrintOrNotToPrint == 1) {
-
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      if (microphone_update == 1) {
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        // Convert the microphone value to dB
-        microphone_average_to_db = round(20.0 * log10(microphone_average));
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        // sprintf(buf, max, "%s\n"%s)  is used to place the average value
-        // in a string in order to be able to write it on the LCD
-        snprintf(microphone, sizeof(microphone), "Mic: %u dB",
-                 microphone_average_to_db);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        // GrDefaultStringRenderer is the function used to draw the string on
-        // the LCD, where I can specify the position of the text and the opacity
-        // of the text
-        GrDefaultStringRenderer(&sContext, microphone, strlen(microphone), 1,
-                                20, OPAQUE_TEXT);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        microphone_update = 0;
-      }
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      if (joystick_update == 1) {
-        snprintf(joystick, sizeof(joystick), "Joy: %u-X, %u-Y",
-                 joystick_x_average, joystick_y_average);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        clear_text(&sContext, 1, 40, 128, 14);
-        GrDefaultStringRenderer(&sContext, joystick, strlen(joystick), 1, 40,
-                                OPAQUE_TEXT);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        joystick_update = 0;
-      }
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      if (accelerometer_update == 1) {
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        // To write all axis on the screen in one line, the font size has to be
-        // really small which I did not like
-        snprintf(accelerometer_x, sizeof(accelerometer_x), "Acc: %u-X",
-                 accelerometer_x_average);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        snprintf(accelerometer_y, sizeof(accelerometer_y), "Acc: %u-Y",
-                 accelerometer_y_average);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        snprintf(accelerometer_z, sizeof(accelerometer_z), "Acc: %u-Z",
-                 accelerometer_z_average);
-
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        GrDefaultStringRenderer(&sContext, accelerometer_x,
-                                strlen(accelerometer_x), 1, 60, OPAQUE_TEXT);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        GrDefaultStringRenderer(&sContext, accelerometer_y,
-                                strlen(accelerometer_y), 1, 80, OPAQUE_TEXT);
-        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        GrDefaultStringRenderer(&sContext, accelerometer_z,
-                                strlen(accelerometer_z), 1, 100, OPAQUE_TEXT);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Sequence number 0 is programmed once with a step for every sensor, so it
+  // never has to be reconfigured. Timer 0 triggers it at SCAN_RATE and the
+  // uDMA moves the samples, so the CPU never has to wait for the ADC. The
+  // interrupt queues every block, scan_queue.high_water tells how far
+  // behind the tasks have been.
+  IDLE_init(&sensors->idle, systemClock, IDLE_WINDOW_MS);
+#if ORIENTATION_MODE
+  // The button events are stamped with the idle clock, which keeps counting
+  // while the core sleeps
+  BTN_init(&g_sCalibrationButton, 1, systemClock, IDLE_now);
+#endif
+  QUEUE_init(&sensors->scan_queue, sensors->scan_frames, sizeof(tScanFrame),
+             SCAN_QUEUE_LOG2);
+  ADC_pingpongInit(&sensors->scan_acquisition, ADC0_BASE, 0,
+                   sensors->scan_ping, sensors->scan_pong,
+                   SCAN_FRAMES * SCAN_CHANNELS);
+  ADC_pingpongSetHandler(&sensors->scan_acquisition, scanBlockHandler,
+                         sensors);
+  ADC_pingpongSteps(&sensors->scan_acquisition, scan_steps, SCAN_CHANNELS);
+  ADC_averageHardware(ADC0_BASE, SCAN_OVERSAMPLE);
+  ADC_pingpongStart(&sensors->scan_acquisition, systemClock, SCAN_RATE);
+  SCHED_start(systemClock, SCHED_TICK_RATE);
+  IntMasterEnable();
+  while (1) {
+#if SLEEP_MODE
+    if (!SCHED_runOnce(&g_sScheduler)) {
+      IDLE_sleep(&sensors->idle, tasksPending, &g_sScheduler);
+      // Once a window, the clock is picked for the load measured in it
+      if (sensors->idle.windows != windows) {
+        windows = sensors->idle.windows;
+        CLOCK_govern(&clock, sensors->idle.active_percent);
       }
-      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      // Redraw the LCD screen
-      GrFlush(&sContext);
-      toPrintOrNotToPrint = 0;
     }
+#else
+    SCHED_runOnce(&g_sScheduler);
+#endif
   }
 }
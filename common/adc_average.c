@@ -0,0 +1,178 @@
+/*
+ * ================================================================
+ * File: adc_average.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Averaged ADC readings with a software, hardware or combined
+ * backend.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "adc_average.h"
+#include "adc_scan.h"
+#include "cycles.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/adc.h"
+
+//=============================================================================
+void ADC_averageHardware(uint32_t adc_base, uint32_t factor) {
+  ADCHardwareOversampleConfigure(adc_base, factor);
+}
+
+//=============================================================================
+// The same channel in every step, the scan sequence sets it up for the
+// processor trigger
+static void ADC_averageSequence(const tADCAverage *average, uint32_t channel,
+                                uint32_t trigger) {
+  uint32_t channels[ADC_AVERAGE_STEPS_MAX];
+  uint32_t steps = 1u << average->software_log2;
+  uint32_t i;
+
+  for (i = 0; i < steps; i++) {
+    channels[i] = channel;
+  }
+  ADC_scanSequence(average->adc_base, average->sequence, channels, steps);
+  if (trigger != ADC_TRIGGER_PROCESSOR) {
+    ADCSequenceDisable(average->adc_base, average->sequence);
+    ADCSequenceConfigure(average->adc_base, average->sequence, trigger, 0);
+    ADCSequenceEnable(average->adc_base, average->sequence);
+  }
+}
+
+// One trigger, one (possibly hardware averaged) sample per step
+static uint32_t ADC_averageTrigger(tADCAverage *average, uint32_t *frame) {
+  return ADC_scanFrame(average->adc_base, average->sequence, frame);
+}
+
+static uint32_t ADC_averageFifo(tADCAverage *average, uint32_t *frame) {
+  return ADCSequenceDataGet(average->adc_base, average->sequence, frame);
+}
+
+#else
+//=============================================================================
+// Host stand-in for the ADC, the hardware averaging included. The hardware
+// truncates the sum.
+static tADCAverageSource g_pfnSource;
+static void *g_pvSourceArgument;
+static uint32_t g_ui32HardwareFactor = 1;
+
+void ADC_averageHostSource(tADCAverageSource source, void *argument) {
+  g_pfnSource = source;
+  g_pvSourceArgument = argument;
+}
+
+void ADC_averageHardware(uint32_t adc_base, uint32_t factor) {
+  g_ui32HardwareFactor = factor < 2 ? 1 : factor;
+}
+
+static void ADC_averageSequence(const tADCAverage *average, uint32_t channel,
+                                uint32_t trigger) {}
+
+// A trigger and a completed sequence are the same to the simulated ADC
+static uint32_t ADC_averageFifo(tADCAverage *average, uint32_t *frame) {
+  uint32_t steps = 1u << average->software_log2;
+  uint32_t sum;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0; i < steps; i++) {
+    sum = 0;
+    for (j = 0; j < g_ui32HardwareFactor; j++) {
+      sum += g_pfnSource(g_pvSourceArgument);
+    }
+    frame[i] = sum / g_ui32HardwareFactor;
+  }
+  return steps;
+}
+
+static uint32_t ADC_averageTrigger(tADCAverage *average, uint32_t *frame) {
+  return ADC_averageFifo(average, frame);
+}
+#endif
+
+//=============================================================================
+// log2 of the steps a sequencer holds
+static uint32_t ADC_averageDepthLog2(uint32_t sequence) {
+  return sequence == 0 ? 3 : sequence == 3 ? 0 : 2;
+}
+
+void ADC_averageInit(tADCAverage *average, uint32_t adc_base,
+                     uint32_t sequence, uint32_t channel, uint32_t trigger,
+                     tADCAverageBackend backend, uint32_t hardware_factor,
+                     uint32_t software_log2) {
+  average->adc_base = adc_base;
+  average->sequence = sequence;
+  average->backend = backend;
+  average->hardware_factor =
+      backend == ADC_AVERAGE_SOFTWARE ? 1 : hardware_factor;
+  average->software_log2 = backend == ADC_AVERAGE_HARDWARE ? 0 : software_log2;
+  if (average->software_log2 > ADC_averageDepthLog2(sequence)) {
+    average->software_log2 = ADC_averageDepthLog2(sequence);
+  }
+  average->values = 0;
+  average->cycles_last = 0;
+  average->cycles_max = 0;
+  average->cycles_total = 0;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  ADC_averageSequence(average, channel, trigger);
+  ADC_averageHardware(adc_base, average->hardware_factor);
+  CYCLES_init();
+}
+
+//=============================================================================
+// The steps of a frame averaged, rounded to nearest, for a single step this
+// is the sample itself. The cycles since start count for the value.
+static uint32_t ADC_averageFinish(tADCAverage *average, const uint32_t *frame,
+                                  uint32_t count, uint32_t start) {
+  uint32_t sum = 0;
+  uint32_t value;
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    sum += frame[i];
+  }
+  value = (sum + (count >> 1)) >> average->software_log2;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  average->cycles_last = CYCLES_now() - start;
+  average->cycles_total += average->cycles_last;
+  if (average->cycles_last > average->cycles_max) {
+    average->cycles_max = average->cycles_last;
+  }
+  average->values++;
+  return value;
+}
+
+//=============================================================================
+uint32_t ADC_averageRead(tADCAverage *average) {
+  uint32_t frame[ADC_AVERAGE_STEPS_MAX];
+  uint32_t start = CYCLES_now();
+  uint32_t count = ADC_averageTrigger(average, frame);
+
+  return ADC_averageFinish(average, frame, count, start);
+}
+
+//=============================================================================
+uint32_t ADC_averageTake(tADCAverage *average) {
+  uint32_t frame[ADC_AVERAGE_STEPS_MAX];
+  uint32_t start = CYCLES_now();
+  uint32_t count = ADC_averageFifo(average, frame);
+
+  return ADC_averageFinish(average, frame, count, start);
+}
+
+//=============================================================================
+uint32_t ADC_averageCyclesPerValue(const tADCAverage *average) {
+  if (average->values == 0) {
+    return 0;
+  }
+  return (uint32_t)(average->cycles_total / average->values);
+}
@@ -0,0 +1,94 @@
+/*
+ * ================================================================
+ * File: adc_average.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Averaged single channel ADC readings with a selectable
+ * backend:
+ *  - software, the sequencer converts the channel 2^software_log2 times on
+ *    every trigger and the CPU sums the conversions
+ *  - hardware, the ADC averages hardware_factor (2 to 64) conversions by
+ *    itself and delivers one sample per trigger
+ *  - both, the CPU averages 2^software_log2 hardware averaged samples
+ * The sequencer can be started by the processor, ADC_averageRead() then
+ * triggers it and waits, or by a timer, and the interrupt of the sequence
+ * takes the value with ADC_averageTake(). Every value is timed with the cycle
+ * counter so the backends can be compared by the CPU cycles spent per
+ * delivered value.
+ *
+ * The software part is limited by the depth of the sequencer: 8 steps for
+ * sequencer 0, 4 for 1 and 2, and 1 for 3. Note that the hardware
+ * oversampling factor is a setting of the whole ADC module, it applies to
+ * every sequencer on that ADC.
+ *
+ * With HOST_BUILD defined the conversions come from a simulated ADC set with
+ * ADC_averageHostSource(), the hardware averaging included.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef ADC_AVERAGE_H_
+#define ADC_AVERAGE_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// Steps of the deepest sequencer, sequencer 0
+#define ADC_AVERAGE_STEPS_MAX 8
+
+//=============================================================================
+typedef enum {
+  ADC_AVERAGE_SOFTWARE,
+  ADC_AVERAGE_HARDWARE,
+  ADC_AVERAGE_BOTH
+} tADCAverageBackend;
+
+typedef struct {
+  uint32_t adc_base;
+  uint32_t sequence;
+  tADCAverageBackend backend;
+  // 1 when the hardware does not average
+  uint32_t hardware_factor;
+  // 0 when the software does not average
+  uint32_t software_log2;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint32_t values;
+  uint32_t cycles_last;
+  uint32_t cycles_max;
+  uint64_t cycles_total;
+} tADCAverage;
+
+//=============================================================================
+// Program the sequencer to convert channel 2^software_log2 times on every
+// trigger, the last step raising its interrupt, and set the hardware
+// oversampling of the ADC. The factor is ignored by the software backend and
+// software_log2 by the hardware backend, software_log2 is cut to what the
+// sequencer holds. trigger is one of the ADC_TRIGGER values of driverlib.
+void ADC_averageInit(tADCAverage *average, uint32_t adc_base,
+                     uint32_t sequence, uint32_t channel, uint32_t trigger,
+                     tADCAverageBackend backend, uint32_t hardware_factor,
+                     uint32_t software_log2);
+
+// Trigger the sequence, wait for it and return the averaged value, rounded
+// to nearest in the software part. Only for ADC_TRIGGER_PROCESSOR.
+uint32_t ADC_averageRead(tADCAverage *average);
+
+// The averaged value of a sequence that has completed, for its interrupt
+// when another trigger starts it
+uint32_t ADC_averageTake(tADCAverage *average);
+
+// Mean CPU cycles spent per value returned so far
+uint32_t ADC_averageCyclesPerValue(const tADCAverage *average);
+
+// Set the hardware oversampling of an ADC module, factor 1 turns it off
+void ADC_averageHardware(uint32_t adc_base, uint32_t factor);
+
+#ifdef HOST_BUILD
+// The simulated ADC, called once for every conversion
+typedef uint32_t (*tADCAverageSource)(void *argument);
+
+void ADC_averageHostSource(tADCAverageSource source, void *argument);
+#endif
+
+#endif // ADC_AVERAGE_H_
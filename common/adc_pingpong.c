@@ -0,0 +1,232 @@
+/*
+ * ================================================================
+ * File: adc_pingpong.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: uDMA ping-pong acquisition for the ADC0 sample sequencers.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "adc_pingpong.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/adc.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+//=============================================================================
+#include "inc/hw_adc.h"
+#include "inc/hw_memmap.h"
+
+//=============================================================================
+// The uDMA control table has to be aligned to 1024 bytes
+#if defined(ccs)
+#pragma DATA_ALIGN(g_psDMAControlTable, 1024)
+static tDMAControlTable g_psDMAControlTable[64];
+#else
+static tDMAControlTable g_psDMAControlTable[64] __attribute__((aligned(1024)));
+#endif
+
+// uDMA channel assignment for each sequencer on ADC0
+static const uint32_t g_pui32DMAChannel[4] = {
+    UDMA_CH14_ADC0_0, UDMA_CH15_ADC0_1, UDMA_CH16_ADC0_2, UDMA_CH17_ADC0_3};
+#endif
+
+//=============================================================================
+// One active acquisition per sequencer, looked up by the interrupt handlers
+static tADCPingPong *g_psPingPong[4];
+
+//=============================================================================
+void ADC_pingpongInit(tADCPingPong *pp, uint32_t adc_base, uint32_t sequence,
+                      uint32_t *ping, uint32_t *pong, uint32_t block_size) {
+  memset(pp, 0, sizeof(*pp));
+  pp->adc_base = adc_base;
+  pp->sequence = sequence;
+  pp->buffer[ADC_PING] = ping;
+  pp->buffer[ADC_PONG] = pong;
+  pp->block_size = block_size;
+  pp->dma_half = ADC_PING;
+  pp->read_half = ADC_PING;
+  g_psPingPong[sequence & 3] = pp;
+}
+
+//=============================================================================
+void ADC_pingpongBlockDone(tADCPingPong *pp, uint32_t half) {
+  if (pp->handler != 0) {
+    pp->handler(pp->buffer[half], pp->blocks_completed++,
+                pp->handler_argument);
+    pp->dma_half = half ^ 1;
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // If the consumer still has not released this half, the uDMA has just
+  // overwritten data that was never read.
+  if (pp->ready[half]) {
+    pp->overruns++;
+  }
+  pp->ready[half] = 1;
+  pp->block_index[half] = pp->blocks_completed++;
+  pp->dma_half = half ^ 1;
+}
+
+//=============================================================================
+uint32_t *ADC_pingpongGetBlock(tADCPingPong *pp) {
+  if (!pp->ready[pp->read_half]) {
+    return 0;
+  }
+  return pp->buffer[pp->read_half];
+}
+
+//=============================================================================
+void ADC_pingpongRelease(tADCPingPong *pp) {
+  pp->ready[pp->read_half] = 0;
+  pp->read_half ^= 1;
+}
+
+//=============================================================================
+void ADC_pingpongSetHandler(tADCPingPong *pp, tADCPingPongHandler handler,
+                            void *argument) {
+  pp->handler = handler;
+  pp->handler_argument = argument;
+}
+
+#ifndef HOST_BUILD
+//=============================================================================
+static void ADC_pingpongArm(tADCPingPong *pp, uint32_t half) {
+  uint32_t fifo = pp->adc_base + ADC_O_SSFIFO0 +
+                  pp->sequence * (ADC_O_SSFIFO1 - ADC_O_SSFIFO0);
+  uDMAChannelTransferSet((g_pui32DMAChannel[pp->sequence] & 0xff) |
+                             (half == ADC_PING ? UDMA_PRI_SELECT
+                                               : UDMA_ALT_SELECT),
+                         UDMA_MODE_PINGPONG, (void *)fifo, pp->buffer[half],
+                         pp->block_size);
+}
+
+//=============================================================================
+// Both halves can have finished if the interrupt was held off for a long
+// time, so keep re-arming until the half the uDMA is on is still running.
+static void ADC_pingpongIntHandler(uint32_t sequence) {
+  tADCPingPong *pp = g_psPingPong[sequence];
+  uint32_t channel = g_pui32DMAChannel[sequence] & 0xff;
+  uint32_t select;
+  uint32_t i;
+
+  ADCIntClearEx(pp->adc_base, ADC_INT_DMA_SS0 << sequence);
+  for (i = 0; i < 2; i++) {
+    select = pp->dma_half == ADC_PING ? UDMA_PRI_SELECT : UDMA_ALT_SELECT;
+    if (uDMAChannelModeGet(channel | select) != UDMA_MODE_STOP) {
+      break;
+    }
+    ADC_pingpongArm(pp, pp->dma_half);
+    ADC_pingpongBlockDone(pp, pp->dma_half);
+  }
+}
+
+static void ADC_pingpongSS0Handler(void) { ADC_pingpongIntHandler(0); }
+static void ADC_pingpongSS1Handler(void) { ADC_pingpongIntHandler(1); }
+static void ADC_pingpongSS2Handler(void) { ADC_pingpongIntHandler(2); }
+static void ADC_pingpongSS3Handler(void) { ADC_pingpongIntHandler(3); }
+
+static void (*const g_pfnHandler[4])(void) = {
+    ADC_pingpongSS0Handler, ADC_pingpongSS1Handler, ADC_pingpongSS2Handler,
+    ADC_pingpongSS3Handler};
+
+//=============================================================================
+void ADC_pingpongSteps(tADCPingPong *pp, const uint32_t *steps,
+                       uint32_t step_count) {
+  uint32_t i;
+
+  ADCSequenceDisable(pp->adc_base, pp->sequence);
+  ADCSequenceConfigure(pp->adc_base, pp->sequence, ADC_TRIGGER_TIMER, 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Every step raises IE, since with the uDMA enabled that is what requests
+  // the transfer of the sample out of the FIFO.
+  for (i = 0; i < step_count; i++) {
+    ADCSequenceStepConfigure(pp->adc_base, pp->sequence, i,
+                             steps[i] | ADC_CTL_IE |
+                                 (i == step_count - 1 ? ADC_CTL_END : 0));
+  }
+}
+
+//=============================================================================
+void ADC_pingpongStart(tADCPingPong *pp, uint32_t system_clock,
+                       uint32_t sample_rate) {
+  static bool udma_enabled = false;
+  uint32_t channel = g_pui32DMAChannel[pp->sequence] & 0xff;
+
+  if (!udma_enabled) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA)) {
+    }
+    uDMAEnable();
+    uDMAControlBaseSet(g_psDMAControlTable);
+    udma_enabled = true;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Move 32-bit words from the FIFO register into the buffers, one sample
+  // per request.
+  uDMAChannelAssign(g_pui32DMAChannel[pp->sequence]);
+  uDMAChannelAttributeDisable(channel, UDMA_ATTR_ALL);
+  uDMAChannelControlSet(channel | UDMA_PRI_SELECT,
+                        UDMA_SIZE_32 | UDMA_SRC_INC_NONE | UDMA_DST_INC_32 |
+                            UDMA_ARB_1);
+  uDMAChannelControlSet(channel | UDMA_ALT_SELECT,
+                        UDMA_SIZE_32 | UDMA_SRC_INC_NONE | UDMA_DST_INC_32 |
+                            UDMA_ARB_1);
+  ADC_pingpongArm(pp, ADC_PING);
+  ADC_pingpongArm(pp, ADC_PONG);
+  uDMAChannelEnable(channel);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  ADCSequenceDMAEnable(pp->adc_base, pp->sequence);
+  ADCIntRegister(pp->adc_base, pp->sequence, g_pfnHandler[pp->sequence]);
+  ADCIntEnableEx(pp->adc_base, ADC_INT_DMA_SS0 << pp->sequence);
+  ADCSequenceEnable(pp->adc_base, pp->sequence);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Timer 0A is the trigger, it starts one sequence each time it times out
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0)) {
+  }
+  TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+  // A new load from a clock switch starts after the interval that runs
+  TimerUpdateMode(TIMER0_BASE, TIMER_A, TIMER_UP_LOAD_TIMEOUT);
+  TimerLoadSet(TIMER0_BASE, TIMER_A, system_clock / sample_rate - 1);
+  TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+  TimerADCEventSet(TIMER0_BASE, TIMER_ADC_TIMEOUT_A);
+  TimerEnable(TIMER0_BASE, TIMER_A);
+}
+
+//=============================================================================
+void ADC_pingpongStop(tADCPingPong *pp) {
+  TimerDisable(TIMER0_BASE, TIMER_A);
+  ADCSequenceDisable(pp->adc_base, pp->sequence);
+  ADCSequenceDMADisable(pp->adc_base, pp->sequence);
+}
+
+#else
+//=============================================================================
+// Host stand-in, the steps and the trigger timer do not exist here
+void ADC_pingpongSteps(tADCPingPong *pp, const uint32_t *steps,
+                       uint32_t step_count) {}
+
+void ADC_pingpongStart(tADCPingPong *pp, uint32_t system_clock,
+                       uint32_t sample_rate) {}
+
+void ADC_pingpongStop(tADCPingPong *pp) {}
+
+//=============================================================================
+void ADC_pingpongHostFill(tADCPingPong *pp, const uint32_t *samples) {
+  uint32_t half = pp->dma_half;
+  memcpy(pp->buffer[half], samples, pp->block_size * sizeof(uint32_t));
+  ADC_pingpongBlockDone(pp, half);
+}
+#endif
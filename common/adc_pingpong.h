@@ -0,0 +1,108 @@
+/*
+ * ================================================================
+ * File: adc_pingpong.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Timer triggered ADC acquisition where the uDMA fills two
+ * buffers (ping and pong) in turn. While the uDMA writes one buffer the CPU
+ * can process the other one, so no cycles are spent polling the ADC status.
+ *
+ * Two halves only cover the time it takes to fill one of them. A block
+ * handler can instead take every block in the interrupt as soon as it is
+ * complete, for example to push it into a sample queue that holds many
+ * blocks, and the half is free again as soon as the handler returns.
+ *
+ * Building with HOST_BUILD defined replaces the ADC/uDMA registers with a
+ * stand-in, ADC_pingpongHostFill(), which plays the role of the uDMA engine.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef ADC_PINGPONG_H_
+#define ADC_PINGPONG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Index of the two halves of a ping-pong pair
+#define ADC_PING 0
+#define ADC_PONG 1
+
+//=============================================================================
+// Called from the interrupt with a complete block and its running number
+typedef void (*tADCPingPongHandler)(const uint32_t *block, uint32_t index,
+                                    void *argument);
+
+//=============================================================================
+// One acquisition channel. Only sequencers on ADC0 are supported since that
+// is the only converter used with the BoosterPack MKII.
+typedef struct {
+  uint32_t adc_base;
+  uint32_t sequence;
+  uint32_t *buffer[2];
+  uint32_t block_size;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Set by the interrupt handler and cleared by the consumer. One flag per
+  // half so that neither side needs a read-modify-write.
+  volatile uint8_t ready[2];
+  volatile uint32_t dma_half;
+  volatile uint32_t blocks_completed;
+  volatile uint32_t overruns;
+  // Running number of the block held by each half
+  volatile uint32_t block_index[2];
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The half the consumer reads next
+  uint32_t read_half;
+  // Takes the blocks instead of the consumer when it is set
+  tADCPingPongHandler handler;
+  void *handler_argument;
+} tADCPingPong;
+
+//=============================================================================
+// Prepare the acquisition. ping and pong must each hold block_size samples.
+void ADC_pingpongInit(tADCPingPong *pp, uint32_t adc_base, uint32_t sequence,
+                      uint32_t *ping, uint32_t *pong, uint32_t block_size);
+
+// Program the sequencer so that every timer trigger converts the channels in
+// the step list, in order. The last step gets ADC_CTL_END added.
+void ADC_pingpongSteps(tADCPingPong *pp, const uint32_t *steps,
+                       uint32_t step_count);
+
+// Start the timer that triggers the sequencer sample_rate times per second
+// and arm both halves of the uDMA transfer.
+void ADC_pingpongStart(tADCPingPong *pp, uint32_t system_clock,
+                       uint32_t sample_rate);
+
+void ADC_pingpongStop(tADCPingPong *pp);
+
+// Returns the oldest completely filled buffer, or 0 when none is ready yet.
+// The buffer belongs to the caller until ADC_pingpongRelease() is called.
+uint32_t *ADC_pingpongGetBlock(tADCPingPong *pp);
+
+void ADC_pingpongRelease(tADCPingPong *pp);
+
+// Hand every block to handler in the interrupt instead. The blocks are then
+// never ready for ADC_pingpongGetBlock() and never overrun. Set it before
+// ADC_pingpongStart().
+void ADC_pingpongSetHandler(tADCPingPong *pp, tADCPingPongHandler handler,
+                            void *argument);
+
+// Running number of the block returned by ADC_pingpongGetBlock(), counting
+// from 0 for the first block after start. Gaps mean blocks were overwritten.
+static inline uint32_t ADC_pingpongBlockIndex(const tADCPingPong *pp) {
+  return pp->block_index[pp->read_half];
+}
+
+// Called when the uDMA has finished writing one half. Used by the interrupt
+// handler and by the host stand-in.
+void ADC_pingpongBlockDone(tADCPingPong *pp, uint32_t half);
+
+#ifdef HOST_BUILD
+// Copy block_size samples into the half the uDMA would be writing and signal
+// completion, exactly as the interrupt handler does on target.
+void ADC_pingpongHostFill(tADCPingPong *pp, const uint32_t *samples);
+#endif
+
+#endif // ADC_PINGPONG_H_
@@ -0,0 +1,49 @@
+/*
+ * ================================================================
+ * File: adc_scan.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Multi-channel scan sequences for the ADC sample sequencers.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "adc_scan.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/adc.h"
+
+//=============================================================================
+void ADC_scanSequence(uint32_t adc_base, uint32_t sequence,
+                      const uint32_t *channels, uint32_t channel_count) {
+  uint32_t i;
+
+  ADCSequenceDisable(adc_base, sequence);
+  ADCSequenceConfigure(adc_base, sequence, ADC_TRIGGER_PROCESSOR, 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only the last step ends the sequence and raises the interrupt flag
+  for (i = 0; i < channel_count; i++) {
+    ADCSequenceStepConfigure(
+        adc_base, sequence, i,
+        channels[i] | (i == channel_count - 1 ? ADC_CTL_IE | ADC_CTL_END : 0));
+  }
+  ADCSequenceEnable(adc_base, sequence);
+  ADCIntClear(adc_base, sequence);
+}
+
+//=============================================================================
+uint32_t ADC_scanFrame(uint32_t adc_base, uint32_t sequence, uint32_t *frame) {
+  ADCProcessorTrigger(adc_base, sequence);
+  while (!ADCIntStatus(adc_base, sequence, false)) {
+  }
+  ADCIntClear(adc_base, sequence);
+  return ADCSequenceDataGet(adc_base, sequence, frame);
+}
+#endif
@@ -0,0 +1,31 @@
+/*
+ * ================================================================
+ * File: adc_scan.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Multi-channel scan sequences. One sequencer is programmed with
+ * an interleaved step list so that a single trigger captures one sample of
+ * every channel (a frame), instead of reconfiguring the sequencer for each
+ * channel.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef ADC_SCAN_H_
+#define ADC_SCAN_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// Variant of ADC_newSequence() taking a list of channels. Every step converts
+// the next channel in the list and the whole list is captured by one
+// processor trigger.
+void ADC_scanSequence(uint32_t adc_base, uint32_t sequence,
+                      const uint32_t *channels, uint32_t channel_count);
+
+// Trigger the sequence once and read back one frame, frame[i] holding the
+// sample of channels[i]. Returns the number of samples read.
+uint32_t ADC_scanFrame(uint32_t adc_base, uint32_t sequence, uint32_t *frame);
+
+#endif // ADC_SCAN_H_
@@ -0,0 +1,178 @@
+/*
+ * ================================================================
+ * File: brightness.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Gamma corrected LED brightness on a PWM pin.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "brightness.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/gpio.h"
+#include "driverlib/pwm.h"
+#endif
+
+//=============================================================================
+// (i / 256)^2.2 in Q16 for i = 0..256, the levels in between are
+// interpolated. Generated with
+//   [round(65535 * (i / 256) ** 2.2) for i in range(257)]
+#define BRIGHT_GAMMA_SHIFT 2
+static const uint16_t g_pui16Gamma[257] = {
+    0, 0, 2, 4, 7, 11, 17, 24,
+    32, 41, 52, 64, 78, 93, 110, 128,
+    147, 168, 191, 215, 240, 267, 296, 327,
+    359, 392, 428, 465, 504, 544, 586, 630,
+    676, 723, 772, 823, 875, 930, 986, 1044,
+    1104, 1165, 1229, 1294, 1361, 1430, 1501, 1574,
+    1648, 1725, 1803, 1884, 1966, 2050, 2136, 2224,
+    2314, 2406, 2500, 2595, 2693, 2793, 2895, 2998,
+    3104, 3212, 3322, 3433, 3547, 3663, 3781, 3900,
+    4022, 4146, 4272, 4400, 4530, 4663, 4797, 4933,
+    5072, 5212, 5355, 5499, 5646, 5795, 5946, 6099,
+    6255, 6412, 6572, 6733, 6897, 7063, 7231, 7402,
+    7574, 7749, 7926, 8105, 8286, 8469, 8655, 8843,
+    9033, 9225, 9419, 9616, 9815, 10016, 10219, 10425,
+    10632, 10842, 11054, 11269, 11486, 11705, 11926, 12149,
+    12375, 12603, 12833, 13066, 13301, 13538, 13777, 14019,
+    14263, 14509, 14758, 15009, 15262, 15517, 15775, 16035,
+    16298, 16563, 16830, 17099, 17371, 17645, 17922, 18201,
+    18482, 18765, 19051, 19339, 19630, 19923, 20218, 20516,
+    20816, 21119, 21424, 21731, 22040, 22352, 22667, 22984,
+    23303, 23624, 23949, 24275, 24604, 24935, 25269, 25605,
+    25943, 26284, 26628, 26973, 27322, 27672, 28026, 28381,
+    28739, 29100, 29462, 29828, 30196, 30566, 30939, 31314,
+    31692, 32072, 32454, 32840, 33227, 33617, 34010, 34405,
+    34802, 35202, 35605, 36010, 36417, 36827, 37240, 37655,
+    38072, 38493, 38915, 39340, 39768, 40198, 40631, 41066,
+    41503, 41944, 42387, 42832, 43280, 43730, 44183, 44639,
+    45097, 45557, 46020, 46486, 46954, 47425, 47899, 48374,
+    48853, 49334, 49818, 50304, 50793, 51284, 51778, 52275,
+    52774, 53276, 53780, 54287, 54796, 55308, 55823, 56341,
+    56860, 57383, 57908, 58436, 58966, 59499, 60035, 60573,
+    61114, 61657, 62203, 62752, 63303, 63857, 64414, 64973,
+    65535,
+};
+
+//=============================================================================
+uint32_t BRIGHT_gamma(uint32_t level) {
+  uint32_t index;
+  uint32_t fraction;
+  uint32_t low;
+
+  if (level >= BRIGHT_MAX) {
+    return 65535;
+  }
+  index = level >> BRIGHT_GAMMA_SHIFT;
+  fraction = level & ((1u << BRIGHT_GAMMA_SHIFT) - 1);
+  low = g_pui16Gamma[index];
+  return low + (((g_pui16Gamma[index + 1] - low) * fraction) >>
+                BRIGHT_GAMMA_SHIFT);
+}
+
+#ifndef HOST_BUILD
+//=============================================================================
+static void BRIGHT_enter(tBrightness *led, tBrightState state) {
+  if (state == BRIGHT_PWM) {
+    GPIOPinTypePWM(led->gpio_base, led->gpio_pin);
+  } else {
+    GPIOPinTypeGPIOOutput(led->gpio_base, led->gpio_pin);
+    GPIOPinWrite(led->gpio_base, led->gpio_pin,
+                 state == BRIGHT_ON ? led->gpio_pin : 0);
+  }
+}
+
+static void BRIGHT_width(tBrightness *led) {
+  PWMPulseWidthSet(led->pwm_base, led->pwm_out, led->width);
+}
+#else
+//=============================================================================
+// Host stand-ins, the state and the width are all there is to look at
+static void BRIGHT_enter(tBrightness *led, tBrightState state) {}
+
+static void BRIGHT_width(tBrightness *led) {}
+#endif
+
+//=============================================================================
+void BRIGHT_init(tBrightness *led, uint32_t pwm_base, uint32_t pwm_out,
+                 uint32_t gpio_base, uint8_t gpio_pin, uint32_t period) {
+  led->pwm_base = pwm_base;
+  led->pwm_out = pwm_out;
+  led->gpio_base = gpio_base;
+  led->gpio_pin = gpio_pin;
+  led->period = period;
+  led->state = BRIGHT_PWM;
+  led->level = 0;
+  led->width = 1;
+  led->remuxes = 0;
+  BRIGHT_width(led);
+}
+
+//=============================================================================
+// The pulse width has to stay between 1 and period - 1, at 0 or a full
+// period the counter resets and the output glitches
+static uint32_t BRIGHT_widthOf(const tBrightness *led, uint32_t level) {
+  uint32_t width =
+      (uint32_t)(((uint64_t)BRIGHT_gamma(level) * led->period) >> 16);
+
+  if (width < 1) {
+    width = 1;
+  } else if (width > led->period - 1) {
+    width = led->period - 1;
+  }
+  return width;
+}
+
+//=============================================================================
+void BRIGHT_set(tBrightness *led, uint32_t level) {
+  tBrightState state;
+  uint32_t width;
+
+  if (level > BRIGHT_MAX) {
+    level = BRIGHT_MAX;
+  }
+  led->level = level;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only the two ends need the GPIO
+  if (level == 0) {
+    state = BRIGHT_OFF;
+  } else if (level == BRIGHT_MAX) {
+    state = BRIGHT_ON;
+  } else {
+    state = BRIGHT_PWM;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (state == BRIGHT_PWM) {
+    width = BRIGHT_widthOf(led, level);
+    // The width is written before the pin goes back to the PWM, so the first
+    // period out of the pin already has the new duty cycle
+    if (width != led->width) {
+      led->width = width;
+      BRIGHT_width(led);
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (state != led->state) {
+    BRIGHT_enter(led, state);
+    led->state = state;
+    led->remuxes++;
+  }
+}
+
+//=============================================================================
+// The compare register is counted from the load, so the width is written
+// even when it comes out the same, and also while the pin is a GPIO
+void BRIGHT_setPeriod(tBrightness *led, uint32_t period) {
+  led->period = period;
+  led->width = BRIGHT_widthOf(led, led->level);
+  BRIGHT_width(led);
+}
@@ -0,0 +1,70 @@
+/*
+ * ================================================================
+ * File: brightness.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: LED brightness on a PWM pin. The level goes through a gamma
+ * curve (2.2) so that equal steps in level look like equal steps in
+ * brightness, the curve is a table so no pow() is needed at run time.
+ *
+ * At 0% and 100% the PWM can not produce a clean output, so there the pin is
+ * switched over to a GPIO that is driven low or high. The pin is only
+ * remuxed when the level crosses into or out of one of those ends, all other
+ * changes only write the new pulse width.
+ *
+ * With HOST_BUILD defined no registers are touched, the state and the pulse
+ * width can be inspected instead.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef BRIGHTNESS_H_
+#define BRIGHTNESS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Levels go from 0 (off) to BRIGHT_MAX (fully on), ten bits
+#define BRIGHT_MAX 1023
+
+// Level from a percentage, rounded to nearest
+#define BRIGHT_FROM_PERCENT(percent) (((percent) * BRIGHT_MAX + 50) / 100)
+
+//=============================================================================
+typedef enum { BRIGHT_OFF, BRIGHT_PWM, BRIGHT_ON } tBrightState;
+
+typedef struct {
+  uint32_t pwm_base;
+  uint32_t pwm_out;
+  uint32_t gpio_base;
+  uint8_t gpio_pin;
+  // PWM period in PWM clock ticks
+  uint32_t period;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tBrightState state;
+  uint32_t level;
+  uint32_t width;
+  // Number of times the pin has been remuxed
+  uint32_t remuxes;
+} tBrightness;
+
+//=============================================================================
+// The PWM generator has to be configured and enabled already, and the pin
+// muxed to the PWM output. The LED starts in the PWM state at pulse width
+// 1 until the first BRIGHT_set().
+void BRIGHT_init(tBrightness *led, uint32_t pwm_base, uint32_t pwm_out,
+                 uint32_t gpio_base, uint8_t gpio_pin, uint32_t period);
+
+// Set the level, 0 to BRIGHT_MAX. Larger values are treated as BRIGHT_MAX.
+void BRIGHT_set(tBrightness *led, uint32_t level);
+
+// The PWM period changed, after the generator load has been set to it. The
+// pulse width is worked out again for the same level.
+void BRIGHT_setPeriod(tBrightness *led, uint32_t period);
+
+// Gamma corrected duty cycle of a level in Q16, 0 to 65535
+uint32_t BRIGHT_gamma(uint32_t level);
+
+#endif // BRIGHTNESS_H_
@@ -0,0 +1,279 @@
+/*
+ * ================================================================
+ * File: button_events.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Edge interrupt buttons with time stamped debouncing, long
+ * press and repeat, queued for the main loop.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "button_events.h"
+#include "sample_queue.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+//=============================================================================
+#include "inc/hw_memmap.h"
+#endif
+
+//=============================================================================
+typedef struct {
+  // Debounced state, and whether the pin is left alone until settle_end
+  bool down;
+  bool settling;
+  uint32_t settle_end;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // While down: when it went down, whether the long press has been given
+  // and when the next repeat is due
+  uint32_t down_time;
+  bool long_sent;
+  uint32_t next_repeat;
+} tBtnState;
+
+static const tBtnPin *g_psBtnPins;
+static uint32_t g_ui32BtnCount;
+static tBtnState g_psBtnStates[BTN_MAX];
+static tBtnClock g_pfnBtnClock;
+// Time outs in ticks of the clock
+static uint32_t g_ui32BtnDebounce;
+static uint32_t g_ui32BtnLong;
+static uint32_t g_ui32BtnRepeat;
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static tSampleQueue g_sBtnQueue;
+static tBtnEvent g_psBtnEvents[1u << BTN_QUEUE_LOG2];
+
+static void BTN_service(uint32_t now);
+
+#ifndef HOST_BUILD
+//=============================================================================
+static bool BTN_read(uint32_t button) {
+  return GPIOPinRead(g_psBtnPins[button].port, g_psBtnPins[button].pin) == 0;
+}
+
+static void BTN_startTimer(uint32_t ticks) {
+  TimerDisable(TIMER2_BASE, TIMER_A);
+  TimerLoadSet(TIMER2_BASE, TIMER_A, ticks);
+  TimerEnable(TIMER2_BASE, TIMER_A);
+}
+
+static void BTN_stopTimer(void) { TimerDisable(TIMER2_BASE, TIMER_A); }
+
+//=============================================================================
+// Shared by every port with a button on it. The level is read rather than
+// worked out from the edge, two edges close together only interrupt once.
+static void BTN_gpioHandler(void) {
+  uint32_t now = g_pfnBtnClock();
+  uint32_t status;
+  uint32_t i;
+
+  for (i = 0; i < g_ui32BtnCount; i++) {
+    status = GPIOIntStatus(g_psBtnPins[i].port, true);
+    if (status & g_psBtnPins[i].pin) {
+      GPIOIntClear(g_psBtnPins[i].port, g_psBtnPins[i].pin);
+    }
+  }
+  BTN_service(now);
+}
+
+static void BTN_timerHandler(void) {
+  TimerIntClear(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+  BTN_service(g_pfnBtnClock());
+}
+
+//=============================================================================
+static void BTN_setup(void) {
+  uint32_t i;
+
+  for (i = 0; i < g_ui32BtnCount; i++) {
+    SysCtlPeripheralEnable(g_psBtnPins[i].peripheral);
+    while (!SysCtlPeripheralReady(g_psBtnPins[i].peripheral)) {
+    }
+    GPIOPinTypeGPIOInput(g_psBtnPins[i].port, g_psBtnPins[i].pin);
+    GPIOPadConfigSet(g_psBtnPins[i].port, g_psBtnPins[i].pin,
+                     GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+    GPIOIntTypeSet(g_psBtnPins[i].port, g_psBtnPins[i].pin, GPIO_BOTH_EDGES);
+    GPIOIntClear(g_psBtnPins[i].port, g_psBtnPins[i].pin);
+    // Registering the same handler again for a port is harmless
+    GPIOIntRegister(g_psBtnPins[i].port, BTN_gpioHandler);
+    GPIOIntEnable(g_psBtnPins[i].port, g_psBtnPins[i].pin);
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER2)) {
+  }
+  TimerConfigure(TIMER2_BASE, TIMER_CFG_ONE_SHOT);
+  TimerIntRegister(TIMER2_BASE, TIMER_A, BTN_timerHandler);
+  TimerIntEnable(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+}
+
+#else
+//=============================================================================
+// Host stand-in, the pins are set by the test and the timer is a deadline
+static bool g_pbHostLevel[BTN_MAX];
+static bool g_bHostArmed;
+static uint32_t g_ui32HostDeadline;
+
+static bool BTN_read(uint32_t button) { return g_pbHostLevel[button]; }
+
+static void BTN_startTimer(uint32_t ticks) {
+  g_bHostArmed = true;
+  g_ui32HostDeadline = g_pfnBtnClock() + ticks;
+}
+
+static void BTN_stopTimer(void) { g_bHostArmed = false; }
+
+static void BTN_setup(void) { g_bHostArmed = false; }
+
+void BTN_hostSet(uint32_t button, bool down) {
+  if (g_pbHostLevel[button] != down) {
+    g_pbHostLevel[button] = down;
+    BTN_service(g_pfnBtnClock());
+  }
+}
+
+bool BTN_hostDeadline(uint32_t *deadline) {
+  *deadline = g_ui32HostDeadline;
+  return g_bHostArmed;
+}
+
+void BTN_hostTimer(void) {
+  g_bHostArmed = false;
+  BTN_service(g_pfnBtnClock());
+}
+#endif
+
+//=============================================================================
+static void BTN_emit(uint32_t button, tBtnEventType type, uint32_t now) {
+  tBtnEvent event;
+
+  event.button = (uint8_t)button;
+  event.type = (uint8_t)type;
+  event.time = now;
+  QUEUE_push(&g_sBtnQueue, &event, 1);
+}
+
+// Time left until a deadline, negative once it has passed
+static inline int32_t BTN_until(uint32_t deadline, uint32_t now) {
+  return (int32_t)(deadline - now);
+}
+
+//=============================================================================
+// Take a change of the pin unless it is still bouncing from the last one
+static void BTN_take(uint32_t button, uint32_t now) {
+  tBtnState *state = &g_psBtnStates[button];
+  bool down = BTN_read(button);
+
+  if (state->settling || down == state->down) {
+    return;
+  }
+  state->down = down;
+  state->settling = true;
+  state->settle_end = now + g_ui32BtnDebounce;
+  if (down) {
+    state->down_time = now;
+    state->long_sent = false;
+  }
+  BTN_emit(button, down ? BTN_PRESS : BTN_RELEASE, now);
+}
+
+//=============================================================================
+// Everything that is due at now, then the timer is loaded with the nearest
+// deadline that is left
+static void BTN_service(uint32_t now) {
+  tBtnState *state;
+  int32_t nearest = INT32_MAX;
+  int32_t left;
+  uint32_t i;
+
+  for (i = 0; i < g_ui32BtnCount; i++) {
+    state = &g_psBtnStates[i];
+    if (state->settling && BTN_until(state->settle_end, now) <= 0) {
+      state->settling = false;
+    }
+    BTN_take(i, now);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    if (state->down && !state->long_sent &&
+        BTN_until(state->down_time + g_ui32BtnLong, now) <= 0) {
+      state->long_sent = true;
+      state->next_repeat = state->down_time + g_ui32BtnLong + g_ui32BtnRepeat;
+      BTN_emit(i, BTN_LONG, now);
+    }
+    if (state->down && state->long_sent &&
+        BTN_until(state->next_repeat, now) <= 0) {
+      state->next_repeat += g_ui32BtnRepeat;
+      // Came too late for more than one, the missed ones are not made up
+      if (BTN_until(state->next_repeat, now) <= 0) {
+        state->next_repeat = now + g_ui32BtnRepeat;
+      }
+      BTN_emit(i, BTN_REPEAT, now);
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    if (state->settling) {
+      left = BTN_until(state->settle_end, now);
+      nearest = left < nearest ? left : nearest;
+    }
+    if (state->down) {
+      left = BTN_until(state->long_sent ? state->next_repeat
+                                        : state->down_time + g_ui32BtnLong,
+                       now);
+      nearest = left < nearest ? left : nearest;
+    }
+  }
+  if (nearest == INT32_MAX) {
+    BTN_stopTimer();
+  } else {
+    BTN_startTimer(nearest > 0 ? (uint32_t)nearest : 1);
+  }
+}
+
+//=============================================================================
+void BTN_setClock(uint32_t system_clock) {
+  g_ui32BtnDebounce = system_clock / 1000 * BTN_DEBOUNCE_MS;
+  g_ui32BtnLong = system_clock / 1000 * BTN_LONG_MS;
+  g_ui32BtnRepeat = system_clock / 1000 * BTN_REPEAT_MS;
+}
+
+//=============================================================================
+void BTN_init(const tBtnPin *pins, uint32_t count, uint32_t system_clock,
+              tBtnClock clock) {
+  uint32_t i;
+
+  g_psBtnPins = pins;
+  g_ui32BtnCount = count < BTN_MAX ? count : BTN_MAX;
+  g_pfnBtnClock = clock;
+  BTN_setClock(system_clock);
+  QUEUE_init(&g_sBtnQueue, g_psBtnEvents, sizeof(tBtnEvent), BTN_QUEUE_LOG2);
+  for (i = 0; i < BTN_MAX; i++) {
+    g_psBtnStates[i].down = false;
+    g_psBtnStates[i].settling = false;
+    g_psBtnStates[i].long_sent = false;
+  }
+  BTN_setup();
+  // A button held down at the start has no edge to be found by, it is
+  // pressed now
+  BTN_service(clock());
+}
+
+//=============================================================================
+uint32_t BTN_pop(tBtnEvent *events, uint32_t max) {
+  return QUEUE_pop(&g_sBtnQueue, events, max);
+}
+
+bool BTN_pending(void) { return QUEUE_count(&g_sBtnQueue) != 0; }
+
+uint32_t BTN_overflows(void) { return g_sBtnQueue.overflows; }
+
+bool BTN_down(uint32_t button) {
+  return button < g_ui32BtnCount && g_psBtnStates[button].down;
+}
@@ -0,0 +1,104 @@
+/*
+ * ================================================================
+ * File: button_events.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Interrupt driven, debounced buttons. Every edge of a button
+ * interrupts, and the first edge that changes the debounced state is taken
+ * at once and stamped with the time of the interrupt. For BTN_DEBOUNCE_MS
+ * after that the contacts are left to bounce, then the pin is read once
+ * more and a change that happened meanwhile is taken then. Holding a button
+ * down gives a long press after BTN_LONG_MS and from then on a repeat every
+ * BTN_REPEAT_MS.
+ *
+ * The events go into a single producer, single consumer queue, see
+ * sample_queue.h, and are popped from the main loop. The time outs come
+ * from Timer 2 in one-shot mode, loaded with the nearest one and only
+ * running while a button is bouncing or held, so a board that waits for a
+ * button can sleep. The GPIO and the timer interrupt have the same
+ * priority and never interrupt each other, together they are the one
+ * producer.
+ *
+ * The time is taken from the clock given to BTN_init(), which counts at the
+ * system clock and has to keep counting in sleep if the loop sleeps, such
+ * as IDLE_now().
+ *
+ * With HOST_BUILD defined the pins are set with BTN_hostSet() and the timer
+ * is run with BTN_hostTimer() when BTN_hostDeadline() says it is due.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef BUTTON_EVENTS_H_
+#define BUTTON_EVENTS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+#define BTN_MAX 4
+#define BTN_DEBOUNCE_MS 20
+#define BTN_LONG_MS 600
+#define BTN_REPEAT_MS 150
+// 2^BTN_QUEUE_LOG2 events can wait to be popped
+#define BTN_QUEUE_LOG2 4
+
+//=============================================================================
+typedef enum { BTN_PRESS, BTN_RELEASE, BTN_LONG, BTN_REPEAT } tBtnEventType;
+
+typedef struct {
+  // Index of the button in the table given to BTN_init()
+  uint8_t button;
+  uint8_t type;
+  // Time of the interrupt that found the change, from the clock
+  uint32_t time;
+} tBtnEvent;
+
+// A button pulled low when pressed, for example {SYSCTL_PERIPH_GPIOJ,
+// GPIO_PORTJ_BASE, GPIO_PIN_0} for USR_SW1 of the LaunchPad
+typedef struct {
+  uint32_t peripheral;
+  uint32_t port;
+  uint8_t pin;
+} tBtnPin;
+
+typedef uint32_t (*tBtnClock)(void);
+
+//=============================================================================
+// Set up count buttons from pins, which has to stay valid, and enable their
+// interrupts. A button held down at the start gives its press at once.
+void BTN_init(const tBtnPin *pins, uint32_t count, uint32_t system_clock,
+              tBtnClock clock);
+
+// The system clock changed, the clock now counts at system_clock. Called
+// with the interrupts masked, a time out already running keeps its length
+// in ticks.
+void BTN_setClock(uint32_t system_clock);
+
+// Copy up to max of the oldest events into events and return how many
+// there were
+uint32_t BTN_pop(tBtnEvent *events, uint32_t max);
+
+// Events waiting to be popped
+bool BTN_pending(void);
+
+// Events lost because the queue was full
+uint32_t BTN_overflows(void);
+
+// Debounced state of a button
+bool BTN_down(uint32_t button);
+
+#ifdef HOST_BUILD
+//=============================================================================
+// Set the level of a pin, the edge interrupt runs if it changed
+void BTN_hostSet(uint32_t button, bool down);
+
+// Whether the timer runs, and the time it fires at
+bool BTN_hostDeadline(uint32_t *deadline);
+
+// The timer interrupt
+void BTN_hostTimer(void);
+#endif
+
+#endif // BUTTON_EVENTS_H_
@@ -0,0 +1,198 @@
+/*
+ * ================================================================
+ * File: clock_profile.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: System clock profiles with PWM, SysTick and ADC timing
+ * derived from the running clock.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "clock_profile.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/interrupt.h"
+#include "driverlib/pwm.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+
+//=============================================================================
+// The slowest profile runs straight from the PIOSC with the PLL off, the
+// others from the PLL locked to the 25 MHz crystal
+const tClockProfile g_psClockProfiles[CLOCK_PROFILES] = {
+    {"low", SYSCTL_OSC_INT | SYSCTL_USE_OSC, CLOCK_PIOSC},
+    {"mid",
+     SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN | SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480,
+     60000000},
+    {"full",
+     SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN | SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480,
+     120000000}};
+
+// PWMClockSet() configuration by log2 of the divider
+static const uint32_t g_pui32PWMClocks[7] = {
+    PWM_SYSCLK_DIV_1,  PWM_SYSCLK_DIV_2,  PWM_SYSCLK_DIV_4, PWM_SYSCLK_DIV_8,
+    PWM_SYSCLK_DIV_16, PWM_SYSCLK_DIV_32, PWM_SYSCLK_DIV_64};
+
+uint32_t CLOCK_pwmClock(const tClockTiming *timing) {
+  uint32_t log2 = 0;
+
+  while ((1u << log2) < timing->pwm_divider && log2 < 6) {
+    log2++;
+  }
+  return g_pui32PWMClocks[log2];
+}
+
+//=============================================================================
+// SysCtlClockFreqSet() returns 0 when the clock could not be set
+static uint32_t CLOCK_frequencySet(const tClockProfile *profile) {
+  return SysCtlClockFreqSet(profile->config, profile->frequency);
+}
+
+static void CLOCK_registers(const tClockUsers *users,
+                            const tClockTiming *timing) {
+  if (users->pwm_rate != 0) {
+    PWMClockSet(users->pwm_base, CLOCK_pwmClock(timing));
+    PWMGenPeriodSet(users->pwm_base, users->pwm_generator, timing->pwm_load);
+  }
+  if (users->systick_rate != 0) {
+    SysTickPeriodSet(timing->systick_period);
+  }
+  if (users->adc_sample_rate != 0) {
+    TimerLoadSet(users->adc_timer_base, TIMER_A, timing->adc_timer_load);
+  }
+}
+
+// IntMasterDisable() returns whether interrupts were already masked
+static inline bool CLOCK_mask(void) { return IntMasterDisable(); }
+
+static inline void CLOCK_unmask(bool was_masked) {
+  if (!was_masked) {
+    IntMasterEnable();
+  }
+}
+
+#else
+//=============================================================================
+// Host stand-ins, the clock is what was asked for
+const tClockProfile g_psClockProfiles[CLOCK_PROFILES] = {
+    {"low", 0, CLOCK_PIOSC}, {"mid", 0, 60000000}, {"full", 0, 120000000}};
+
+static uint32_t CLOCK_frequencySet(const tClockProfile *profile) {
+  return profile->frequency;
+}
+
+static void CLOCK_registers(const tClockUsers *users,
+                            const tClockTiming *timing) {}
+
+static inline bool CLOCK_mask(void) { return false; }
+
+static inline void CLOCK_unmask(bool was_masked) {}
+#endif
+
+//=============================================================================
+void CLOCK_derive(const tClockUsers *users, uint32_t system_clock,
+                  tClockTiming *timing) {
+  timing->system_clock = system_clock;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The smallest divider that fits the period into the load register keeps
+  // the most steps of pulse width
+  timing->pwm_divider = 1;
+  timing->pwm_load = 0;
+  if (users->pwm_rate != 0) {
+    while (system_clock / timing->pwm_divider / users->pwm_rate >
+               CLOCK_PWM_LOAD_MAX &&
+           timing->pwm_divider < CLOCK_PWM_DIVIDER_MAX) {
+      timing->pwm_divider <<= 1;
+    }
+    timing->pwm_load = system_clock / timing->pwm_divider / users->pwm_rate;
+    if (timing->pwm_load > CLOCK_PWM_LOAD_MAX) {
+      timing->pwm_load = CLOCK_PWM_LOAD_MAX;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  timing->systick_period = 0;
+  if (users->systick_rate != 0) {
+    timing->systick_period = system_clock / users->systick_rate;
+    if (timing->systick_period > CLOCK_SYSTICK_MAX) {
+      timing->systick_period = CLOCK_SYSTICK_MAX;
+    }
+  }
+  timing->adc_timer_load = 0;
+  if (users->adc_sample_rate != 0) {
+    timing->adc_timer_load = system_clock / users->adc_sample_rate - 1;
+  }
+}
+
+//=============================================================================
+bool CLOCK_init(tClock *clock, const tClockUsers *users,
+                tClockProfileId profile, tClockChanged changed,
+                void *argument) {
+  uint32_t system_clock = CLOCK_frequencySet(&g_psClockProfiles[profile]);
+
+  clock->users = users;
+  clock->changed = changed;
+  clock->argument = argument;
+  clock->profile = profile;
+  clock->switches = 0;
+  CLOCK_derive(users, system_clock, &clock->timing);
+  return system_clock != 0;
+}
+
+//=============================================================================
+bool CLOCK_set(tClock *clock, tClockProfileId profile) {
+  bool was_masked;
+  uint32_t system_clock;
+
+  if (profile == clock->profile || profile >= CLOCK_PROFILES) {
+    return false;
+  }
+  // Nothing may run on the old timing once the clock has changed
+  was_masked = CLOCK_mask();
+  system_clock = CLOCK_frequencySet(&g_psClockProfiles[profile]);
+  if (system_clock == 0) {
+    CLOCK_unmask(was_masked);
+    return false;
+  }
+  CLOCK_derive(clock->users, system_clock, &clock->timing);
+  // The load first, the pulse width is worked out from it
+  CLOCK_registers(clock->users, &clock->timing);
+  if (clock->users->pwm_rate != 0 && clock->users->led != 0) {
+    BRIGHT_setPeriod(clock->users->led, clock->timing.pwm_load);
+  }
+  clock->profile = profile;
+  clock->switches++;
+  if (clock->changed != 0) {
+    clock->changed(&clock->timing, clock->argument);
+  }
+  CLOCK_unmask(was_masked);
+  return true;
+}
+
+//=============================================================================
+bool CLOCK_govern(tClock *clock, uint32_t active_percent) {
+  uint32_t slower;
+
+  if (active_percent > CLOCK_UP_PERCENT) {
+    return clock->profile + 1 < CLOCK_PROFILES &&
+           CLOCK_set(clock, (tClockProfileId)(clock->profile + 1));
+  }
+  if (clock->profile == CLOCK_LOW) {
+    return false;
+  }
+  // The same work takes longer in proportion at the slower clock
+  slower = g_psClockProfiles[clock->profile - 1].frequency;
+  if ((uint64_t)active_percent * clock->timing.system_clock <=
+      (uint64_t)CLOCK_DOWN_PERCENT * slower) {
+    return CLOCK_set(clock, (tClockProfileId)(clock->profile - 1));
+  }
+  return false;
+}
@@ -0,0 +1,138 @@
+/*
+ * ================================================================
+ * File: clock_profile.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Named system clock profiles, and everything that is timed
+ * off the system clock worked out again from the one that is running. The
+ * application says once what it needs, a PWM rate, a SysTick rate and an
+ * ADC sample rate, and CLOCK_derive() turns that into the register values
+ * for a given clock:
+ *  - the PWM clock divider and the generator load, the pulse width is set
+ *    again through the brightness engine for the same level
+ *  - the SysTick reload
+ *  - the load of the timer that triggers the ADC. The conversions
+ *    themselves are clocked from the PIOSC as well.
+ *
+ * The UART is left out. Clocked from the PIOSC with UARTClockSourceSet()
+ * and configured for CLOCK_PIOSC, its divisors are the same in every
+ * profile and a switch never touches it, a character being sent is not cut
+ * up.
+ *
+ * CLOCK_set() switches with the interrupts masked. The new PWM load and
+ * pulse width only take effect when the counter reaches zero, and both are
+ * in ticks of the same clock, so the period that runs across the switch
+ * keeps its duty cycle. The ADC timer should be set to
+ * TimerUpdateMode(TIMER_UP_LOAD_TIMEOUT), then the new load also starts at
+ * the end of the interval that is running.
+ *
+ * CLOCK_govern() drops to a lower profile when the work would fit there
+ * and goes up again under load, see CLOCK_UP_PERCENT.
+ *
+ * With HOST_BUILD defined no registers are touched, the system clock is
+ * what the profile asks for.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef CLOCK_PROFILE_H_
+#define CLOCK_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "brightness.h"
+
+//=============================================================================
+#define CLOCK_PIOSC 16000000
+// Above CLOCK_UP_PERCENT active time the next faster profile is taken. A
+// slower one is only taken when the same work would be at most
+// CLOCK_DOWN_PERCENT of it, which keeps the two from taking turns.
+#define CLOCK_UP_PERCENT 80
+#define CLOCK_DOWN_PERCENT 50
+// The PWM load register has 16 bits, the divider goes up to 64
+#define CLOCK_PWM_LOAD_MAX 65536
+#define CLOCK_PWM_DIVIDER_MAX 64
+// SysTick has a 24-bit counter
+#define CLOCK_SYSTICK_MAX (1u << 24)
+
+//=============================================================================
+// Slowest first
+typedef enum {
+  CLOCK_LOW,
+  CLOCK_MID,
+  CLOCK_FULL,
+  CLOCK_PROFILES
+} tClockProfileId;
+
+typedef struct {
+  const char *name;
+  // SysCtlClockFreqSet() configuration and frequency asked for
+  uint32_t config;
+  uint32_t frequency;
+} tClockProfile;
+
+extern const tClockProfile g_psClockProfiles[CLOCK_PROFILES];
+
+// What runs off the system clock, the same in every profile. A rate of 0
+// leaves that part alone. A PWM or SysTick rate too slow for the clock gets
+// the longest period there is.
+typedef struct {
+  uint32_t pwm_base;
+  uint32_t pwm_generator;
+  uint32_t pwm_rate;
+  // The LED on the generator, its pulse width follows the load. May be 0.
+  tBrightness *led;
+  uint32_t systick_rate;
+  uint32_t adc_timer_base;
+  uint32_t adc_sample_rate;
+} tClockUsers;
+
+// Register values for one system clock
+typedef struct {
+  uint32_t system_clock;
+  // PWM clock is the system clock divided by pwm_divider, 1 to 64
+  uint32_t pwm_divider;
+  uint32_t pwm_load;
+  uint32_t systick_period;
+  uint32_t adc_timer_load;
+} tClockTiming;
+
+// Called after every switch, for what is not in tClockUsers
+typedef void (*tClockChanged)(const tClockTiming *timing, void *argument);
+
+typedef struct {
+  const tClockUsers *users;
+  tClockChanged changed;
+  void *argument;
+  tClockProfileId profile;
+  tClockTiming timing;
+  uint32_t switches;
+} tClock;
+
+//=============================================================================
+void CLOCK_derive(const tClockUsers *users, uint32_t system_clock,
+                  tClockTiming *timing);
+
+// Start the system clock in a profile and work out clock->timing. Nothing
+// else is set, the peripherals are set up from clock->timing afterwards.
+// Returns false if the clock could not be set.
+bool CLOCK_init(tClock *clock, const tClockUsers *users,
+                tClockProfileId profile, tClockChanged changed,
+                void *argument);
+
+// Switch to another profile and set everything in users to match. Returns
+// false and stays in the old profile if the clock could not be set.
+bool CLOCK_set(tClock *clock, tClockProfileId profile);
+
+// Pick the profile for the active time measured in the current one, see
+// idle.h. Returns true if it switched.
+bool CLOCK_govern(tClock *clock, uint32_t active_percent);
+
+#ifndef HOST_BUILD
+// PWMClockSet() configuration for the divider in timing
+uint32_t CLOCK_pwmClock(const tClockTiming *timing);
+#endif
+
+#endif // CLOCK_PROFILE_H_
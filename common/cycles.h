@@ -0,0 +1,59 @@
+/*
+ * ================================================================
+ * File: cycles.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Cycle counter for timing code. On the TM4C129 this is the
+ * Cortex-M4 DWT cycle counter, one count per system clock cycle, wrapping
+ * after 2^32 cycles (about 35 s at 120 MHz). Differences of two readings are
+ * correct across a wrap as long as they are taken as uint32_t.
+ *
+ * With HOST_BUILD defined the counter is a monotonic clock in nanoseconds.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef CYCLES_H_
+#define CYCLES_H_
+
+#include <stdint.h>
+
+#ifndef HOST_BUILD
+//=============================================================================
+// Debug Exception and Monitor Control, and the DWT registers
+#define CYCLES_DEMCR (*((volatile uint32_t *)0xE000EDFC))
+#define CYCLES_DEMCR_TRCENA 0x01000000
+#define CYCLES_DWT_CTRL (*((volatile uint32_t *)0xE0001000))
+#define CYCLES_DWT_CTRL_CYCCNTENA 0x00000001
+#define CYCLES_DWT_CYCCNT (*((volatile uint32_t *)0xE0001004))
+
+//=============================================================================
+// Several modules call this, only the first call resets the counter so that
+// measurements already running are not disturbed. The DWT registers can only
+// be trusted once TRCENA is set, so that comes before CYCCNTENA is tested.
+static inline void CYCLES_init(void) {
+  CYCLES_DEMCR |= CYCLES_DEMCR_TRCENA;
+  if (CYCLES_DWT_CTRL & CYCLES_DWT_CTRL_CYCCNTENA) {
+    return;
+  }
+  CYCLES_DWT_CYCCNT = 0;
+  CYCLES_DWT_CTRL |= CYCLES_DWT_CTRL_CYCCNTENA;
+}
+
+static inline uint32_t CYCLES_now(void) { return CYCLES_DWT_CYCCNT; }
+
+#else
+//=============================================================================
+#include <time.h>
+
+static inline void CYCLES_init(void) {}
+
+static inline uint32_t CYCLES_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000000000ull + now.tv_nsec);
+}
+#endif
+
+#endif // CYCLES_H_
@@ -0,0 +1,524 @@
+/*
+ * ================================================================
+ * File: dashboard.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Text dashboard with dirty-rectangle updates, a glyph cache
+ * for drawing without grlib, and a pixel counting display.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "dashboard.h"
+
+//=============================================================================
+void DASH_init(tDashboard *dash, tContext *context) {
+  memset(dash, 0, sizeof(*dash));
+  dash->context = context;
+}
+
+//=============================================================================
+uint32_t DASH_addField(tDashboard *dash, int32_t x, int32_t y) {
+  tDashField *field;
+
+  if (dash->field_count == DASH_MAX_FIELDS) {
+    return DASH_MAX_FIELDS;
+  }
+  field = &dash->field[dash->field_count];
+  field->x = x;
+  field->y = y;
+  field->shown_length = 0;
+  field->shown_width = 0;
+  return dash->field_count++;
+}
+
+//=============================================================================
+// Whether every one of the first length characters is in the cache
+static bool DASH_cached(const tDashGlyphs *glyphs, const char *text,
+                        int32_t length) {
+  int32_t i;
+
+  if (glyphs == 0) {
+    return false;
+  }
+  for (i = 0; i < length; i++) {
+    if ((uint8_t)text[i] >= 128 ||
+        glyphs->slot[(uint8_t)text[i]] == DASH_GLYPH_NONE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//=============================================================================
+// Width in pixels of the first length characters, grlib treats a length of
+// 0 as "up to the terminator" so that case is handled here. The cells have
+// the widths grlib gives the characters, so both ways agree.
+static int32_t DASH_width(const tDashboard *dash, const char *text,
+                          int32_t length) {
+  int32_t width = 0;
+  int32_t i;
+
+  if (!DASH_cached(dash->glyphs, text, length)) {
+    return length > 0 ? GrStringWidthGet(dash->context, text, length) : 0;
+  }
+  for (i = 0; i < length; i++) {
+    width += dash->glyphs->width[dash->glyphs->slot[(uint8_t)text[i]]];
+  }
+  return width;
+}
+
+//=============================================================================
+// Send the rectangle x0..x1 - 1 of a line starting with count cells, the
+// rest of it is background. Every row is put together from a row of each
+// cell in turn and sent as one 1 bpp run, which the driver sends in one
+// window, so the cost is about that of the pixels. The bits of the cells
+// are collected left aligned in bits and written out a byte at a time.
+static void DASH_glyphDraw(const tDisplay *display, const tDashGlyphs *glyphs,
+                           const char *text, int32_t count, int32_t x0,
+                           int32_t x1, int32_t y) {
+  static uint8_t line[DASH_GLYPH_LINE / 8];
+  const uint8_t *slot = glyphs->slot;
+  uint32_t cell;
+  uint32_t bits;
+  int32_t pending;
+  int32_t width;
+  int32_t x;
+  int32_t row;
+  int32_t i;
+
+  for (row = 0; row < glyphs->height; row++) {
+    memset(line, 0, (x1 - x0 + 7) >> 3);
+    bits = 0;
+    pending = 0;
+    x = 0;
+    for (i = 0; i < count && x < x1 - x0; i++) {
+      cell = slot[(uint8_t)text[i]];
+      width = glyphs->width[cell] < x1 - x0 - x ? glyphs->width[cell]
+                                                : x1 - x0 - x;
+      bits |= ((uint32_t)glyphs->rows[cell][row] << 16 &
+               ~(0xffffffffu >> width)) >>
+              pending;
+      pending += width;
+      x += width;
+      for (; pending >= 8; pending -= 8) {
+        line[(x - pending) >> 3] = bits >> 24;
+        bits <<= 8;
+      }
+    }
+    if (pending > 0) {
+      line[(x - pending) >> 3] = bits >> 24;
+    }
+    DpyPixelDrawMultiple(display, x0, y + row, 0, x1 - x0, 1, line,
+                         (const uint8_t *)glyphs->palette);
+  }
+}
+
+//=============================================================================
+void DASH_setText(tDashboard *dash, uint32_t id, const char *text) {
+  tDashField *field;
+  tContext *context = dash->context;
+  tRectangle clip;
+  tRectangle rect;
+  uint32_t foreground;
+  int32_t length = strlen(text);
+  int32_t first = 0;
+  int32_t last_new;
+  int32_t last_old;
+  int32_t changed;
+  int32_t count;
+  int32_t width;
+  int32_t height;
+  int32_t x0;
+  int32_t x1;
+
+  if (id >= dash->field_count) {
+    return;
+  }
+  field = &dash->field[id];
+  if (length > DASH_TEXT_MAX - 1) {
+    length = DASH_TEXT_MAX - 1;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Skip the characters that are the same at the start and at the end
+  while (first < length && first < field->shown_length &&
+         text[first] == field->shown[first]) {
+    first++;
+  }
+  if (first == length && first == field->shown_length) {
+    return;
+  }
+  last_new = length;
+  last_old = field->shown_length;
+  while (last_new > first && last_old > first &&
+         text[last_new - 1] == field->shown[last_old - 1]) {
+    last_new--;
+    last_old--;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The unchanged end of the line only stays in place if the changed middle
+  // has the same width as before, otherwise everything after the first
+  // change moves and has to be redrawn.
+  width = DASH_width(dash, text, length);
+  x0 = field->x + DASH_width(dash, text, first);
+  changed = DASH_width(dash, text + first, last_new - first);
+  if (changed == DASH_width(dash, field->shown + first, last_old - first)) {
+    x1 = x0 + changed;
+    count = last_new - first;
+  } else {
+    x1 = field->x + (width > field->shown_width ? width : field->shown_width);
+    count = length - first;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  memcpy(field->shown, text, length);
+  field->shown[length] = '\0';
+  field->shown_length = length;
+  field->shown_width = width;
+  // Like grlib nothing is sent right of the clipping region
+  clip = context->sClipRegion;
+  if (x1 > clip.i16XMax + 1) {
+    x1 = clip.i16XMax + 1;
+  }
+  if (x1 <= x0) {
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // From the cache the characters in the rectangle are sent as they are,
+  // and the part that the old, longer text used as background. A line that
+  // does not fit in the clipping region on the left or vertically, or is
+  // wider than a row from the cache can be, is left to grlib.
+  if (DASH_cached(dash->glyphs, text + first, count) &&
+      x0 >= clip.i16XMin && field->y >= clip.i16YMin &&
+      field->y + dash->glyphs->height - 1 <= clip.i16YMax &&
+      x1 - x0 <= DASH_GLYPH_LINE) {
+    DASH_glyphDraw(context->psDisplay, dash->glyphs, text + first, count, x0,
+                   x1, field->y);
+    dash->pixels_this_frame += (x1 - x0) * dash->glyphs->height;
+    dash->rects_this_frame++;
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Draw the whole string but clipped to the dirty rectangle, grlib then only
+  // sends the pixels inside it. Opaque text covers its own cells and the part
+  // that the old, longer text used is filled with the background.
+  height = GrStringHeightGet(context);
+  rect.i16XMin = x0;
+  rect.i16YMin = field->y;
+  rect.i16XMax = x1 - 1;
+  rect.i16YMax = field->y + height - 1;
+  GrContextClipRegionSet(context, &rect);
+  GrStringDraw(context, text, length, field->x, field->y, true);
+  if (field->x + width < x1) {
+    rect.i16XMin = field->x + width > x0 ? field->x + width : x0;
+    foreground = context->ui32Foreground;
+    GrContextForegroundSetTranslated(context, context->ui32Background);
+    GrRectFill(context, &rect);
+    GrContextForegroundSetTranslated(context, foreground);
+  }
+  GrContextClipRegionSet(context, &clip);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  dash->pixels_this_frame += (x1 - x0) * height;
+  dash->rects_this_frame++;
+}
+
+//=============================================================================
+void DASH_endFrame(tDashboard *dash) {
+  if (dash->rects_this_frame != 0) {
+    GrFlush(dash->context);
+  }
+  dash->pixels_last_frame = dash->pixels_this_frame;
+  dash->rects_last_frame = dash->rects_this_frame;
+  dash->pixels_this_frame = 0;
+  dash->rects_this_frame = 0;
+  dash->frames++;
+}
+
+//=============================================================================
+// Glyph cache
+//=============================================================================
+uint32_t DASH_glyphsInit(tDashGlyphs *glyphs, const tContext *context,
+                         const char *characters) {
+  // Every character is drawn by grlib into this memory display, on the
+  // background, and the cell is read back out of it bit by bit
+  static uint16_t scratch[DASH_GLYPH_WIDTH * DASH_GLYPH_HEIGHT];
+  tDisplay display;
+  tDashCounter counter;
+  tContext cell;
+  uint16_t *rows;
+  uint16_t pixel;
+  uint8_t character;
+  bool two_colors;
+  int32_t width;
+  int32_t row;
+  int32_t i;
+
+  memset(glyphs->slot, DASH_GLYPH_NONE, sizeof(glyphs->slot));
+  glyphs->count = 0;
+  glyphs->height = GrStringHeightGet(context);
+  glyphs->palette[0] = context->ui32Background;
+  glyphs->palette[1] = context->ui32Foreground;
+  if (glyphs->height > DASH_GLYPH_HEIGHT) {
+    return 0;
+  }
+  DASH_counterInit(&display, &counter, 0, scratch, DASH_GLYPH_WIDTH,
+                   DASH_GLYPH_HEIGHT);
+  GrContextInit(&cell, &display);
+  GrContextFontSet(&cell, context->psFont);
+  // The colors of context are already translated to RGB565 by its display
+  GrContextForegroundSetTranslated(&cell, context->ui32Foreground);
+  GrContextBackgroundSetTranslated(&cell, context->ui32Background);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  for (; *characters != '\0' && glyphs->count < DASH_GLYPH_MAX;
+       characters++) {
+    character = *characters;
+    width = GrStringWidthGet(&cell, characters, 1);
+    if (character >= 128 || glyphs->slot[character] != DASH_GLYPH_NONE ||
+        width <= 0 || width > DASH_GLYPH_WIDTH) {
+      continue;
+    }
+    for (i = 0; i < DASH_GLYPH_WIDTH * DASH_GLYPH_HEIGHT; i++) {
+      scratch[i] = context->ui32Background;
+    }
+    GrStringDraw(&cell, characters, 1, 0, 0, true);
+    rows = glyphs->rows[glyphs->count];
+    two_colors = true;
+    for (row = 0; row < glyphs->height; row++) {
+      rows[row] = 0;
+      for (i = 0; i < width; i++) {
+        pixel = scratch[row * DASH_GLYPH_WIDTH + i];
+        if (pixel == (uint16_t)context->ui32Foreground) {
+          rows[row] |= 0x8000 >> i;
+        } else if (pixel != (uint16_t)context->ui32Background) {
+          two_colors = false;
+        }
+      }
+    }
+    if (!two_colors) {
+      continue;
+    }
+    glyphs->width[glyphs->count] = width;
+    glyphs->slot[character] = glyphs->count++;
+  }
+  return glyphs->count;
+}
+
+//=============================================================================
+void DASH_useGlyphs(tDashboard *dash, const tDashGlyphs *glyphs) {
+  dash->glyphs = glyphs;
+}
+
+//=============================================================================
+// Line formatting
+//=============================================================================
+void DASH_lineClear(tDashLine *line) {
+  line->text[0] = '\0';
+  line->length = 0;
+}
+
+//=============================================================================
+void DASH_lineText(tDashLine *line, const char *text) {
+  while (*text != '\0' && line->length < DASH_TEXT_MAX - 1) {
+    line->text[line->length++] = *text++;
+  }
+  line->text[line->length] = '\0';
+}
+
+//=============================================================================
+// The digits come out lowest first, so they are collected backwards in a
+// buffer large enough for the ten digits of 2^32 - 1
+void DASH_lineUnsigned(tDashLine *line, uint32_t value) {
+  char digits[11];
+  uint32_t i = sizeof(digits) - 1;
+
+  digits[i] = '\0';
+  do {
+    digits[--i] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  DASH_lineText(line, &digits[i]);
+}
+
+void DASH_lineSigned(tDashLine *line, int32_t value) {
+  if (value < 0) {
+    DASH_lineText(line, "-");
+    // Negated as unsigned, which also works for INT32_MIN
+    DASH_lineUnsigned(line, -(uint32_t)value);
+    return;
+  }
+  DASH_lineUnsigned(line, value);
+}
+
+//=============================================================================
+// Counting display
+//=============================================================================
+static uint32_t DASH_counterColorTranslate(void *data, uint32_t value) {
+  tDashCounter *counter = data;
+
+  if (counter->target != 0) {
+    return counter->target->pfnColorTranslate(counter->target->pvDisplayData,
+                                              value);
+  }
+  // RGB888 to RGB565
+  return ((value & 0x00f80000) >> 8) | ((value & 0x0000fc00) >> 5) |
+         ((value & 0x000000f8) >> 3);
+}
+
+//=============================================================================
+static void DASH_counterStore(tDashCounter *counter, int32_t x, int32_t y,
+                              uint32_t value) {
+  counter->framebuffer[y * counter->width + x] = value;
+}
+
+//=============================================================================
+static void DASH_counterStoreLine(tDashCounter *counter, int32_t x1,
+                                  int32_t x2, int32_t y, uint32_t value) {
+  int32_t x;
+
+  for (x = x1; x <= x2; x++) {
+    DASH_counterStore(counter, x, y, value);
+  }
+}
+
+//=============================================================================
+static void DASH_counterPixelDraw(void *data, int32_t x, int32_t y,
+                                  uint32_t value) {
+  tDashCounter *counter = data;
+
+  counter->pixels++;
+  if (counter->target != 0) {
+    counter->target->pfnPixelDraw(counter->target->pvDisplayData, x, y, value);
+  } else {
+    DASH_counterStore(counter, x, y, value);
+  }
+}
+
+//=============================================================================
+static void DASH_counterPixelDrawMultiple(void *data, int32_t x, int32_t y,
+                                          int32_t x0, int32_t count,
+                                          int32_t bpp, const uint8_t *pixels,
+                                          const uint8_t *palette) {
+  tDashCounter *counter = data;
+  const uint8_t *entry;
+  uint32_t index = 0;
+  int32_t i;
+
+  counter->pixels += count;
+  if (counter->target != 0) {
+    counter->target->pfnPixelDrawMultiple(counter->target->pvDisplayData, x, y,
+                                          x0, count, bpp, pixels, palette);
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The 1 and 4 bpp palettes hold translated colors, the 8 bpp palette holds
+  // 24-bit RGB entries
+  for (i = 0; i < count; i++) {
+    switch (bpp) {
+    case 1:
+      index = (pixels[(x0 + i) >> 3] >> (7 - ((x0 + i) & 7))) & 1;
+      DASH_counterStore(counter, x + i, y,
+                        ((const uint32_t *)palette)[index]);
+      break;
+    case 4:
+      index = pixels[(x0 + i) >> 1];
+      index = (x0 + i) & 1 ? index & 0x0f : index >> 4;
+      DASH_counterStore(counter, x + i, y,
+                        ((const uint32_t *)palette)[index]);
+      break;
+    case 8:
+      entry = palette + pixels[i] * 3;
+      DASH_counterStore(counter, x + i, y,
+                        DASH_counterColorTranslate(
+                            counter, entry[0] | (entry[1] << 8) |
+                                         ((uint32_t)entry[2] << 16)));
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+//=============================================================================
+static void DASH_counterLineDrawH(void *data, int32_t x1, int32_t x2,
+                                  int32_t y, uint32_t value) {
+  tDashCounter *counter = data;
+
+  counter->pixels += x2 - x1 + 1;
+  if (counter->target != 0) {
+    counter->target->pfnLineDrawH(counter->target->pvDisplayData, x1, x2, y,
+                                  value);
+  } else {
+    DASH_counterStoreLine(counter, x1, x2, y, value);
+  }
+}
+
+//=============================================================================
+static void DASH_counterLineDrawV(void *data, int32_t x, int32_t y1,
+                                  int32_t y2, uint32_t value) {
+  tDashCounter *counter = data;
+  int32_t y;
+
+  counter->pixels += y2 - y1 + 1;
+  if (counter->target != 0) {
+    counter->target->pfnLineDrawV(counter->target->pvDisplayData, x, y1, y2,
+                                  value);
+    return;
+  }
+  for (y = y1; y <= y2; y++) {
+    DASH_counterStore(counter, x, y, value);
+  }
+}
+
+//=============================================================================
+static void DASH_counterRectFill(void *data, const tRectangle *rect,
+                                 uint32_t value) {
+  tDashCounter *counter = data;
+  int32_t y;
+
+  counter->pixels +=
+      (rect->i16XMax - rect->i16XMin + 1) * (rect->i16YMax - rect->i16YMin + 1);
+  if (counter->target != 0) {
+    counter->target->pfnRectFill(counter->target->pvDisplayData, rect, value);
+    return;
+  }
+  for (y = rect->i16YMin; y <= rect->i16YMax; y++) {
+    DASH_counterStoreLine(counter, rect->i16XMin, rect->i16XMax, y, value);
+  }
+}
+
+//=============================================================================
+static void DASH_counterFlush(void *data) {
+  tDashCounter *counter = data;
+
+  if (counter->target != 0) {
+    counter->target->pfnFlush(counter->target->pvDisplayData);
+  }
+}
+
+//=============================================================================
+void DASH_counterInit(tDisplay *display, tDashCounter *counter,
+                      const tDisplay *target, uint16_t *framebuffer,
+                      uint16_t width, uint16_t height) {
+  counter->target = target;
+  counter->framebuffer = framebuffer;
+  counter->width = target != 0 ? target->ui16Width : width;
+  counter->pixels = 0;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  display->i32Size = sizeof(tDisplay);
+  display->pvDisplayData = counter;
+  display->ui16Width = target != 0 ? target->ui16Width : width;
+  display->ui16Height = target != 0 ? target->ui16Height : height;
+  display->pfnPixelDraw = DASH_counterPixelDraw;
+  display->pfnPixelDrawMultiple = DASH_counterPixelDrawMultiple;
+  display->pfnLineDrawH = DASH_counterLineDrawH;
+  display->pfnLineDrawV = DASH_counterLineDrawV;
+  display->pfnRectFill = DASH_counterRectFill;
+  display->pfnColorTranslate = DASH_counterColorTranslate;
+  display->pfnFlush = DASH_counterFlush;
+}
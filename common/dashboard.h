@@ -0,0 +1,148 @@
+/*
+ * ================================================================
+ * File: dashboard.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Text dashboard that only redraws what changed. Every field
+ * remembers the text that is on the LCD, and when new text is set only the
+ * rectangle covering the characters that differ is sent to the display.
+ *
+ * The counting display wraps another grlib display and counts the pixels
+ * that pass through it. Without a target display it draws into a memory
+ * framebuffer instead, which is the mock used to check the output on a host.
+ * There test/grlib stands in for grlib, so no drivers are needed.
+ *
+ * Decoding the compressed grlib font costs more than sending the pixels, so
+ * the characters a dashboard uses can be rasterised once into a glyph cache
+ * of 1 bit per pixel cells. Text made only of cached characters is then
+ * sent without grlib, a row of the dirty rectangle at a time as one run
+ * through the pfnPixelDrawMultiple of the context's display, so it also
+ * passes through the counting display. The runs are 1 bpp with the
+ * background and foreground as the palette, the way grlib sends text, which
+ * every grlib driver takes. A character with pixels of any other color, from
+ * an anti-aliased font, is left to grlib. The digits of the Cm fonts are
+ * all equally wide, so a number that keeps its length is redrawn as
+ * fixed-width cells of only the changed digits.
+ *
+ * A line is built with the DASH_line functions instead of snprintf(), they
+ * append text and decimal numbers to a fixed buffer and never allocate.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef DASHBOARD_H_
+#define DASHBOARD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "grlib/grlib.h"
+
+//=============================================================================
+#define DASH_MAX_FIELDS 8
+#define DASH_TEXT_MAX 32
+// Characters in a glyph cache and the largest cell, Cm14 fits in 14 x 14
+#define DASH_GLYPH_MAX 40
+#define DASH_GLYPH_WIDTH 16
+#define DASH_GLYPH_HEIGHT 16
+#define DASH_GLYPH_NONE 0xff
+// Widest rectangle sent from the cache, in pixels
+#define DASH_GLYPH_LINE (DASH_TEXT_MAX * DASH_GLYPH_WIDTH)
+
+//=============================================================================
+typedef struct {
+  int32_t x;
+  int32_t y;
+  // What is currently on the LCD and how wide it is in pixels
+  char shown[DASH_TEXT_MAX];
+  int32_t shown_length;
+  int32_t shown_width;
+} tDashField;
+
+typedef struct {
+  // Cell of every ASCII character, DASH_GLYPH_NONE if it is not cached
+  uint8_t slot[128];
+  uint8_t width[DASH_GLYPH_MAX];
+  // The rows of each cell, a set bit is foreground and the leftmost pixel
+  // is the top bit
+  uint16_t rows[DASH_GLYPH_MAX][DASH_GLYPH_HEIGHT];
+  uint32_t count;
+  int32_t height;
+  // Background and foreground translated by the display, the palette of the
+  // runs
+  uint32_t palette[2];
+} tDashGlyphs;
+
+typedef struct {
+  char text[DASH_TEXT_MAX];
+  uint32_t length;
+} tDashLine;
+
+typedef struct {
+  tContext *context;
+  // Used for the text it has every character of, 0 to always use grlib
+  const tDashGlyphs *glyphs;
+  tDashField field[DASH_MAX_FIELDS];
+  uint32_t field_count;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Statistics for the current and the last finished frame
+  uint32_t pixels_this_frame;
+  uint32_t rects_this_frame;
+  uint32_t pixels_last_frame;
+  uint32_t rects_last_frame;
+  uint32_t frames;
+} tDashboard;
+
+typedef struct {
+  const tDisplay *target;
+  // Used instead of target when it is 0, width * height RGB565 pixels
+  uint16_t *framebuffer;
+  uint16_t width;
+  uint32_t pixels;
+} tDashCounter;
+
+//=============================================================================
+void DASH_init(tDashboard *dash, tContext *context);
+
+// Returns the id of the new field, which has its top left corner at x, y.
+// When all DASH_MAX_FIELDS are taken DASH_MAX_FIELDS is returned, and text
+// set on it is ignored.
+uint32_t DASH_addField(tDashboard *dash, int32_t x, int32_t y);
+
+// Draw the part of text that differs from what the field shows
+void DASH_setText(tDashboard *dash, uint32_t field, const char *text);
+
+// Flush the display if anything was drawn and roll the frame statistics
+void DASH_endFrame(tDashboard *dash);
+
+//=============================================================================
+// Rasterise characters with the font and colors of context into the cache.
+// Returns the number of characters cached, those that do not fit in a cell
+// or have pixels of other colors than the two are left out.
+uint32_t DASH_glyphsInit(tDashGlyphs *glyphs, const tContext *context,
+                         const char *characters);
+
+// Draw text of the dashboard from the cache when it can. The cache has to
+// be made with the font and colors of the dashboard's context.
+void DASH_useGlyphs(tDashboard *dash, const tDashGlyphs *glyphs);
+
+//=============================================================================
+// Start an empty line. Text past DASH_TEXT_MAX - 1 characters is dropped,
+// like DASH_setText() does.
+void DASH_lineClear(tDashLine *line);
+
+void DASH_lineText(tDashLine *line, const char *text);
+
+// Append value in decimal, the signed one with a minus sign when negative
+void DASH_lineUnsigned(tDashLine *line, uint32_t value);
+void DASH_lineSigned(tDashLine *line, int32_t value);
+
+//=============================================================================
+// Build a display with the size of target (or width x height when target is
+// 0) that counts every pixel drawn through it.
+void DASH_counterInit(tDisplay *display, tDashCounter *counter,
+                      const tDisplay *target, uint16_t *framebuffer,
+                      uint16_t width, uint16_t height);
+
+#endif // DASHBOARD_H_
@@ -0,0 +1,162 @@
+/*
+ * ================================================================
+ * File: fft.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Radix-2 decimation in time FFT in Q15.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdint.h>
+//=============================================================================
+#include "fft.h"
+
+//=============================================================================
+// A quarter of a sine period in Q15, sin(2 * pi * k / FFT_MAX_POINTS) for
+// k = 0..FFT_MAX_POINTS / 4. Generated with
+//   [round(32767 * sin(2 * pi * k / 512)) for k in range(129)]
+#define FFT_QUARTER (FFT_MAX_POINTS / 4)
+static const int16_t g_pi16Sine[FFT_QUARTER + 1] = {
+    0, 402, 804, 1206, 1608, 2009, 2410, 2811,
+    3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+    6393, 6786, 7179, 7571, 7962, 8351, 8739, 9126,
+    9512, 9896, 10278, 10659, 11039, 11417, 11793, 12167,
+    12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090,
+    15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,
+    18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475,
+    20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884,
+    23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072,
+    25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,
+    27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706,
+    28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+    30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237,
+    31356, 31470, 31580, 31685, 31785, 31880, 31971, 32057,
+    32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567,
+    32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765,
+    32767,
+};
+
+//=============================================================================
+// sin and cos of 2 * pi * k / FFT_MAX_POINTS for k = 0..FFT_MAX_POINTS / 2,
+// which is all the twiddle factors need
+static inline int32_t FFT_sin(uint32_t k) {
+  return g_pi16Sine[k <= FFT_QUARTER ? k : 2 * FFT_QUARTER - k];
+}
+
+static inline int32_t FFT_cos(uint32_t k) {
+  return k <= FFT_QUARTER ? g_pi16Sine[FFT_QUARTER - k]
+                          : -g_pi16Sine[k - FFT_QUARTER];
+}
+
+//=============================================================================
+void FFT_hann(tFFTComplex *data, const int16_t *samples,
+              uint32_t log2_points) {
+  uint32_t points = 1u << log2_points;
+  uint32_t step = FFT_MAX_POINTS >> log2_points;
+  uint32_t k;
+  int32_t cosine;
+  int32_t window;
+  uint32_t i;
+
+  for (i = 0; i < points; i++) {
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // (1 - cos(2 * pi * i / points)) / 2, the second half of the period
+    // mirrors the first
+    k = i * step;
+    cosine = FFT_cos(k <= FFT_MAX_POINTS / 2 ? k : FFT_MAX_POINTS - k);
+    window = (32767 - cosine) >> 1;
+    data[i].re = (int16_t)((samples[i] * window + 0x4000) >> 15);
+    data[i].im = 0;
+  }
+}
+
+//=============================================================================
+void FFT_transform(tFFTComplex *data, uint32_t log2_points) {
+  uint32_t points = 1u << log2_points;
+  tFFTComplex swap;
+  uint32_t size;
+  uint32_t half;
+  uint32_t step;
+  uint32_t i;
+  uint32_t j;
+  uint32_t k;
+  int32_t wr;
+  int32_t wi;
+  int32_t tr;
+  int32_t ti;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Bit reversed order, j walks the reversed index of i
+  for (i = 1, j = 0; i < points; i++) {
+    k = points >> 1;
+    while (j & k) {
+      j ^= k;
+      k >>= 1;
+    }
+    j |= k;
+    if (i < j) {
+      swap = data[i];
+      data[i] = data[j];
+      data[j] = swap;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Butterflies, the twiddle factor exp(-2 * pi * j * k / size) is looked up
+  // once and used for every butterfly that needs it. Halving the sum keeps
+  // the magnitude of every value within the magnitude of the input. The
+  // product is rounded, truncating it as well as the halving adds up to
+  // 1.5 LSB of bias at 512 points. The halving has to truncate, rounding it
+  // would take 32767 - -32768 to 32768.
+  for (size = 2; size <= points; size <<= 1) {
+    half = size >> 1;
+    step = FFT_MAX_POINTS / size;
+    for (k = 0; k < half; k++) {
+      wr = FFT_cos(k * step);
+      wi = FFT_sin(k * step);
+      for (i = k; i < points; i += size) {
+        j = i + half;
+        tr = (data[j].re * wr + data[j].im * wi + 0x4000) >> 15;
+        ti = (data[j].im * wr - data[j].re * wi + 0x4000) >> 15;
+        data[j].re = (int16_t)((data[i].re - tr) >> 1);
+        data[j].im = (int16_t)((data[i].im - ti) >> 1);
+        data[i].re = (int16_t)((data[i].re + tr) >> 1);
+        data[i].im = (int16_t)((data[i].im + ti) >> 1);
+      }
+    }
+  }
+}
+
+//=============================================================================
+void FFT_magnitude(const tFFTComplex *data, uint16_t *magnitude,
+                   uint32_t count) {
+  uint32_t square;
+  uint32_t root;
+  uint32_t bit;
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    square = (uint32_t)(data[i].re * data[i].re) +
+             (uint32_t)(data[i].im * data[i].im);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Integer square root, one result bit per iteration
+    root = 0;
+    bit = 1u << 30;
+    while (bit > square) {
+      bit >>= 2;
+    }
+    while (bit != 0) {
+      if (square >= root + bit) {
+        square -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    magnitude[i] = (uint16_t)root;
+  }
+}
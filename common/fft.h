@@ -0,0 +1,47 @@
+/*
+ * ================================================================
+ * File: fft.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: In-place fixed-point FFT for blocks of up to FFT_MAX_POINTS
+ * samples. The data is Q15 and every radix-2 stage divides by two, so the
+ * result is the DFT divided by the number of points and can never overflow.
+ * A full scale sine ends up as two bins of half the amplitude.
+ *
+ * Against a double precision DFT divided by the number of points the real
+ * and imaginary parts are within 5 LSB at 512 points, 0.8 LSB rms, on full
+ * scale noise and sines (see test/test_fft.c).
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef FFT_H_
+#define FFT_H_
+
+#include <stdint.h>
+
+//=============================================================================
+#define FFT_MAX_LOG2 9
+#define FFT_MAX_POINTS (1u << FFT_MAX_LOG2)
+
+//=============================================================================
+typedef struct {
+  int16_t re;
+  int16_t im;
+} tFFTComplex;
+
+//=============================================================================
+// Multiply 2^log2_points real Q15 samples by a Hann window and store them as
+// complex values with a zero imaginary part
+void FFT_hann(tFFTComplex *data, const int16_t *samples, uint32_t log2_points);
+
+// Forward transform of 2^log2_points values in place, log2_points at most
+// FFT_MAX_LOG2
+void FFT_transform(tFFTComplex *data, uint32_t log2_points);
+
+// Magnitude of the first count bins, rounded down
+void FFT_magnitude(const tFFTComplex *data, uint16_t *magnitude,
+                   uint32_t count);
+
+#endif // FFT_H_
@@ -0,0 +1,230 @@
+/*
+ * ================================================================
+ * File: filter.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Integer smoothing filters for ADC samples.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "filter.h"
+
+#ifndef HOST_BUILD
+#include "driverlib/debug.h"
+#else
+#include <assert.h>
+#define ASSERT(expr) assert(expr)
+#endif
+
+//=============================================================================
+void FILTER_movingAverageInit(tFilterMovingAverage *f, uint32_t *window,
+                              uint32_t log2_length) {
+  f->window = window;
+  f->shift = log2_length;
+  f->index = 0;
+  f->sum = 0;
+  f->primed = false;
+}
+
+//=============================================================================
+uint32_t FILTER_movingAveragePush(tFilterMovingAverage *f, uint32_t sample) {
+  uint32_t i;
+  uint32_t mask = FILTER_LENGTH(f->shift) - 1;
+
+  if (!f->primed) {
+    for (i = 0; i <= mask; i++) {
+      f->window[i] = sample;
+    }
+    f->sum = sample << f->shift;
+    f->primed = true;
+    return sample;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Replace the oldest sample, only the difference has to be added to the
+  // running sum
+  f->sum += sample - f->window[f->index];
+  f->window[f->index] = sample;
+  f->index = (f->index + 1) & mask;
+  return FILTER_movingAverageGet(f);
+}
+
+//=============================================================================
+uint32_t FILTER_movingAveragePushBlock(tFilterMovingAverage *f,
+                                       const uint32_t *samples,
+                                       uint32_t count) {
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    FILTER_movingAveragePush(f, samples[i]);
+  }
+  return FILTER_movingAverageGet(f);
+}
+
+//=============================================================================
+void FILTER_exponentialInit(tFilterExponential *f, uint32_t shift) {
+  f->state = 0;
+  f->shift = shift;
+  f->primed = false;
+}
+
+//=============================================================================
+uint32_t FILTER_exponentialPush(tFilterExponential *f, uint32_t sample) {
+  if (!f->primed) {
+    f->state = sample << f->shift;
+    f->primed = true;
+  } else {
+    f->state += sample - (f->state >> f->shift);
+  }
+  return (f->state + ((1u << f->shift) >> 1)) >> f->shift;
+}
+
+//=============================================================================
+void FILTER_medianInit(tFilterMedian *f, uint32_t *window, uint32_t length) {
+  ASSERT((length & 1) != 0 && length <= FILTER_MEDIAN_MAX);
+  f->window = window;
+  f->length = length > FILTER_MEDIAN_MAX ? FILTER_MEDIAN_MAX : length;
+  f->index = 0;
+  f->primed = false;
+}
+
+//=============================================================================
+// Put the smaller of a and b in a and the larger in b. The compiler turns
+// the ?: into a conditional select (an IT block on the Cortex-M4), so there
+// is no branch and the time does not depend on the samples.
+#define FILTER_EXCHANGE(a, b)                                               \
+  do {                                                                       \
+    uint32_t low = (a) < (b) ? (a) : (b);                                    \
+    (b) ^= (a) ^ low;                                                        \
+    (a) = low;                                                               \
+  } while (0)
+
+// The networks only do the exchanges the middle element depends on. 3, 7
+// and 13 exchanges for 3, 5 and 7 samples, 19 for 9.
+static uint32_t FILTER_median3(uint32_t *p) {
+  FILTER_EXCHANGE(p[0], p[1]);
+  FILTER_EXCHANGE(p[1], p[2]);
+  FILTER_EXCHANGE(p[0], p[1]);
+  return p[1];
+}
+
+static uint32_t FILTER_median5(uint32_t *p) {
+  FILTER_EXCHANGE(p[0], p[1]);
+  FILTER_EXCHANGE(p[3], p[4]);
+  FILTER_EXCHANGE(p[0], p[3]);
+  FILTER_EXCHANGE(p[1], p[4]);
+  FILTER_EXCHANGE(p[1], p[2]);
+  FILTER_EXCHANGE(p[2], p[3]);
+  FILTER_EXCHANGE(p[1], p[2]);
+  return p[2];
+}
+
+static uint32_t FILTER_median7(uint32_t *p) {
+  FILTER_EXCHANGE(p[0], p[5]);
+  FILTER_EXCHANGE(p[0], p[3]);
+  FILTER_EXCHANGE(p[1], p[6]);
+  FILTER_EXCHANGE(p[2], p[4]);
+  FILTER_EXCHANGE(p[0], p[1]);
+  FILTER_EXCHANGE(p[3], p[5]);
+  FILTER_EXCHANGE(p[2], p[6]);
+  FILTER_EXCHANGE(p[2], p[3]);
+  FILTER_EXCHANGE(p[3], p[6]);
+  FILTER_EXCHANGE(p[4], p[5]);
+  FILTER_EXCHANGE(p[1], p[4]);
+  FILTER_EXCHANGE(p[1], p[3]);
+  FILTER_EXCHANGE(p[3], p[4]);
+  return p[3];
+}
+
+static uint32_t FILTER_median9(uint32_t *p) {
+  FILTER_EXCHANGE(p[1], p[2]);
+  FILTER_EXCHANGE(p[4], p[5]);
+  FILTER_EXCHANGE(p[7], p[8]);
+  FILTER_EXCHANGE(p[0], p[1]);
+  FILTER_EXCHANGE(p[3], p[4]);
+  FILTER_EXCHANGE(p[6], p[7]);
+  FILTER_EXCHANGE(p[1], p[2]);
+  FILTER_EXCHANGE(p[4], p[5]);
+  FILTER_EXCHANGE(p[7], p[8]);
+  FILTER_EXCHANGE(p[0], p[3]);
+  FILTER_EXCHANGE(p[5], p[8]);
+  FILTER_EXCHANGE(p[4], p[7]);
+  FILTER_EXCHANGE(p[3], p[6]);
+  FILTER_EXCHANGE(p[1], p[4]);
+  FILTER_EXCHANGE(p[2], p[5]);
+  FILTER_EXCHANGE(p[4], p[7]);
+  FILTER_EXCHANGE(p[4], p[2]);
+  FILTER_EXCHANGE(p[6], p[4]);
+  FILTER_EXCHANGE(p[4], p[2]);
+  return p[4];
+}
+
+//=============================================================================
+uint32_t FILTER_medianOf(const uint32_t *samples, uint32_t length) {
+  uint32_t sorted[FILTER_MEDIAN_MAX];
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  // An even length has no middle sample, and there is nothing to return for
+  // an empty window
+  ASSERT((length & 1) != 0 && length <= FILTER_MEDIAN_MAX);
+  if (length == 0) {
+    return 0;
+  }
+  if (length > FILTER_MEDIAN_MAX) {
+    length = FILTER_MEDIAN_MAX;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The networks work on a copy, the window keeps its order
+  if (length <= 9) {
+    for (i = 0; i < length; i++) {
+      sorted[i] = samples[i];
+    }
+    switch (length) {
+    case 3:
+      return FILTER_median3(sorted);
+    case 5:
+      return FILTER_median5(sorted);
+    case 7:
+      return FILTER_median7(sorted);
+    case 9:
+      return FILTER_median9(sorted);
+    default:
+      break;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Insertion sort for the other lengths, the windows are small enough that
+  // this beats anything smarter
+  for (i = 0; i < length; i++) {
+    value = samples[i];
+    for (j = i; j > 0 && sorted[j - 1] > value; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+  return sorted[length >> 1];
+}
+
+//=============================================================================
+uint32_t FILTER_medianPush(tFilterMedian *f, uint32_t sample) {
+  uint32_t i;
+
+  if (!f->primed) {
+    for (i = 0; i < f->length; i++) {
+      f->window[i] = sample;
+    }
+    f->primed = true;
+    return sample;
+  }
+  f->window[f->index] = sample;
+  f->index = f->index + 1 == f->length ? 0 : f->index + 1;
+  return FILTER_medianOf(f->window, f->length);
+}
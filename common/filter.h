@@ -0,0 +1,91 @@
+/*
+ * ================================================================
+ * File: filter.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Integer smoothing filters for ADC samples. Every filter is
+ * updated one sample at a time in constant time:
+ *  - moving average, ring buffer with a running sum. The window length is a
+ *    power of two so the division is a shift.
+ *  - exponential (first order IIR), y += (x - y) / 2^shift
+ *  - median of a small window, for rejecting single spikes. Windows of 3, 5,
+ *    7 and 9 samples go through a sorting network of min and max without
+ *    branches, so the time does not depend on the samples.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Window length of a moving average given as log2, to size its buffer
+#define FILTER_LENGTH(log2_length) (1u << (log2_length))
+
+// Longest window the median filter accepts
+#define FILTER_MEDIAN_MAX 15
+
+//=============================================================================
+typedef struct {
+  uint32_t *window;
+  uint32_t shift;
+  uint32_t index;
+  uint32_t sum;
+  bool primed;
+} tFilterMovingAverage;
+
+typedef struct {
+  // The state is kept scaled by 2^shift so no precision is lost
+  uint32_t state;
+  uint32_t shift;
+  bool primed;
+} tFilterExponential;
+
+typedef struct {
+  uint32_t *window;
+  uint32_t length;
+  uint32_t index;
+  bool primed;
+} tFilterMedian;
+
+//=============================================================================
+// window must hold FILTER_LENGTH(log2_length) samples. With 12-bit samples
+// the running sum does not overflow for windows up to 2^20.
+void FILTER_movingAverageInit(tFilterMovingAverage *f, uint32_t *window,
+                              uint32_t log2_length);
+
+// Add a sample and return the rounded average of the window. The first
+// sample fills the whole window so the output is valid from the start.
+uint32_t FILTER_movingAveragePush(tFilterMovingAverage *f, uint32_t sample);
+
+// Push count samples, returning the average after the last one
+uint32_t FILTER_movingAveragePushBlock(tFilterMovingAverage *f,
+                                       const uint32_t *samples, uint32_t count);
+
+static inline uint32_t
+FILTER_movingAverageGet(const tFilterMovingAverage *f) {
+  return (f->sum + ((1u << f->shift) >> 1)) >> f->shift;
+}
+
+//=============================================================================
+// A shift of n gives roughly the smoothing of a 2^(n+1) - 1 sample average.
+void FILTER_exponentialInit(tFilterExponential *f, uint32_t shift);
+
+uint32_t FILTER_exponentialPush(tFilterExponential *f, uint32_t sample);
+
+//=============================================================================
+// window must hold length samples, length being odd and at most
+// FILTER_MEDIAN_MAX. Any other length fails an ASSERT.
+void FILTER_medianInit(tFilterMedian *f, uint32_t *window, uint32_t length);
+
+uint32_t FILTER_medianPush(tFilterMedian *f, uint32_t sample);
+
+// Median of length samples, length being odd and at most FILTER_MEDIAN_MAX,
+// any other length fails an ASSERT. The samples are left as they were.
+uint32_t FILTER_medianOf(const uint32_t *samples, uint32_t length);
+
+#endif // FILTER_H_
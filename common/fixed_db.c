@@ -0,0 +1,82 @@
+/*
+ * ================================================================
+ * File: fixed_db.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Integer 20 * log10(x) without libm.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdint.h>
+//=============================================================================
+#include "fixed_db.h"
+
+//=============================================================================
+// log2(1 + i/32) in Q16 for i = 0..32
+static const uint32_t g_pui32Log2Table[33] = {
+    0,     2909,  5732,  8473,  11136, 13727, 16248, 18704, 21098,
+    23433, 25711, 27936, 30109, 32234, 34312, 36346, 38336, 40286,
+    42196, 44068, 45904, 47705, 49472, 51207, 52911, 54584, 56229,
+    57845, 59434, 60997, 62534, 64047, 65536};
+
+// 20 * log10(2) in Q12
+#define DB_PER_OCTAVE_Q12 24660
+
+//=============================================================================
+// Index of the highest set bit, x must not be 0. The Cortex-M4 does this in a
+// single CLZ instruction.
+static inline uint32_t DB_highestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(x);
+#else
+  uint32_t n = 0;
+  uint32_t step;
+
+  for (step = 16; step > 0; step >>= 1) {
+    if (x >= 1u << step) {
+      n += step;
+      x >>= step;
+    }
+  }
+  return n;
+#endif
+}
+
+//=============================================================================
+uint32_t DB_log2(uint32_t x) {
+  uint32_t exponent;
+  uint32_t mantissa;
+  uint32_t index;
+  uint32_t fraction;
+  uint32_t low;
+
+  if (x == 0) {
+    return 0;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Shift the highest set bit up to bit 31, the bits below it are the
+  // fraction of the mantissa 1.xxx
+  exponent = DB_highestBit(x);
+  mantissa = x << (31 - exponent);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The top 5 fraction bits select the table segment and the next 16 bits
+  // interpolate within it
+  index = (mantissa >> 26) & 31;
+  fraction = (mantissa >> 10) & 0xffff;
+  low = g_pui32Log2Table[index];
+  return (exponent << 16) +
+         low + (((g_pui32Log2Table[index + 1] - low) * fraction) >> 16);
+}
+
+//=============================================================================
+int32_t DB_fromLinear(uint32_t x) {
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // log2 in Q12 is below 2^17 and the scale below 2^15, so the Q24 product
+  // fits in 32 bits
+  uint32_t log2_q12 = (DB_log2(x) + (1 << 3)) >> 4;
+  return (int32_t)((log2_q12 * DB_PER_OCTAVE_Q12 + (1 << 15)) >> 16);
+}
@@ -0,0 +1,44 @@
+/*
+ * ================================================================
+ * File: fixed_db.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Integer conversion of a linear value to decibels,
+ * 20 * log10(x), without libm. log2(x) is found from the position of the
+ * highest set bit plus a 33 entry table of log2(1 + i/32) that is linearly
+ * interpolated, and then scaled by 20 * log10(2).
+ *
+ * Maximum error against 20 * log10(x), checked for every x in the 12-bit ADC
+ * range 1..4095: 0.0044 dB. Checked for every x up to 2^32 - 1 it stays below
+ * 0.0066 dB (0.00658 dB at x = 2182733823), see test/test_fixed_db.c. After
+ * DB_round() the whole dB value equals round(20.0 * log10(x)) for every
+ * 12-bit x except x = 944 (59.4994 dB), which is within the error of the .5
+ * boundary and rounds up to 60.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef FIXED_DB_H_
+#define FIXED_DB_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// Number of fraction bits in the returned decibel values
+#define DB_FRACTION_BITS 8
+
+//=============================================================================
+// 20 * log10(x) in Q8 (1/256 dB). Both x = 0 and x = 1 give 0 dB, since the
+// display cannot show minus infinity anyway.
+int32_t DB_fromLinear(uint32_t x);
+
+// log2(x) in Q16, 0 for x = 0
+uint32_t DB_log2(uint32_t x);
+
+// Round a Q8 decibel value to whole dB
+static inline int32_t DB_round(int32_t db_q8) {
+  return (db_q8 + (1 << (DB_FRACTION_BITS - 1))) >> DB_FRACTION_BITS;
+}
+
+#endif // FIXED_DB_H_
@@ -0,0 +1,283 @@
+/*
+ * ================================================================
+ * File: game.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Fixed time step game runtime with a back buffer.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "cycles.h"
+#include "game.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "adc_scan.h"
+#include "button_events.h"
+#include "driverlib/adc.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "inc/hw_memmap.h"
+
+// Sequencer 1 of ADC0 reads the joystick, X on AIN9 (PE4) and Y on AIN0
+// (PE3)
+#define GAME_JOYSTICK_SEQUENCE 1
+static const uint32_t g_pui32JoystickChannels[2] = {ADC_CTL_CH9, ADC_CTL_CH0};
+
+// S1 (PL1), S2 (PL2) and the joystick button (PC6), in the order of the
+// GAME_BUTTON_ bits
+#define GAME_BUTTON_COUNT 3
+#define GAME_BUTTON_EVENTS 8
+static const tBtnPin g_psGameButtons[GAME_BUTTON_COUNT] = {
+    {SYSCTL_PERIPH_GPIOL, GPIO_PORTL_BASE, GPIO_PIN_1},
+    {SYSCTL_PERIPH_GPIOL, GPIO_PORTL_BASE, GPIO_PIN_2},
+    {SYSCTL_PERIPH_GPIOC, GPIO_PORTC_BASE, GPIO_PIN_6}};
+
+//=============================================================================
+// The button events are stamped with the cycle counter, the games never
+// sleep
+static void GAME_buttonsInit(uint32_t ticks_per_second) {
+  BTN_init(g_psGameButtons, GAME_BUTTON_COUNT, ticks_per_second, CYCLES_now);
+}
+
+void GAME_inputInit(void) {
+  ADC_scanSequence(ADC0_BASE, GAME_JOYSTICK_SEQUENCE, g_pui32JoystickChannels,
+                   2);
+}
+
+//=============================================================================
+// A press is kept in pressed until an update has seen it, even when the
+// button was let go of again before this frame
+static void GAME_inputPoll(tGame *game) {
+  uint32_t joystick[2];
+  tBtnEvent events[GAME_BUTTON_EVENTS];
+  uint32_t count;
+  uint32_t bit;
+  uint32_t i;
+
+  ADC_scanFrame(ADC0_BASE, GAME_JOYSTICK_SEQUENCE, joystick);
+  game->input.joystick_x = (int32_t)joystick[0] - 2048;
+  game->input.joystick_y = (int32_t)joystick[1] - 2048;
+  count = BTN_pop(events, GAME_BUTTON_EVENTS);
+  for (i = 0; i < count; i++) {
+    bit = 1u << events[i].button;
+    if (events[i].type == BTN_PRESS) {
+      game->input.buttons |= bit;
+      game->input.pressed |= bit;
+    } else if (events[i].type == BTN_RELEASE) {
+      game->input.buttons &= ~bit;
+    }
+  }
+}
+
+#else
+//=============================================================================
+// On the host the input only changes when the test says so
+static void GAME_buttonsInit(uint32_t ticks_per_second) {}
+
+void GAME_inputInit(void) {}
+
+static void GAME_inputPoll(tGame *game) {}
+
+void GAME_hostInput(tGame *game, int32_t joystick_x, int32_t joystick_y,
+                    uint32_t buttons) {
+  game->input.joystick_x = joystick_x;
+  game->input.joystick_y = joystick_y;
+  game->input.pressed |= buttons & ~game->input.buttons;
+  game->input.buttons = buttons;
+}
+#endif
+
+//=============================================================================
+void GAME_init(tGame *game, uint32_t ticks_per_second, uint32_t update_rate,
+               tGameUpdate update, tGameRender render, void *argument) {
+  memset(game, 0, sizeof(*game));
+  game->update = update;
+  game->render = render;
+  game->argument = argument;
+  game->step = ticks_per_second / update_rate;
+  CYCLES_init();
+  GAME_buttonsInit(ticks_per_second);
+}
+
+//=============================================================================
+void GAME_run(tGame *game) {
+  while (1) {
+    GAME_frame(game, CYCLES_now());
+  }
+}
+
+//=============================================================================
+uint32_t GAME_frame(tGame *game, uint32_t now) {
+  uint32_t updates = 0;
+  uint32_t start;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The first frame only starts the clock, and draws the starting state
+  if (!game->started) {
+    game->started = true;
+    game->last_time = now;
+    game->render(game, game->argument);
+    GAME_present(game);
+    return 0;
+  }
+  game->frame_ticks_last = now - game->last_time;
+  game->last_time = now;
+  game->accumulator += game->frame_ticks_last;
+  game->frames++;
+  game->frame_ticks_total += game->frame_ticks_last;
+  if (game->frame_ticks_last > game->frame_ticks_max) {
+    game->frame_ticks_max = game->frame_ticks_last;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A button press is only reported to the first update after it
+  GAME_inputPoll(game);
+  start = CYCLES_now();
+  while (game->accumulator >= game->step && updates < GAME_MAX_CATCH_UP) {
+    game->update(game, &game->input, game->argument);
+    game->input.pressed = 0;
+    game->accumulator -= game->step;
+    updates++;
+  }
+  if (game->accumulator >= game->step) {
+    game->updates_skipped += game->accumulator / game->step;
+    game->accumulator %= game->step;
+  }
+  game->updates += updates;
+  if (updates == 0) {
+    return 0;
+  }
+  game->update_ticks_last = CYCLES_now() - start;
+  if (game->update_ticks_last > game->update_ticks_max) {
+    game->update_ticks_max = game->update_ticks_last;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  start = CYCLES_now();
+  game->render(game, game->argument);
+  GAME_present(game);
+  game->work_ticks_last = CYCLES_now() - start;
+  if (game->work_ticks_last > game->work_ticks_max) {
+    game->work_ticks_max = game->work_ticks_last;
+  }
+  return updates;
+}
+
+//=============================================================================
+void GAME_present(tGame *game) {
+  if (!game->dirty) {
+    return;
+  }
+  ST7735_blit(game->framebuffer, GAME_WIDTH, game->dirty_x0, game->dirty_y0,
+              game->dirty_x1, game->dirty_y1);
+  game->pixels_sent += (game->dirty_x1 - game->dirty_x0 + 1) *
+                       (game->dirty_y1 - game->dirty_y0 + 1);
+  game->dirty = false;
+}
+
+//=============================================================================
+void GAME_markDirty(tGame *game, int32_t x0, int32_t y0, int32_t x1,
+                    int32_t y1) {
+  if (!game->dirty) {
+    game->dirty = true;
+    game->dirty_x0 = x0;
+    game->dirty_y0 = y0;
+    game->dirty_x1 = x1;
+    game->dirty_y1 = y1;
+    return;
+  }
+  if (x0 < game->dirty_x0) {
+    game->dirty_x0 = x0;
+  }
+  if (y0 < game->dirty_y0) {
+    game->dirty_y0 = y0;
+  }
+  if (x1 > game->dirty_x1) {
+    game->dirty_x1 = x1;
+  }
+  if (y1 > game->dirty_y1) {
+    game->dirty_y1 = y1;
+  }
+}
+
+//=============================================================================
+void GAME_clear(tGame *game, uint16_t color) {
+  GAME_fillRect(game, 0, 0, GAME_WIDTH, GAME_HEIGHT, color);
+}
+
+//=============================================================================
+void GAME_fillRect(tGame *game, int32_t x, int32_t y, int32_t width,
+                   int32_t height, uint16_t color) {
+  int32_t x1 = x + width;
+  int32_t y1 = y + height;
+  uint16_t *row;
+  int32_t i;
+  int32_t j;
+
+  if (x < 0) {
+    x = 0;
+  }
+  if (y < 0) {
+    y = 0;
+  }
+  if (x1 > GAME_WIDTH) {
+    x1 = GAME_WIDTH;
+  }
+  if (y1 > GAME_HEIGHT) {
+    y1 = GAME_HEIGHT;
+  }
+  if (x >= x1 || y >= y1) {
+    return;
+  }
+  for (j = y; j < y1; j++) {
+    row = game->framebuffer + j * GAME_WIDTH;
+    for (i = x; i < x1; i++) {
+      row[i] = color;
+    }
+  }
+  GAME_markDirty(game, x, y, x1 - 1, y1 - 1);
+}
+
+//=============================================================================
+void GAME_moveRect(tGame *game, tGameRect *shown, int32_t x, int32_t y,
+                   int32_t width, int32_t height, uint16_t color,
+                   uint16_t background) {
+  int32_t dx = x - shown->x;
+
+  if (x == shown->x && y == shown->y && width == shown->width &&
+      height == shown->height) {
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A small sideways move, like a scrolling pipe, only changes a strip on
+  // each side. Those are sent one at a time, together they would cover the
+  // whole rectangle again.
+  if (y == shown->y && width == shown->width && height == shown->height &&
+      dx > -width && dx < width) {
+    if (dx < 0) {
+      GAME_fillRect(game, x + width, y, -dx, height, background);
+      GAME_present(game);
+      GAME_fillRect(game, x, y, -dx, height, color);
+    } else {
+      GAME_fillRect(game, shown->x, y, dx, height, background);
+      GAME_present(game);
+      GAME_fillRect(game, shown->x + width, y, dx, height, color);
+    }
+  } else {
+    GAME_fillRect(game, shown->x, shown->y, shown->width, shown->height,
+                  background);
+    GAME_fillRect(game, x, y, width, height, color);
+  }
+  GAME_present(game);
+  shown->x = x;
+  shown->y = y;
+  shown->width = width;
+  shown->height = height;
+}
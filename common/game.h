@@ -0,0 +1,161 @@
+/*
+ * ================================================================
+ * File: game.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Runtime shared by the 4.1 games. The game state is updated
+ * at a fixed rate, independent of how long drawing takes, and drawn into a
+ * 128 x 128 RGB565 back buffer in SRAM. After drawing only the bounding
+ * rectangle of what was touched is sent to the ST7735S, the LCD's own
+ * memory being the front buffer.
+ *
+ * Time is counted in ticks of the cycle counter, see cycles.h. The input is
+ * the joystick and the two buttons of the BoosterPack MKII. The buttons
+ * come as debounced events from their interrupts, see button_events.h, so
+ * a press shorter than a frame is not lost.
+ *
+ * With HOST_BUILD defined the input is set with GAME_hostInput() and the
+ * time is given to GAME_frame() by the caller, so a run can be replayed
+ * exactly. The LCD is the emulation in st7735.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "st7735.h"
+
+//=============================================================================
+#define GAME_WIDTH ST7735_WIDTH
+#define GAME_HEIGHT ST7735_HEIGHT
+// Updates run back to back at most this many times to catch up, beyond that
+// the game slows down instead of never getting to draw
+#define GAME_MAX_CATCH_UP 4
+
+// Buttons, S1 and S2 on the MKII and pressing the joystick. Bit n is button
+// n of the table given to BTN_init().
+#define GAME_BUTTON_S1 0x01
+#define GAME_BUTTON_S2 0x02
+#define GAME_BUTTON_SELECT 0x04
+
+// 8-bit red, green and blue to RGB565
+#define GAME_RGB(r, g, b)                                                      \
+  ((uint16_t)((((r) & 0xf8) << 8) | (((g) & 0xfc) << 3) | ((b) >> 3)))
+
+//=============================================================================
+typedef struct {
+  // Joystick position, -2048 to 2047 with 0 in the middle
+  int32_t joystick_x;
+  int32_t joystick_y;
+  // Buttons held down, and the ones that went down since the last update
+  uint32_t buttons;
+  uint32_t pressed;
+} tGameInput;
+
+// A rectangle as it is shown on the LCD, for GAME_moveRect()
+typedef struct {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+} tGameRect;
+
+typedef struct sGame tGame;
+
+typedef void (*tGameUpdate)(tGame *game, const tGameInput *input,
+                            void *argument);
+typedef void (*tGameRender)(tGame *game, void *argument);
+
+struct sGame {
+  uint16_t framebuffer[GAME_HEIGHT * GAME_WIDTH];
+  // Bounding rectangle of everything drawn since the last present
+  bool dirty;
+  int32_t dirty_x0;
+  int32_t dirty_y0;
+  int32_t dirty_x1;
+  int32_t dirty_y1;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tGameUpdate update;
+  tGameRender render;
+  void *argument;
+  tGameInput input;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Fixed time step, in ticks
+  uint32_t step;
+  uint32_t accumulator;
+  uint32_t last_time;
+  bool started;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Statistics. The frame time is from the start of one frame to the start
+  // of the next, the update time what the updates of one frame took and the
+  // work time what rendering and sending took.
+  uint32_t updates;
+  uint32_t updates_skipped;
+  uint32_t frames;
+  uint32_t frame_ticks_last;
+  uint32_t frame_ticks_max;
+  uint64_t frame_ticks_total;
+  uint32_t update_ticks_last;
+  uint32_t update_ticks_max;
+  uint32_t work_ticks_last;
+  uint32_t work_ticks_max;
+  uint32_t pixels_sent;
+};
+
+//=============================================================================
+// ticks_per_second is the rate of the cycle counter, the system clock on the
+// target. update is called update_rate times per second of game time. On
+// the target the button interrupts are enabled here.
+void GAME_init(tGame *game, uint32_t ticks_per_second, uint32_t update_rate,
+               tGameUpdate update, tGameRender render, void *argument);
+
+// Configure the joystick sequencer. The ADC and the joystick have to be
+// enabled with PERIPH_init() and SENSOR_enable(JOYSTICK). The buttons are
+// set up by GAME_init().
+void GAME_inputInit(void);
+
+// One pass of the loop at time now: read the input, run the updates that
+// are due and, if any ran, render and present. Returns the number of
+// updates run.
+uint32_t GAME_frame(tGame *game, uint32_t now);
+
+// GAME_frame() forever with the time from the cycle counter
+void GAME_run(tGame *game);
+
+// Send the dirty rectangle of the back buffer to the LCD
+void GAME_present(tGame *game);
+
+//=============================================================================
+// Drawing into the back buffer, clipped to the screen
+void GAME_clear(tGame *game, uint16_t color);
+void GAME_fillRect(tGame *game, int32_t x, int32_t y, int32_t width,
+                   int32_t height, uint16_t color);
+
+static inline void GAME_pixel(tGame *game, int32_t x, int32_t y,
+                              uint16_t color) {
+  GAME_fillRect(game, x, y, 1, 1, color);
+}
+
+// Include a rectangle in what is sent on the next present, for code that
+// writes to the framebuffer itself
+void GAME_markDirty(tGame *game, int32_t x0, int32_t y0, int32_t x1,
+                    int32_t y1);
+
+// Move a filled rectangle from where it is shown to x, y with the given
+// size and present it. Only the pixels that change are sent, a rectangle
+// that did not move sends nothing. Width 0 erases it.
+void GAME_moveRect(tGame *game, tGameRect *shown, int32_t x, int32_t y,
+                   int32_t width, int32_t height, uint16_t color,
+                   uint16_t background);
+
+#ifdef HOST_BUILD
+void GAME_hostInput(tGame *game, int32_t joystick_x, int32_t joystick_y,
+                    uint32_t buttons);
+#endif
+
+#endif // GAME_H_
@@ -0,0 +1,170 @@
+/*
+ * ================================================================
+ * File: idle.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Sleeping between interrupts, with active time accounting.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "idle.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+//=============================================================================
+#include "inc/hw_memmap.h"
+
+//=============================================================================
+// Timer 1 counts down from 2^32 - 1, so its value inverted counts up
+uint32_t IDLE_now(void) { return ~TimerValueGet(TIMER1_BASE, TIMER_A); }
+
+static void IDLE_startClock(void) {
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER1)) {
+  }
+  TimerConfigure(TIMER1_BASE, TIMER_CFG_PERIODIC);
+  TimerLoadSet(TIMER1_BASE, TIMER_A, 0xffffffff);
+  TimerEnable(TIMER1_BASE, TIMER_A);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Without clock gating every peripheral that runs keeps running in sleep
+  // mode, the timer, the ADC, the uDMA and the UART included
+  SysCtlPeripheralClockGating(false);
+}
+
+// IntMasterDisable() returns whether interrupts were already masked
+static inline bool IDLE_mask(void) { return IntMasterDisable(); }
+
+static inline void IDLE_unmask(bool was_masked) {
+  if (!was_masked) {
+    IntMasterEnable();
+  }
+}
+
+static inline void IDLE_wait(void) { SysCtlSleep(); }
+
+#else
+//=============================================================================
+// Host stand-in, time is simulated and so are the interrupts
+static uint32_t g_ui32HostNow;
+static bool g_bHostMasked;
+static tIdleHostSource g_pfnHostSource;
+static void *g_pvHostArgument;
+static uint32_t g_ui32HostNext;
+
+uint32_t IDLE_now(void) { return g_ui32HostNow; }
+
+static void IDLE_startClock(void) {}
+
+void IDLE_hostSource(tIdleHostSource source, void *argument, uint32_t first) {
+  g_pfnHostSource = source;
+  g_pvHostArgument = argument;
+  g_ui32HostNext = first;
+}
+
+// Handle the interrupts due by time until, each one at its own time
+static void IDLE_hostDeliver(uint32_t until) {
+  while (!g_bHostMasked && g_pfnHostSource != 0 &&
+         (int32_t)(until - g_ui32HostNext) >= 0) {
+    g_ui32HostNow = g_ui32HostNext;
+    g_ui32HostNext = g_pfnHostSource(g_pvHostArgument);
+  }
+  g_ui32HostNow = until;
+}
+
+void IDLE_hostRun(uint32_t cycles) {
+  IDLE_hostDeliver(g_ui32HostNow + cycles);
+}
+
+static inline bool IDLE_mask(void) {
+  bool was_masked = g_bHostMasked;
+
+  g_bHostMasked = true;
+  return was_masked;
+}
+
+static inline void IDLE_unmask(bool was_masked) {
+  g_bHostMasked = was_masked;
+  IDLE_hostDeliver(g_ui32HostNow);
+}
+
+// WFI returns at once when an interrupt is already pending, otherwise time
+// passes until the next one
+static inline void IDLE_wait(void) {
+  if (g_pfnHostSource != 0 &&
+      (int32_t)(g_ui32HostNext - g_ui32HostNow) > 0) {
+    g_ui32HostNow = g_ui32HostNext;
+  }
+}
+#endif
+
+//=============================================================================
+void IDLE_init(tIdle *idle, uint32_t system_clock, uint32_t window_ms) {
+  IDLE_startClock();
+  idle->system_clock = system_clock;
+  idle->window = system_clock / 1000 * window_ms;
+  idle->window_start = IDLE_now();
+  idle->window_sleep = 0;
+  idle->active_percent = 100;
+  idle->windows = 0;
+  idle->sleeps = 0;
+  idle->skipped = 0;
+}
+
+//=============================================================================
+void IDLE_setClock(tIdle *idle, uint32_t system_clock) {
+  idle->window =
+      (uint32_t)((uint64_t)idle->window * system_clock / idle->system_clock);
+  idle->system_clock = system_clock;
+  idle->window_start = IDLE_now();
+  idle->window_sleep = 0;
+}
+
+//=============================================================================
+void IDLE_sleep(tIdle *idle, tIdlePending pending, void *argument) {
+  bool was_masked = IDLE_mask();
+  uint32_t start;
+  uint32_t elapsed;
+
+  if (pending != 0 && pending(argument)) {
+    idle->skipped++;
+  } else {
+    start = IDLE_now();
+    IDLE_wait();
+    idle->window_sleep += IDLE_now() - start;
+    idle->sleeps++;
+  }
+  IDLE_unmask(was_masked);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  elapsed = IDLE_now() - idle->window_start;
+  if (elapsed >= idle->window) {
+    idle->active_percent =
+        (uint32_t)((uint64_t)(elapsed - idle->window_sleep) * 100 / elapsed);
+    idle->window_start += elapsed;
+    idle->window_sleep = 0;
+    idle->windows++;
+  }
+}
+
+//=============================================================================
+void IDLE_latency(tIdleLatency *latency, uint32_t since) {
+  latency->last = IDLE_now() - since;
+  if (latency->last > latency->max) {
+    latency->max = latency->last;
+  }
+  latency->count++;
+}
+
+//=============================================================================
+uint32_t IDLE_microseconds(const tIdle *idle, uint32_t cycles) {
+  return (uint32_t)((uint64_t)cycles * 1000000 / idle->system_clock);
+}
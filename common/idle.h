@@ -0,0 +1,100 @@
+/*
+ * ================================================================
+ * File: idle.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Sleep while there is nothing to do. Instead of spinning on
+ * flags the main loop calls IDLE_sleep() with a function that tells whether
+ * work is waiting, and the core stops in WFI (SysCtlSleep()) until the next
+ * interrupt. The ADC, the SysTick, the UART and GPIO interrupts all wake
+ * it the same way.
+ *
+ * The check and the WFI are done with interrupts masked. An interrupt that
+ * arrives between them stays pending, and a pending interrupt ends WFI at
+ * once even while masked, so no wake-up can be lost. The handler runs as
+ * soon as the mask is lifted after the WFI.
+ *
+ * The cycle counter stops while the core sleeps, so time is measured with
+ * timer 1 instead, counting system clock cycles whether the core sleeps or
+ * not. IDLE_now() reads it, and every window the share of the time the
+ * core was awake is worked out as active_percent.
+ *
+ * With HOST_BUILD defined there is neither timer nor WFI. Time only moves
+ * with IDLE_hostRun() and while asleep, and the interrupts come from a
+ * simulated source set with IDLE_hostSource(), delivered only when they are
+ * not masked.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef IDLE_H_
+#define IDLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Returns true when there is work waiting. Called with interrupts masked.
+typedef bool (*tIdlePending)(void *argument);
+
+typedef struct {
+  uint32_t system_clock;
+  // Length of a measuring window in timer cycles
+  uint32_t window;
+  uint32_t window_start;
+  uint32_t window_sleep;
+  // Share of the last window the core was awake, and the number of windows
+  // finished. active_percent is new whenever windows changes.
+  uint32_t active_percent;
+  uint32_t windows;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint32_t sleeps;
+  // Calls that found work waiting and did not sleep
+  uint32_t skipped;
+} tIdle;
+
+// Time from an event to the response to it, in timer cycles
+typedef struct {
+  uint32_t last;
+  uint32_t max;
+  uint32_t count;
+} tIdleLatency;
+
+//=============================================================================
+// Start timer 1 free running at the system clock. active_percent is worked
+// out every window_ms milliseconds.
+void IDLE_init(tIdle *idle, uint32_t system_clock, uint32_t window_ms);
+
+// The system clock changed, timer 1 now counts at system_clock. The window
+// starts over.
+void IDLE_setClock(tIdle *idle, uint32_t system_clock);
+
+// Timer cycles since IDLE_init(), also counting while asleep
+uint32_t IDLE_now(void);
+
+// Sleep until the next interrupt unless pending (if not 0) says there is
+// work waiting. Returns after at most one sleep, with the interrupt that
+// ended it handled.
+void IDLE_sleep(tIdle *idle, tIdlePending pending, void *argument);
+
+// Record the time from since (an IDLE_now() reading) until now
+void IDLE_latency(tIdleLatency *latency, uint32_t since);
+
+// Timer cycles in microseconds
+uint32_t IDLE_microseconds(const tIdle *idle, uint32_t cycles);
+
+#ifdef HOST_BUILD
+// The simulated interrupt: handle the interrupt that is due now and return
+// the time of the next one
+typedef uint32_t (*tIdleHostSource)(void *argument);
+
+// The first interrupt comes at time first
+void IDLE_hostSource(tIdleHostSource source, void *argument, uint32_t first);
+
+// Let cycles pass awake, the interrupts that come due are handled at their
+// time unless they are masked
+void IDLE_hostRun(uint32_t cycles);
+#endif
+
+#endif // IDLE_H_
@@ -0,0 +1,67 @@
+/*
+ * ================================================================
+ * File: joystick.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Deadzone, end stops and hysteresis for a joystick axis.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "joystick.h"
+
+//=============================================================================
+void JOY_axisInit(tJoyAxis *axis, const tJoyAxisConfig *config) {
+  axis->config = config;
+  axis->position = 0;
+}
+
+//=============================================================================
+// Between the edge of the deadzone and the end stop the position is linear,
+// each side of the centre with its own slope
+int32_t JOY_axisMap(const tJoyAxisConfig *config, uint32_t reading) {
+  int32_t value = (int32_t)reading;
+  int32_t start;
+
+  if (value >= config->high_stop) {
+    return JOY_FULL;
+  }
+  if (value <= config->low_stop) {
+    return -JOY_FULL;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  start = config->centre + config->deadzone;
+  if (value > start) {
+    return (value - start) * JOY_FULL / (config->high_stop - start);
+  }
+  start = config->centre - config->deadzone;
+  if (value < start) {
+    return -((start - value) * JOY_FULL / (start - config->low_stop));
+  }
+  return 0;
+}
+
+//=============================================================================
+bool JOY_axisUpdate(tJoyAxis *axis, uint32_t reading) {
+  int32_t position = JOY_axisMap(axis->config, reading);
+  int32_t moved = position - axis->position;
+
+  if (moved == 0) {
+    return false;
+  }
+  // The centre and the ends have to be reachable, a band would otherwise
+  // keep the position just short of them
+  if (position == 0 || position == JOY_FULL || position == -JOY_FULL ||
+      moved >= axis->config->hysteresis ||
+      moved <= -axis->config->hysteresis) {
+    axis->position = position;
+    return true;
+  }
+  return false;
+}
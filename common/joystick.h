@@ -0,0 +1,59 @@
+/*
+ * ================================================================
+ * File: joystick.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Conditioning of one joystick axis. The filtered reading is
+ * turned into a position from -JOY_FULL to JOY_FULL:
+ *  - a deadzone around the centre reads as exactly 0, the stick never comes
+ *    back to precisely the same reading
+ *  - everything beyond the end stops reads as exactly +-JOY_FULL, the stick
+ *    does not reach 0 and 4095 either, and in between the position is
+ *    linear
+ *  - hysteresis, the position only follows once the stick has moved a band
+ *    away from it, so noise of a few counts does not make it flicker. The
+ *    centre and the ends are always taken at once.
+ *
+ * Each axis has its own configuration, the two axes of a stick rarely have
+ * the same centre.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef JOYSTICK_H_
+#define JOYSTICK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+#define JOY_FULL 2048
+
+//=============================================================================
+typedef struct {
+  // Reading at rest, and how far either side of it still reads as 0
+  int32_t centre;
+  int32_t deadzone;
+  // Readings at and beyond these are -JOY_FULL and JOY_FULL
+  int32_t low_stop;
+  int32_t high_stop;
+  // Width of the hysteresis band, in position units
+  int32_t hysteresis;
+} tJoyAxisConfig;
+
+typedef struct {
+  const tJoyAxisConfig *config;
+  int32_t position;
+} tJoyAxis;
+
+//=============================================================================
+void JOY_axisInit(tJoyAxis *axis, const tJoyAxisConfig *config);
+
+// Position a reading maps to, without the hysteresis
+int32_t JOY_axisMap(const tJoyAxisConfig *config, uint32_t reading);
+
+// Update the position from a filtered reading. Returns true if it changed.
+bool JOY_axisUpdate(tJoyAxis *axis, uint32_t reading);
+
+#endif // JOYSTICK_H_
@@ -0,0 +1,291 @@
+/*
+ * ================================================================
+ * File: orientation.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Integer CORDIC pitch and roll with a stored calibration.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "orientation.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/eeprom.h"
+#include "driverlib/sysctl.h"
+#endif
+
+//=============================================================================
+#define ORIENT_CORDIC_STEPS 20
+// atan(2^-i) in Q16.16 degrees. After the last step the angle is off by at
+// most the last entry, well below a thousandth of a degree.
+static const int32_t g_pi32OrientAtan[ORIENT_CORDIC_STEPS] = {
+    2949120, 1740967, 919879, 466945, 234379, 117304, 58666,
+    29335,   14668,   7334,   3667,   1833,   917,    458,
+    229,     115,     57,     29,     14,     7};
+// Every step makes the vector longer, after all of them by 1.64676, this is
+// 1 / 1.64676 in Q30
+#define ORIENT_CORDIC_GAIN_Q30 652032874u
+#define ORIENT_180_DEGREES (180 << 16)
+// The vector is scaled up to just below 2^29 before the steps. That keeps
+// the most bits of the small readings and still leaves room for the growth,
+// 2^29 * 1.65 * sqrt(2) is below 2^31.
+#define ORIENT_CORDIC_TOP 28
+// Typical sensitivity of the KXTC9 accelerometer at 3.3 V, in 12-bit counts
+#define ORIENT_DEFAULT_COUNTS_PER_G 819
+
+//=============================================================================
+// Index of the highest set bit, x must not be 0
+static inline uint32_t ORIENT_highestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(x);
+#else
+  uint32_t n = 0;
+  uint32_t step;
+
+  for (step = 16; step > 0; step >>= 1) {
+    if (x >= 1u << step) {
+      n += step;
+      x >>= step;
+    }
+  }
+  return n;
+#endif
+}
+
+//=============================================================================
+int32_t ORIENT_atan2(int32_t y, int32_t x, uint32_t *magnitude) {
+  uint32_t largest;
+  int32_t shift;
+  int32_t angle = 0;
+  int32_t next_x;
+  uint32_t length;
+  uint32_t i;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Or-ing the two has the same highest bit as the larger of them
+  largest = (uint32_t)(x < 0 ? -x : x) | (uint32_t)(y < 0 ? -y : y);
+  if (largest == 0) {
+    if (magnitude != 0) {
+      *magnitude = 0;
+    }
+    return 0;
+  }
+  shift = ORIENT_CORDIC_TOP - (int32_t)ORIENT_highestBit(largest);
+  if (shift >= 0) {
+    x = (int32_t)((uint32_t)x << shift);
+    y = (int32_t)((uint32_t)y << shift);
+  } else {
+    x >>= -shift;
+    y >>= -shift;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The steps only reach +-99 degrees, so a vector pointing left is turned
+  // round by 180 degrees first
+  if (x < 0) {
+    angle = y >= 0 ? ORIENT_180_DEGREES : -ORIENT_180_DEGREES;
+    x = -x;
+    y = -y;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Turn the vector by +-atan(2^-i) towards the X axis, what it was turned
+  // by in total is its angle. Only shifts and adds.
+  for (i = 0; i < ORIENT_CORDIC_STEPS; i++) {
+    if (y > 0) {
+      next_x = x + (y >> i);
+      y -= x >> i;
+      angle += g_pi32OrientAtan[i];
+    } else {
+      next_x = x - (y >> i);
+      y += x >> i;
+      angle -= g_pi32OrientAtan[i];
+    }
+    x = next_x;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The vector now lies on the X axis, x is its length times the growth
+  if (magnitude != 0) {
+    length = (uint32_t)(((uint64_t)x * ORIENT_CORDIC_GAIN_Q30) >> 30);
+    *magnitude = shift >= 0 ? (length + (1u << shift >> 1)) >> shift
+                            : length << -shift;
+  }
+  return angle;
+}
+
+//=============================================================================
+void ORIENT_update(const tOrientCalibration *calibration,
+                   const uint32_t *raw, tOrientation *orientation) {
+  int32_t axis[ORIENT_AXES];
+  uint32_t yz;
+  uint32_t i;
+
+  // The calibrated axes keep 8 bits below the count. Cut off at the count,
+  // a tilted axis reading only a few counts would make the angle jump.
+  for (i = 0; i < ORIENT_AXES; i++) {
+    axis[i] = (int32_t)(((int64_t)((int32_t)raw[i] - calibration->offset[i]) *
+                         calibration->gain[i]) >>
+                        8);
+  }
+  // The roll turns about the X axis, the pitch is how far X is tilted out
+  // of the plane of Y and Z
+  orientation->roll = ORIENT_atan2(axis[1], axis[2], &yz);
+  orientation->pitch =
+      ORIENT_atan2(-axis[0], (int32_t)yz, &orientation->magnitude);
+  orientation->magnitude = (orientation->magnitude + 0x80) >> 8;
+}
+
+//=============================================================================
+void ORIENT_calibrationDefault(tOrientCalibration *calibration) {
+  uint32_t i;
+
+  for (i = 0; i < ORIENT_AXES; i++) {
+    calibration->offset[i] = 2048;
+    calibration->gain[i] =
+        ((int32_t)ORIENT_ONE_G << 16) / ORIENT_DEFAULT_COUNTS_PER_G;
+  }
+}
+
+//=============================================================================
+void ORIENT_captureStart(tOrientCapture *capture) {
+  uint32_t i;
+
+  for (i = 0; i < ORIENT_AXES; i++) {
+    capture->min[i] = 0xffffffff;
+    capture->max[i] = 0;
+  }
+  capture->samples = 0;
+}
+
+void ORIENT_captureAdd(tOrientCapture *capture, const uint32_t *raw) {
+  uint32_t i;
+
+  for (i = 0; i < ORIENT_AXES; i++) {
+    if (raw[i] < capture->min[i]) {
+      capture->min[i] = raw[i];
+    }
+    if (raw[i] > capture->max[i]) {
+      capture->max[i] = raw[i];
+    }
+  }
+  capture->samples++;
+}
+
+//=============================================================================
+// Straight up and straight down are the two ends, 0 g is halfway between
+// them and 1 g is half the distance
+bool ORIENT_captureFinish(const tOrientCapture *capture,
+                          tOrientCalibration *calibration) {
+  uint32_t i;
+
+  for (i = 0; i < ORIENT_AXES; i++) {
+    if (capture->samples == 0 ||
+        capture->max[i] - capture->min[i] < ORIENT_MIN_RANGE) {
+      return false;
+    }
+  }
+  for (i = 0; i < ORIENT_AXES; i++) {
+    calibration->offset[i] =
+        (int32_t)((capture->min[i] + capture->max[i] + 1) / 2);
+    calibration->gain[i] = (int32_t)(((uint32_t)ORIENT_ONE_G << 17) /
+                                     (capture->max[i] - capture->min[i]));
+  }
+  return true;
+}
+
+//=============================================================================
+// What is kept in the EEPROM, whole words only
+#define ORIENT_MAGIC 0x544e524f
+typedef struct {
+  uint32_t magic;
+  tOrientCalibration calibration;
+  uint32_t check;
+} tOrientRecord;
+
+#define ORIENT_RECORD_WORDS (sizeof(tOrientRecord) / 4)
+
+static uint32_t ORIENT_check(const tOrientRecord *record) {
+  const uint32_t *words = (const uint32_t *)record;
+  uint32_t sum = 0;
+  uint32_t i;
+
+  for (i = 0; i < ORIENT_RECORD_WORDS - 1; i++) {
+    sum = (sum << 1 | sum >> 31) + words[i];
+  }
+  return ~sum;
+}
+
+#ifndef HOST_BUILD
+//=============================================================================
+static bool ORIENT_eepromInit(void) {
+  static bool ready;
+
+  if (!ready) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0)) {
+    }
+    ready = EEPROMInit() == EEPROM_INIT_OK;
+  }
+  return ready;
+}
+
+static void ORIENT_eepromRead(tOrientRecord *record) {
+  EEPROMRead((uint32_t *)record, ORIENT_EEPROM_ADDRESS, sizeof(*record));
+}
+
+static bool ORIENT_eepromWrite(tOrientRecord *record) {
+  return EEPROMProgram((uint32_t *)record, ORIENT_EEPROM_ADDRESS,
+                       sizeof(*record)) == 0;
+}
+
+#else
+//=============================================================================
+// Host stand-in, the EEPROM lasts as long as the process
+static tOrientRecord g_sHostEEPROM;
+
+static bool ORIENT_eepromInit(void) { return true; }
+
+static void ORIENT_eepromRead(tOrientRecord *record) {
+  memcpy(record, &g_sHostEEPROM, sizeof(*record));
+}
+
+static bool ORIENT_eepromWrite(tOrientRecord *record) {
+  memcpy(&g_sHostEEPROM, record, sizeof(*record));
+  return true;
+}
+#endif
+
+//=============================================================================
+bool ORIENT_load(tOrientCalibration *calibration) {
+  tOrientRecord record;
+
+  if (ORIENT_eepromInit()) {
+    ORIENT_eepromRead(&record);
+    if (record.magic == ORIENT_MAGIC && record.check == ORIENT_check(&record)) {
+      *calibration = record.calibration;
+      return true;
+    }
+  }
+  ORIENT_calibrationDefault(calibration);
+  return false;
+}
+
+//=============================================================================
+bool ORIENT_save(const tOrientCalibration *calibration) {
+  tOrientRecord record;
+
+  if (!ORIENT_eepromInit()) {
+    return false;
+  }
+  record.magic = ORIENT_MAGIC;
+  record.calibration = *calibration;
+  record.check = ORIENT_check(&record);
+  return ORIENT_eepromWrite(&record);
+}
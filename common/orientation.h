@@ -0,0 +1,91 @@
+/*
+ * ================================================================
+ * File: orientation.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Pitch and roll from the accelerometer of the BoosterPack
+ * MKII, in integers only. Each axis is calibrated with an offset and a gain,
+ * then a CORDIC in vectoring mode turns the Y and Z axes into the roll angle
+ * and the length of the vector, and a second one turns X and that length
+ * into the pitch. Angles are Q16.16 degrees, the roll from -180 to 180 and
+ * the pitch from -90 to 90.
+ *
+ * The calibration is found by turning the board so that every axis points
+ * straight up and straight down once while the readings are captured. Each
+ * axis then reads the same for 1 g either way. It is kept in the on-chip
+ * EEPROM, so a calibrated board starts up calibrated.
+ *
+ * With HOST_BUILD defined the EEPROM is an array in RAM.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef ORIENTATION_H_
+#define ORIENTATION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+#define ORIENT_AXES 3
+// A calibrated axis reads ORIENT_ONE_G for 1 g
+#define ORIENT_ONE_G 4096
+// A capture where an axis moved less than this many counts from one end to
+// the other is not trusted, the board was not turned all the way round
+#define ORIENT_MIN_RANGE 400
+// Where the calibration is kept in the EEPROM, a multiple of 4
+#define ORIENT_EEPROM_ADDRESS 0
+// Q16.16 degrees to whole degrees, rounded to nearest
+#define ORIENT_DEGREES(angle) (((angle) + 0x8000) >> 16)
+
+//=============================================================================
+typedef struct {
+  // Raw reading at 0 g
+  int32_t offset[ORIENT_AXES];
+  // Q16, raw counts from the offset to ORIENT_ONE_G counts
+  int32_t gain[ORIENT_AXES];
+} tOrientCalibration;
+
+// Extremes seen while the board is turned round
+typedef struct {
+  uint32_t min[ORIENT_AXES];
+  uint32_t max[ORIENT_AXES];
+  uint32_t samples;
+} tOrientCapture;
+
+typedef struct {
+  int32_t pitch;
+  int32_t roll;
+  // Length of the calibrated vector, ORIENT_ONE_G at rest
+  uint32_t magnitude;
+} tOrientation;
+
+//=============================================================================
+// Angle of (x, y) in Q16.16 degrees, and if magnitude is not 0 the length of
+// the vector
+int32_t ORIENT_atan2(int32_t y, int32_t x, uint32_t *magnitude);
+
+// Pitch and roll from raw 12-bit readings of the X, Y and Z axis
+void ORIENT_update(const tOrientCalibration *calibration,
+                   const uint32_t *raw, tOrientation *orientation);
+
+//=============================================================================
+// Until the board is calibrated, 0 g is the middle of the ADC range and
+// 1 g the typical sensitivity of the accelerometer
+void ORIENT_calibrationDefault(tOrientCalibration *calibration);
+
+void ORIENT_captureStart(tOrientCapture *capture);
+void ORIENT_captureAdd(tOrientCapture *capture, const uint32_t *raw);
+// Work out the calibration from the capture. Returns false and leaves the
+// calibration as it was if an axis did not move far enough.
+bool ORIENT_captureFinish(const tOrientCapture *capture,
+                          tOrientCalibration *calibration);
+
+//=============================================================================
+// Read the calibration from the EEPROM. Returns false and sets the default
+// if there is none or it is damaged.
+bool ORIENT_load(tOrientCalibration *calibration);
+bool ORIENT_save(const tOrientCalibration *calibration);
+
+#endif // ORIENTATION_H_
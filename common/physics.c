@@ -0,0 +1,207 @@
+/*
+ * ================================================================
+ * File: physics.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Q16.16 physics with swept box collision.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "physics.h"
+
+//=============================================================================
+// Times of a sweep are Q16.16 fractions of the path but kept in 64 bits,
+// since a box far away gives a time far beyond 1
+#define PHYS_NEVER INT64_MAX
+
+//=============================================================================
+void PHYS_accelerate(tPhysBody *body, tQ16 ax, tQ16 ay, tQ16 dt) {
+  body->vx += PHYS_mul(ax, dt);
+  body->vy += PHYS_mul(ay, dt);
+}
+
+//=============================================================================
+bool PHYS_overlap(const tPhysBox *a, const tPhysBox *b) {
+  return a->x < b->x + b->width && a->x + a->width > b->x &&
+         a->y < b->y + b->height && a->y + a->height > b->y;
+}
+
+//=============================================================================
+// When the box enters and leaves the target along one axis. Returns false
+// if that never happens.
+static bool PHYS_axis(tQ16 position, tQ16 size, tQ16 d, tQ16 target,
+                      tQ16 target_size, int64_t *entry, int64_t *exit) {
+  int64_t near;
+  int64_t far;
+
+  if (d == 0) {
+    if (position < target + target_size && position + size > target) {
+      *entry = -PHYS_NEVER;
+      *exit = PHYS_NEVER;
+      return true;
+    }
+    return false;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Distances to the near and the far side of the target. The division
+  // rounds towards zero, which makes the time of entry slightly early
+  // rather than late, so the box is never moved into the target.
+  if (d > 0) {
+    near = (int64_t)target - (position + size);
+    far = (int64_t)target + target_size - position;
+  } else {
+    near = (int64_t)target + target_size - position;
+    far = (int64_t)target - (position + size);
+  }
+  *entry = near * PHYS_ONE / d;
+  *exit = far * PHYS_ONE / d;
+  return true;
+}
+
+//=============================================================================
+bool PHYS_sweep(const tPhysBox *box, tQ16 dx, tQ16 dy,
+                const tPhysBox *target, tPhysHit *hit) {
+  int64_t entry_x;
+  int64_t entry_y;
+  int64_t exit_x;
+  int64_t exit_y;
+  int64_t entry;
+  int64_t exit;
+
+  if (!PHYS_axis(box->x, box->width, dx, target->x, target->width, &entry_x,
+                 &exit_x) ||
+      !PHYS_axis(box->y, box->height, dy, target->y, target->height,
+                 &entry_y, &exit_y)) {
+    return false;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Inside on both axes at the same time, during this move. Entering and
+  // leaving at the same moment is only grazing a corner.
+  entry = entry_x > entry_y ? entry_x : entry_y;
+  exit = exit_x < exit_y ? exit_x : exit_y;
+  if (entry >= exit || entry < 0 || entry > PHYS_ONE) {
+    return false;
+  }
+  hit->time = (tQ16)entry;
+  hit->normal_x = 0;
+  hit->normal_y = 0;
+  if (entry_x > entry_y) {
+    hit->normal_x = dx > 0 ? -1 : 1;
+  } else {
+    hit->normal_y = dy > 0 ? -1 : 1;
+  }
+  return true;
+}
+
+//=============================================================================
+int32_t PHYS_move(tPhysBody *body, tQ16 *time, const tPhysBox *boxes,
+                  uint32_t mask, tPhysHit *hit) {
+  tQ16 dx = PHYS_mul(body->vx, *time);
+  tQ16 dy = PHYS_mul(body->vy, *time);
+  int32_t first = -1;
+  tPhysHit candidate;
+  uint32_t i;
+
+  for (i = 0; i < PHYS_MAX_BOXES && mask != 0; i++, mask >>= 1) {
+    if ((mask & 1) && PHYS_sweep(&body->box, dx, dy, &boxes[i], &candidate) &&
+        (first < 0 || candidate.time < hit->time)) {
+      *hit = candidate;
+      first = i;
+    }
+  }
+  if (first < 0) {
+    body->box.x += dx;
+    body->box.y += dy;
+    *time = 0;
+    return -1;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only as far as the hit, rounding towards zero again so that the body
+  // stops short of the box rather than in it
+  body->box.x += (tQ16)((int64_t)dx * hit->time / PHYS_ONE);
+  body->box.y += (tQ16)((int64_t)dy * hit->time / PHYS_ONE);
+  *time -= PHYS_mul(*time, hit->time);
+  return first;
+}
+
+//=============================================================================
+void PHYS_bounce(tPhysBody *body, const tPhysHit *hit) {
+  if (hit->normal_x != 0) {
+    body->vx = -body->vx;
+  }
+  if (hit->normal_y != 0) {
+    body->vy = -body->vy;
+  }
+}
+
+//=============================================================================
+void PHYS_paddleBounce(tPhysBody *body, const tPhysBox *paddle,
+                       const tPhysHit *hit, tQ16 max_slope) {
+  tQ16 speed = body->vx < 0 ? -body->vx : body->vx;
+  int64_t offset;
+  tQ16 reach;
+
+  if (hit->normal_x == 0) {
+    PHYS_bounce(body, hit);
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Distance between the middles, as a fraction of the largest distance at
+  // which the two can touch
+  reach = (paddle->height + body->box.height) / 2;
+  offset = ((int64_t)body->box.y + body->box.height / 2) -
+           ((int64_t)paddle->y + paddle->height / 2);
+  offset = offset * PHYS_ONE / reach;
+  if (offset > PHYS_ONE) {
+    offset = PHYS_ONE;
+  } else if (offset < -PHYS_ONE) {
+    offset = -PHYS_ONE;
+  }
+  body->vx = hit->normal_x * speed;
+  body->vy = PHYS_mul(PHYS_mul(speed, (tQ16)offset), max_slope);
+}
+
+//=============================================================================
+void PHYS_poolInit(tPhysPool *pool) { memset(pool, 0, sizeof(*pool)); }
+
+//=============================================================================
+int32_t PHYS_poolAdd(tPhysPool *pool, const tPhysBox *box) {
+  uint32_t i;
+
+  for (i = 0; i < PHYS_POOL_SIZE; i++) {
+    if (!(pool->active & (1u << i))) {
+      pool->box[i] = *box;
+      pool->active |= 1u << i;
+      return i;
+    }
+  }
+  return -1;
+}
+
+void PHYS_poolRemove(tPhysPool *pool, uint32_t number) {
+  pool->active &= ~(1u << number);
+}
+
+//=============================================================================
+void PHYS_poolShift(tPhysPool *pool, tQ16 dx, tQ16 dy) {
+  uint32_t i;
+
+  for (i = 0; i < PHYS_POOL_SIZE; i++) {
+    if (!(pool->active & (1u << i))) {
+      continue;
+    }
+    pool->box[i].x += dx;
+    pool->box[i].y += dy;
+    if (pool->box[i].x + pool->box[i].width <= 0) {
+      PHYS_poolRemove(pool, i);
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ * ================================================================
+ * File: physics.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Fixed-point physics for the 4.1 games. Positions, sizes and
+ * velocities are Q16.16 pixels and pixels per second, time is Q16.16
+ * seconds. Integer arithmetic only, so a run gives the same result bit for
+ * bit every time and on every machine.
+ *
+ * Bodies are axis aligned boxes. Moving one sweeps it along its path, so a
+ * body that covers more than its own size in one update still stops at
+ * whatever it would have hit instead of passing through.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef PHYSICS_H_
+#define PHYSICS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+typedef int32_t tQ16;
+
+#define PHYS_ONE ((tQ16)1 << 16)
+#define PHYS_FROM_INT(i) ((tQ16)(i) * PHYS_ONE)
+// Rounds towards minus infinity, so a box that is partly on pixel -1 is
+// drawn from pixel -1
+#define PHYS_TO_INT(q) ((int32_t)((q) >> 16))
+// a / b in Q16.16, for example PHYS_RATIO(1, 60) for 1/60 s
+#define PHYS_RATIO(a, b) ((tQ16)(((int64_t)(a) << 16) / (b)))
+// Boxes that can be tested in one call
+#define PHYS_MAX_BOXES 32
+#define PHYS_POOL_SIZE 8
+
+static inline tQ16 PHYS_mul(tQ16 a, tQ16 b) {
+  return (tQ16)(((int64_t)a * b) >> 16);
+}
+
+//=============================================================================
+// Top left corner and size
+typedef struct {
+  tQ16 x;
+  tQ16 y;
+  tQ16 width;
+  tQ16 height;
+} tPhysBox;
+
+typedef struct {
+  tPhysBox box;
+  tQ16 vx;
+  tQ16 vy;
+} tPhysBody;
+
+// Where a sweep hit. time is the fraction of the path travelled, the normal
+// is the side of the box that was hit, -1, 0 or 1 on each axis.
+typedef struct {
+  tQ16 time;
+  int32_t normal_x;
+  int32_t normal_y;
+} tPhysHit;
+
+// Boxes that come and go, for example the pipes. active has one bit per
+// box, boxes are reused instead of allocated.
+typedef struct {
+  tPhysBox box[PHYS_POOL_SIZE];
+  uint32_t active;
+} tPhysPool;
+
+//=============================================================================
+// Add acceleration times dt to the velocity, before moving
+void PHYS_accelerate(tPhysBody *body, tQ16 ax, tQ16 ay, tQ16 dt);
+
+// Whether two boxes overlap. Boxes that only touch do not.
+bool PHYS_overlap(const tPhysBox *a, const tPhysBox *b);
+
+// Sweep box along dx, dy against target. Returns true and fills hit if it
+// gets into the target on the way. A box that already overlaps the target
+// does not hit it, so it can get out again.
+bool PHYS_sweep(const tPhysBox *box, tQ16 dx, tQ16 dy,
+                const tPhysBox *target, tPhysHit *hit);
+
+// Move body with its velocity for *time seconds, or until it hits the first
+// of the boxes whose bit is set in mask. The body is left touching that box
+// and *time is set to the time that was not used. Returns the number of the
+// box that was hit, or -1 when nothing was.
+int32_t PHYS_move(tPhysBody *body, tQ16 *time, const tPhysBox *boxes,
+                  uint32_t mask, tPhysHit *hit);
+
+// Mirror the velocity on the side that was hit
+void PHYS_bounce(tPhysBody *body, const tPhysHit *hit);
+
+// Bounce off the face of a paddle. The further from the middle of the
+// paddle the body hits, the steeper it leaves: at the ends the vertical
+// speed is max_slope times the horizontal speed. A hit on the top or the
+// bottom of the paddle is a plain bounce.
+void PHYS_paddleBounce(tPhysBody *body, const tPhysBox *paddle,
+                       const tPhysHit *hit, tQ16 max_slope);
+
+//=============================================================================
+void PHYS_poolInit(tPhysPool *pool);
+
+// Take a free box. Returns its number, or -1 when all are in use.
+int32_t PHYS_poolAdd(tPhysPool *pool, const tPhysBox *box);
+
+void PHYS_poolRemove(tPhysPool *pool, uint32_t number);
+
+// Move every box by dx, dy and free the ones that end up completely left of
+// x = 0
+void PHYS_poolShift(tPhysPool *pool, tQ16 dx, tQ16 dy);
+
+#endif // PHYSICS_H_
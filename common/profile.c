@@ -0,0 +1,207 @@
+/*
+ * ================================================================
+ * File: profile.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Per stage cycle statistics and histograms.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "cycles.h"
+#include "profile.h"
+#include "uart_console.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/interrupt.h"
+
+// IntMasterDisable() returns whether interrupts were already masked
+static inline bool PROF_mask(void) { return IntMasterDisable(); }
+
+static inline void PROF_unmask(bool was_masked) {
+  if (!was_masked) {
+    IntMasterEnable();
+  }
+}
+
+#else
+//=============================================================================
+// Host stand-in, the signals are the interrupts
+#include <signal.h>
+
+static inline bool PROF_mask(void) {
+  sigset_t all;
+  sigset_t old;
+
+  sigfillset(&all);
+  sigprocmask(SIG_BLOCK, &all, &old);
+  return sigismember(&old, SIGALRM);
+}
+
+static inline void PROF_unmask(bool was_masked) {
+  sigset_t all;
+
+  if (!was_masked) {
+    sigfillset(&all);
+    sigprocmask(SIG_UNBLOCK, &all, 0);
+  }
+}
+#endif
+
+//=============================================================================
+static tProfStage g_psProfStages[PROF_MAX_STAGES];
+static uint32_t g_ui32ProfStageCount;
+
+//=============================================================================
+// The bin of a duration is the index of its highest set bit. The Cortex-M4
+// does this in a single CLZ instruction.
+static inline uint32_t PROF_bin(uint32_t cycles) {
+  if (cycles < 2) {
+    return 0;
+  }
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(cycles);
+#else
+  {
+    uint32_t n = 0;
+    uint32_t step;
+
+    for (step = 16; step > 0; step >>= 1) {
+      if (cycles >= 1u << step) {
+        n += step;
+        cycles >>= step;
+      }
+    }
+    return n;
+  }
+#endif
+}
+
+static void PROF_clear(tProfStage *stage) {
+  const char *name = stage->name;
+
+  memset(stage, 0, sizeof(*stage));
+  stage->name = name;
+  stage->min = 0xffffffff;
+}
+
+//=============================================================================
+// An interrupt that registers its stage between the read of the count and
+// its increment would get the same slot, so the registration is masked.
+// Once registered a stage only reads its id.
+uint32_t PROF_begin(uint32_t *stage, const char *name) {
+  bool was_masked;
+
+  if (*stage == PROF_STAGE_NONE) {
+    was_masked = PROF_mask();
+    if (*stage == PROF_STAGE_NONE &&
+        g_ui32ProfStageCount < PROF_MAX_STAGES) {
+      CYCLES_init();
+      g_psProfStages[g_ui32ProfStageCount].name = name;
+      PROF_clear(&g_psProfStages[g_ui32ProfStageCount]);
+      *stage = g_ui32ProfStageCount++;
+    }
+    PROF_unmask(was_masked);
+  }
+  return CYCLES_now();
+}
+
+//=============================================================================
+void PROF_end(uint32_t stage, uint32_t start) {
+  uint32_t cycles = CYCLES_now() - start;
+  tProfStage *s;
+
+  if (stage >= g_ui32ProfStageCount) {
+    return;
+  }
+  s = &g_psProfStages[stage];
+  s->count++;
+  s->total += cycles;
+  if (cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  s->histogram[PROF_bin(cycles)]++;
+}
+
+//=============================================================================
+void PROF_reset(void) {
+  uint32_t i;
+
+  for (i = 0; i < g_ui32ProfStageCount; i++) {
+    PROF_clear(&g_psProfStages[i]);
+  }
+}
+
+#ifdef HOST_BUILD
+void PROF_hostForget(void) { g_ui32ProfStageCount = 0; }
+#endif
+
+uint32_t PROF_stageCount(void) { return g_ui32ProfStageCount; }
+
+const tProfStage *PROF_stage(uint32_t stage) {
+  return stage < g_ui32ProfStageCount ? &g_psProfStages[stage] : 0;
+}
+
+//=============================================================================
+void PROF_dumpStart(tProfDump *dump) {
+  dump->stage = PROF_STAGE_NONE;
+  dump->bin = PROF_STAGE_NONE;
+  dump->active = true;
+}
+
+//=============================================================================
+// One line per call of CONSOLE_printf(), the header first, then for every
+// stage a line with its statistics followed by a line per bin that is not
+// empty. dump->bin is PROF_STAGE_NONE while the statistics line is still to
+// come.
+bool PROF_dump(tProfDump *dump) {
+  const tProfStage *stage;
+
+  while (dump->active && CONSOLE_txFree() >= CONSOLE_PRINTF_MAX) {
+    if (dump->stage == PROF_STAGE_NONE) {
+      // The names are padded after them by %12s, so they line up under
+      // "stage" and the numbers under their headings
+      CONSOLE_printf("stage             count        min       mean"
+                     "        max\n");
+      dump->stage = 0;
+      continue;
+    }
+    if (dump->stage >= g_ui32ProfStageCount) {
+      dump->active = false;
+      break;
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    stage = &g_psProfStages[dump->stage];
+    if (dump->bin == PROF_STAGE_NONE) {
+      CONSOLE_printf("%12s %10u %10u %10u %10u\n", stage->name, stage->count,
+                     stage->count ? stage->min : 0,
+                     stage->count ? (uint32_t)(stage->total / stage->count) : 0,
+                     stage->max);
+      dump->bin = 0;
+      continue;
+    }
+    while (dump->bin < PROF_BINS && stage->histogram[dump->bin] == 0) {
+      dump->bin++;
+    }
+    if (dump->bin == PROF_BINS) {
+      dump->stage++;
+      dump->bin = PROF_STAGE_NONE;
+      continue;
+    }
+    CONSOLE_printf("  >= 2^%2u %10u\n", dump->bin,
+                   stage->histogram[dump->bin]);
+    dump->bin++;
+  }
+  return !dump->active;
+}
@@ -0,0 +1,102 @@
+/*
+ * ================================================================
+ * File: profile.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Where does the time go. A piece of code between
+ * PROF_BEGIN(name) and PROF_END(name) is a stage, and every time it runs
+ * its duration in cycles (see cycles.h) goes into the stage's count, min,
+ * max, total and a histogram with one bin per power of two.
+ *
+ *   PROF_BEGIN(flush);
+ *   DASH_endFrame(&dashboard);
+ *   PROF_END(flush);
+ *
+ * A stage registers itself by its name the first time it runs, at most
+ * PROF_MAX_STAGES of them. The registration masks interrupts, so stages of
+ * the main loop and of interrupts may register in any order. BEGIN declares
+ * variables, so the matching END has to be in the same block. A stage
+ * should only run either from the main loop or from one interrupt, as the
+ * statistics are not updated atomically.
+ *
+ * The macros are only there when the code is built with PROFILE defined,
+ * otherwise they compile away to nothing and the stages cost nothing.
+ * PROF_dump() prints the tables through the console, a few lines at a time
+ * so that it never fills the TX ring.
+ *
+ * With HOST_BUILD defined the cycles are nanoseconds of the monotonic clock,
+ * so the same stages can be profiled on the host, and signals stand in for
+ * the interrupts: the registration blocks them.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+#define PROF_MAX_STAGES 16
+// Bin n counts the durations from 2^n up to 2^(n + 1) - 1, bin 0 also 0
+#define PROF_BINS 32
+// Stage id of a stage not registered yet, or that did not fit
+#define PROF_STAGE_NONE 0xffffffff
+
+//=============================================================================
+typedef struct {
+  const char *name;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+  uint32_t histogram[PROF_BINS];
+} tProfStage;
+
+// Where PROF_dump() got to
+typedef struct {
+  uint32_t stage;
+  uint32_t bin;
+  bool active;
+} tProfDump;
+
+//=============================================================================
+#ifdef PROFILE
+#define PROF_BEGIN(name)                                                     \
+  static uint32_t prof_stage_##name = PROF_STAGE_NONE;                      \
+  uint32_t prof_start_##name = PROF_begin(&prof_stage_##name, #name)
+#define PROF_END(name) PROF_end(prof_stage_##name, prof_start_##name)
+#else
+#define PROF_BEGIN(name)
+#define PROF_END(name)
+#endif
+
+//=============================================================================
+// Used by the macros. PROF_begin() registers the stage if *stage is still
+// PROF_STAGE_NONE and returns the start time.
+uint32_t PROF_begin(uint32_t *stage, const char *name);
+void PROF_end(uint32_t stage, uint32_t start);
+
+// Forget the statistics, the stages stay registered
+void PROF_reset(void);
+
+uint32_t PROF_stageCount(void);
+const tProfStage *PROF_stage(uint32_t stage);
+
+#ifdef HOST_BUILD
+// Forget every stage, for the tests. The stage ids the callers keep have to
+// be set back to PROF_STAGE_NONE with it, with the signals blocked.
+void PROF_hostForget(void);
+#endif
+
+//=============================================================================
+// Start printing the tables from the top
+void PROF_dumpStart(tProfDump *dump);
+
+// Print as many lines as the console TX ring has room for. Call it until it
+// returns true, the tables are then printed and dump is no longer active.
+bool PROF_dump(tProfDump *dump);
+
+#endif // PROFILE_H_
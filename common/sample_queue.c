@@ -0,0 +1,115 @@
+/*
+ * ================================================================
+ * File: sample_queue.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Lock-free single producer, single consumer record queue.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "sample_queue.h"
+
+//=============================================================================
+// The Cortex-M4 does not reorder accesses to normal memory, but the
+// architecture allows it, and the "memory" clobber also keeps the compiler
+// from moving the copies across the index update
+#ifdef HOST_BUILD
+#define QUEUE_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(ccs)
+#define QUEUE_BARRIER() __asm(" dmb")
+#else
+#define QUEUE_BARRIER() __asm volatile("dmb" : : : "memory")
+#endif
+
+//=============================================================================
+void QUEUE_init(tSampleQueue *queue, void *storage, uint32_t record_size,
+                uint32_t size_log2) {
+  queue->records = storage;
+  queue->record_size = record_size;
+  queue->mask = (1u << size_log2) - 1;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->overflows = 0;
+  queue->high_water = 0;
+}
+
+//=============================================================================
+// Copy count records into or out of the ring starting at index, in two
+// pieces when they wrap around the end of the ring
+static void QUEUE_copyIn(tSampleQueue *queue, uint32_t index,
+                         const uint8_t *records, uint32_t count) {
+  uint32_t first = index & queue->mask;
+  uint32_t part = queue->mask + 1 - first;
+
+  if (part > count) {
+    part = count;
+  }
+  memcpy(queue->records + first * queue->record_size, records,
+         part * queue->record_size);
+  memcpy(queue->records, records + part * queue->record_size,
+         (count - part) * queue->record_size);
+}
+
+static void QUEUE_copyOut(const tSampleQueue *queue, uint32_t index,
+                          uint8_t *records, uint32_t count) {
+  uint32_t first = index & queue->mask;
+  uint32_t part = queue->mask + 1 - first;
+
+  if (part > count) {
+    part = count;
+  }
+  memcpy(records, queue->records + first * queue->record_size,
+         part * queue->record_size);
+  memcpy(records + part * queue->record_size, queue->records,
+         (count - part) * queue->record_size);
+}
+
+//=============================================================================
+bool QUEUE_push(tSampleQueue *queue, const void *records, uint32_t count) {
+  uint32_t head = queue->head;
+  uint32_t waiting;
+
+  // The records at tail may only be overwritten once they are copied out
+  waiting = head - queue->tail;
+  QUEUE_BARRIER();
+  if (count > queue->mask + 1 - waiting) {
+    queue->overflows += count;
+    return false;
+  }
+  QUEUE_copyIn(queue, head, records, count);
+  QUEUE_BARRIER();
+  queue->head = head + count;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (waiting + count > queue->high_water) {
+    queue->high_water = waiting + count;
+  }
+  return true;
+}
+
+//=============================================================================
+uint32_t QUEUE_pop(tSampleQueue *queue, void *records, uint32_t max) {
+  uint32_t tail = queue->tail;
+  uint32_t count;
+
+  // The records below head are only complete once head has been read
+  count = queue->head - tail;
+  QUEUE_BARRIER();
+  if (count > max) {
+    count = max;
+  }
+  if (count == 0) {
+    return 0;
+  }
+  QUEUE_copyOut(queue, tail, records, count);
+  QUEUE_BARRIER();
+  queue->tail = tail + count;
+  return count;
+}
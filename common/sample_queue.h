@@ -0,0 +1,67 @@
+/*
+ * ================================================================
+ * File: sample_queue.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Lock-free single producer, single consumer queue of fixed
+ * size records, for handing samples from an interrupt handler to the main
+ * loop. The interrupt pushes, the main loop pops in batches, and neither
+ * ever waits for the other or turns interrupts off.
+ *
+ * The producer is the only one writing head and the consumer the only one
+ * writing tail, both count records since the start and wrap at 2^32. A
+ * record is copied in before head is moved past it, and copied out before
+ * tail is moved past it, with a DMB in between so that the other side never
+ * sees the new index before the record. A full queue drops what is pushed
+ * and counts it, the producer never overwrites a record not yet read.
+ *
+ * With HOST_BUILD defined the DMB is a full fence of the host compiler, so
+ * the producer and the consumer can be two threads.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef SAMPLE_QUEUE_H_
+#define SAMPLE_QUEUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+typedef struct {
+  uint8_t *records;
+  uint32_t record_size;
+  // The number of records is a power of two, indices are masked with this
+  uint32_t mask;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Records pushed and popped since the start
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Kept by the producer: records dropped because the queue was full, and
+  // the most records that were ever waiting
+  volatile uint32_t overflows;
+  volatile uint32_t high_water;
+} tSampleQueue;
+
+//=============================================================================
+// storage holds 2^size_log2 records of record_size bytes each
+void QUEUE_init(tSampleQueue *queue, void *storage, uint32_t record_size,
+                uint32_t size_log2);
+
+// Producer side. Either all count records are queued or, when there is not
+// room for them, none are, they are counted as overflows and false is
+// returned.
+bool QUEUE_push(tSampleQueue *queue, const void *records, uint32_t count);
+
+// Consumer side. Copy up to max of the oldest records into records and
+// return how many there were.
+uint32_t QUEUE_pop(tSampleQueue *queue, void *records, uint32_t max);
+
+// Records waiting, from either side
+static inline uint32_t QUEUE_count(const tSampleQueue *queue) {
+  return queue->head - queue->tail;
+}
+
+#endif // SAMPLE_QUEUE_H_
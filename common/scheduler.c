@@ -0,0 +1,146 @@
+/*
+ * ================================================================
+ * File: scheduler.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Tick based cooperative scheduler.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "cycles.h"
+#include "scheduler.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/systick.h"
+#endif
+
+//=============================================================================
+static volatile uint32_t g_ui32Ticks;
+
+//=============================================================================
+// Tick comparisons are done on the signed difference so that they still work
+// when the tick counter wraps
+static inline bool SCHED_reached(uint32_t now, uint32_t time) {
+  return (int32_t)(now - time) >= 0;
+}
+
+//=============================================================================
+void SCHED_tickHandler(void) { g_ui32Ticks++; }
+
+uint32_t SCHED_now(void) { return g_ui32Ticks; }
+
+//=============================================================================
+void SCHED_init(tScheduler *scheduler) {
+  memset(scheduler, 0, sizeof(*scheduler));
+  CYCLES_init();
+}
+
+//=============================================================================
+uint32_t SCHED_addTask(tScheduler *scheduler, const char *name,
+                       tTaskFunction function, void *argument,
+                       uint32_t period, uint32_t offset) {
+  tTask *task;
+
+  if (scheduler->task_count == SCHED_MAX_TASKS) {
+    return SCHED_MAX_TASKS;
+  }
+  task = &scheduler->task[scheduler->task_count];
+  memset(task, 0, sizeof(*task));
+  task->name = name;
+  task->function = function;
+  task->argument = argument;
+  task->period = period;
+  task->next_release = SCHED_now() + offset;
+  return scheduler->task_count++;
+}
+
+//=============================================================================
+bool SCHED_runOnce(tScheduler *scheduler) {
+  tTask *task = 0;
+  uint32_t now = SCHED_now();
+  uint32_t deadline = 0;
+  uint32_t start;
+  uint32_t skipped;
+  uint32_t i;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Earliest deadline first among the released tasks, on equal deadlines
+  // the task added first wins
+  for (i = 0; i < scheduler->task_count; i++) {
+    tTask *candidate = &scheduler->task[i];
+    if (!SCHED_reached(now, candidate->next_release)) {
+      continue;
+    }
+    if (task == 0 || (int32_t)(candidate->next_release + candidate->period -
+                               deadline) < 0) {
+      task = candidate;
+      deadline = candidate->next_release + candidate->period;
+    }
+  }
+  if (task == 0) {
+    scheduler->idle_calls++;
+    return false;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  start = CYCLES_now();
+  task->function(task->argument);
+  task->cycles_last = CYCLES_now() - start;
+  task->cycles_total += task->cycles_last;
+  if (task->cycles_last > task->cycles_max) {
+    task->cycles_max = task->cycles_last;
+  }
+  task->runs++;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Finishing after the deadline is a miss, and so is every release that
+  // passed while the task was waiting. Those releases are skipped instead of
+  // running the task several times in a row to catch up.
+  now = SCHED_now();
+  if (!SCHED_reached(deadline, now)) {
+    task->deadline_misses++;
+  }
+  task->next_release += task->period;
+  if (SCHED_reached(now, task->next_release + task->period)) {
+    skipped = (now - task->next_release) / task->period;
+    task->next_release += skipped * task->period;
+    task->deadline_misses += skipped;
+  }
+  return true;
+}
+
+//=============================================================================
+bool SCHED_pending(const tScheduler *scheduler) {
+  uint32_t now = SCHED_now();
+  uint32_t i;
+
+  for (i = 0; i < scheduler->task_count; i++) {
+    if (SCHED_reached(now, scheduler->task[i].next_release)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifndef HOST_BUILD
+//=============================================================================
+void SCHED_start(uint32_t system_clock, uint32_t tick_rate) {
+  SysTickPeriodSet(system_clock / tick_rate);
+  SysTickIntRegister(SCHED_tickHandler);
+  SysTickIntEnable();
+  SysTickEnable();
+}
+
+#else
+//=============================================================================
+void SCHED_start(uint32_t system_clock, uint32_t tick_rate) {}
+
+void SCHED_hostAdvance(uint32_t ticks) { g_ui32Ticks += ticks; }
+#endif
@@ -0,0 +1,82 @@
+/*
+ * ================================================================
+ * File: scheduler.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Tick based cooperative scheduler. SysTick counts ticks and
+ * every task is released once per period. SCHED_runOnce() runs the released
+ * task with the earliest deadline (the end of its period) to completion.
+ * A task that finishes after its deadline, or that is released again before
+ * it got to run, counts as a deadline miss. The execution time of every run
+ * is measured with the cycle counter.
+ *
+ * With HOST_BUILD defined there is no SysTick, the ticks are advanced with
+ * SCHED_hostAdvance() so that the scheduling can be replayed exactly.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+#define SCHED_MAX_TASKS 8
+
+//=============================================================================
+typedef void (*tTaskFunction)(void *argument);
+
+typedef struct {
+  const char *name;
+  tTaskFunction function;
+  void *argument;
+  uint32_t period;
+  uint32_t next_release;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint32_t runs;
+  uint32_t deadline_misses;
+  uint32_t cycles_last;
+  uint32_t cycles_max;
+  uint64_t cycles_total;
+} tTask;
+
+typedef struct {
+  tTask task[SCHED_MAX_TASKS];
+  uint32_t task_count;
+  // Calls of SCHED_runOnce() that found nothing to run
+  uint32_t idle_calls;
+} tScheduler;
+
+//=============================================================================
+void SCHED_init(tScheduler *scheduler);
+
+// Add a task released every period ticks, the first time offset ticks from
+// now. Offsets spread tasks with the same period over different ticks.
+// Returns the task id, or SCHED_MAX_TASKS when all tasks are taken and the
+// task was not added.
+uint32_t SCHED_addTask(tScheduler *scheduler, const char *name,
+                       tTaskFunction function, void *argument,
+                       uint32_t period, uint32_t offset);
+
+// Start SysTick at tick_rate ticks per second
+void SCHED_start(uint32_t system_clock, uint32_t tick_rate);
+
+// Run the most urgent released task. Returns false if no task was released.
+bool SCHED_runOnce(tScheduler *scheduler);
+
+// True if a task has been released and is waiting to run
+bool SCHED_pending(const tScheduler *scheduler);
+
+uint32_t SCHED_now(void);
+
+// SysTick interrupt handler
+void SCHED_tickHandler(void);
+
+#ifdef HOST_BUILD
+void SCHED_hostAdvance(uint32_t ticks);
+#endif
+
+#endif // SCHEDULER_H_
@@ -0,0 +1,151 @@
+/*
+ * ================================================================
+ * File: sound_meter.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: RMS and peak sound level meter with A-weighting.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "cycles.h"
+#include "fixed_db.h"
+#include "sound_meter.h"
+
+//=============================================================================
+// A-weighting at 8 kHz with the analog poles at 20.6 Hz (twice) in the
+// first section and 107.7 Hz and 737.9 Hz in the second, mapped to
+// z = exp(-2 pi f / fs), and the double zero at 0 Hz in each. The bilinear
+// transform puts the curve 0.2 dB low below 1 kHz, this mapping 0.05 dB.
+// The two poles at 12194 Hz lie above the Nyquist frequency and map to
+// almost nothing, yet they take 0.5 dB off at 3150 Hz. The third section is
+// a three tap FIR fitted to their response from 20 Hz to 3.9 kHz, within
+// 0.08 dB. Each section is scaled to 0 dB at 1 kHz. b0, b1, b2, a1, a2 in
+// Q30.
+#define METER_COEFFICIENT_BITS 30
+static const int32_t g_pi32AWeighting[METER_SECTIONS][5] = {
+    {1056981444, -2113962887, 1056981444, -2113018636, 1039553377},
+    {977162957, -1954325913, 977162957, -1588111794, 552676131},
+    {1042641349, 43782893, -13540582, 0, 0}};
+
+// One count in dB, 20 * log10(2^8) in Q8, to remove the fraction bits
+#define METER_ONE_COUNT_DB 12330
+
+//=============================================================================
+void METER_init(tSoundMeter *meter, bool a_weighting, uint32_t rms_window,
+                uint32_t peak_window, uint32_t cycle_budget) {
+  memset(meter, 0, sizeof(*meter));
+  meter->a_weighting = a_weighting;
+  meter->rms_window = rms_window;
+  meter->peak_window = peak_window;
+  meter->cycle_budget = cycle_budget;
+  FILTER_exponentialInit(&meter->dc, METER_DC_SHIFT);
+  CYCLES_init();
+}
+
+//=============================================================================
+// Direct form I, the states are the filter input and output so nothing
+// inside a section can overflow as long as the output fits
+static int32_t METER_biquad(int32_t *state, const int32_t *c, int32_t x) {
+  int64_t acc = (int64_t)c[0] * x + (int64_t)c[1] * state[0] +
+                (int64_t)c[2] * state[1] - (int64_t)c[3] * state[2] -
+                (int64_t)c[4] * state[3];
+  int32_t y = (int32_t)(acc >> METER_COEFFICIENT_BITS);
+
+  state[1] = state[0];
+  state[0] = x;
+  state[3] = state[2];
+  state[2] = y;
+  return y;
+}
+
+//=============================================================================
+// Square root of a 64-bit value, rounded down, one result bit per iteration
+static uint32_t METER_sqrt(uint64_t x) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+//=============================================================================
+static int32_t METER_db(uint32_t level) {
+  return DB_fromLinear(level) - METER_ONE_COUNT_DB;
+}
+
+//=============================================================================
+bool METER_pushBlock(tSoundMeter *meter, const uint32_t *samples,
+                     uint32_t count) {
+  uint32_t start = CYCLES_now();
+  bool rms_done = false;
+  uint32_t magnitude;
+  int32_t x;
+  uint32_t i;
+  uint32_t s;
+
+  for (i = 0; i < count; i++) {
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // The DC tracker runs on the scaled sample so that the bias is known to
+    // a fraction of a count
+    x = (int32_t)(samples[i] << METER_FRACTION_BITS);
+    x -= (int32_t)FILTER_exponentialPush(&meter->dc, (uint32_t)x);
+    if (meter->a_weighting) {
+      for (s = 0; s < METER_SECTIONS; s++) {
+        x = METER_biquad(meter->state[s], g_pi32AWeighting[s], x);
+      }
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    magnitude = x < 0 ? (uint32_t)-x : (uint32_t)x;
+    meter->sum_squares += (uint64_t)magnitude * magnitude;
+    if (magnitude > meter->peak_running) {
+      meter->peak_running = magnitude;
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    if (++meter->rms_count == meter->rms_window) {
+      meter->rms = METER_sqrt(meter->sum_squares / meter->rms_window);
+      meter->rms_db = METER_db(meter->rms);
+      meter->rms_windows++;
+      meter->sum_squares = 0;
+      meter->rms_count = 0;
+      rms_done = true;
+    }
+    if (++meter->peak_count == meter->peak_window) {
+      meter->peak = meter->peak_running;
+      meter->peak_db = METER_db(meter->peak);
+      meter->peak_windows++;
+      meter->peak_running = 0;
+      meter->peak_count = 0;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (count != 0) {
+    meter->cycles_per_sample = (CYCLES_now() - start) / count;
+    if (meter->cycles_per_sample > meter->cycles_per_sample_max) {
+      meter->cycles_per_sample_max = meter->cycles_per_sample;
+    }
+    if (meter->cycle_budget != 0 &&
+        meter->cycles_per_sample > meter->cycle_budget) {
+      meter->budget_overruns++;
+    }
+  }
+  return rms_done;
+}
@@ -0,0 +1,87 @@
+/*
+ * ================================================================
+ * File: sound_meter.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Sound level meter for the microphone channel. The samples
+ * have to come at a fixed rate of METER_SAMPLE_RATE, timer triggered, since
+ * the weighting filter is designed for that rate. Per sample:
+ *  - the DC bias of the microphone is tracked with an exponential average
+ *    and removed
+ *  - an A-weighting filter (three biquads, Q30 coefficients) is applied, or
+ *    none for a flat (Z) weighting
+ *  - the square and the absolute value go into the RMS and peak windows
+ * All levels are in ADC counts, 8 fraction bits, and in dB relative to one
+ * count (Q8 dB). There is no calibration to sound pressure.
+ *
+ * The CPU cycles spent per sample are measured for every block and compared
+ * against a budget.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef SOUND_METER_H_
+#define SOUND_METER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "filter.h"
+
+//=============================================================================
+// The rate the A-weighting coefficients are designed for. From 20 Hz to
+// 3.9 kHz the filter is within 0.12 dB of the standard curve (see
+// test/test_sound_meter.c).
+#define METER_SAMPLE_RATE 8000
+#define METER_SECTIONS 3
+// Time constant of the DC tracker, 2^10 samples or 128 ms
+#define METER_DC_SHIFT 10
+// Fraction bits of the samples inside the meter
+#define METER_FRACTION_BITS 8
+
+//=============================================================================
+typedef struct {
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Settings
+  bool a_weighting;
+  uint32_t rms_window;
+  uint32_t peak_window;
+  uint32_t cycle_budget;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Filter state, x[n-1], x[n-2], y[n-1], y[n-2] of every section
+  tFilterExponential dc;
+  int32_t state[METER_SECTIONS][4];
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint64_t sum_squares;
+  uint32_t rms_count;
+  uint32_t peak_running;
+  uint32_t peak_count;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Results of the last completed windows
+  uint32_t rms;
+  uint32_t peak;
+  int32_t rms_db;
+  int32_t peak_db;
+  uint32_t rms_windows;
+  uint32_t peak_windows;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Cycles per sample of the last block and the worst block, and the number
+  // of blocks that went over the budget
+  uint32_t cycles_per_sample;
+  uint32_t cycles_per_sample_max;
+  uint32_t budget_overruns;
+} tSoundMeter;
+
+//=============================================================================
+// The windows are given in samples. cycle_budget is the number of cycles
+// one sample may cost, 0 for no budget.
+void METER_init(tSoundMeter *meter, bool a_weighting, uint32_t rms_window,
+                uint32_t peak_window, uint32_t cycle_budget);
+
+// Run a block of raw 12-bit samples through the meter. Returns true if an
+// RMS window was completed, rms and rms_db then hold the new level.
+bool METER_pushBlock(tSoundMeter *meter, const uint32_t *samples,
+                     uint32_t count);
+
+#endif // SOUND_METER_H_
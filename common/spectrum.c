@@ -0,0 +1,117 @@
+/*
+ * ================================================================
+ * File: spectrum.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Spectrum analyzer bars with partial redraws.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "fixed_db.h"
+#include "spectrum.h"
+
+//=============================================================================
+void SPECTRUM_init(tSpectrum *spectrum, tContext *context, int32_t x,
+                   int32_t y, int32_t width, int32_t height,
+                   uint32_t bar_count) {
+  memset(spectrum, 0, sizeof(*spectrum));
+  if (bar_count > SPECTRUM_MAX_BARS) {
+    bar_count = SPECTRUM_MAX_BARS;
+  }
+  if (height > 255) {
+    height = 255;
+  }
+  spectrum->context = context;
+  spectrum->x = x;
+  spectrum->y = y;
+  spectrum->height = height;
+  spectrum->bar_count = bar_count;
+  spectrum->bar_width = width / bar_count;
+}
+
+//=============================================================================
+void SPECTRUM_setBins(tSpectrum *spectrum, const uint16_t *magnitude,
+                      uint32_t bin_count) {
+  uint32_t bins = bin_count - 1;
+  uint32_t first;
+  uint32_t last;
+  uint32_t loudest;
+  int32_t db;
+  uint32_t b;
+  uint32_t i;
+
+  for (b = 0; b < spectrum->bar_count; b++) {
+    first = 1 + b * bins / spectrum->bar_count;
+    last = 1 + (b + 1) * bins / spectrum->bar_count;
+    loudest = 0;
+    for (i = first; i < last; i++) {
+      if (magnitude[i] > loudest) {
+        loudest = magnitude[i];
+      }
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Linear in dB between the floor and the top
+    db = DB_fromLinear(loudest) - (SPECTRUM_DB_FLOOR << DB_FRACTION_BITS);
+    if (db < 0) {
+      db = 0;
+    }
+    db = db * spectrum->height /
+         ((SPECTRUM_DB_TOP - SPECTRUM_DB_FLOOR) << DB_FRACTION_BITS);
+    spectrum->target[b] = db > spectrum->height ? spectrum->height : db;
+  }
+}
+
+//=============================================================================
+uint32_t SPECTRUM_draw(tSpectrum *spectrum, uint32_t max_bars) {
+  tContext *context = spectrum->context;
+  int32_t bottom = spectrum->y + spectrum->height - 1;
+  uint32_t foreground = context->ui32Foreground;
+  tRectangle rect;
+  uint32_t drawn = 0;
+  uint32_t checked;
+  uint32_t b = spectrum->next;
+  int32_t shown;
+  int32_t target;
+
+  for (checked = 0; checked < spectrum->bar_count && drawn < max_bars;
+       checked++) {
+    shown = spectrum->shown[b];
+    target = spectrum->target[b];
+    if (shown != target) {
+      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      // Only the strip between the old and the new top is filled, with the
+      // bar color when the bar grew and the background when it shrank
+      rect.i16XMin = spectrum->x + b * spectrum->bar_width;
+      rect.i16XMax = rect.i16XMin + spectrum->bar_width - 2;
+      if (target > shown) {
+        rect.i16YMin = bottom - target + 1;
+        rect.i16YMax = bottom - shown;
+      } else {
+        rect.i16YMin = bottom - shown + 1;
+        rect.i16YMax = bottom - target;
+        GrContextForegroundSetTranslated(context, context->ui32Background);
+      }
+      GrRectFill(context, &rect);
+      GrContextForegroundSetTranslated(context, foreground);
+      // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      spectrum->shown[b] = target;
+      spectrum->pixels += (rect.i16XMax - rect.i16XMin + 1) *
+                          (rect.i16YMax - rect.i16YMin + 1);
+      spectrum->bars_drawn++;
+      drawn++;
+    }
+    b = b + 1 == spectrum->bar_count ? 0 : b + 1;
+  }
+  spectrum->next = b;
+  if (drawn != 0) {
+    GrFlush(context);
+  }
+  return drawn;
+}
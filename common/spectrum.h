@@ -0,0 +1,67 @@
+/*
+ * ================================================================
+ * File: spectrum.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Spectrum analyzer bars. The FFT bins are grouped into bars
+ * whose height is the level of the loudest bin in dB. Every bar remembers
+ * its height on the LCD, and only the part of a bar that grew or shrank is
+ * filled. Drawing is spread over several calls with a limit on the bars per
+ * call, so that one new spectrum can not hold up the rest of the program.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include <stdint.h>
+//=============================================================================
+#include "grlib/grlib.h"
+
+//=============================================================================
+#define SPECTRUM_MAX_BARS 64
+// Magnitudes from FFT_magnitude() are Q15 divided by the number of points,
+// so a full scale sine is at 20 * log10(2^13) = 78 dB with the Hann window.
+// One ADC count scaled to Q15 is at 12 dB.
+#define SPECTRUM_DB_FLOOR 12
+#define SPECTRUM_DB_TOP 78
+
+//=============================================================================
+typedef struct {
+  tContext *context;
+  int32_t x;
+  int32_t y;
+  int32_t height;
+  uint32_t bar_count;
+  uint32_t bar_width;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Height of every bar on the LCD and the height it should have
+  uint8_t shown[SPECTRUM_MAX_BARS];
+  uint8_t target[SPECTRUM_MAX_BARS];
+  // Where the next call to SPECTRUM_draw() starts looking
+  uint32_t next;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint32_t bars_drawn;
+  uint32_t pixels;
+} tSpectrum;
+
+//=============================================================================
+// The bars fill the rectangle at x, y of width by height pixels, bar_count
+// bars of width / bar_count pixels with a one pixel gap. The area is
+// expected to be cleared to the background already.
+void SPECTRUM_init(tSpectrum *spectrum, tContext *context, int32_t x,
+                   int32_t y, int32_t width, int32_t height,
+                   uint32_t bar_count);
+
+// New target heights from bin_count magnitudes. Bin 0 (DC) is left out and
+// the rest are shared evenly between the bars.
+void SPECTRUM_setBins(tSpectrum *spectrum, const uint16_t *magnitude,
+                      uint32_t bin_count);
+
+// Bring at most max_bars bars up to date. Returns the number of bars drawn,
+// 0 when the LCD shows the targets.
+uint32_t SPECTRUM_draw(tSpectrum *spectrum, uint32_t max_bars);
+
+#endif // SPECTRUM_H_
@@ -0,0 +1,395 @@
+/*
+ * ================================================================
+ * File: st7735.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Direct SPI access to the ST7735S LCD controller.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "st7735.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/gpio.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/ssi.h"
+#include "driverlib/sysctl.h"
+//=============================================================================
+#include "inc/hw_memmap.h"
+
+#define ST7735_SSI_BASE SSI2_BASE
+#define ST7735_CS_PORT GPIO_PORTN_BASE
+#define ST7735_CS_PIN GPIO_PIN_2
+#define ST7735_DC_PORT GPIO_PORTL_BASE
+#define ST7735_DC_PIN GPIO_PIN_3
+#define ST7735_RST_PORT GPIO_PORTH_BASE
+#define ST7735_RST_PIN GPIO_PIN_3
+#else
+//=============================================================================
+#include <stdio.h>
+#endif
+
+//=============================================================================
+static uint32_t g_ui32BytesSent;
+// Where the panel starts in controller memory, in the current orientation
+static uint32_t g_ui32XOffset = ST7735_X_OFFSET;
+static uint32_t g_ui32YOffset = ST7735_Y_OFFSET;
+
+#ifndef HOST_BUILD
+//=============================================================================
+static uint32_t g_ui32SystemClock;
+
+static void ST7735_delay(uint32_t ms) {
+  // SysCtlDelay() takes three cycles per loop
+  SysCtlDelay(g_ui32SystemClock / 3000 * ms);
+}
+
+// The data/command line is sampled with the last bit of every byte, so the
+// FIFO has to be empty before it is changed
+static void ST7735_mode(uint8_t data) {
+  while (SSIBusy(ST7735_SSI_BASE)) {
+  }
+  GPIOPinWrite(ST7735_DC_PORT, ST7735_DC_PIN, data ? ST7735_DC_PIN : 0);
+}
+
+static inline void ST7735_send(uint8_t byte) {
+  SSIDataPut(ST7735_SSI_BASE, byte);
+}
+
+#else
+//=============================================================================
+// Emulation of the controller, enough of it to follow the window and memory
+// writes, the memory access order and the scrolling. Parameters are
+// collected until the command is complete. The memory is kept the way the
+// controller has it: 162 rows, one per scan line, of 132 pixels.
+static uint16_t g_pui16GRAM[ST7735_GRAM_HEIGHT][ST7735_GRAM_WIDTH];
+static uint8_t g_ui8Command;
+static uint8_t g_pui8Parameter[6];
+static uint32_t g_ui32ParameterCount;
+static uint8_t g_ui8Data;
+static uint32_t g_ui32Column[2];
+static uint32_t g_ui32Row[2];
+static uint32_t g_ui32X;
+static uint32_t g_ui32Y;
+static uint8_t g_ui8HighByte;
+static bool g_bHaveHighByte;
+static uint8_t g_ui8MADCTL;
+// Scroll area, the lines before it, the lines in it and where it starts
+// in memory. After reset everything scrolls and nothing has moved.
+static uint32_t g_ui32ScrollTop;
+static uint32_t g_ui32ScrollLines = ST7735_GRAM_HEIGHT;
+static uint32_t g_ui32ScrollStart;
+
+static void ST7735_delay(uint32_t ms) {}
+
+static void ST7735_mode(uint8_t data) { g_ui8Data = data; }
+
+static inline uint32_t ST7735_parameter(uint32_t i) {
+  return (g_pui8Parameter[2 * i] << 8) | g_pui8Parameter[2 * i + 1];
+}
+
+// Memory row and column of a column and row address. MV swaps the two
+// before MX and MY mirror them. Returns false outside the memory.
+static bool ST7735_address(uint32_t column, uint32_t row, uint32_t *memory_row,
+                           uint32_t *memory_column) {
+  uint32_t swap;
+
+  if (g_ui8MADCTL & ST7735_MADCTL_MV) {
+    swap = column;
+    column = row;
+    row = swap;
+  }
+  if (column >= ST7735_GRAM_WIDTH || row >= ST7735_GRAM_HEIGHT) {
+    return false;
+  }
+  *memory_column =
+      g_ui8MADCTL & ST7735_MADCTL_MX ? ST7735_GRAM_WIDTH - 1 - column : column;
+  *memory_row =
+      g_ui8MADCTL & ST7735_MADCTL_MY ? ST7735_GRAM_HEIGHT - 1 - row : row;
+  return true;
+}
+
+static void ST7735_send(uint8_t byte) {
+  uint32_t memory_row;
+  uint32_t memory_column;
+
+  if (!g_ui8Data) {
+    g_ui8Command = byte;
+    g_ui32ParameterCount = 0;
+    g_bHaveHighByte = false;
+    if (byte == ST7735_RAMWR) {
+      g_ui32X = g_ui32Column[0];
+      g_ui32Y = g_ui32Row[0];
+    } else if (byte == ST7735_SWRESET) {
+      g_ui8MADCTL = 0;
+      g_ui32ScrollTop = 0;
+      g_ui32ScrollLines = ST7735_GRAM_HEIGHT;
+      g_ui32ScrollStart = 0;
+    }
+    return;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (g_ui8Command == ST7735_RAMWR) {
+    if (!g_bHaveHighByte) {
+      g_ui8HighByte = byte;
+      g_bHaveHighByte = true;
+      return;
+    }
+    g_bHaveHighByte = false;
+    if (ST7735_address(g_ui32X, g_ui32Y, &memory_row, &memory_column)) {
+      g_pui16GRAM[memory_row][memory_column] = (g_ui8HighByte << 8) | byte;
+    }
+    // The write position wraps to the next row of the window, and back to
+    // the top when the window is full
+    if (++g_ui32X > g_ui32Column[1]) {
+      g_ui32X = g_ui32Column[0];
+      if (++g_ui32Y > g_ui32Row[1]) {
+        g_ui32Y = g_ui32Row[0];
+      }
+    }
+    return;
+  }
+  if (g_ui32ParameterCount < sizeof(g_pui8Parameter)) {
+    g_pui8Parameter[g_ui32ParameterCount++] = byte;
+  }
+  switch (g_ui8Command) {
+  case ST7735_CASET:
+    if (g_ui32ParameterCount == 4) {
+      g_ui32Column[0] = ST7735_parameter(0);
+      g_ui32Column[1] = ST7735_parameter(1);
+    }
+    break;
+  case ST7735_RASET:
+    if (g_ui32ParameterCount == 4) {
+      g_ui32Row[0] = ST7735_parameter(0);
+      g_ui32Row[1] = ST7735_parameter(1);
+    }
+    break;
+  case ST7735_MADCTL:
+    g_ui8MADCTL = byte;
+    break;
+  case ST7735_VSCRDEF:
+    if (g_ui32ParameterCount == 6) {
+      g_ui32ScrollTop = ST7735_parameter(0);
+      g_ui32ScrollLines = ST7735_parameter(1);
+    }
+    break;
+  case ST7735_VSCSAD:
+    if (g_ui32ParameterCount == 2) {
+      g_ui32ScrollStart = ST7735_parameter(0);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+//=============================================================================
+// The scan line a position is on shows the memory row the scroll puts
+// there. In the scroll area the first line shows the row at the start
+// address and the rest follow, wrapping around within the area.
+uint16_t ST7735_hostPixel(uint32_t x, uint32_t y) {
+  uint32_t line;
+  uint32_t column;
+
+  if (!ST7735_address(x + g_ui32XOffset, y + g_ui32YOffset, &line, &column)) {
+    return 0;
+  }
+  if (line >= g_ui32ScrollTop && line < g_ui32ScrollTop + g_ui32ScrollLines) {
+    line = g_ui32ScrollTop +
+           (line - g_ui32ScrollTop + g_ui32ScrollStart - g_ui32ScrollTop +
+            g_ui32ScrollLines) %
+               g_ui32ScrollLines;
+  }
+  return g_pui16GRAM[line][column];
+}
+
+int ST7735_hostWritePPM(const char *path) {
+  FILE *file = fopen(path, "wb");
+  uint16_t pixel;
+  uint32_t x;
+  uint32_t y;
+
+  if (file == 0) {
+    return -1;
+  }
+  fprintf(file, "P6\n%d %d\n255\n", ST7735_WIDTH, ST7735_HEIGHT);
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      pixel = ST7735_hostPixel(x, y);
+      fputc(((pixel >> 11) & 0x1f) * 255 / 31, file);
+      fputc(((pixel >> 5) & 0x3f) * 255 / 63, file);
+      fputc((pixel & 0x1f) * 255 / 31, file);
+    }
+  }
+  return fclose(file) == 0 ? 0 : -1;
+}
+#endif
+
+//=============================================================================
+void ST7735_command(uint8_t command, const uint8_t *data, uint32_t length) {
+  uint32_t i;
+
+  ST7735_mode(0);
+  ST7735_send(command);
+  ST7735_mode(1);
+  for (i = 0; i < length; i++) {
+    ST7735_send(data[i]);
+  }
+  g_ui32BytesSent += 1 + length;
+}
+
+//=============================================================================
+void ST7735_setWindow(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+  uint8_t column[4];
+  uint8_t row[4];
+
+  x0 += g_ui32XOffset;
+  x1 += g_ui32XOffset;
+  y0 += g_ui32YOffset;
+  y1 += g_ui32YOffset;
+  column[0] = x0 >> 8;
+  column[1] = x0;
+  column[2] = x1 >> 8;
+  column[3] = x1;
+  row[0] = y0 >> 8;
+  row[1] = y0;
+  row[2] = y1 >> 8;
+  row[3] = y1;
+  ST7735_command(ST7735_CASET, column, 4);
+  ST7735_command(ST7735_RASET, row, 4);
+  ST7735_command(ST7735_RAMWR, 0, 0);
+}
+
+//=============================================================================
+// The controller takes the high byte of every pixel first
+void ST7735_writePixels(const uint16_t *pixels, uint32_t count) {
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    ST7735_send(pixels[i] >> 8);
+    ST7735_send(pixels[i] & 0xff);
+  }
+  g_ui32BytesSent += 2 * count;
+}
+
+void ST7735_writeColor(uint16_t color, uint32_t count) {
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    ST7735_send(color >> 8);
+    ST7735_send(color & 0xff);
+  }
+  g_ui32BytesSent += 2 * count;
+}
+
+//=============================================================================
+void ST7735_blit(const uint16_t *framebuffer, uint32_t stride, uint32_t x0,
+                 uint32_t y0, uint32_t x1, uint32_t y1) {
+  uint32_t y;
+
+  ST7735_setWindow(x0, y0, x1, y1);
+  for (y = y0; y <= y1; y++) {
+    ST7735_writePixels(framebuffer + y * stride + x0, x1 - x0 + 1);
+  }
+}
+
+//=============================================================================
+uint32_t ST7735_bytesSent(void) { return g_ui32BytesSent; }
+
+//=============================================================================
+// Upright the rows and the columns are mirrored, which puts the panel at
+// scan lines 31 to 158 with y = 0 on line 158. Turned, MV makes the column
+// address pick the scan line instead, so x runs along the lines the other
+// way round and y across them.
+void ST7735_setOrientation(tST7735Orientation orientation) {
+  uint8_t parameter;
+  uint8_t area[6];
+
+  if (orientation == ST7735_LEFT) {
+    parameter = ST7735_MADCTL_MY | ST7735_MADCTL_MV | ST7735_MADCTL_BGR;
+    g_ui32XOffset = ST7735_Y_OFFSET;
+    g_ui32YOffset = ST7735_X_OFFSET;
+  } else {
+    parameter = ST7735_MADCTL_MX | ST7735_MADCTL_MY | ST7735_MADCTL_BGR;
+    g_ui32XOffset = ST7735_X_OFFSET;
+    g_ui32YOffset = ST7735_Y_OFFSET;
+  }
+  ST7735_command(ST7735_MADCTL, &parameter, 1);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only the lines the panel shows scroll, so what leaves one side comes
+  // back on the other without passing through hidden lines
+  area[0] = 0;
+  area[1] = ST7735_SCROLL_TOP;
+  area[2] = 0;
+  area[3] = ST7735_HEIGHT;
+  area[4] = 0;
+  area[5] = ST7735_SCROLL_BOTTOM;
+  ST7735_command(ST7735_VSCRDEF, area, 6);
+  ST7735_scroll(0);
+}
+
+//=============================================================================
+// Position p is on scan line 158 - p, so for it to show at p - offset the
+// scroll area has to start offset lines further back in memory
+void ST7735_scroll(uint32_t offset) {
+  uint32_t start =
+      ST7735_SCROLL_TOP + (ST7735_HEIGHT - offset % ST7735_HEIGHT) %
+                              ST7735_HEIGHT;
+  uint8_t address[2];
+
+  address[0] = start >> 8;
+  address[1] = start;
+  ST7735_command(ST7735_VSCSAD, address, 2);
+}
+
+//=============================================================================
+void ST7735_init(uint32_t system_clock) {
+  uint8_t parameter;
+
+#ifndef HOST_BUILD
+  g_ui32SystemClock = system_clock;
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_SSI2);
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOD);
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOH);
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOL);
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPION);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_SSI2)) {
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only clock and MOSI, nothing is ever read back from the LCD
+  GPIOPinConfigure(GPIO_PD3_SSI2CLK);
+  GPIOPinConfigure(GPIO_PD1_SSI2XDAT0);
+  GPIOPinTypeSSI(GPIO_PORTD_BASE, GPIO_PIN_3 | GPIO_PIN_1);
+  GPIOPinTypeGPIOOutput(ST7735_CS_PORT, ST7735_CS_PIN);
+  GPIOPinTypeGPIOOutput(ST7735_DC_PORT, ST7735_DC_PIN);
+  GPIOPinTypeGPIOOutput(ST7735_RST_PORT, ST7735_RST_PIN);
+  SSIConfigSetExpClk(ST7735_SSI_BASE, system_clock, SSI_FRF_MOTO_MODE_0,
+                     SSI_MODE_MASTER, ST7735_SPI_RATE, 8);
+  SSIEnable(ST7735_SSI_BASE);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The LCD is the only device on the bus, so it stays selected
+  GPIOPinWrite(ST7735_CS_PORT, ST7735_CS_PIN, 0);
+  GPIOPinWrite(ST7735_RST_PORT, ST7735_RST_PIN, 0);
+  ST7735_delay(10);
+  GPIOPinWrite(ST7735_RST_PORT, ST7735_RST_PIN, ST7735_RST_PIN);
+  ST7735_delay(120);
+#endif
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  ST7735_command(ST7735_SWRESET, 0, 0);
+  ST7735_delay(150);
+  ST7735_command(ST7735_SLPOUT, 0, 0);
+  ST7735_delay(120);
+  parameter = ST7735_COLMOD_16BIT;
+  ST7735_command(ST7735_COLMOD, &parameter, 1);
+  ST7735_setOrientation(ST7735_UP);
+  ST7735_command(ST7735_DISPON, 0, 0);
+}
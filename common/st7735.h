@@ -0,0 +1,128 @@
+/*
+ * ================================================================
+ * File: st7735.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Direct SPI access to the ST7735S LCD controller on the
+ * BoosterPack MKII, for RGB565 pixel data that does not go through grlib.
+ * A window is opened on the controller and the pixels are streamed into it,
+ * which is what makes sending a dirty rectangle of a framebuffer cheap.
+ *
+ * BoosterPack 1 on the EK-TM4C1294XL:
+ *  - SPI clock  PD3 (SSI2CLK)
+ *  - SPI MOSI   PD1 (SSI2XDAT0)
+ *  - chip select PN2
+ *  - data/command PL3
+ *  - reset      PH3
+ *
+ * The controller can scroll the picture itself, along its scan lines. Those
+ * run along y in the upright orientation and along x when the picture is
+ * turned a quarter turn, which is how a game scrolls sideways by sending
+ * only the column that comes into view.
+ *
+ * With HOST_BUILD defined the bytes go to an emulation of the controller
+ * instead, which keeps the controller's own memory and follows the memory
+ * access order and the scrolling, so the picture on the LCD can be read
+ * back or written to a PPM file.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef ST7735_H_
+#define ST7735_H_
+
+#include <stdint.h>
+
+//=============================================================================
+#define ST7735_WIDTH 128
+#define ST7735_HEIGHT 128
+// The controller memory is 132 x 162, the panel shows a 128 x 128 window of
+// it starting at this column and row. Turned, the two are swapped.
+#define ST7735_X_OFFSET 2
+#define ST7735_Y_OFFSET 3
+#define ST7735_GRAM_WIDTH 132
+#define ST7735_GRAM_HEIGHT 162
+// The scan lines before and after the ones the panel shows, these do not
+// scroll
+#define ST7735_SCROLL_TOP                                                      \
+  (ST7735_GRAM_HEIGHT - ST7735_HEIGHT - ST7735_Y_OFFSET)
+#define ST7735_SCROLL_BOTTOM ST7735_Y_OFFSET
+// The controller accepts a write clock of up to 15 MHz
+#define ST7735_SPI_RATE 15000000
+
+//=============================================================================
+// Commands
+#define ST7735_SWRESET 0x01
+#define ST7735_SLPOUT 0x11
+#define ST7735_DISPON 0x29
+#define ST7735_CASET 0x2A
+#define ST7735_RASET 0x2B
+#define ST7735_RAMWR 0x2C
+#define ST7735_VSCRDEF 0x33
+#define ST7735_MADCTL 0x36
+#define ST7735_VSCSAD 0x37
+#define ST7735_COLMOD 0x3A
+// Memory access control: row/column order and BGR color order
+#define ST7735_MADCTL_MY 0x80
+#define ST7735_MADCTL_MX 0x40
+#define ST7735_MADCTL_MV 0x20
+#define ST7735_MADCTL_BGR 0x08
+// 16 bits per pixel
+#define ST7735_COLMOD_16BIT 0x05
+
+//=============================================================================
+typedef enum {
+  // The MKII held the normal way, scrolling moves the picture up
+  ST7735_UP,
+  // Turned a quarter turn, the board is held on its side and scrolling
+  // moves the picture left
+  ST7735_LEFT
+} tST7735Orientation;
+
+//=============================================================================
+// Reset the controller and set it up for 16-bit pixels, upright. Takes the
+// SSI2 module and the pins above.
+void ST7735_init(uint32_t system_clock);
+
+// Change the memory access order, the coordinates of everything sent after
+// this are in the new orientation. The scroll area is set to the lines the
+// panel shows and the scroll to 0, what is on the LCD is not redrawn.
+void ST7735_setOrientation(tST7735Orientation orientation);
+
+// Show the picture moved by offset pixels along the scan lines: what was
+// sent to position p (y upright, x turned) is shown at p - offset, and what
+// goes out on one side comes back on the other. Only two bytes are sent
+// however far it moves.
+void ST7735_scroll(uint32_t offset);
+
+// Send a command byte followed by its parameter bytes
+void ST7735_command(uint8_t command, const uint8_t *data, uint32_t length);
+
+// Open the window x0..x1, y0..y1 (inclusive, LCD coordinates) for writing.
+// Pixels then fill it row by row.
+void ST7735_setWindow(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+// Send count RGB565 pixels into the open window
+void ST7735_writePixels(const uint16_t *pixels, uint32_t count);
+
+// Send count copies of one color into the open window
+void ST7735_writeColor(uint16_t color, uint32_t count);
+
+// Send the rectangle x0..x1, y0..y1 of a framebuffer that is stride pixels
+// wide to the same place on the LCD
+void ST7735_blit(const uint16_t *framebuffer, uint32_t stride, uint32_t x0,
+                 uint32_t y0, uint32_t x1, uint32_t y1);
+
+// Number of bytes sent over the SPI since start, commands included
+uint32_t ST7735_bytesSent(void);
+
+#ifdef HOST_BUILD
+// The pixel shown at x, y of the panel, in the current orientation
+uint16_t ST7735_hostPixel(uint32_t x, uint32_t y);
+
+// Write what the panel shows as a binary PPM. Returns 0 on success.
+int ST7735_hostWritePPM(const char *path);
+#endif
+
+#endif // ST7735_H_
@@ -0,0 +1,196 @@
+/*
+ * ================================================================
+ * File: telemetry.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: COBS framed binary telemetry of sensor frames.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "telemetry.h"
+#include "uart_console.h"
+
+//=============================================================================
+static uint8_t *TELEM_put16(uint8_t *out, uint16_t value) {
+  out[0] = value;
+  out[1] = value >> 8;
+  return out + 2;
+}
+
+static uint8_t *TELEM_put32(uint8_t *out, uint32_t value) {
+  out = TELEM_put16(out, value);
+  return TELEM_put16(out, value >> 16);
+}
+
+static uint16_t TELEM_get16(const uint8_t *in) { return in[0] | (in[1] << 8); }
+
+static uint32_t TELEM_get32(const uint8_t *in) {
+  return TELEM_get16(in) | ((uint32_t)TELEM_get16(in + 2) << 16);
+}
+
+//=============================================================================
+static uint16_t TELEM_fletcher16(const uint8_t *data, uint32_t length) {
+  uint32_t sum1 = 0;
+  uint32_t sum2 = 0;
+  uint32_t i;
+
+  for (i = 0; i < length; i++) {
+    sum1 = (sum1 + data[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  return (sum2 << 8) | sum1;
+}
+
+//=============================================================================
+void TELEM_init(tTelemetry *telemetry) {
+  telemetry->record_count = 0;
+  telemetry->sequence = 0;
+  telemetry->frames_sent = 0;
+  telemetry->records_sent = 0;
+  telemetry->records_dropped = 0;
+}
+
+//=============================================================================
+bool TELEM_add(tTelemetry *telemetry, uint32_t timestamp,
+               const uint16_t *values) {
+  uint8_t *out = telemetry->payload + 1 +
+                 telemetry->record_count * TELEM_RECORD_SIZE;
+  uint32_t i;
+
+  out = TELEM_put16(out, telemetry->sequence++);
+  out = TELEM_put32(out, timestamp);
+  for (i = 0; i < TELEM_CHANNELS; i++) {
+    out = TELEM_put16(out, values[i]);
+  }
+  if (++telemetry->record_count < TELEM_BATCH) {
+    return false;
+  }
+  return TELEM_flush(telemetry);
+}
+
+//=============================================================================
+bool TELEM_flush(tTelemetry *telemetry) {
+  uint8_t frame[TELEM_FRAME_MAX];
+  uint32_t length;
+  uint32_t count = telemetry->record_count;
+
+  if (count == 0) {
+    return false;
+  }
+  telemetry->record_count = 0;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  length = 1 + count * TELEM_RECORD_SIZE;
+  telemetry->payload[0] = count;
+  TELEM_put16(telemetry->payload + length,
+              TELEM_fletcher16(telemetry->payload, length));
+  length = TELEM_cobsEncode(telemetry->payload, length + 2, frame);
+  frame[length++] = 0;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A frame is only queued whole, a partial frame would be useless anyway
+  if (!CONSOLE_writeRaw(frame, length)) {
+    telemetry->records_dropped += count;
+    return false;
+  }
+  telemetry->frames_sent++;
+  telemetry->records_sent += count;
+  return true;
+}
+
+//=============================================================================
+uint32_t TELEM_cobsEncode(const uint8_t *in, uint32_t length, uint8_t *out) {
+  uint32_t read = 0;
+  uint32_t write = 1;
+  uint32_t code_index = 0;
+  uint8_t code = 1;
+
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Every 0x00 is replaced by the distance to the next one, and a run of 254
+  // bytes without any zero gets a 0xff code of its own
+  while (read < length) {
+    if (in[read] == 0) {
+      out[code_index] = code;
+      code = 1;
+      code_index = write++;
+      read++;
+    } else {
+      out[write++] = in[read++];
+      if (++code == 0xff) {
+        out[code_index] = code;
+        code = 1;
+        code_index = write++;
+      }
+    }
+  }
+  out[code_index] = code;
+  return write;
+}
+
+//=============================================================================
+int32_t TELEM_cobsDecode(const uint8_t *in, uint32_t length, uint8_t *out) {
+  uint32_t read = 0;
+  uint32_t write = 0;
+  uint32_t i;
+  uint8_t code;
+
+  while (read < length) {
+    code = in[read++];
+    if (code == 0 || read + code - 1 > length) {
+      return -1;
+    }
+    for (i = 1; i < code; i++) {
+      if (in[read] == 0) {
+        return -1;
+      }
+      out[write++] = in[read++];
+    }
+    if (code != 0xff && read != length) {
+      out[write++] = 0;
+    }
+  }
+  return write;
+}
+
+//=============================================================================
+int32_t TELEM_decodeFrame(const uint8_t *frame, uint32_t length,
+                          tTelemRecord *records, uint32_t max_records) {
+  uint8_t payload[TELEM_FRAME_MAX];
+  const uint8_t *in;
+  int32_t decoded;
+  uint32_t count;
+  uint32_t r;
+  uint32_t i;
+
+  if (length > TELEM_FRAME_MAX) {
+    return -1;
+  }
+  decoded = TELEM_cobsDecode(frame, length, payload);
+  if (decoded < 3) {
+    return -1;
+  }
+  count = payload[0];
+  if ((uint32_t)decoded != 1 + count * TELEM_RECORD_SIZE + 2 ||
+      count > max_records ||
+      TELEM_get16(payload + decoded - 2) !=
+          TELEM_fletcher16(payload, decoded - 2)) {
+    return -1;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  in = payload + 1;
+  for (r = 0; r < count; r++) {
+    records[r].sequence = TELEM_get16(in);
+    records[r].timestamp = TELEM_get32(in + 2);
+    in += 6;
+    for (i = 0; i < TELEM_CHANNELS; i++) {
+      records[r].value[i] = TELEM_get16(in);
+      in += 2;
+    }
+  }
+  return count;
+}
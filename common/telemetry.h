@@ -0,0 +1,83 @@
+/*
+ * ================================================================
+ * File: telemetry.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Binary telemetry stream of sensor frames over the UART
+ * console. Records are collected into batches, and every batch is sent as one
+ * COBS encoded frame ended by a 0x00 byte, so a receiver can always find the
+ * start of the next frame after losing bytes.
+ *
+ * Frame before COBS encoding, all values little-endian:
+ *   [record count, 1 byte]
+ *   count * [sequence, 2 bytes][timestamp, 4 bytes][value, 2 bytes] * 6
+ *   [Fletcher-16 checksum of everything before it, 2 bytes]
+ *
+ * The decoding functions have no hardware dependencies and are meant to be
+ * used on the host side as well.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Values per record: mic, joystick X/Y, accelerometer X/Y/Z
+#define TELEM_CHANNELS 6
+// Records per transmitted frame
+#define TELEM_BATCH 8
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#define TELEM_RECORD_SIZE (2 + 4 + 2 * TELEM_CHANNELS)
+#define TELEM_PAYLOAD_MAX (1 + TELEM_BATCH * TELEM_RECORD_SIZE + 2)
+// COBS adds one byte per 254 bytes plus one, and the frame ends with 0x00
+#define TELEM_FRAME_MAX (TELEM_PAYLOAD_MAX + TELEM_PAYLOAD_MAX / 254 + 2)
+
+//=============================================================================
+typedef struct {
+  uint16_t sequence;
+  uint32_t timestamp;
+  uint16_t value[TELEM_CHANNELS];
+} tTelemRecord;
+
+typedef struct {
+  uint8_t payload[TELEM_PAYLOAD_MAX];
+  uint32_t record_count;
+  uint16_t sequence;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  uint32_t frames_sent;
+  uint32_t records_sent;
+  // Records lost because the UART could not keep up
+  uint32_t records_dropped;
+} tTelemetry;
+
+//=============================================================================
+void TELEM_init(tTelemetry *telemetry);
+
+// Add one record, the batch is sent when it is full. Returns true when a
+// frame was queued for transmission.
+bool TELEM_add(tTelemetry *telemetry, uint32_t timestamp,
+               const uint16_t *values);
+
+// Send whatever records are collected, even if the batch is not full
+bool TELEM_flush(tTelemetry *telemetry);
+
+//=============================================================================
+// COBS encode length bytes. out needs room for length + length / 254 + 1
+// bytes. Returns the encoded length, the 0x00 delimiter is not added.
+uint32_t TELEM_cobsEncode(const uint8_t *in, uint32_t length, uint8_t *out);
+
+// Decode one COBS frame without its delimiter. Returns the decoded length or
+// -1 if the frame is malformed.
+int32_t TELEM_cobsDecode(const uint8_t *in, uint32_t length, uint8_t *out);
+
+// Decode one received frame, without its delimiter, into records. Returns
+// the number of records or -1 on a framing or checksum error.
+int32_t TELEM_decodeFrame(const uint8_t *frame, uint32_t length,
+                          tTelemRecord *records, uint32_t max_records);
+
+#endif // TELEMETRY_H_
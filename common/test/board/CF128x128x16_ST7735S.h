@@ -0,0 +1,28 @@
+/*
+ * ================================================================
+ * File: CF128x128x16_ST7735S.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h. The display needs tDisplay,
+ * so it is declared here with the grlib stand-in rather than in board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef CF128X128X16_ST7735S_H_
+#define CF128X128X16_ST7735S_H_
+
+#include "board.h"
+#include "grlib/grlib.h"
+
+//=============================================================================
+// The font of the LCD, the host font of the grlib stand-in takes its place
+#define g_sFontCm14 g_sFontHost
+
+extern const tDisplay g_sCF128x128x16_ST7735S;
+
+void CF128x128x16_ST7735SInit(uint32_t system_clock);
+void CF128x128x16_ST7735SClear(uint32_t colour);
+
+#endif // CF128X128X16_ST7735S_H_
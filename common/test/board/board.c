@@ -0,0 +1,26 @@
+/*
+ * ================================================================
+ * File: board.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the board functions of board.h, none of
+ * them does anything.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdint.h>
+//=============================================================================
+#include "board.h"
+
+//=============================================================================
+uint32_t SysCtlClockFreqSet(uint32_t config, uint32_t frequency) {
+  return frequency;
+}
+
+void PERIPH_init(uint32_t peripheral) {}
+
+void SENSOR_enable(uint32_t sensor) {}
@@ -0,0 +1,84 @@
+/*
+ * ================================================================
+ * File: board.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the TivaWare and board headers the 4.1
+ * games and 4.2 include, so that a test can compile a game's main.c as it
+ * is and drive its update and render functions. Every stand-in header
+ * includes this one. Only what the programs use outside of the common
+ * modules is here, and main() of a game is renamed by the test and never
+ * called. 4.2 is only compiled, the functions it alone uses are declared
+ * here but not defined in board.c.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// driverlib/sysctl.h
+#define SYSCTL_XTAL_25MHZ 0x00000680
+#define SYSCTL_OSC_INT 0x00000010
+#define SYSCTL_USE_PLL 0x00000000
+#define SYSCTL_CFG_VCO_480 0xF1000000
+#define SYSCTL_PERIPH_ADC0 0xf0003800
+#define SYSCTL_PERIPH_GPIOL 0xf000080a
+
+uint32_t SysCtlClockFreqSet(uint32_t config, uint32_t frequency);
+
+//=============================================================================
+// driverlib/adc.h
+#define ADC_CTL_CH0 0x00000000
+#define ADC_CTL_CH1 0x00000001
+#define ADC_CTL_CH2 0x00000002
+#define ADC_CTL_CH3 0x00000003
+#define ADC_CTL_CH8 0x00000008
+#define ADC_CTL_CH9 0x00000009
+#define ADC_CLOCK_SRC_PIOSC 0x00000001
+#define ADC_CLOCK_RATE_FULL 0x00000070
+
+void ADCClockConfigSet(uint32_t base, uint32_t config, uint32_t divider);
+
+//=============================================================================
+// driverlib/gpio.h
+#define GPIO_PIN_1 0x00000002
+
+//=============================================================================
+// driverlib/interrupt.h
+bool IntMasterEnable(void);
+
+//=============================================================================
+// driverlib/uart.h
+#define UART_CONFIG_WLEN_8 0x00000060
+#define UART_CONFIG_STOP_ONE 0x00000000
+#define UART_CONFIG_PAR_NONE 0x00000000
+
+void UARTConfigSetExpClk(uint32_t base, uint32_t clock, uint32_t baud,
+                         uint32_t config);
+
+//=============================================================================
+// inc/hw_memmap.h
+#define ADC0_BASE 0x40038000
+#define GPIO_PORTL_BASE 0x40062000
+#define TIMER0_BASE 0x40030000
+#define UART0_BASE 0x4000C000
+
+//=============================================================================
+// tm4c129_functions.h
+#define JOYSTICK 0x1
+#define MICROPHONE 0x2
+#define ACCELEROMETER 0x4
+
+void PERIPH_init(uint32_t peripheral);
+void SENSOR_enable(uint32_t sensor);
+void ConfigureUART(void);
+uint32_t abs_diff(uint32_t a, uint32_t b);
+
+
+#endif // BOARD_H_
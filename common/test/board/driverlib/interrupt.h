@@ -0,0 +1,17 @@
+/*
+ * ================================================================
+ * File: interrupt.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef INTERRUPT_H_
+#define INTERRUPT_H_
+
+#include "board.h"
+
+#endif // INTERRUPT_H_
@@ -0,0 +1,17 @@
+/*
+ * ================================================================
+ * File: pin_map.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef PIN_MAP_H_
+#define PIN_MAP_H_
+
+#include "board.h"
+
+#endif // PIN_MAP_H_
@@ -0,0 +1,17 @@
+/*
+ * ================================================================
+ * File: hw_memmap.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef HW_MEMMAP_H_
+#define HW_MEMMAP_H_
+
+#include "board.h"
+
+#endif // HW_MEMMAP_H_
@@ -0,0 +1,17 @@
+/*
+ * ================================================================
+ * File: tm4c129encpdt.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef TM4C129ENCPDT_H_
+#define TM4C129ENCPDT_H_
+
+#include "board.h"
+
+#endif // TM4C129ENCPDT_H_
@@ -0,0 +1,17 @@
+/*
+ * ================================================================
+ * File: uartstdio.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in, see board.h.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef UARTSTDIO_H_
+#define UARTSTDIO_H_
+
+#include "board.h"
+
+#endif // UARTSTDIO_H_
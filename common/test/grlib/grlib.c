@@ -0,0 +1,164 @@
+/*
+ * ================================================================
+ * File: grlib.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the part of TivaWare grlib the common
+ * modules use.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "grlib.h"
+
+//=============================================================================
+// 14 pixels high, the digits 8 wide and the rest 4 to 13 wide
+const tFont g_sFontHost = {
+    14,
+    {4,  5,  6,  10, 9,  12, 11, 4,  6,  6,  7,  9,  4,  6,  4,  6,
+     8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  4,  4,  9,  9,  9,  7,
+     13, 10, 9,  10, 10, 9,  9,  11, 10, 5,  7,  10, 9,  12, 10, 11,
+     9,  11, 10, 8,  9,  10, 10, 13, 10, 10, 9,  5,  6,  5,  8,  8,
+     5,  8,  8,  7,  8,  7,  6,  8,  8,  4,  5,  8,  4,  12, 8,  8,
+     8,  8,  6,  7,  6,  8,  8,  11, 8,  8,  7,  6,  4,  6,  9}};
+
+//=============================================================================
+static int32_t GrHostWidth(const tFont *psFont, char cCharacter) {
+  if (cCharacter < ' ' || cCharacter > '~') {
+    return 0;
+  }
+  return psFont->pui8Width[cCharacter - ' '];
+}
+
+uint32_t GrHostFontRow(const tFont *psFont, char cCharacter, int32_t i32Row) {
+  uint32_t ui32Hash = (uint8_t)cCharacter * 2654435761u + i32Row * 40503u;
+
+  // The outer column and the top and bottom rows stay background, like the
+  // spacing of a real font
+  if (cCharacter == ' ' || i32Row == 0 || i32Row == psFont->ui8Height - 1) {
+    return 0;
+  }
+  ui32Hash ^= ui32Hash >> 13;
+  ui32Hash *= 0x5bd1e995;
+  ui32Hash ^= ui32Hash >> 15;
+  return ui32Hash & ((1u << (GrHostWidth(psFont, cCharacter) - 1)) - 1);
+}
+
+//=============================================================================
+void GrContextInit(tContext *psContext, const tDisplay *psDisplay) {
+  psContext->i32Size = sizeof(tContext);
+  psContext->psDisplay = psDisplay;
+  psContext->sClipRegion.i16XMin = 0;
+  psContext->sClipRegion.i16YMin = 0;
+  psContext->sClipRegion.i16XMax = psDisplay->ui16Width - 1;
+  psContext->sClipRegion.i16YMax = psDisplay->ui16Height - 1;
+  psContext->ui32Foreground = 0;
+  psContext->ui32Background = 0;
+  psContext->psFont = 0;
+}
+
+//=============================================================================
+void GrContextClipRegionSet(tContext *psContext, tRectangle *psRect) {
+  int32_t i32W = psContext->psDisplay->ui16Width;
+  int32_t i32H = psContext->psDisplay->ui16Height;
+
+  psContext->sClipRegion.i16XMin = psRect->i16XMin < 0 ? 0 : psRect->i16XMin;
+  psContext->sClipRegion.i16YMin = psRect->i16YMin < 0 ? 0 : psRect->i16YMin;
+  psContext->sClipRegion.i16XMax =
+      psRect->i16XMax >= i32W ? i32W - 1 : psRect->i16XMax;
+  psContext->sClipRegion.i16YMax =
+      psRect->i16YMax >= i32H ? i32H - 1 : psRect->i16YMax;
+}
+
+//=============================================================================
+void GrRectFill(const tContext *psContext, const tRectangle *psRect) {
+  tRectangle sRect = *psRect;
+  const tRectangle *psClip = &psContext->sClipRegion;
+
+  if (sRect.i16XMin < psClip->i16XMin) {
+    sRect.i16XMin = psClip->i16XMin;
+  }
+  if (sRect.i16YMin < psClip->i16YMin) {
+    sRect.i16YMin = psClip->i16YMin;
+  }
+  if (sRect.i16XMax > psClip->i16XMax) {
+    sRect.i16XMax = psClip->i16XMax;
+  }
+  if (sRect.i16YMax > psClip->i16YMax) {
+    sRect.i16YMax = psClip->i16YMax;
+  }
+  if (sRect.i16XMin > sRect.i16XMax || sRect.i16YMin > sRect.i16YMax) {
+    return;
+  }
+  DpyRectFill(psContext->psDisplay, &sRect, psContext->ui32Foreground);
+}
+
+//=============================================================================
+int32_t GrStringWidthGet(const tContext *psContext, const char *pcString,
+                         int32_t i32Length) {
+  int32_t i32Width = 0;
+
+  while (i32Length-- != 0 && *pcString != '\0') {
+    i32Width += GrHostWidth(psContext->psFont, *pcString++);
+  }
+  return i32Width;
+}
+
+//=============================================================================
+// Every row of a character cell is packed 1 bit per pixel, leftmost pixel in
+// the top bit, and the part inside the clipping region is drawn with one
+// call, as grlib does
+void GrStringDraw(const tContext *psContext, const char *pcString,
+                  int32_t i32Length, int32_t i32X, int32_t i32Y,
+                  uint32_t bOpaque) {
+  const tRectangle *psClip = &psContext->sClipRegion;
+  const tFont *psFont = psContext->psFont;
+  uint32_t pui32Palette[2];
+  uint8_t pui8Row[4];
+  uint32_t ui32Bits;
+  int32_t i32Width;
+  int32_t i32Row;
+  int32_t i32X0;
+  int32_t i32X1;
+  int32_t i;
+
+  pui32Palette[0] = psContext->ui32Background;
+  pui32Palette[1] = psContext->ui32Foreground;
+  for (; i32Length-- != 0 && *pcString != '\0'; pcString++) {
+    i32Width = GrHostWidth(psFont, *pcString);
+    i32X0 = i32X < psClip->i16XMin ? psClip->i16XMin - i32X : 0;
+    i32X1 = i32X + i32Width - 1 > psClip->i16XMax ? psClip->i16XMax - i32X
+                                                  : i32Width - 1;
+    for (i32Row = 0; i32Row < psFont->ui8Height && i32X0 <= i32X1; i32Row++) {
+      if (i32Y + i32Row < psClip->i16YMin || i32Y + i32Row > psClip->i16YMax) {
+        continue;
+      }
+      ui32Bits = GrHostFontRow(psFont, *pcString, i32Row);
+      if (bOpaque) {
+        for (i = 0; i < 4; i++) {
+          pui8Row[i] = 0;
+        }
+        for (i = 0; i < i32Width; i++) {
+          pui8Row[i >> 3] |= ((ui32Bits >> i) & 1) << (7 - (i & 7));
+        }
+        DpyPixelDrawMultiple(psContext->psDisplay, i32X + i32X0, i32Y + i32Row,
+                             i32X0, i32X1 - i32X0 + 1, 1, pui8Row,
+                             (const uint8_t *)pui32Palette);
+        continue;
+      }
+      for (i = i32X0; i <= i32X1; i++) {
+        if ((ui32Bits >> i) & 1) {
+          DpyPixelDraw(psContext->psDisplay, i32X + i, i32Y + i32Row,
+                       psContext->ui32Foreground);
+        }
+      }
+    }
+    i32X += i32Width;
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ * ================================================================
+ * File: grlib.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the part of TivaWare grlib the common
+ * modules use, so they build and can be tested without the drivers
+ * submodule. The types and the display interface are the ones of grlib,
+ * drawing goes through the display functions the same way.
+ *
+ * The font is not a grlib font. g_sFontHost is a generated proportional
+ * font: every character has its own width and a fixed pseudo random bit
+ * pattern, and the digits are all equally wide like those of the Cm fonts.
+ * Text is drawn the way grlib draws it, one call to pfnPixelDrawMultiple
+ * with 1 bit per pixel for each row of each character cell.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef GRLIB_H_
+#define GRLIB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+typedef struct {
+  int16_t i16XMin;
+  int16_t i16YMin;
+  int16_t i16XMax;
+  int16_t i16YMax;
+} tRectangle;
+
+typedef struct {
+  int32_t i32Size;
+  void *pvDisplayData;
+  uint16_t ui16Width;
+  uint16_t ui16Height;
+  void (*pfnPixelDraw)(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                       uint32_t ui32Value);
+  void (*pfnPixelDrawMultiple)(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                               int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+                               const uint8_t *pui8Data,
+                               const uint8_t *pui8Palette);
+  void (*pfnLineDrawH)(void *pvDisplayData, int32_t i32X1, int32_t i32X2,
+                       int32_t i32Y, uint32_t ui32Value);
+  void (*pfnLineDrawV)(void *pvDisplayData, int32_t i32X, int32_t i32Y1,
+                       int32_t i32Y2, uint32_t ui32Value);
+  void (*pfnRectFill)(void *pvDisplayData, const tRectangle *psRect,
+                      uint32_t ui32Value);
+  uint32_t (*pfnColorTranslate)(void *pvDisplayData, uint32_t ui32Value);
+  void (*pfnFlush)(void *pvDisplayData);
+} tDisplay;
+
+// Widths of the printable characters ' ' to '~', the rows come from
+// GrHostFontRow()
+typedef struct {
+  uint8_t ui8Height;
+  uint8_t pui8Width[95];
+} tFont;
+
+typedef struct {
+  int32_t i32Size;
+  const tDisplay *psDisplay;
+  tRectangle sClipRegion;
+  uint32_t ui32Foreground;
+  uint32_t ui32Background;
+  const tFont *psFont;
+} tContext;
+
+//=============================================================================
+#define ClrBlack 0x00000000
+#define ClrWhite 0x00FFFFFF
+#define ClrRed 0x00FF0000
+#define ClrGreen 0x00008000
+#define ClrBlue 0x000000FF
+#define ClrYellow 0x00FFFF00
+
+//=============================================================================
+#define DpyColorTranslate(psDisplay, ui32Value)                                \
+  ((psDisplay)->pfnColorTranslate((psDisplay)->pvDisplayData, ui32Value))
+#define DpyPixelDraw(psDisplay, i32X, i32Y, ui32Value)                         \
+  ((psDisplay)->pfnPixelDraw((psDisplay)->pvDisplayData, i32X, i32Y,           \
+                             ui32Value))
+#define DpyPixelDrawMultiple(psDisplay, i32X, i32Y, i32X0, i32Count, i32BPP,   \
+                             pui8Data, pui8Palette)                            \
+  ((psDisplay)->pfnPixelDrawMultiple((psDisplay)->pvDisplayData, i32X, i32Y,   \
+                                     i32X0, i32Count, i32BPP, pui8Data,        \
+                                     pui8Palette))
+#define DpyLineDrawH(psDisplay, i32X1, i32X2, i32Y, ui32Value)                 \
+  ((psDisplay)->pfnLineDrawH((psDisplay)->pvDisplayData, i32X1, i32X2, i32Y,   \
+                             ui32Value))
+#define DpyRectFill(psDisplay, psRect, ui32Value)                              \
+  ((psDisplay)->pfnRectFill((psDisplay)->pvDisplayData, psRect, ui32Value))
+#define DpyFlush(psDisplay) ((psDisplay)->pfnFlush((psDisplay)->pvDisplayData))
+
+//=============================================================================
+#define GrContextFontSet(psContext, psFnt)                                     \
+  do {                                                                         \
+    (psContext)->psFont = (psFnt);                                             \
+  } while (0)
+#define GrContextForegroundSetTranslated(psContext, ui32Value)                 \
+  do {                                                                         \
+    (psContext)->ui32Foreground = (ui32Value);                                 \
+  } while (0)
+#define GrContextBackgroundSetTranslated(psContext, ui32Value)                 \
+  do {                                                                         \
+    (psContext)->ui32Background = (ui32Value);                                 \
+  } while (0)
+#define GrContextForegroundSet(psContext, ui32Value)                           \
+  GrContextForegroundSetTranslated(                                            \
+      psContext, DpyColorTranslate((psContext)->psDisplay, ui32Value))
+#define GrContextBackgroundSet(psContext, ui32Value)                           \
+  GrContextBackgroundSetTranslated(                                            \
+      psContext, DpyColorTranslate((psContext)->psDisplay, ui32Value))
+#define GrStringHeightGet(psContext) ((psContext)->psFont->ui8Height)
+#define GrFlush(psContext) DpyFlush((psContext)->psDisplay)
+
+//=============================================================================
+void GrContextInit(tContext *psContext, const tDisplay *psDisplay);
+void GrContextClipRegionSet(tContext *psContext, tRectangle *psRect);
+void GrRectFill(const tContext *psContext, const tRectangle *psRect);
+
+// A length of -1 draws or measures up to the terminator
+int32_t GrStringWidthGet(const tContext *psContext, const char *pcString,
+                         int32_t i32Length);
+void GrStringDraw(const tContext *psContext, const char *pcString,
+                  int32_t i32Length, int32_t i32X, int32_t i32Y,
+                  uint32_t bOpaque);
+
+//=============================================================================
+extern const tFont g_sFontHost;
+
+// Pixels of one row of a character, bit 0 is the leftmost
+uint32_t GrHostFontRow(const tFont *psFont, char cCharacter, int32_t i32Row);
+
+#endif // GRLIB_H_
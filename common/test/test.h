@@ -0,0 +1,60 @@
+/*
+ * ================================================================
+ * File: test.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Minimal check and timing helpers for the host tests of the
+ * common modules. A failed check is reported with its location and the
+ * test keeps going, TEST_finish() turns the failure count into the exit
+ * status.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+//=============================================================================
+static int g_iTestFailures;
+
+#define TEST_CHECK(condition)                                                  \
+  TEST_check((condition), #condition, __FILE__, __LINE__)
+
+static inline bool TEST_check(bool ok, const char *expression,
+                              const char *file, int line) {
+  if (!ok) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    g_iTestFailures++;
+  }
+  return ok;
+}
+
+// Exit status of the test
+static inline int TEST_finish(const char *name) {
+  if (g_iTestFailures != 0) {
+    printf("%s: %d check(s) failed\n", name, g_iTestFailures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+//=============================================================================
+// Monotonic time in seconds for the benchmarks, unlike CYCLES_now() it does
+// not wrap during a long run
+static inline double TEST_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Keep the compiler from optimising away a benchmarked result
+static volatile uint32_t g_ui32TestSink;
+
+#endif // TEST_H_
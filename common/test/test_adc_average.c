@@ -0,0 +1,147 @@
+/*
+ * ================================================================
+ * File: test_adc_average.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host benchmark of the averaging backends on a simulated ADC
+ * with Gaussian noise: the noise left in the averaged values, against the
+ * 1 / sqrt(N) of averaging N conversions, and the samples the CPU has to
+ * sum per value. The software part is cut to the depth of the sequencer.
+ *
+ * On the host the hardware averaging is simulated by the CPU as well, so
+ * the host time per value only compares the software part of the backends.
+ * On the target the hardware backend costs one trigger and one FIFO read
+ * per value, whatever the factor.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+//=============================================================================
+#include "adc_average.h"
+#include "test.h"
+
+#define LEVEL 2000.3
+#define NOISE 8.0
+#define VALUES 4000
+// ADC_TRIGGER_PROCESSOR, the host has no driverlib
+#define TRIGGER 0
+
+//=============================================================================
+// 12-bit conversions of LEVEL with Gaussian noise of NOISE LSB
+static uint32_t noisySource(void *argument) {
+  double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double sample = LEVEL + NOISE * sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+
+  (void)argument;
+  if (sample < 0) {
+    return 0;
+  }
+  return sample > 4095 ? 4095 : (uint32_t)(sample + 0.5);
+}
+
+// The values of a list, one after the other
+static uint32_t listSource(void *argument) {
+  const uint32_t **next = argument;
+
+  return *(*next)++;
+}
+
+//=============================================================================
+// The hardware truncates its sum, the software rounds to nearest. A sequence
+// taken in its interrupt gives the same value as a read.
+static void testRounding(void) {
+  static const uint32_t samples[] = {0, 1, 0, 1, 0, 1, 0, 1};
+  const uint32_t *next;
+  tADCAverage average;
+
+  ADC_averageHostSource(listSource, &next);
+  next = samples;
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, ADC_AVERAGE_HARDWARE, 2, 0);
+  TEST_CHECK(ADC_averageRead(&average) == 0);
+  next = samples;
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, ADC_AVERAGE_SOFTWARE, 2, 1);
+  TEST_CHECK(average.hardware_factor == 1);
+  TEST_CHECK(ADC_averageRead(&average) == 1);
+  next = samples;
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, ADC_AVERAGE_BOTH, 2, 2);
+  TEST_CHECK(ADC_averageTake(&average) == 0);
+  next = samples;
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, ADC_AVERAGE_SOFTWARE, 1, 0);
+  TEST_CHECK(ADC_averageRead(&average) == 0);
+  TEST_CHECK(ADC_averageTake(&average) == 1);
+  TEST_CHECK(average.values == 2);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Sequencer 0 holds 8 steps, 1 and 2 hold 4 and 3 only one
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, ADC_AVERAGE_SOFTWARE, 1, 5);
+  TEST_CHECK(average.software_log2 == 3);
+  ADC_averageInit(&average, 0, 2, 0, TRIGGER, ADC_AVERAGE_BOTH, 4, 3);
+  TEST_CHECK(average.software_log2 == 2);
+  ADC_averageInit(&average, 0, 3, 0, TRIGGER, ADC_AVERAGE_SOFTWARE, 1, 2);
+  TEST_CHECK(average.software_log2 == 0);
+}
+
+//=============================================================================
+// Standard deviation of VALUES averaged values, compared with NOISE /
+// sqrt(factor). Some noise is left by the rounding and the truncation,
+// so the check allows for a quarter LSB more.
+static void noise(tADCAverageBackend backend, uint32_t hardware_factor,
+                  uint32_t software_log2) {
+  static const char *const names[] = {"software", "hardware", "both"};
+  tADCAverage average;
+  double sum = 0;
+  double squares = 0;
+  double deviation;
+  double expected;
+  double mean;
+  uint32_t factor;
+  uint32_t value;
+  uint32_t i;
+
+  srand(1);
+  ADC_averageHostSource(noisySource, 0);
+  ADC_averageInit(&average, 0, 0, 0, TRIGGER, backend, hardware_factor,
+                  software_log2);
+  factor = average.hardware_factor << average.software_log2;
+  for (i = 0; i < VALUES; i++) {
+    value = ADC_averageRead(&average);
+    sum += value;
+    squares += (double)value * value;
+  }
+  mean = sum / VALUES;
+  deviation = sqrt(squares / VALUES - mean * mean);
+  expected = NOISE / sqrt(factor);
+  printf("  %-8s %2u x %u: mean %7.2f, noise %5.2f LSB (%5.2f expected), "
+         "%u samples summed, %6u host ns per value\n",
+         names[backend], average.hardware_factor, 1u << average.software_log2,
+         mean, deviation, expected, 1u << average.software_log2,
+         ADC_averageCyclesPerValue(&average));
+  TEST_CHECK(deviation < expected * 1.1 + 0.25);
+  // The hardware truncation pulls the mean down by up to one LSB
+  TEST_CHECK(fabs(mean - LEVEL) < 1.0);
+  TEST_CHECK(average.values == VALUES);
+  TEST_CHECK(average.cycles_max >= ADC_averageCyclesPerValue(&average));
+}
+
+//=============================================================================
+int main(void) {
+  testRounding();
+  printf("noise left after averaging %.1f LSB of noise:\n", NOISE);
+  noise(ADC_AVERAGE_SOFTWARE, 1, 0);
+  noise(ADC_AVERAGE_SOFTWARE, 1, 2);
+  noise(ADC_AVERAGE_SOFTWARE, 1, 3);
+  noise(ADC_AVERAGE_HARDWARE, 4, 0);
+  noise(ADC_AVERAGE_HARDWARE, 16, 0);
+  noise(ADC_AVERAGE_HARDWARE, 64, 0);
+  noise(ADC_AVERAGE_BOTH, 16, 2);
+  noise(ADC_AVERAGE_BOTH, 64, 3);
+  return TEST_finish("test_adc_average");
+}
@@ -0,0 +1,182 @@
+/*
+ * ================================================================
+ * File: test_adc_pingpong.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the ping-pong buffer swaps, driven through the
+ * uDMA stand-in, and a benchmark of the samples per second the swap logic
+ * can hand to a consumer.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "adc_pingpong.h"
+#include "test.h"
+
+#define BLOCK_SIZE 16
+
+static uint32_t g_pui32Ping[BLOCK_SIZE];
+static uint32_t g_pui32Pong[BLOCK_SIZE];
+
+//=============================================================================
+// Block n holds n * BLOCK_SIZE + i at position i
+static void makeBlock(uint32_t *block, uint32_t n) {
+  uint32_t i;
+
+  for (i = 0; i < BLOCK_SIZE; i++) {
+    block[i] = n * BLOCK_SIZE + i;
+  }
+}
+
+static bool isBlock(const uint32_t *block, uint32_t n) {
+  uint32_t expected[BLOCK_SIZE];
+
+  makeBlock(expected, n);
+  return memcmp(block, expected, sizeof(expected)) == 0;
+}
+
+//=============================================================================
+// A consumer that keeps up sees every block once, in order, from alternating
+// halves
+static void testInOrder(void) {
+  tADCPingPong pp;
+  uint32_t samples[BLOCK_SIZE];
+  uint32_t *block;
+  uint32_t n;
+
+  ADC_pingpongInit(&pp, 0, 0, g_pui32Ping, g_pui32Pong, BLOCK_SIZE);
+  TEST_CHECK(ADC_pingpongGetBlock(&pp) == 0);
+  for (n = 0; n < 10; n++) {
+    makeBlock(samples, n);
+    ADC_pingpongHostFill(&pp, samples);
+    block = ADC_pingpongGetBlock(&pp);
+    TEST_CHECK(block == (n & 1 ? g_pui32Pong : g_pui32Ping));
+    TEST_CHECK(block != 0 && isBlock(block, n));
+    TEST_CHECK(ADC_pingpongBlockIndex(&pp) == n);
+    ADC_pingpongRelease(&pp);
+    TEST_CHECK(ADC_pingpongGetBlock(&pp) == 0);
+  }
+  TEST_CHECK(pp.blocks_completed == 10);
+  TEST_CHECK(pp.overruns == 0);
+}
+
+//=============================================================================
+// Both halves may be full before the consumer gets to them, a third block
+// then overwrites the oldest unread one and is counted as an overrun
+static void testOverrun(void) {
+  tADCPingPong pp;
+  uint32_t samples[BLOCK_SIZE];
+  uint32_t *block;
+  uint32_t n;
+
+  ADC_pingpongInit(&pp, 0, 0, g_pui32Ping, g_pui32Pong, BLOCK_SIZE);
+  for (n = 0; n < 2; n++) {
+    makeBlock(samples, n);
+    ADC_pingpongHostFill(&pp, samples);
+  }
+  TEST_CHECK(pp.overruns == 0);
+  block = ADC_pingpongGetBlock(&pp);
+  TEST_CHECK(block != 0 && isBlock(block, 0));
+  ADC_pingpongRelease(&pp);
+  block = ADC_pingpongGetBlock(&pp);
+  TEST_CHECK(block != 0 && isBlock(block, 1));
+  ADC_pingpongRelease(&pp);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  for (n = 2; n < 5; n++) {
+    makeBlock(samples, n);
+    ADC_pingpongHostFill(&pp, samples);
+  }
+  TEST_CHECK(pp.overruns == 1);
+  block = ADC_pingpongGetBlock(&pp);
+  TEST_CHECK(block == g_pui32Ping && isBlock(block, 4));
+  TEST_CHECK(ADC_pingpongBlockIndex(&pp) == 4);
+}
+
+//=============================================================================
+// With a handler every block goes to it in the interrupt, in order, and
+// nothing is left for the consumer
+static uint32_t g_ui32HandlerBlocks;
+static bool g_bHandlerOrdered = true;
+
+static void countBlock(const uint32_t *block, uint32_t index, void *argument) {
+  if (index != g_ui32HandlerBlocks || !isBlock(block, index) ||
+      argument != &g_ui32HandlerBlocks) {
+    g_bHandlerOrdered = false;
+  }
+  g_ui32HandlerBlocks++;
+}
+
+static void testHandler(void) {
+  tADCPingPong pp;
+  uint32_t samples[BLOCK_SIZE];
+  uint32_t n;
+
+  ADC_pingpongInit(&pp, 0, 0, g_pui32Ping, g_pui32Pong, BLOCK_SIZE);
+  ADC_pingpongSetHandler(&pp, countBlock, &g_ui32HandlerBlocks);
+  for (n = 0; n < 100; n++) {
+    makeBlock(samples, n);
+    ADC_pingpongHostFill(&pp, samples);
+  }
+  TEST_CHECK(g_ui32HandlerBlocks == 100);
+  TEST_CHECK(g_bHandlerOrdered);
+  TEST_CHECK(ADC_pingpongGetBlock(&pp) == 0);
+  TEST_CHECK(pp.overruns == 0);
+}
+
+//=============================================================================
+// Fill, take and release blocks back to back, summing each one the way the
+// averaging code does
+static void benchmark(uint32_t block_size) {
+  static uint32_t ping[1024];
+  static uint32_t pong[1024];
+  static uint32_t samples[1024];
+  tADCPingPong pp;
+  uint32_t *block;
+  uint32_t blocks = (1u << 24) / block_size;
+  uint32_t sum = 0;
+  uint32_t n;
+  uint32_t i;
+  double start;
+  double seconds;
+
+  for (i = 0; i < block_size; i++) {
+    samples[i] = i & 0xfff;
+  }
+  ADC_pingpongInit(&pp, 0, 0, ping, pong, block_size);
+  start = TEST_seconds();
+  for (n = 0; n < blocks; n++) {
+    ADC_pingpongHostFill(&pp, samples);
+    block = ADC_pingpongGetBlock(&pp);
+    for (i = 0; i < block_size; i++) {
+      sum += block[i];
+    }
+    ADC_pingpongRelease(&pp);
+  }
+  seconds = TEST_seconds() - start;
+  g_ui32TestSink = sum;
+  TEST_CHECK(pp.overruns == 0);
+  printf("  block %4u: %7.1f Msamples/s, %6.1f ns per block\n", block_size,
+         blocks * block_size / seconds * 1e-6, seconds / blocks * 1e9);
+}
+
+//=============================================================================
+int main(void) {
+  testInOrder();
+  testOverrun();
+  testHandler();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  printf("adc_pingpong throughput, fill + take + sum + release:\n");
+  benchmark(16);
+  benchmark(64);
+  benchmark(256);
+  benchmark(1024);
+  return TEST_finish("test_adc_pingpong");
+}
@@ -0,0 +1,126 @@
+/*
+ * ================================================================
+ * File: test_brightness.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the LED brightness. BRIGHT_FROM_PERCENT() has
+ * to reach both ends, the gamma table may never go down and has to follow
+ * the 2.2 curve, and the pin is only remuxed when the level crosses into or
+ * out of 0% or 100%.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+//=============================================================================
+#include "brightness.h"
+#include "test.h"
+
+// A PWM period in ticks, as 2.2 has at 16 MHz
+#define PERIOD 16000
+
+//=============================================================================
+// 0% and 100% are the two ends, every percentage in between is rounded to
+// the nearest level and a larger percentage never gives a lower level
+static void testPercent(void) {
+  double error = 0;
+  bool rising = true;
+  uint32_t percent;
+
+  TEST_CHECK(BRIGHT_FROM_PERCENT(0) == 0);
+  TEST_CHECK(BRIGHT_FROM_PERCENT(100) == BRIGHT_MAX);
+  for (percent = 1; percent <= 100; percent++) {
+    rising &= BRIGHT_FROM_PERCENT(percent) > BRIGHT_FROM_PERCENT(percent - 1);
+    error = fmax(error, fabs(BRIGHT_FROM_PERCENT(percent) -
+                             percent * BRIGHT_MAX / 100.0));
+  }
+  printf("  percent: max error %.2f levels\n", error);
+  TEST_CHECK(rising);
+  TEST_CHECK(error <= 0.5);
+}
+
+//=============================================================================
+// The table is (i / 256)^2.2, so level l is at (l / 1024)^2.2 and only
+// BRIGHT_MAX itself is fully on. The pulse widths follow it and stay
+// between 1 and PERIOD - 1.
+static void testGamma(void) {
+  tBrightness led;
+  double error = 0;
+  bool rising = true;
+  bool widths = true;
+  uint32_t width = 1;
+  uint32_t level;
+
+  BRIGHT_init(&led, 0, 0, 0, 0, PERIOD);
+  TEST_CHECK(BRIGHT_gamma(0) == 0);
+  TEST_CHECK(BRIGHT_gamma(BRIGHT_MAX) == 65535);
+  TEST_CHECK(BRIGHT_gamma(BRIGHT_MAX + 1) == 65535);
+  for (level = 1; level <= BRIGHT_MAX; level++) {
+    rising &= BRIGHT_gamma(level) >= BRIGHT_gamma(level - 1);
+    if (level < BRIGHT_MAX) {
+      error = fmax(error, fabs(BRIGHT_gamma(level) -
+                               65535 * pow(level / 1024.0, 2.2)));
+      BRIGHT_set(&led, level);
+      widths &= led.width >= width && led.width <= PERIOD - 1;
+      width = led.width;
+    }
+  }
+  printf("  gamma: max error %.1f of 65535 against the curve\n", error);
+  TEST_CHECK(rising);
+  TEST_CHECK(widths);
+  TEST_CHECK(error <= 2);
+}
+
+//=============================================================================
+// Only the ends are driven as a GPIO, a sweep from off to on and back
+// remuxes four times however many levels it goes through
+static void testRemux(void) {
+  tBrightness led;
+  uint32_t level;
+
+  BRIGHT_init(&led, 0, 0, 0, 0, PERIOD);
+  TEST_CHECK(led.state == BRIGHT_PWM && led.width == 1);
+  BRIGHT_set(&led, 1);
+  TEST_CHECK(led.state == BRIGHT_PWM && led.remuxes == 0);
+  BRIGHT_set(&led, BRIGHT_FROM_PERCENT(0));
+  TEST_CHECK(led.state == BRIGHT_OFF && led.remuxes == 1);
+  BRIGHT_set(&led, 0);
+  TEST_CHECK(led.state == BRIGHT_OFF && led.remuxes == 1);
+  // Straight from one end to the other is a single remux
+  BRIGHT_set(&led, BRIGHT_FROM_PERCENT(100));
+  TEST_CHECK(led.state == BRIGHT_ON && led.remuxes == 2);
+  BRIGHT_set(&led, BRIGHT_MAX + 100);
+  TEST_CHECK(led.state == BRIGHT_ON && led.remuxes == 2);
+  TEST_CHECK(led.level == BRIGHT_MAX);
+  // Leaving an end, the width is already the one for the new level
+  BRIGHT_set(&led, BRIGHT_MAX - 1);
+  TEST_CHECK(led.state == BRIGHT_PWM && led.remuxes == 3);
+  TEST_CHECK(led.width ==
+             (uint32_t)((uint64_t)BRIGHT_gamma(BRIGHT_MAX - 1) * PERIOD >> 16));
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  BRIGHT_set(&led, 0);
+  led.remuxes = 0;
+  for (level = 0; level <= BRIGHT_MAX; level++) {
+    BRIGHT_set(&led, level);
+  }
+  for (level = BRIGHT_MAX + 1; level > 0; level--) {
+    BRIGHT_set(&led, level - 1);
+  }
+  printf("  remuxes in a sweep: %u\n", led.remuxes);
+  TEST_CHECK(led.state == BRIGHT_OFF && led.remuxes == 4);
+}
+
+//=============================================================================
+int main(void) {
+  printf("brightness:\n");
+  testPercent();
+  testGamma();
+  testRemux();
+  return TEST_finish("test_brightness");
+}
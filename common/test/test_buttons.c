@@ -0,0 +1,227 @@
+/*
+ * ================================================================
+ * File: test_buttons.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host simulation of a bouncing button, S1 as the 4.2
+ * calibration uses it. The contacts bounce on every press and release,
+ * mostly for a few milliseconds and now and then for longer than the 10 ms
+ * the accelerometer task runs at, and the task pops the events every 10 ms:
+ *  - every press and release is one event, stamped with the time of the
+ *    first edge, and the presses toggle the calibration once each
+ *  - a hold longer than BTN_LONG_MS gives one long press
+ * The same edges polled every 10 ms with an edge detection, the way 4.2 read
+ * PL1 before, see extra presses in the longer bounces.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+//=============================================================================
+#include "button_events.h"
+#include "test.h"
+
+#define PRESSES 2000
+// The clock counts microseconds
+#define TICKS_PER_MS 1000
+#define TASK_PERIOD (10 * TICKS_PER_MS)
+#define EVENTS_PER_RUN 4
+
+typedef struct {
+  // The contacts, and when the task runs next
+  bool level;
+  uint32_t next_run;
+  // Kept by the task from the events
+  uint32_t presses;
+  uint32_t releases;
+  uint32_t longs;
+  uint32_t repeats;
+  uint32_t wrong_order;
+  uint32_t wrong_time;
+  bool calibrating;
+  uint32_t toggles;
+  uint32_t latency_max;
+  // The first edges of the press and release the task waits for
+  uint32_t press_edge;
+  uint32_t release_edge;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The old way, the level read each run
+  bool polled_previous;
+  bool polled_waiting;
+  uint32_t polled_presses;
+  uint32_t polled_latency_max;
+} tSimulation;
+
+static tSimulation g_sSimulation;
+static uint32_t g_ui32Now;
+static uint32_t g_ui32Random;
+
+static uint32_t now(void) { return g_ui32Now; }
+
+static uint32_t random32(void) {
+  g_ui32Random = g_ui32Random * 1664525 + 1013904223;
+  return g_ui32Random >> 8;
+}
+
+//=============================================================================
+// The accelerometer task: the calibration toggles on every press
+static void task(tSimulation *simulation) {
+  tBtnEvent events[EVENTS_PER_RUN];
+  uint32_t count;
+  uint32_t latency;
+  uint32_t i;
+  bool down;
+
+  do {
+    count = BTN_pop(events, EVENTS_PER_RUN);
+    for (i = 0; i < count; i++) {
+      latency = g_ui32Now - events[i].time;
+      if (latency > simulation->latency_max) {
+        simulation->latency_max = latency;
+      }
+      switch (events[i].type) {
+      case BTN_PRESS:
+        simulation->wrong_order += simulation->presses != simulation->releases;
+        simulation->wrong_time += events[i].time != simulation->press_edge;
+        simulation->presses++;
+        simulation->calibrating = !simulation->calibrating;
+        simulation->toggles++;
+        break;
+      case BTN_RELEASE:
+        simulation->releases++;
+        simulation->wrong_order += simulation->presses != simulation->releases;
+        simulation->wrong_time += events[i].time != simulation->release_edge;
+        break;
+      case BTN_LONG:
+        simulation->longs++;
+        break;
+      default:
+        simulation->repeats++;
+        break;
+      }
+    }
+  } while (count == EVENTS_PER_RUN);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  down = simulation->level;
+  if (down && !simulation->polled_previous) {
+    simulation->polled_presses++;
+    latency = g_ui32Now - simulation->press_edge;
+    if (simulation->polled_waiting &&
+        latency > simulation->polled_latency_max) {
+      simulation->polled_latency_max = latency;
+    }
+    simulation->polled_waiting = false;
+  }
+  simulation->polled_previous = down;
+}
+
+// Let time pass until time, running the button timer and the task when they
+// are due, in the order they come
+static void advance(tSimulation *simulation, uint32_t time) {
+  uint32_t deadline;
+  bool armed;
+
+  for (;;) {
+    armed = BTN_hostDeadline(&deadline);
+    if (armed && (int32_t)(deadline - simulation->next_run) <= 0 &&
+        (int32_t)(time - deadline) >= 0) {
+      g_ui32Now = deadline;
+      BTN_hostTimer();
+    } else if ((int32_t)(time - simulation->next_run) >= 0) {
+      g_ui32Now = simulation->next_run;
+      task(simulation);
+      simulation->next_run += TASK_PERIOD;
+    } else {
+      break;
+    }
+  }
+  g_ui32Now = time;
+}
+
+static void edge(tSimulation *simulation, uint32_t time, bool level) {
+  advance(simulation, time);
+  simulation->level = level;
+  BTN_hostSet(0, level);
+}
+
+// The contacts close or open at time and bounce for a while. Most bounces
+// are over in 5 ms, one in eight lasts up to 15 ms, all well within
+// BTN_DEBOUNCE_MS. Returns when the contacts are settled.
+static uint32_t bounce(tSimulation *simulation, uint32_t time, bool level) {
+  uint32_t span = (random32() % 8 == 0 ? 15 : 5) * TICKS_PER_MS;
+  uint32_t end = time + random32() % span;
+  uint32_t t = time;
+
+  edge(simulation, t, level);
+  for (;;) {
+    t += 30 + random32() % 1500;
+    if ((int32_t)(end - t) < 0) {
+      break;
+    }
+    edge(simulation, t, !level);
+    t += 30 + random32() % 1500;
+    edge(simulation, t, level);
+  }
+  return t;
+}
+
+//=============================================================================
+static void testBouncingPresses(void) {
+  static const tBtnPin pin = {0, 0, 0};
+  tSimulation *simulation = &g_sSimulation;
+  uint32_t expected_longs = 0;
+  uint32_t hold;
+  uint32_t t = 0;
+  uint32_t i;
+
+  g_ui32Random = 24;
+  BTN_init(&pin, 1, 1000 * TICKS_PER_MS, now);
+  simulation->next_run = TASK_PERIOD;
+  for (i = 0; i < PRESSES; i++) {
+    t += (50 + random32() % 500) * TICKS_PER_MS;
+    simulation->press_edge = t;
+    simulation->polled_waiting = true;
+    bounce(simulation, t, true);
+    // Clear of the edge of the long press either way
+    hold = (40 + random32() % 1000) * TICKS_PER_MS;
+    if (hold > (BTN_LONG_MS - 2) * TICKS_PER_MS &&
+        hold < (BTN_LONG_MS + 2) * TICKS_PER_MS) {
+      hold += 4 * TICKS_PER_MS;
+    }
+    expected_longs += hold > BTN_LONG_MS * TICKS_PER_MS;
+    t += hold;
+    advance(simulation, t);
+    simulation->release_edge = t;
+    t = bounce(simulation, t, false);
+  }
+  advance(simulation, t + 1000 * TICKS_PER_MS);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  printf("  events:  %u presses, %u releases, %u long, %u repeats, "
+         "popped within %.1f ms\n",
+         simulation->presses, simulation->releases, simulation->longs,
+         simulation->repeats, simulation->latency_max / (double)TICKS_PER_MS);
+  printf("  polling: %u presses of %u, seen within %.1f ms\n",
+         simulation->polled_presses, PRESSES,
+         simulation->polled_latency_max / (double)TICKS_PER_MS);
+  TEST_CHECK(simulation->presses == PRESSES &&
+             simulation->releases == PRESSES);
+  TEST_CHECK(simulation->wrong_order == 0 && simulation->wrong_time == 0);
+  TEST_CHECK(simulation->toggles == PRESSES && !simulation->calibrating);
+  TEST_CHECK(simulation->longs == expected_longs);
+  TEST_CHECK(simulation->latency_max <= TASK_PERIOD);
+  TEST_CHECK(BTN_overflows() == 0 && !BTN_down(0));
+  // The long bounces have to fool the polling, or they test nothing
+  TEST_CHECK(simulation->polled_presses > PRESSES);
+}
+
+//=============================================================================
+int main(void) {
+  printf("bouncing button through the events and through polling:\n");
+  testBouncingPresses();
+  return TEST_finish("test_buttons");
+}
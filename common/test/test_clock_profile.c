@@ -0,0 +1,145 @@
+/*
+ * ================================================================
+ * File: test_clock_profile.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the register values CLOCK_derive() works out
+ * for every profile, against values worked out by hand for the users of
+ * 2.2, and of what a switch keeps: the PWM, SysTick and ADC rates, and the
+ * duty cycle of the LED for every level. The governor has to go up under
+ * load and down only when the work fits the slower clock.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "brightness.h"
+#include "clock_profile.h"
+#include "test.h"
+
+#define PWM_RATE 1000
+#define SYSTICK_RATE 1000
+#define SAMPLE_RATE 8000
+
+//=============================================================================
+// PWM divider and load, SysTick reload and ADC timer load for 16, 60 and
+// 120 MHz. At 120 MHz a period of 120000 ticks does not fit the 16-bit
+// load, the divider of 2 halves it.
+static void testDerive(void) {
+  static const tClockTiming expected[CLOCK_PROFILES] = {
+      {16000000, 1, 16000, 16000, 1999},
+      {60000000, 1, 60000, 60000, 7499},
+      {120000000, 2, 60000, 120000, 14999}};
+  tClockUsers users = {0, 0, PWM_RATE, 0, SYSTICK_RATE, 0, SAMPLE_RATE};
+  tClockTiming timing;
+  uint32_t p;
+
+  for (p = 0; p < CLOCK_PROFILES; p++) {
+    CLOCK_derive(&users, g_psClockProfiles[p].frequency, &timing);
+    printf("  %-4s %9u Hz: PWM /%u load %u, SysTick %u, ADC timer %u\n",
+           g_psClockProfiles[p].name, timing.system_clock, timing.pwm_divider,
+           timing.pwm_load, timing.systick_period, timing.adc_timer_load);
+    TEST_CHECK(memcmp(&timing, &expected[p], sizeof(timing)) == 0);
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Rates too slow for the registers get the longest period there is, a
+  // rate of 0 leaves that part at 0
+  users.pwm_rate = 10;
+  users.systick_rate = 1;
+  users.adc_sample_rate = 0;
+  CLOCK_derive(&users, 120000000, &timing);
+  TEST_CHECK(timing.pwm_divider == CLOCK_PWM_DIVIDER_MAX &&
+             timing.pwm_load == CLOCK_PWM_LOAD_MAX);
+  TEST_CHECK(timing.systick_period == CLOCK_SYSTICK_MAX);
+  TEST_CHECK(timing.adc_timer_load == 0);
+}
+
+//=============================================================================
+// Every switch between two profiles keeps the rates and, for every level,
+// the duty cycle of the LED to within a tick at the 16 MHz load
+static void testSwitch(void) {
+  tClockUsers users = {0, 0, PWM_RATE, 0, SYSTICK_RATE, 0, SAMPLE_RATE};
+  tBrightness led;
+  tClock clock;
+  double duty_error = 0;
+  double duty_before;
+  double error;
+  bool rates = true;
+  uint32_t level;
+  uint32_t from;
+  uint32_t to;
+
+  users.led = &led;
+  for (from = 0; from < CLOCK_PROFILES; from++) {
+    for (to = 0; to < CLOCK_PROFILES; to++) {
+      if (from == to) {
+        continue;
+      }
+      for (level = 0; level <= BRIGHT_MAX; level += 31) {
+        TEST_CHECK(CLOCK_init(&clock, &users, (tClockProfileId)from, 0, 0));
+        BRIGHT_init(&led, 0, 0, 0, 0, clock.timing.pwm_load);
+        BRIGHT_set(&led, level);
+        duty_before = (double)led.width / led.period;
+        TEST_CHECK(CLOCK_set(&clock, (tClockProfileId)to));
+        TEST_CHECK(led.period == clock.timing.pwm_load);
+        if (led.state == BRIGHT_PWM) {
+          error = (double)led.width / led.period - duty_before;
+          error = error < 0 ? -error : error;
+          duty_error = error > duty_error ? error : duty_error;
+        }
+        rates = rates &&
+                clock.timing.system_clock / clock.timing.pwm_divider /
+                        clock.timing.pwm_load ==
+                    PWM_RATE &&
+                clock.timing.system_clock / clock.timing.systick_period ==
+                    SYSTICK_RATE &&
+                clock.timing.system_clock /
+                        (clock.timing.adc_timer_load + 1) ==
+                    SAMPLE_RATE;
+      }
+    }
+  }
+  printf("  switches keep the duty cycle to %.2g\n", duty_error);
+  TEST_CHECK(rates);
+  TEST_CHECK(duty_error <= 1.0 / 16000);
+  TEST_CHECK(!CLOCK_set(&clock, clock.profile));
+}
+
+//=============================================================================
+// Up above CLOCK_UP_PERCENT, down only when the same work would be at most
+// CLOCK_DOWN_PERCENT of the slower clock
+static void testGovern(void) {
+  tClockUsers users = {0, 0, PWM_RATE, 0, SYSTICK_RATE, 0, SAMPLE_RATE};
+  tClock clock;
+
+  CLOCK_init(&clock, &users, CLOCK_LOW, 0, 0);
+  TEST_CHECK(!CLOCK_govern(&clock, CLOCK_UP_PERCENT));
+  TEST_CHECK(CLOCK_govern(&clock, CLOCK_UP_PERCENT + 1));
+  TEST_CHECK(clock.profile == CLOCK_MID);
+  TEST_CHECK(CLOCK_govern(&clock, 100) && clock.profile == CLOCK_FULL);
+  TEST_CHECK(!CLOCK_govern(&clock, 100));
+  // 25 % at 120 MHz is 50 % at 60 MHz, 26 % would not fit
+  TEST_CHECK(!CLOCK_govern(&clock, 26) && clock.profile == CLOCK_FULL);
+  TEST_CHECK(CLOCK_govern(&clock, 25) && clock.profile == CLOCK_MID);
+  // 13 % at 60 MHz would be 49 % at 16 MHz
+  TEST_CHECK(!CLOCK_govern(&clock, 14) && clock.profile == CLOCK_MID);
+  TEST_CHECK(CLOCK_govern(&clock, 13) && clock.profile == CLOCK_LOW);
+  TEST_CHECK(!CLOCK_govern(&clock, 0));
+  TEST_CHECK(clock.switches == 4);
+}
+
+//=============================================================================
+int main(void) {
+  printf("clock profiles:\n");
+  testDerive();
+  testSwitch();
+  testGovern();
+  return TEST_finish("test_clock_profile");
+}
@@ -0,0 +1,399 @@
+/*
+ * ================================================================
+ * File: test_dashboard.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the dashboard on the mock display and on the
+ * emulated ST7735S. After every frame the screen has to equal a full
+ * redraw of all fields pixel for pixel, and the pixels the counting display
+ * counted, two bytes each on the SPI, have to be the ones the dashboard
+ * reports. That holds with grlib drawing the text and with the glyph cache
+ * sending it as 1 bpp runs, to an LCD driver that like those of TivaWare
+ * takes only 1, 4 and 8 bpp. A benchmark compares the two on the LCD, in
+ * time, windows and SPI bytes per frame.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "dashboard.h"
+#include "grlib/grlib.h"
+#include "st7735.h"
+#include "test.h"
+
+#define WIDTH 128
+#define HEIGHT 128
+#define FIELDS 4
+// Every character of the test lines
+#define CHARACTERS "MicJoyPthRlWd:BXY-, 0123456789"
+
+static uint16_t g_pui16Screen[WIDTH * HEIGHT];
+static uint16_t g_pui16Reference[WIDTH * HEIGHT];
+
+static tDisplay g_sLCD;
+static uint32_t g_pui32Runs[17];
+static bool g_bOnLCD;
+static tDashGlyphs g_sGlyphs;
+static tDisplay g_sDisplay;
+static tDashCounter g_sCounter;
+static tContext g_sContext;
+static tDashboard g_sDash;
+static uint32_t g_pui32Field[FIELDS];
+static char g_ppcText[FIELDS][DASH_TEXT_MAX];
+
+//=============================================================================
+// A grlib driver on the emulated ST7735S the way the MKII driver works: a
+// window for every call and the pixels into it. Like the TivaWare drivers it
+// only takes runs of 1, 4 and 8 bpp and draws nothing for any other. The
+// runs are counted by bits per pixel, the others together under 16.
+static uint32_t lcdColorTranslate(void *data, uint32_t value) {
+  return ((value & 0x00f80000) >> 8) | ((value & 0x0000fc00) >> 5) |
+         ((value & 0x000000f8) >> 3);
+}
+
+static void lcdLineDrawH(void *data, int32_t x1, int32_t x2, int32_t y,
+                         uint32_t value) {
+  ST7735_setWindow(x1, y, x2, y);
+  ST7735_writeColor(value, x2 - x1 + 1);
+}
+
+static void lcdPixelDraw(void *data, int32_t x, int32_t y, uint32_t value) {
+  lcdLineDrawH(data, x, x, y, value);
+}
+
+static void lcdLineDrawV(void *data, int32_t x, int32_t y1, int32_t y2,
+                         uint32_t value) {
+  ST7735_setWindow(x, y1, x, y2);
+  ST7735_writeColor(value, y2 - y1 + 1);
+}
+
+static void lcdRectFill(void *data, const tRectangle *rect, uint32_t value) {
+  ST7735_setWindow(rect->i16XMin, rect->i16YMin, rect->i16XMax,
+                   rect->i16YMax);
+  ST7735_writeColor(value, (rect->i16XMax - rect->i16XMin + 1) *
+                               (rect->i16YMax - rect->i16YMin + 1));
+}
+
+static void lcdPixelDrawMultiple(void *data, int32_t x, int32_t y, int32_t x0,
+                                 int32_t count, int32_t bpp,
+                                 const uint8_t *pixels,
+                                 const uint8_t *palette) {
+  const uint8_t *entry;
+  uint32_t color;
+  uint32_t index;
+  int32_t i;
+
+  g_pui32Runs[bpp < 16 ? bpp : 16]++;
+  if (bpp != 1 && bpp != 4 && bpp != 8) {
+    return;
+  }
+  ST7735_setWindow(x, y, x + count - 1, y);
+  for (i = 0; i < count; i++) {
+    if (bpp == 8) {
+      entry = palette + pixels[i] * 3;
+      color = lcdColorTranslate(data, entry[0] | (entry[1] << 8) |
+                                          ((uint32_t)entry[2] << 16));
+    } else {
+      index = bpp == 1 ? pixels[(x0 + i) >> 3] >> (7 - ((x0 + i) & 7)) & 1
+              : (x0 + i) & 1 ? pixels[(x0 + i) >> 1] & 0x0f
+                             : pixels[(x0 + i) >> 1] >> 4;
+      color = ((const uint32_t *)palette)[index];
+    }
+    ST7735_writeColor(color, 1);
+  }
+}
+
+static void lcdFlush(void *data) {}
+
+static void lcdInit(void) {
+  g_sLCD.i32Size = sizeof(tDisplay);
+  g_sLCD.ui16Width = WIDTH;
+  g_sLCD.ui16Height = HEIGHT;
+  g_sLCD.pfnPixelDraw = lcdPixelDraw;
+  g_sLCD.pfnPixelDrawMultiple = lcdPixelDrawMultiple;
+  g_sLCD.pfnLineDrawH = lcdLineDrawH;
+  g_sLCD.pfnLineDrawV = lcdLineDrawV;
+  g_sLCD.pfnRectFill = lcdRectFill;
+  g_sLCD.pfnColorTranslate = lcdColorTranslate;
+  g_sLCD.pfnFlush = lcdFlush;
+}
+
+//=============================================================================
+// Fill a framebuffer with the background, like the LCD after a clear
+static void clearScreen(uint16_t *screen) {
+  uint32_t i;
+
+  for (i = 0; i < WIDTH * HEIGHT; i++) {
+    screen[i] = g_sContext.ui32Background;
+  }
+}
+
+static uint16_t screenPixel(uint32_t x, uint32_t y) {
+  return g_bOnLCD ? ST7735_hostPixel(x, y) : g_pui16Screen[y * WIDTH + x];
+}
+
+// The dashboard on the mock or, through the counting display, on the LCD,
+// with the glyph cache of characters or without one when it is 0
+static void setUp(bool on_lcd, const char *characters) {
+  uint32_t i;
+
+  g_bOnLCD = on_lcd;
+  lcdInit();
+  DASH_counterInit(&g_sDisplay, &g_sCounter, on_lcd ? &g_sLCD : 0,
+                   g_pui16Screen, WIDTH, HEIGHT);
+  GrContextInit(&g_sContext, &g_sDisplay);
+  GrContextFontSet(&g_sContext, &g_sFontHost);
+  GrContextForegroundSet(&g_sContext, ClrYellow);
+  GrContextBackgroundSet(&g_sContext, ClrBlue);
+  clearScreen(g_pui16Screen);
+  ST7735_init(120000000);
+  ST7735_setWindow(0, 0, WIDTH - 1, HEIGHT - 1);
+  ST7735_writeColor(g_sContext.ui32Background, WIDTH * HEIGHT);
+  memset(g_pui32Runs, 0, sizeof(g_pui32Runs));
+  DASH_init(&g_sDash, &g_sContext);
+  if (characters != 0) {
+    DASH_glyphsInit(&g_sGlyphs, &g_sContext, characters);
+    DASH_useGlyphs(&g_sDash, &g_sGlyphs);
+  }
+  for (i = 0; i < FIELDS; i++) {
+    g_pui32Field[i] = DASH_addField(&g_sDash, 1 + i * 3, 1 + i * 20);
+    g_ppcText[i][0] = '\0';
+  }
+}
+
+//=============================================================================
+// Every field drawn whole on a cleared screen
+static void drawReference(void) {
+  tDisplay display;
+  tDashCounter counter;
+  tContext context;
+  uint32_t i;
+
+  DASH_counterInit(&display, &counter, 0, g_pui16Reference, WIDTH, HEIGHT);
+  GrContextInit(&context, &display);
+  GrContextFontSet(&context, &g_sFontHost);
+  GrContextForegroundSetTranslated(&context, g_sContext.ui32Foreground);
+  GrContextBackgroundSetTranslated(&context, g_sContext.ui32Background);
+  clearScreen(g_pui16Reference);
+  for (i = 0; i < FIELDS; i++) {
+    GrStringDraw(&context, g_ppcText[i], -1, g_sDash.field[i].x,
+                 g_sDash.field[i].y, true);
+  }
+}
+
+// Set the text of the fields, end the frame and compare with the reference.
+// Returns the pixels sent for the frame.
+static uint32_t frame(const char *const *texts) {
+  uint32_t before = g_sCounter.pixels;
+  uint32_t sent;
+  bool same;
+  uint32_t x;
+  uint32_t y;
+  uint32_t i;
+
+  for (i = 0; i < FIELDS; i++) {
+    if (texts[i] != 0) {
+      DASH_setText(&g_sDash, g_pui32Field[i], texts[i]);
+      strncpy(g_ppcText[i], texts[i], DASH_TEXT_MAX - 1);
+    }
+  }
+  DASH_endFrame(&g_sDash);
+  sent = g_sCounter.pixels - before;
+  drawReference();
+  same = true;
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      same = same && screenPixel(x, y) == g_pui16Reference[y * WIDTH + x];
+    }
+  }
+  TEST_CHECK(same);
+  TEST_CHECK(sent == g_sDash.pixels_last_frame);
+  return sent;
+}
+
+//=============================================================================
+// Lines like those of 4.2 going through a run of changes: same length, a
+// digit more or less, narrower and wider characters, and no change at all
+static const char *const g_pppcFrames[][FIELDS] = {
+      {"Mic: 40 dB", "Joy: 50-X, 50-Y", "Pitch: 0", "Roll: 0"},
+      {"Mic: 41 dB", 0, 0, 0},
+      {"Mic: 41 dB", "Joy: 50-X, 50-Y", "Pitch: 0", "Roll: 0"},
+      {"Mic: 9 dB", "Joy: 100-X, 50-Y", "Pitch: -12", "Roll: 7"},
+      {"Mic: 100 dB", "Joy: 0-X, 0-Y", "Pitch: -1", "Roll: 77"},
+      {"Mic: 1 dB", "Joy: 1-X, 1-Y", "Pitch: W", "Roll: i"},
+      {"", "Joy: 1-X, 1-Y", "Pitch: i", "Roll: W"},
+      {"Mic: 40 dB", "", "", ""},
+};
+
+static void testDirtyRectangles(void) {
+  const char *const(*frames)[FIELDS] = g_pppcFrames;
+  uint32_t full_pixels = 0;
+  uint32_t sent;
+  uint32_t i;
+
+  setUp(false, 0);
+  for (i = 0; i < sizeof(g_pppcFrames) / sizeof(g_pppcFrames[0]); i++) {
+    sent = frame(frames[i]);
+    printf("  frame %u: %5u pixels, %5u bytes, %u rectangles\n", i, sent,
+           2 * sent, g_sDash.rects_last_frame);
+    if (i == 0) {
+      full_pixels = sent;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // One changed digit of one field is a digit cell, and a frame with the
+  // text that is already shown sends nothing
+  setUp(false, 0);
+  frame(frames[0]);
+  TEST_CHECK(frame(frames[1]) == 8 * GrStringHeightGet(&g_sContext));
+  TEST_CHECK(g_sDash.rects_last_frame == 1);
+  TEST_CHECK(frame(frames[2]) == 0);
+  TEST_CHECK(g_sDash.rects_last_frame == 0);
+  TEST_CHECK(frame(frames[3]) < full_pixels);
+}
+
+//=============================================================================
+// A field past DASH_MAX_FIELDS gets an id that is ignored
+static void testFieldLimit(void) {
+  uint32_t id;
+  uint32_t i;
+
+  setUp(false, 0);
+  for (i = FIELDS; i < DASH_MAX_FIELDS; i++) {
+    TEST_CHECK(DASH_addField(&g_sDash, 0, 100) == i);
+  }
+  id = DASH_addField(&g_sDash, 0, 100);
+  TEST_CHECK(id == DASH_MAX_FIELDS);
+  TEST_CHECK(g_sDash.field_count == DASH_MAX_FIELDS);
+  DASH_setText(&g_sDash, id, "ignored");
+  DASH_endFrame(&g_sDash);
+  TEST_CHECK(g_sDash.pixels_last_frame == 0);
+  TEST_CHECK(g_sCounter.pixels == 0);
+}
+
+//=============================================================================
+// The same frames from the glyph cache, into the mock through the 1 bpp
+// runs of the counting display and through it onto the LCD. Every
+// character is cached, so grlib draws nothing and every row is one run.
+static void testGlyphCache(void) {
+  uint32_t on_lcd;
+  uint32_t rows;
+  uint32_t i;
+
+  for (on_lcd = 0; on_lcd < 2; on_lcd++) {
+    setUp(on_lcd, CHARACTERS);
+    TEST_CHECK(g_sGlyphs.count == strlen(CHARACTERS));
+    rows = 0;
+    for (i = 0; i < sizeof(g_pppcFrames) / sizeof(g_pppcFrames[0]); i++) {
+      frame(g_pppcFrames[i]);
+      rows += g_sDash.rects_last_frame * g_sGlyphs.height;
+    }
+    if (on_lcd) {
+      TEST_CHECK(g_pui32Runs[1] == rows && g_pui32Runs[16] == 0);
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A character that is not cached leaves its line to grlib, which sends a
+  // run for every row of every character
+  setUp(true, "0123456789");
+  frame(g_pppcFrames[0]);
+  TEST_CHECK(g_pui32Runs[1] > FIELDS * g_sGlyphs.height &&
+             g_pui32Runs[16] == 0);
+}
+
+//=============================================================================
+// 4.2 style lines with changing numbers on the LCD, drawn by grlib and from
+// the cache
+static void benchmark(bool cached) {
+  uint32_t frames = 20000;
+  uint32_t pixels;
+  uint32_t bytes;
+  uint32_t runs;
+  uint32_t value;
+  tDashLine line;
+  double start;
+  uint32_t i;
+
+  setUp(true, cached ? CHARACTERS : 0);
+  pixels = g_sCounter.pixels;
+  bytes = ST7735_bytesSent();
+  start = TEST_seconds();
+  for (i = 0; i < frames; i++) {
+    value = i * 2654435761u;
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Mic: ");
+    DASH_lineUnsigned(&line, 30 + i / 7 % 40);
+    DASH_lineText(&line, " dB");
+    DASH_setText(&g_sDash, g_pui32Field[0], line.text);
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Joy: ");
+    DASH_lineUnsigned(&line, value >> 8 & 63);
+    DASH_lineText(&line, "-X, ");
+    DASH_lineUnsigned(&line, value >> 16 & 63);
+    DASH_lineText(&line, "-Y");
+    DASH_setText(&g_sDash, g_pui32Field[1], line.text);
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Pitch: ");
+    DASH_lineSigned(&line, (int32_t)(i / 3 % 181) - 90);
+    DASH_setText(&g_sDash, g_pui32Field[2], line.text);
+    DASH_lineClear(&line);
+    DASH_lineText(&line, "Roll: ");
+    DASH_lineSigned(&line, (int32_t)(i / 5 % 181) - 90);
+    DASH_setText(&g_sDash, g_pui32Field[3], line.text);
+    DASH_endFrame(&g_sDash);
+  }
+  start = TEST_seconds() - start;
+  pixels = g_sCounter.pixels - pixels;
+  bytes = ST7735_bytesSent() - bytes;
+  runs = g_pui32Runs[1];
+  printf("  %s: %6.2f host us, %6.1f pixels, %5.1f windows and %6.1f SPI "
+         "bytes per frame\n",
+         cached ? "glyph cache" : "grlib      ", start / frames * 1e6,
+         (double)pixels / frames, (double)runs / frames,
+         (double)bytes / frames);
+}
+
+//=============================================================================
+static void testLine(void) {
+  tDashLine line;
+  uint32_t i;
+
+  DASH_lineClear(&line);
+  DASH_lineText(&line, "Mic: ");
+  DASH_lineSigned(&line, -42);
+  DASH_lineText(&line, " ");
+  DASH_lineUnsigned(&line, 0);
+  DASH_lineText(&line, " ");
+  DASH_lineUnsigned(&line, 4294967295u);
+  TEST_CHECK(strcmp(line.text, "Mic: -42 0 4294967295") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  DASH_lineClear(&line);
+  DASH_lineSigned(&line, INT32_MIN);
+  TEST_CHECK(strcmp(line.text, "-2147483648") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  DASH_lineClear(&line);
+  for (i = 0; i < 10; i++) {
+    DASH_lineUnsigned(&line, 12345);
+  }
+  TEST_CHECK(line.length == DASH_TEXT_MAX - 1);
+  TEST_CHECK(strlen(line.text) == DASH_TEXT_MAX - 1);
+}
+
+//=============================================================================
+int main(void) {
+  printf("dashboard on the mock display and the LCD:\n");
+  testDirtyRectangles();
+  testFieldLimit();
+  testGlyphCache();
+  testLine();
+  benchmark(false);
+  benchmark(true);
+  return TEST_finish("test_dashboard");
+}
@@ -0,0 +1,208 @@
+/*
+ * ================================================================
+ * File: test_fft.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the Q15 FFT against a DFT in double precision
+ * divided by the number of points, on full scale noise and sines for every
+ * size, the Hann window and the magnitudes included, and a benchmark of the
+ * time per transform.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+//=============================================================================
+#include "fft.h"
+#include "test.h"
+
+// The bound stated in fft.h, in LSB of the real and imaginary parts
+#define FFT_ERROR_MAX 5.0
+
+static double g_pdRe[FFT_MAX_POINTS];
+static double g_pdIm[FFT_MAX_POINTS];
+
+//=============================================================================
+// Reference DFT of the input as it went into FFT_transform(), divided by the
+// number of points
+static void referenceDFT(const tFFTComplex *input, uint32_t points) {
+  double angle;
+  uint32_t k;
+  uint32_t n;
+
+  for (k = 0; k < points; k++) {
+    g_pdRe[k] = 0;
+    g_pdIm[k] = 0;
+    for (n = 0; n < points; n++) {
+      angle = -2 * M_PI * (double)((uint64_t)k * n % points) / points;
+      g_pdRe[k] += input[n].re * cos(angle) - input[n].im * sin(angle);
+      g_pdIm[k] += input[n].re * sin(angle) + input[n].im * cos(angle);
+    }
+    g_pdRe[k] /= points;
+    g_pdIm[k] /= points;
+  }
+}
+
+// Largest difference of the real and imaginary parts to the reference
+static double transformError(tFFTComplex *data, uint32_t log2_points,
+                             double *rms) {
+  uint32_t points = 1u << log2_points;
+  double largest = 0;
+  double squares = 0;
+  double error;
+  uint32_t k;
+
+  referenceDFT(data, points);
+  FFT_transform(data, log2_points);
+  for (k = 0; k < points; k++) {
+    error = fmax(fabs(data[k].re - g_pdRe[k]), fabs(data[k].im - g_pdIm[k]));
+    squares += (data[k].re - g_pdRe[k]) * (data[k].re - g_pdRe[k]) +
+               (data[k].im - g_pdIm[k]) * (data[k].im - g_pdIm[k]);
+    largest = fmax(largest, error);
+  }
+  *rms = sqrt(squares / (2 * points));
+  return largest;
+}
+
+//=============================================================================
+// Full scale noise, real and complex, and a full scale sine on a bin and
+// between two, for every size
+static void testAccuracy(void) {
+  static tFFTComplex data[FFT_MAX_POINTS];
+  double largest;
+  double rms;
+  double error;
+  double rms_error;
+  uint32_t log2_points;
+  uint32_t points;
+  uint32_t trial;
+  uint32_t n;
+
+  srand(7);
+  for (log2_points = 1; log2_points <= FFT_MAX_LOG2; log2_points++) {
+    points = 1u << log2_points;
+    largest = 0;
+    rms = 0;
+    for (trial = 0; trial < 24; trial++) {
+      for (n = 0; n < points; n++) {
+        if (trial < 8) {
+          data[n].re = (int16_t)(rand() % 65536 - 32768);
+          data[n].im = trial < 4 ? 0 : (int16_t)(rand() % 23170 - 11585);
+        } else {
+          data[n].re = (int16_t)lround(
+              32767 * sin(2 * M_PI * (trial - 7) * (n + 0.5 * (trial & 1)) /
+                          points));
+          data[n].im = 0;
+        }
+      }
+      error = transformError(data, log2_points, &rms_error);
+      largest = fmax(largest, error);
+      rms = fmax(rms, rms_error);
+    }
+    printf("  %3u points: max error %5.2f LSB, rms %4.2f LSB\n", points,
+           largest, rms);
+    TEST_CHECK(largest < FFT_ERROR_MAX);
+  }
+}
+
+//=============================================================================
+// A windowed full scale sine on bin 32 of 512: the Hann window leaves a
+// quarter of the amplitude in the bin and an eighth in each neighbour, and
+// next to nothing further out
+static void testHannSine(void) {
+  static int16_t samples[FFT_MAX_POINTS];
+  static tFFTComplex data[FFT_MAX_POINTS];
+  static uint16_t magnitude[FFT_MAX_POINTS / 2];
+  double window_error = 0;
+  uint32_t leakage = 0;
+  uint32_t n;
+
+  for (n = 0; n < FFT_MAX_POINTS; n++) {
+    samples[n] = (int16_t)lround(32767 * cos(2 * M_PI * 32 * n / 512.0));
+  }
+  FFT_hann(data, samples, FFT_MAX_LOG2);
+  for (n = 0; n < FFT_MAX_POINTS; n++) {
+    window_error =
+        fmax(window_error, fabs(data[n].re - samples[n] * (0.5 - 0.5 * cos(
+                                                  2 * M_PI * n / 512.0))));
+  }
+  printf("  Hann window: max error %.2f LSB\n", window_error);
+  // The window peaks at 32767 / 32768 and is built from the Q15 table
+  TEST_CHECK(window_error < 2.5);
+  FFT_transform(data, FFT_MAX_LOG2);
+  FFT_magnitude(data, magnitude, FFT_MAX_POINTS / 2);
+  TEST_CHECK(fabs(magnitude[32] - 32767 / 4.0) < FFT_ERROR_MAX * 2);
+  TEST_CHECK(fabs(magnitude[31] - 32767 / 8.0) < FFT_ERROR_MAX * 2);
+  TEST_CHECK(fabs(magnitude[33] - 32767 / 8.0) < FFT_ERROR_MAX * 2);
+  for (n = 0; n < FFT_MAX_POINTS / 2; n++) {
+    if (n < 31 || n > 33) {
+      leakage = magnitude[n] > leakage ? magnitude[n] : leakage;
+    }
+  }
+  printf("  Hann windowed sine on bin 32: %u, %u, %u, largest other bin %u\n",
+         magnitude[31], magnitude[32], magnitude[33], leakage);
+  TEST_CHECK(leakage < 2 * FFT_ERROR_MAX);
+}
+
+// The magnitudes are the rounded down square roots
+static void testMagnitude(void) {
+  static const tFFTComplex data[] = {
+      {3, 4}, {-3, -4}, {0, 0}, {32767, 0}, {-32768, 0}, {23170, 23170}};
+  static const uint16_t expected[] = {5, 5, 0, 32767, 32768, 32767};
+  uint16_t magnitude[6];
+  uint32_t i;
+
+  FFT_magnitude(data, magnitude, 6);
+  for (i = 0; i < 6; i++) {
+    TEST_CHECK(magnitude[i] == expected[i]);
+  }
+}
+
+//=============================================================================
+static void benchmark(uint32_t log2_points) {
+  static int16_t samples[FFT_MAX_POINTS];
+  static tFFTComplex data[FFT_MAX_POINTS];
+  static uint16_t magnitude[FFT_MAX_POINTS / 2];
+  uint32_t points = 1u << log2_points;
+  uint32_t rounds = 20000;
+  double start;
+  double fft;
+  uint32_t i;
+
+  for (i = 0; i < points; i++) {
+    samples[i] = (int16_t)(rand() % 65536 - 32768);
+  }
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    FFT_hann(data, samples, log2_points);
+    FFT_transform(data, log2_points);
+    FFT_magnitude(data, magnitude, points / 2);
+  }
+  fft = (TEST_seconds() - start) / rounds * 1e6;
+  g_ui32TestSink = magnitude[1];
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  start = TEST_seconds();
+  referenceDFT(data, points);
+  printf("  %3u points: %7.2f host us per window, transform and magnitude, "
+         "%8.1f us for the double DFT\n",
+         points, fft, (TEST_seconds() - start) * 1e6);
+}
+
+//=============================================================================
+int main(void) {
+  printf("FFT against a double precision DFT:\n");
+  testAccuracy();
+  testHannSine();
+  testMagnitude();
+  benchmark(7);
+  benchmark(8);
+  benchmark(9);
+  return TEST_finish("test_fft");
+}
@@ -0,0 +1,260 @@
+/*
+ * ================================================================
+ * File: test_filter.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the integer filters against straightforward
+ * reference versions, and a benchmark of the time per sample against the
+ * averaging the labs did before: the float re-sum of 50 samples in
+ * moving_average() of 2.2, and the integer re-sum of the whole sample array
+ * that calculate_average() does for 4.2.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+//=============================================================================
+#include "filter.h"
+#include "test.h"
+
+#define SAMPLES 100000
+
+static uint32_t g_pui32Samples[SAMPLES];
+
+//=============================================================================
+// 12-bit samples around mid-scale with noise and the odd spike
+static void makeSamples(void) {
+  uint32_t i;
+
+  srand(1);
+  for (i = 0; i < SAMPLES; i++) {
+    g_pui32Samples[i] = 2048 + rand() % 200 - 100;
+    if (rand() % 50 == 0) {
+      g_pui32Samples[i] = rand() & 0xfff;
+    }
+  }
+}
+
+static int compareSamples(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+//=============================================================================
+// The average of the last 2^log2 samples, with the samples before the first
+// taken to be equal to it
+static void testMovingAverage(uint32_t log2_length) {
+  uint32_t window[FILTER_LENGTH(10)];
+  tFilterMovingAverage f;
+  uint32_t length = FILTER_LENGTH(log2_length);
+  uint32_t sum;
+  uint32_t i;
+  uint32_t j;
+  bool exact = true;
+
+  FILTER_movingAverageInit(&f, window, log2_length);
+  for (i = 0; i < 5000; i++) {
+    sum = 0;
+    for (j = 0; j < length; j++) {
+      sum += g_pui32Samples[i < j ? 0 : i - j];
+    }
+    if (FILTER_movingAveragePush(&f, g_pui32Samples[i]) !=
+        (sum + length / 2) / length) {
+      exact = false;
+    }
+  }
+  TEST_CHECK(exact);
+}
+
+//=============================================================================
+// A constant input is reproduced exactly and a step settles on the new value
+static void testExponential(void) {
+  tFilterExponential f;
+  uint32_t value = 0;
+  uint32_t i;
+
+  FILTER_exponentialInit(&f, 4);
+  TEST_CHECK(FILTER_exponentialPush(&f, 1000) == 1000);
+  TEST_CHECK(FILTER_exponentialPush(&f, 1000) == 1000);
+  for (i = 0; i < 400; i++) {
+    value = FILTER_exponentialPush(&f, 3000);
+  }
+  TEST_CHECK(value == 3000);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // After one time constant of 2^4 samples a step is about 1 - 1/e done
+  FILTER_exponentialInit(&f, 4);
+  FILTER_exponentialPush(&f, 0);
+  for (i = 0; i < 16; i++) {
+    value = FILTER_exponentialPush(&f, 4000);
+  }
+  TEST_CHECK(value > 2400 && value < 2700);
+}
+
+//=============================================================================
+// Every odd length against a sort, the window must keep its order
+static void testMedian(void) {
+  uint32_t samples[FILTER_MEDIAN_MAX];
+  uint32_t sorted[FILTER_MEDIAN_MAX];
+  uint32_t copy[FILTER_MEDIAN_MAX];
+  uint32_t length;
+  uint32_t round;
+  uint32_t i;
+  bool exact = true;
+  bool unchanged = true;
+
+  srand(2);
+  for (length = 1; length <= FILTER_MEDIAN_MAX; length += 2) {
+    for (round = 0; round < 20000; round++) {
+      for (i = 0; i < length; i++) {
+        // A small range so that equal samples are common
+        samples[i] = round & 1 ? rand() & 0xfff : rand() % 4;
+        sorted[i] = copy[i] = samples[i];
+      }
+      qsort(sorted, length, sizeof(sorted[0]), compareSamples);
+      if (FILTER_medianOf(samples, length) != sorted[length / 2]) {
+        exact = false;
+      }
+      for (i = 0; i < length; i++) {
+        unchanged = unchanged && samples[i] == copy[i];
+      }
+    }
+  }
+  TEST_CHECK(exact);
+  TEST_CHECK(unchanged);
+}
+
+static void testMedianPush(void) {
+  uint32_t window[5];
+  tFilterMedian f;
+
+  FILTER_medianInit(&f, window, 5);
+  TEST_CHECK(FILTER_medianPush(&f, 100) == 100);
+  // A single spike never gets through
+  TEST_CHECK(FILTER_medianPush(&f, 4095) == 100);
+  TEST_CHECK(FILTER_medianPush(&f, 110) == 100);
+  TEST_CHECK(FILTER_medianPush(&f, 0) == 100);
+  TEST_CHECK(FILTER_medianPush(&f, 120) == 110);
+}
+
+//=============================================================================
+// What 2.2 did before, a float sum over the whole window for every value
+static uint32_t oldMovingAverage(const uint32_t *window, uint32_t size) {
+  float sum = 0;
+  uint32_t i;
+
+  for (i = 0; i < size; i++) {
+    sum += window[i];
+  }
+  return (uint32_t)roundf(sum / size);
+}
+
+// What calculate_average() does for 4.2, an integer sum over the whole array
+static uint32_t oldCalculateAverage(const uint32_t *window, uint32_t size) {
+  uint32_t sum = 0;
+  uint32_t i;
+
+  for (i = 0; i < size; i++) {
+    sum += window[i];
+  }
+  return sum / size;
+}
+
+typedef uint32_t (*tResum)(const uint32_t *window, uint32_t size);
+
+// Keep a window of the last size samples and re-sum it on every sample
+static double benchmarkResum(tResum resum, uint32_t size) {
+  uint32_t window[64] = {0};
+  uint32_t index = 0;
+  uint32_t sum = 0;
+  uint32_t i;
+  double start = TEST_seconds();
+
+  for (i = 0; i < SAMPLES; i++) {
+    window[index] = g_pui32Samples[i];
+    index = index + 1 == size ? 0 : index + 1;
+    sum += resum(window, size);
+  }
+  g_ui32TestSink = sum;
+  return (TEST_seconds() - start) / SAMPLES * 1e9;
+}
+
+static double benchmarkMovingAverage(uint32_t log2_length) {
+  uint32_t window[64];
+  tFilterMovingAverage f;
+  uint32_t sum = 0;
+  uint32_t i;
+  double start;
+
+  FILTER_movingAverageInit(&f, window, log2_length);
+  start = TEST_seconds();
+  for (i = 0; i < SAMPLES; i++) {
+    sum += FILTER_movingAveragePush(&f, g_pui32Samples[i]);
+  }
+  g_ui32TestSink = sum;
+  return (TEST_seconds() - start) / SAMPLES * 1e9;
+}
+
+static double benchmarkExponential(void) {
+  tFilterExponential f;
+  uint32_t sum = 0;
+  uint32_t i;
+  double start;
+
+  FILTER_exponentialInit(&f, 5);
+  start = TEST_seconds();
+  for (i = 0; i < SAMPLES; i++) {
+    sum += FILTER_exponentialPush(&f, g_pui32Samples[i]);
+  }
+  g_ui32TestSink = sum;
+  return (TEST_seconds() - start) / SAMPLES * 1e9;
+}
+
+static double benchmarkMedian(uint32_t length) {
+  uint32_t window[FILTER_MEDIAN_MAX];
+  tFilterMedian f;
+  uint32_t sum = 0;
+  uint32_t i;
+  double start;
+
+  FILTER_medianInit(&f, window, length);
+  start = TEST_seconds();
+  for (i = 0; i < SAMPLES; i++) {
+    sum += FILTER_medianPush(&f, g_pui32Samples[i]);
+  }
+  g_ui32TestSink = sum;
+  return (TEST_seconds() - start) / SAMPLES * 1e9;
+}
+
+//=============================================================================
+int main(void) {
+  makeSamples();
+  testMovingAverage(0);
+  testMovingAverage(3);
+  testMovingAverage(6);
+  testMovingAverage(10);
+  testExponential();
+  testMedian();
+  testMedianPush();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  printf("filter, host ns per sample:\n");
+  printf("  old 2.2 float re-sum of 50     %6.2f\n",
+         benchmarkResum(oldMovingAverage, 50));
+  printf("  old 4.2 integer re-sum of 8    %6.2f\n",
+         benchmarkResum(oldCalculateAverage, 8));
+  printf("  moving average of 8            %6.2f\n",
+         benchmarkMovingAverage(3));
+  printf("  moving average of 64           %6.2f\n",
+         benchmarkMovingAverage(6));
+  printf("  exponential, shift 5           %6.2f\n", benchmarkExponential());
+  printf("  median of 5                    %6.2f\n", benchmarkMedian(5));
+  printf("  median of 9                    %6.2f\n", benchmarkMedian(9));
+  return TEST_finish("test_filter");
+}
@@ -0,0 +1,163 @@
+/*
+ * ================================================================
+ * File: test_fixed_db.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Accuracy test of DB_fromLinear() against 20 * log10(x) from
+ * libm, and a benchmark of the two.
+ *
+ * Every 12-bit x is checked, and every x up to 2^20. Above that the 32-bit
+ * range is checked with a stride plus the worst case found by a full run,
+ * which takes about a minute and a half and is done with
+ *   ./build/test_fixed_db full
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "fixed_db.h"
+#include "test.h"
+
+// The bounds stated in fixed_db.h
+#define ERROR_12_BIT 0.0044
+#define ERROR_32_BIT 0.0066
+#define WORST_X 2182733823u
+
+//=============================================================================
+static double dbError(uint32_t x) {
+  return fabs(DB_fromLinear(x) / 256.0 - 20.0 * log10((double)x));
+}
+
+// Largest error for x = first, first + stride, ... up to and including last
+static double maxError(uint64_t first, uint64_t last, uint64_t stride,
+                       uint32_t *worst) {
+  double largest = 0;
+  double error;
+  uint64_t x;
+
+  for (x = first; x <= last; x += stride) {
+    error = dbError((uint32_t)x);
+    if (error > largest) {
+      largest = error;
+      *worst = (uint32_t)x;
+    }
+  }
+  return largest;
+}
+
+//=============================================================================
+static void testAccuracy(bool full) {
+  uint32_t worst = 0;
+  double error;
+
+  TEST_CHECK(DB_fromLinear(0) == 0);
+  TEST_CHECK(DB_fromLinear(1) == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  error = maxError(1, 4095, 1, &worst);
+  printf("  x = 1..4095:       max error %.5f dB at %u\n", error, worst);
+  TEST_CHECK(error < ERROR_12_BIT);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  error = maxError(4096, 1u << 20, 1, &worst);
+  printf("  x = 4096..2^20:    max error %.5f dB at %u\n", error, worst);
+  TEST_CHECK(error < ERROR_32_BIT);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  if (full) {
+    error = maxError((1u << 20) + 1, 0xffffffffu, 1, &worst);
+  } else {
+    error = maxError((1u << 20) + 1, 0xffffffffu, 251, &worst);
+  }
+  printf("  x = 2^20..2^32-1:  max error %.5f dB at %u%s\n", error, worst,
+         full ? "" : " (every 251st x)");
+  TEST_CHECK(error < ERROR_32_BIT);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  error = dbError(WORST_X);
+  TEST_CHECK(error > 0.0065 && error < ERROR_32_BIT);
+  if (full) {
+    TEST_CHECK(worst == WORST_X);
+  }
+}
+
+//=============================================================================
+// Whole dB values as the display shows them, only x = 944 is allowed to
+// round differently
+static void testRounding(void) {
+  uint32_t x;
+  int32_t reference;
+  bool exact = true;
+
+  for (x = 1; x < 4096; x++) {
+    reference = (int32_t)round(20.0 * log10((double)x));
+    if (DB_round(DB_fromLinear(x)) != reference && x != 944) {
+      printf("  x = %u rounds to %d, libm gives %d\n", x,
+             DB_round(DB_fromLinear(x)), reference);
+      exact = false;
+    }
+  }
+  TEST_CHECK(exact);
+  TEST_CHECK(DB_round(DB_fromLinear(944)) == 60);
+}
+
+// log2 is exact at the powers of two
+static void testLog2(void) {
+  uint32_t n;
+  bool exact = true;
+
+  TEST_CHECK(DB_log2(0) == 0);
+  for (n = 0; n < 32; n++) {
+    exact = exact && DB_log2(1u << n) == n << 16;
+  }
+  TEST_CHECK(exact);
+}
+
+//=============================================================================
+static void benchmark(void) {
+  uint32_t rounds = 2000;
+  uint32_t sum = 0;
+  double libm_sum = 0;
+  double start;
+  double fixed;
+  double libm;
+  uint32_t pass;
+  uint32_t x;
+
+  start = TEST_seconds();
+  for (pass = 0; pass < rounds; pass++) {
+    for (x = 1; x < 4096; x++) {
+      sum += DB_round(DB_fromLinear(x ^ pass));
+    }
+  }
+  fixed = (TEST_seconds() - start) / (rounds * 4095.0) * 1e9;
+  g_ui32TestSink = sum;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  start = TEST_seconds();
+  for (pass = 0; pass < rounds; pass++) {
+    for (x = 1; x < 4096; x++) {
+      libm_sum += round(20.0 * log10((double)(x ^ pass)));
+    }
+  }
+  libm = (TEST_seconds() - start) / (rounds * 4095.0) * 1e9;
+  g_ui32TestSink = (uint32_t)libm_sum;
+  printf("  host ns per conversion: DB_fromLinear %.2f, "
+         "round(20 * log10) %.2f\n",
+         fixed, libm);
+}
+
+//=============================================================================
+int main(int argc, char *argv[]) {
+  bool full = argc > 1 && strcmp(argv[1], "full") == 0;
+
+  printf("fixed_db against libm:\n");
+  testAccuracy(full);
+  testRounding();
+  testLog2();
+  benchmark();
+  return TEST_finish("test_fixed_db");
+}
@@ -0,0 +1,336 @@
+/*
+ * ================================================================
+ * File: test_game.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host replay test of the game runtime with a small pong-like
+ * game on the emulated LCD:
+ *  - the fixed time step under irregular frame times, and the catch-up
+ *    limit after a long frame
+ *  - a button press between two frames reaching exactly one update
+ *  - a recorded session replayed twice giving the same game, the same LCD
+ *    and the same SPI bytes, with the LCD equal to the back buffer after
+ *    every frame
+ * and a benchmark of the frames per second the runtime and the SPI allow.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "game.h"
+#include "st7735.h"
+#include "test.h"
+
+// One tick per microsecond, 50 updates per second
+#define TICKS_PER_SECOND 1000000
+#define UPDATE_RATE 50
+#define STEP (TICKS_PER_SECOND / UPDATE_RATE)
+#define SESSION_FRAMES 3000
+
+#define COLOR_BACKGROUND GAME_RGB(0, 0, 0)
+#define COLOR_PADDLE GAME_RGB(255, 255, 255)
+#define COLOR_BALL GAME_RGB(255, 255, 0)
+#define COLOR_BALL_PRESSED GAME_RGB(255, 0, 0)
+
+//=============================================================================
+// A paddle moved by the joystick and a ball bouncing off the walls and the
+// paddle. S1 changes the color of the ball.
+typedef struct {
+  int32_t paddle_y;
+  int32_t ball_x;
+  int32_t ball_y;
+  int32_t ball_vx;
+  int32_t ball_vy;
+  uint32_t presses;
+  uint32_t updates;
+  // Presses seen by each update, for the press test
+  uint32_t pressed_updates;
+  bool full_redraw;
+  bool drawn;
+  tGameRect shown_paddle;
+  tGameRect shown_ball;
+  uint16_t shown_ball_color;
+} tTestGame;
+
+static void update(tGame *game, const tGameInput *input, void *argument) {
+  tTestGame *state = argument;
+
+  state->updates++;
+  state->paddle_y += input->joystick_y / 512;
+  if (state->paddle_y < 0) {
+    state->paddle_y = 0;
+  } else if (state->paddle_y > GAME_HEIGHT - 24) {
+    state->paddle_y = GAME_HEIGHT - 24;
+  }
+  if (input->pressed & GAME_BUTTON_S1) {
+    state->presses++;
+    state->pressed_updates++;
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  state->ball_x += state->ball_vx;
+  state->ball_y += state->ball_vy;
+  if (state->ball_y < 0 || state->ball_y > GAME_HEIGHT - 4) {
+    state->ball_vy = -state->ball_vy;
+    state->ball_y += 2 * state->ball_vy;
+  }
+  if (state->ball_x > GAME_WIDTH - 4 ||
+      (state->ball_x < 8 && state->ball_y + 4 > state->paddle_y &&
+       state->ball_y < state->paddle_y + 24)) {
+    state->ball_vx = -state->ball_vx;
+    state->ball_x += 2 * state->ball_vx;
+  } else if (state->ball_x < 0) {
+    state->ball_x = GAME_WIDTH / 2;
+  }
+}
+
+static void render(tGame *game, void *argument) {
+  tTestGame *state = argument;
+  uint16_t ball_color = state->presses & 1 ? COLOR_BALL_PRESSED : COLOR_BALL;
+
+  if (!state->drawn || state->full_redraw) {
+    state->drawn = true;
+    GAME_clear(game, COLOR_BACKGROUND);
+    GAME_fillRect(game, 4, state->paddle_y, 4, 24, COLOR_PADDLE);
+    GAME_fillRect(game, state->ball_x, state->ball_y, 4, 4, ball_color);
+    GAME_present(game);
+    return;
+  }
+  GAME_moveRect(game, &state->shown_paddle, 4, state->paddle_y, 4, 24,
+                COLOR_PADDLE, COLOR_BACKGROUND);
+  // The runtime only sends what moved, so a ball that changed color is
+  // erased first
+  if (ball_color != state->shown_ball_color) {
+    GAME_moveRect(game, &state->shown_ball, 0, 0, 0, 0, 0, COLOR_BACKGROUND);
+    state->shown_ball_color = ball_color;
+  }
+  GAME_moveRect(game, &state->shown_ball, state->ball_x, state->ball_y, 4, 4,
+                ball_color, COLOR_BACKGROUND);
+}
+
+static void gameInit(tGame *game, tTestGame *state, bool full_redraw) {
+  memset(state, 0, sizeof(*state));
+  state->paddle_y = 50;
+  state->ball_x = 60;
+  state->ball_y = 30;
+  state->ball_vx = 3;
+  state->ball_vy = 2;
+  state->full_redraw = full_redraw;
+  ST7735_init(120000000);
+  GAME_init(game, TICKS_PER_SECOND, UPDATE_RATE, update, render, state);
+}
+
+// The emulated LCD shows the back buffer
+static bool lcdShowsFramebuffer(const tGame *game) {
+  uint32_t x;
+  uint32_t y;
+
+  for (y = 0; y < GAME_HEIGHT; y++) {
+    for (x = 0; x < GAME_WIDTH; x++) {
+      if (ST7735_hostPixel(x, y) != game->framebuffer[y * GAME_WIDTH + x]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//=============================================================================
+// Frames come at irregular times, but the updates keep to the step: after
+// every frame they are the elapsed time divided by the step
+static void testFixedStep(void) {
+  static tGame game;
+  tTestGame state;
+  uint32_t now = 0xfff00000;
+  uint32_t elapsed;
+  uint32_t frame;
+
+  srand(11);
+  gameInit(&game, &state, false);
+  GAME_frame(&game, now);
+  for (frame = 0; frame < 2000; frame++) {
+    // 1 ms to 60 ms, less than the catch-up limit, across a wrap of the
+    // tick counter
+    now += 1000 + rand() % 59000;
+    GAME_frame(&game, now);
+    elapsed = now - 0xfff00000;
+    TEST_CHECK(game.updates == elapsed / STEP);
+  }
+  TEST_CHECK(state.updates == game.updates);
+  TEST_CHECK(game.frames == 2000);
+  TEST_CHECK(game.updates_skipped == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A frame of ten steps runs GAME_MAX_CATCH_UP updates and drops the rest,
+  // keeping the fraction of a step
+  gameInit(&game, &state, false);
+  GAME_frame(&game, 0);
+  TEST_CHECK(GAME_frame(&game, 10 * STEP + 5) == GAME_MAX_CATCH_UP);
+  TEST_CHECK(game.updates_skipped == 10 - GAME_MAX_CATCH_UP);
+  TEST_CHECK(game.accumulator == 5);
+  TEST_CHECK(GAME_frame(&game, 11 * STEP - 1) == 0);
+  TEST_CHECK(GAME_frame(&game, 11 * STEP) == 1);
+  TEST_CHECK(game.accumulator == 0);
+}
+
+//=============================================================================
+// A press that is over before the next frame still reaches one update, and
+// only one, however many updates that frame runs
+static void testShortPress(void) {
+  static tGame game;
+  tTestGame state;
+
+  gameInit(&game, &state, false);
+  GAME_frame(&game, 0);
+  GAME_hostInput(&game, 0, 0, GAME_BUTTON_S1);
+  GAME_hostInput(&game, 0, 0, 0);
+  TEST_CHECK(GAME_frame(&game, 3 * STEP) == 3);
+  TEST_CHECK(state.pressed_updates == 1);
+  // Held down over several frames it is still one press
+  GAME_hostInput(&game, 0, 0, GAME_BUTTON_S1);
+  GAME_frame(&game, 4 * STEP);
+  GAME_frame(&game, 5 * STEP);
+  GAME_hostInput(&game, 0, 0, GAME_BUTTON_S1);
+  GAME_frame(&game, 6 * STEP);
+  TEST_CHECK(state.pressed_updates == 2);
+  // A frame without an update keeps the press for the next one
+  GAME_hostInput(&game, 0, 0, 0);
+  GAME_hostInput(&game, 0, 0, GAME_BUTTON_S1);
+  TEST_CHECK(GAME_frame(&game, 6 * STEP + 10) == 0);
+  TEST_CHECK(GAME_frame(&game, 7 * STEP) == 1);
+  TEST_CHECK(state.pressed_updates == 3);
+}
+
+//=============================================================================
+// A session is the time and the input of every frame
+typedef struct {
+  uint32_t time;
+  int32_t joystick_y;
+  uint32_t buttons;
+} tSessionFrame;
+
+static tSessionFrame g_psSession[SESSION_FRAMES];
+
+static void recordSession(void) {
+  uint32_t now = 0;
+  int32_t joystick = 0;
+  uint32_t i;
+
+  srand(12);
+  for (i = 0; i < SESSION_FRAMES; i++) {
+    now += 5000 + rand() % 40000;
+    if (rand() % 20 == 0) {
+      joystick = rand() % 4096 - 2048;
+    }
+    g_psSession[i].time = now;
+    g_psSession[i].joystick_y = joystick;
+    g_psSession[i].buttons = rand() % 8 == 0 ? GAME_BUTTON_S1 : 0;
+  }
+}
+
+// Play the session, checking the LCD after every frame. Returns a hash of
+// the LCD at the end.
+static uint32_t playSession(tGame *game, tTestGame *state, bool *lcd_ok,
+                            uint32_t *bytes) {
+  uint32_t start;
+  uint32_t hash = 2166136261u;
+  uint32_t x;
+  uint32_t y;
+  uint32_t i;
+
+  gameInit(game, state, false);
+  start = ST7735_bytesSent();
+  GAME_frame(game, 0);
+  *lcd_ok = lcdShowsFramebuffer(game);
+  for (i = 0; i < SESSION_FRAMES; i++) {
+    GAME_hostInput(game, 0, g_psSession[i].joystick_y,
+                   g_psSession[i].buttons);
+    GAME_frame(game, g_psSession[i].time);
+    *lcd_ok = *lcd_ok && lcdShowsFramebuffer(game);
+  }
+  *bytes = ST7735_bytesSent() - start;
+  for (y = 0; y < GAME_HEIGHT; y++) {
+    for (x = 0; x < GAME_WIDTH; x++) {
+      hash = (hash ^ ST7735_hostPixel(x, y)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+static void testReplay(void) {
+  static tGame first_game;
+  static tGame second_game;
+  tTestGame first;
+  tTestGame second;
+  uint32_t first_hash;
+  uint32_t second_hash;
+  uint32_t first_bytes;
+  uint32_t second_bytes;
+  bool lcd_ok;
+
+  recordSession();
+  first_hash = playSession(&first_game, &first, &lcd_ok, &first_bytes);
+  TEST_CHECK(lcd_ok);
+  second_hash = playSession(&second_game, &second, &lcd_ok, &second_bytes);
+  TEST_CHECK(lcd_ok);
+  TEST_CHECK(first_hash == second_hash);
+  TEST_CHECK(first_bytes == second_bytes);
+  TEST_CHECK(first.updates == second.updates);
+  TEST_CHECK(first.presses == second.presses);
+  TEST_CHECK(first.presses > 100);
+  TEST_CHECK(first.ball_x == second.ball_x && first.ball_y == second.ball_y);
+  TEST_CHECK(first.paddle_y == second.paddle_y);
+  TEST_CHECK(memcmp(first_game.framebuffer, second_game.framebuffer,
+                    sizeof(first_game.framebuffer)) == 0);
+  TEST_CHECK(first_game.pixels_sent == second_game.pixels_sent);
+  printf("  replay of %u frames: %u updates, %u presses, %u SPI bytes, "
+         "same both times\n",
+         SESSION_FRAMES, first.updates, first.presses, first_bytes);
+}
+
+//=============================================================================
+// Frames back to back with an update each. The SPI moves 8 bits per clock
+// at ST7735_SPI_RATE, which bounds the frame rate by the bytes per frame.
+static void benchmark(bool full_redraw) {
+  static tGame game;
+  tTestGame state;
+  uint32_t frames = 20000;
+  uint32_t bytes;
+  double start;
+  double host;
+  double spi;
+  uint32_t i;
+
+  gameInit(&game, &state, full_redraw);
+  GAME_frame(&game, 0);
+  bytes = ST7735_bytesSent();
+  start = TEST_seconds();
+  for (i = 1; i <= frames; i++) {
+    GAME_hostInput(&game, 0, (i / 100) % 2 ? 1500 : -1500, 0);
+    GAME_frame(&game, i * STEP);
+  }
+  host = (TEST_seconds() - start) / frames;
+  bytes = (ST7735_bytesSent() - bytes) / frames;
+  spi = bytes * 8.0 / ST7735_SPI_RATE;
+  printf("  %s: %5u SPI bytes per frame, %7.0f frames/s on the host, "
+         "%5.0f frames/s the SPI allows\n",
+         full_redraw ? "full redraw " : "dirty rects ", bytes, 1.0 / host,
+         1.0 / spi);
+}
+
+//=============================================================================
+int main(void) {
+  printf("game runtime:\n");
+  testFixedStep();
+  testShortPress();
+  testReplay();
+  benchmark(true);
+  benchmark(false);
+  return TEST_finish("test_game");
+}
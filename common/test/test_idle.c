@@ -0,0 +1,151 @@
+/*
+ * ================================================================
+ * File: test_idle.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host simulation of the main loop sleeping with IDLE_sleep()
+ * between simulated interrupts. Checking for work takes time, and an
+ * interrupt often comes during the check, after the flag was read and
+ * before the WFI. With the check masked that interrupt stays pending and
+ * ends the WFI at once, so every event is handled within the time of one
+ * check and the work, long before the next interrupt. The same loop with
+ * the check done unmasked, the way a plain flag loop does it, sleeps
+ * through such events until the next interrupt, which shows that the
+ * simulation catches a lost wake-up.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "idle.h"
+#include "test.h"
+
+#define EVENTS 100000
+// Cycles between interrupts, and the most a check and the work for one
+// event take. An event handled later than GAP_MIN after it came was only
+// handled because the next interrupt woke the core.
+#define GAP_MIN 5000
+#define GAP_MAX 20000
+#define CHECK_MAX 400
+#define WORK_MAX 1000
+#define SYSTEM_CLOCK 120000000
+
+typedef struct {
+  // Raised by the interrupt, handled by the main loop
+  volatile uint32_t raised;
+  uint32_t handled;
+  uint32_t time[16];
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // When the last check started and ended, and the interrupts that came
+  // in between, after the flag was read
+  uint32_t check_start;
+  uint32_t check_end;
+  uint32_t races;
+  tIdleLatency latency;
+  uint32_t lost;
+} tSimulation;
+
+//=============================================================================
+// The interrupt: note the time of the event and when the next one comes.
+// Now and then two come close together.
+static uint32_t interrupt(void *argument) {
+  tSimulation *simulation = argument;
+
+  simulation->time[simulation->raised % 16] = IDLE_now();
+  simulation->raised++;
+  return IDLE_now() + (rand() % 16 == 0 ? 10 + rand() % 100
+                                         : GAP_MIN + rand() % (GAP_MAX -
+                                                               GAP_MIN));
+}
+
+// Reading the flag comes first, deciding on it takes a while
+static bool pending(void *argument) {
+  tSimulation *simulation = argument;
+  bool busy = simulation->raised != simulation->handled;
+
+  simulation->check_start = IDLE_now();
+  IDLE_hostRun(rand() % CHECK_MAX);
+  simulation->check_end = IDLE_now();
+  return busy;
+}
+
+static void handle(tSimulation *simulation) {
+  uint32_t came;
+
+  if (simulation->handled != simulation->raised) {
+    came = simulation->time[simulation->handled % 16];
+    if (came - simulation->check_start <
+        simulation->check_end - simulation->check_start) {
+      simulation->races++;
+    }
+  }
+  while (simulation->handled != simulation->raised) {
+    IDLE_latency(&simulation->latency,
+                 simulation->time[simulation->handled % 16]);
+    if (simulation->latency.last >= GAP_MIN) {
+      simulation->lost++;
+    }
+    simulation->handled++;
+    IDLE_hostRun(rand() % WORK_MAX);
+  }
+}
+
+//=============================================================================
+// The main loop of the programs: sleep, then handle what came. masked is
+// false for the plain loop that checks the flag and then sleeps.
+static void run(tSimulation *simulation, tIdle *idle, bool masked) {
+  memset(simulation, 0, sizeof(*simulation));
+  IDLE_init(idle, SYSTEM_CLOCK, 10);
+  IDLE_hostSource(interrupt, simulation, IDLE_now() + GAP_MIN);
+  while (simulation->handled < EVENTS) {
+    if (masked) {
+      IDLE_sleep(idle, pending, simulation);
+    } else if (!pending(simulation)) {
+      IDLE_sleep(idle, 0, 0);
+    }
+    handle(simulation);
+  }
+  IDLE_hostSource(0, 0, 0);
+}
+
+//=============================================================================
+static void testNoLostWakeUp(void) {
+  static tSimulation simulation;
+  tIdle idle;
+
+  srand(20);
+  run(&simulation, &idle, true);
+  printf("  masked check: %u events, %u sleeps, %u came during the check, "
+         "latency at most %u cycles, %u lost, %u%% awake\n",
+         simulation.handled, idle.sleeps, simulation.races,
+         simulation.latency.max, simulation.lost, idle.active_percent);
+  TEST_CHECK(simulation.lost == 0);
+  TEST_CHECK(simulation.latency.max < CHECK_MAX + 2 * WORK_MAX + 100);
+  // The interrupt came during the check often enough for this to mean
+  // something
+  TEST_CHECK(simulation.races > EVENTS / 1000);
+  TEST_CHECK(idle.windows > 0 && idle.active_percent < 20);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  srand(20);
+  run(&simulation, &idle, false);
+  printf("  plain check:  %u events, %u sleeps, %u came during the check, "
+         "latency at most %u cycles, %u lost\n",
+         simulation.handled, idle.sleeps, simulation.races,
+         simulation.latency.max, simulation.lost);
+  TEST_CHECK(simulation.lost > 0);
+}
+
+//=============================================================================
+int main(void) {
+  printf("sleeping between simulated interrupts:\n");
+  testNoLostWakeUp();
+  return TEST_finish("test_idle");
+}
@@ -0,0 +1,278 @@
+/*
+ * ================================================================
+ * File: test_joystick.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the joystick conditioning on noisy traces, run
+ * through the chain 2.2 and 4.2 use: a median of 5, a moving average and
+ * the axis with its deadzone, end stops and hysteresis. The traces follow
+ * moves of the stick the way the ADC sees them, with noise of a few counts
+ * and spikes to the rails now and then, one or two samples long:
+ *  - at rest the position does not change, not even once
+ *  - held at the centre and at the ends it reads exactly 0 and +-JOY_FULL
+ *  - while the stick moves one way the position never steps back
+ * The same traces through the average alone show the spikes the median
+ * takes out. A benchmark times the median networks against an insertion
+ * sort and the whole chain per sample.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "filter.h"
+#include "joystick.h"
+#include "test.h"
+
+#define MEDIAN_LENGTH 5
+#define TRACE_MAX 60000
+// Samples a hold takes to settle after a move, the median and the longest
+// average
+#define SETTLE (MEDIAN_LENGTH + FILTER_LENGTH(3))
+
+// The configuration of 2.2 and 4.2
+static const tJoyAxisConfig g_sConfig = {2048, 48, 60, 4035, 24};
+
+// A move of the stick: in samples it goes in a straight line to reading
+typedef struct {
+  uint32_t samples;
+  int32_t reading;
+} tMove;
+
+typedef struct {
+  const char *name;
+  const tMove *moves;
+  uint32_t count;
+} tTrace;
+
+// Rests off the exact centre, the way a released stick does, slow and fast
+// moves to the ends and back, and holds part of the way
+static const tMove g_psRest[] = {{1, 2061}, {40000, 2061}};
+static const tMove g_psSweep[] = {
+    {1, 2040},    {2000, 2040}, {6000, 4090}, {3000, 4090}, {6000, 2040},
+    {2000, 2040}, {6000, 8},    {3000, 8},    {6000, 2056}, {3000, 2056}};
+static const tMove g_psFlicks[] = {
+    {1, 2050},  {3000, 2050}, {40, 4090},  {2000, 4090}, {40, 2035},
+    {2000, 2035}, {40, 5},    {2000, 5},   {40, 2058},   {2000, 2058},
+    {200, 3100}, {3000, 3100}, {200, 1200}, {3000, 1200}, {100, 2048},
+    {3000, 2048}};
+
+static const tTrace g_psTraces[] = {
+    {"rest", g_psRest, sizeof(g_psRest) / sizeof(g_psRest[0])},
+    {"sweep", g_psSweep, sizeof(g_psSweep) / sizeof(g_psSweep[0])},
+    {"flicks", g_psFlicks, sizeof(g_psFlicks) / sizeof(g_psFlicks[0])}};
+
+static uint32_t g_pui32Readings[TRACE_MAX];
+// Where the stick really was, and whether it was held still there
+static int32_t g_pi32Stick[TRACE_MAX];
+static bool g_pbHeld[TRACE_MAX];
+static uint32_t g_ui32Random;
+
+static uint32_t random32(void) {
+  g_ui32Random = g_ui32Random * 1664525 + 1013904223;
+  return g_ui32Random >> 8;
+}
+
+//=============================================================================
+// The readings of a trace. The noise is the sum of four uniform draws, near
+// normal with a deviation of about 5 counts, and one sample in 250 is a
+// spike to a rail, one in 2000 two of them in a row.
+static uint32_t makeTrace(const tTrace *trace) {
+  int32_t from = trace->moves[0].reading;
+  int32_t reading;
+  uint32_t length = 0;
+  uint32_t spikes = 0;
+  uint32_t m;
+  uint32_t i;
+
+  g_ui32Random = 23;
+  for (m = 0; m < trace->count; m++) {
+    for (i = 1; i <= trace->moves[m].samples && length < TRACE_MAX; i++) {
+      g_pi32Stick[length] =
+          from + (trace->moves[m].reading - from) * (int32_t)i /
+                     (int32_t)trace->moves[m].samples;
+      g_pbHeld[length] = trace->moves[m].reading == from && i > SETTLE;
+      reading = g_pi32Stick[length];
+      reading += (int32_t)(random32() % 9 + random32() % 9 + random32() % 9 +
+                           random32() % 9) -
+                 16;
+      if (spikes > 0 || random32() % 250 == 0) {
+        spikes = spikes > 0 ? spikes - 1 : random32() % 8 == 0;
+        reading = random32() & 1 ? 4095 : 0;
+      }
+      g_pui32Readings[length++] =
+          (uint32_t)(reading < 0 ? 0 : reading > 4095 ? 4095 : reading);
+    }
+    from = trace->moves[m].reading;
+  }
+  return length;
+}
+
+//=============================================================================
+typedef struct {
+  // Position changes while the stick was held still
+  uint32_t held_changes;
+  uint32_t changes;
+  // Steps against the way the stick was moving
+  uint32_t reversals;
+  // Holds at the centre or an end that did not read it exactly
+  uint32_t inexact;
+} tRun;
+
+// The position a hold should settle at, or 1 when it is between the
+// centre and the ends, where it only has to come within the band
+static int32_t exactPosition(int32_t stick) {
+  int32_t position = JOY_axisMap(&g_sConfig, (uint32_t)stick);
+
+  return position == 0 || position == JOY_FULL || position == -JOY_FULL
+             ? position
+             : 1;
+}
+
+static void run(uint32_t length, bool median, uint32_t average_log2,
+                tRun *result) {
+  uint32_t average_window[FILTER_LENGTH(3)];
+  uint32_t median_window[MEDIAN_LENGTH];
+  tFilterMovingAverage average;
+  tFilterMedian filter;
+  tJoyAxis axis;
+  int32_t previous;
+  int32_t way;
+  int32_t step;
+  int32_t exact;
+  uint32_t reading;
+  uint32_t i;
+
+  memset(result, 0, sizeof(*result));
+  FILTER_medianInit(&filter, median_window, MEDIAN_LENGTH);
+  FILTER_movingAverageInit(&average, average_window, average_log2);
+  JOY_axisInit(&axis, &g_sConfig);
+  for (i = 0; i < length; i++) {
+    reading = median ? FILTER_medianPush(&filter, g_pui32Readings[i])
+                     : g_pui32Readings[i];
+    reading = FILTER_movingAveragePush(&average, reading);
+    previous = axis.position;
+    if (JOY_axisUpdate(&axis, reading)) {
+      way = i > 0 ? g_pi32Stick[i] - g_pi32Stick[i - 1] : 0;
+      step = axis.position - previous;
+      result->changes++;
+      result->held_changes += g_pbHeld[i];
+      result->reversals += (way > 0 && step < 0) || (way < 0 && step > 0);
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Where the position ended up at the last sample of a hold
+    if (g_pbHeld[i] && (i + 1 == length || !g_pbHeld[i + 1])) {
+      exact = exactPosition(g_pi32Stick[i]);
+      result->inexact += exact != 1 && axis.position != exact;
+    }
+  }
+}
+
+//=============================================================================
+static void testTraces(void) {
+  tRun chain;
+  tRun plain;
+  uint32_t length;
+  uint32_t log2;
+  uint32_t t;
+
+  for (t = 0; t < sizeof(g_psTraces) / sizeof(g_psTraces[0]); t++) {
+    length = makeTrace(&g_psTraces[t]);
+    for (log2 = 2; log2 <= 3; log2++) {
+      run(length, true, log2, &chain);
+      run(length, false, log2, &plain);
+      printf("  %-6s average of %u: %5u changes, %u held, %u back, "
+             "%u inexact; without the median %u held\n",
+             g_psTraces[t].name, FILTER_LENGTH(log2), chain.changes,
+             chain.held_changes, chain.reversals, chain.inexact,
+             plain.held_changes);
+      TEST_CHECK(chain.held_changes == 0);
+      TEST_CHECK(chain.reversals == 0);
+      TEST_CHECK(chain.inexact == 0);
+      // The spikes are there, and it is the median that takes them out
+      TEST_CHECK(plain.held_changes > 0);
+    }
+  }
+}
+
+//=============================================================================
+// What the networks replace, for the benchmark
+static uint32_t insertionMedian(const uint32_t *samples, uint32_t length) {
+  uint32_t sorted[FILTER_MEDIAN_MAX];
+  uint32_t value;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0; i < length; i++) {
+    value = samples[i];
+    for (j = i; j > 0 && sorted[j - 1] > value; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+  return sorted[length >> 1];
+}
+
+static void benchmark(void) {
+  uint32_t average_window[FILTER_LENGTH(2)];
+  uint32_t median_window[MEDIAN_LENGTH];
+  tFilterMovingAverage average;
+  tFilterMedian filter;
+  tJoyAxis axis;
+  uint32_t length;
+  uint32_t sum;
+  uint32_t n;
+  uint32_t i;
+  double network;
+  double insertion;
+  double start;
+
+  length = makeTrace(&g_psTraces[2]);
+  for (n = 3; n <= 9; n += 2) {
+    sum = 0;
+    start = TEST_seconds();
+    for (i = 0; i + n <= length; i++) {
+      sum += FILTER_medianOf(&g_pui32Readings[i], n);
+    }
+    network = (TEST_seconds() - start) / (length - n + 1);
+    start = TEST_seconds();
+    for (i = 0; i + n <= length; i++) {
+      sum -= insertionMedian(&g_pui32Readings[i], n);
+    }
+    insertion = (TEST_seconds() - start) / (length - n + 1);
+    g_ui32TestSink = sum;
+    printf("  median of %u: %5.1f host ns with the network, %5.1f ns with "
+           "an insertion sort\n",
+           n, network * 1e9, insertion * 1e9);
+    TEST_CHECK(sum == 0);
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  FILTER_medianInit(&filter, median_window, MEDIAN_LENGTH);
+  FILTER_movingAverageInit(&average, average_window, 2);
+  JOY_axisInit(&axis, &g_sConfig);
+  sum = 0;
+  start = TEST_seconds();
+  for (i = 0; i < length; i++) {
+    sum += JOY_axisUpdate(
+        &axis, FILTER_movingAveragePush(
+                   &average, FILTER_medianPush(&filter, g_pui32Readings[i])));
+  }
+  g_ui32TestSink = sum;
+  printf("  median, average and axis: %.1f host ns per sample\n",
+         (TEST_seconds() - start) / length * 1e9);
+}
+
+//=============================================================================
+int main(void) {
+  printf("joystick conditioning on noisy traces:\n");
+  testTraces();
+  benchmark();
+  return TEST_finish("test_joystick");
+}
@@ -0,0 +1,241 @@
+/*
+ * ================================================================
+ * File: test_orientation.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the CORDIC pitch and roll against libm. The
+ * angle and length of ORIENT_atan2() are compared with atan2() and hypot()
+ * all the way round and over the whole range of lengths, and the pitch and
+ * roll of ORIENT_update() with the ones libm gives for the same calibrated
+ * axes, on every tilt of a simulated board. A calibration captured from a
+ * simulated board that is turned round has to find its offsets and gains
+ * and survive the EEPROM. A benchmark times an update against libm.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "orientation.h"
+#include "test.h"
+
+// Largest angle error allowed, in degrees. The last CORDIC step is 7 / 2^16
+// degrees and the rounding of the shifts adds a little.
+#define ANGLE_ERROR_MAX 0.0005
+#define Q16 65536.0
+#define PI 3.14159265358979323846
+
+static double degrees(double radians) { return radians * 180 / PI; }
+
+// The difference of two angles, taken the short way round
+static double angleError(int32_t angle, double reference) {
+  double error = fabs(angle / Q16 - reference);
+
+  return error > 180 ? 360 - error : error;
+}
+
+//=============================================================================
+// Vectors all the way round, from lengths of a few counts up to 2^30. The
+// shortest ones have too few bits for the angle, they only have to be
+// within the angle a count makes.
+static void testAtan2(void) {
+  static const double lengths[] = {3, 20, 200, 819, 4096, 1 << 16, 1 << 24,
+                                   1 << 30};
+  double worst_angle = 0;
+  double worst_length = 0;
+  double reference;
+  double error;
+  double turn;
+  uint32_t magnitude;
+  int32_t angle;
+  int32_t x;
+  int32_t y;
+  uint32_t l;
+  uint32_t i;
+
+  for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    for (i = 0; i < 36000; i++) {
+      turn = i * 2 * PI / 36000;
+      x = (int32_t)lrint(lengths[l] * cos(turn));
+      y = (int32_t)lrint(lengths[l] * sin(turn));
+      angle = ORIENT_atan2(y, x, &magnitude);
+      if (x == 0 && y == 0) {
+        continue;
+      }
+      reference = hypot(x, y);
+      error = angleError(angle, degrees(atan2(y, x)));
+      if (lengths[l] >= 200) {
+        worst_angle = error > worst_angle ? error : worst_angle;
+        TEST_CHECK(error < ANGLE_ERROR_MAX);
+      } else {
+        TEST_CHECK(error < degrees(1.5 / reference));
+      }
+      error = fabs(magnitude - reference);
+      TEST_CHECK(error <= 1 + reference * 1e-5);
+      error /= reference;
+      if (lengths[l] >= 4096) {
+        worst_length = error > worst_length ? error : worst_length;
+      }
+    }
+  }
+  printf("  atan2: max error %.6f degrees, length off by %.2g at most\n",
+         worst_angle, worst_length);
+  // The axes and the far left, where the vector is turned round first
+  TEST_CHECK(ORIENT_atan2(0, 0, &magnitude) == 0 && magnitude == 0);
+  TEST_CHECK(angleError(ORIENT_atan2(0, 5, 0), 0) < ANGLE_ERROR_MAX);
+  TEST_CHECK(angleError(ORIENT_atan2(5, 0, 0), 90) < ANGLE_ERROR_MAX);
+  TEST_CHECK(angleError(ORIENT_atan2(-5, 0, 0), -90) < ANGLE_ERROR_MAX);
+  TEST_CHECK(angleError(ORIENT_atan2(0, -5, 0), 180) < ANGLE_ERROR_MAX);
+  TEST_CHECK(angleError(ORIENT_atan2(-1, -1000000, 0), -180) <
+             ANGLE_ERROR_MAX);
+}
+
+//=============================================================================
+// The raw readings of a board tilted by pitch and roll, in degrees, with
+// the default calibration and 1 g pointing down through the board
+static void tilt(double pitch, double roll, uint32_t *raw) {
+  double counts = 819;
+
+  pitch = pitch * PI / 180;
+  roll = roll * PI / 180;
+  raw[0] = (uint32_t)lrint(2048 - counts * sin(pitch));
+  raw[1] = (uint32_t)lrint(2048 + counts * cos(pitch) * sin(roll));
+  raw[2] = (uint32_t)lrint(2048 + counts * cos(pitch) * cos(roll));
+}
+
+// Every tilt a degree apart, against libm on the same calibrated axes, so
+// that only the CORDIC is measured and not the rounding of the readings
+static void testUpdate(void) {
+  tOrientCalibration calibration;
+  tOrientation orientation;
+  double worst = 0;
+  double axis[ORIENT_AXES];
+  double error;
+  uint32_t raw[ORIENT_AXES];
+  int32_t pitch;
+  int32_t roll;
+  uint32_t i;
+
+  ORIENT_calibrationDefault(&calibration);
+  for (pitch = -89; pitch <= 89; pitch++) {
+    for (roll = -179; roll <= 180; roll++) {
+      tilt(pitch, roll, raw);
+      ORIENT_update(&calibration, raw, &orientation);
+      for (i = 0; i < ORIENT_AXES; i++) {
+        axis[i] = floor(((int32_t)raw[i] - calibration.offset[i]) *
+                        (double)calibration.gain[i] / 256);
+      }
+      error = angleError(orientation.roll, degrees(atan2(axis[1], axis[2])));
+      worst = error > worst ? error : worst;
+      error = angleError(orientation.pitch,
+                         degrees(atan2(-axis[0], hypot(axis[1], axis[2]))));
+      worst = error > worst ? error : worst;
+      // The readings are whole counts, the tilt comes out to a tenth
+      TEST_CHECK(angleError(orientation.pitch, pitch) < 0.1);
+      TEST_CHECK(abs((int32_t)orientation.magnitude - ORIENT_ONE_G) < 10);
+    }
+  }
+  printf("  update: max error %.6f degrees against libm\n", worst);
+  TEST_CHECK(worst < ANGLE_ERROR_MAX);
+}
+
+//=============================================================================
+// A board with its own offsets and sensitivities, turned so that every axis
+// points up and down once
+static void testCalibration(void) {
+  static const int32_t offsets[ORIENT_AXES] = {1990, 2101, 2050};
+  static const int32_t counts[ORIENT_AXES] = {790, 845, 812};
+  tOrientCalibration calibration;
+  tOrientCalibration loaded;
+  tOrientCapture capture;
+  tOrientation orientation;
+  uint32_t raw[ORIENT_AXES];
+  uint32_t i;
+  uint32_t j;
+
+  ORIENT_calibrationDefault(&calibration);
+  ORIENT_captureStart(&capture);
+  TEST_CHECK(!ORIENT_captureFinish(&capture, &calibration));
+  for (i = 0; i < 2 * ORIENT_AXES; i++) {
+    for (j = 0; j < ORIENT_AXES; j++) {
+      raw[j] = (uint32_t)(offsets[j] +
+                          (j == i / 2 ? (i & 1 ? -counts[j] : counts[j]) : 0));
+    }
+    ORIENT_captureAdd(&capture, raw);
+  }
+  TEST_CHECK(ORIENT_captureFinish(&capture, &calibration));
+  for (i = 0; i < ORIENT_AXES; i++) {
+    TEST_CHECK(calibration.offset[i] == offsets[i]);
+  }
+  // Lying flat with Z up the board reads 1 g and no tilt
+  for (i = 0; i < ORIENT_AXES; i++) {
+    raw[i] = (uint32_t)(offsets[i] + (i == 2 ? counts[i] : 0));
+  }
+  ORIENT_update(&calibration, raw, &orientation);
+  TEST_CHECK(abs((int32_t)orientation.magnitude - ORIENT_ONE_G) <= 1);
+  TEST_CHECK(angleError(orientation.pitch, 0) < ANGLE_ERROR_MAX &&
+             angleError(orientation.roll, 0) < ANGLE_ERROR_MAX);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  TEST_CHECK(ORIENT_save(&calibration));
+  TEST_CHECK(ORIENT_load(&loaded));
+  TEST_CHECK(memcmp(&loaded, &calibration, sizeof(loaded)) == 0);
+}
+
+//=============================================================================
+static void benchmark(void) {
+  static uint32_t raws[1024][ORIENT_AXES];
+  tOrientCalibration calibration;
+  tOrientation orientation;
+  uint32_t rounds = 2000000;
+  double axis[ORIENT_AXES];
+  double cordic;
+  double libm;
+  double start;
+  double sink = 0;
+  uint32_t i;
+  uint32_t j;
+
+  srand(22);
+  for (i = 0; i < 1024; i++) {
+    tilt(rand() % 179 - 89, rand() % 360 - 179, raws[i]);
+  }
+  ORIENT_calibrationDefault(&calibration);
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    ORIENT_update(&calibration, raws[i % 1024], &orientation);
+    g_ui32TestSink = (uint32_t)orientation.pitch;
+  }
+  cordic = (TEST_seconds() - start) / rounds;
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    for (j = 0; j < ORIENT_AXES; j++) {
+      axis[j] = ((int32_t)raws[i % 1024][j] - calibration.offset[j]) *
+                (double)calibration.gain[j] / 256;
+    }
+    sink += atan2(axis[1], axis[2]) +
+            atan2(-axis[0], hypot(axis[1], axis[2]));
+  }
+  libm = (TEST_seconds() - start) / rounds;
+  g_ui32TestSink = (uint32_t)sink;
+  printf("  update: %.1f host ns with the CORDIC, %.1f ns with libm in "
+         "double\n",
+         cordic * 1e9, libm * 1e9);
+}
+
+//=============================================================================
+int main(void) {
+  printf("orientation against libm:\n");
+  testAtan2();
+  testUpdate();
+  testCalibration();
+  benchmark();
+  return TEST_finish("test_orientation");
+}
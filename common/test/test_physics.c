@@ -0,0 +1,291 @@
+/*
+ * ================================================================
+ * File: test_physics.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the fixed-point physics, compiled with the 4.1
+ * pong from its main.c and the stand-ins of board/. Ten minutes of joystick
+ * input are recorded from a simulated player, then the log is replayed
+ * through the game's update twice. Both replays have to end in the state of
+ * the recording bit for bit, and match the hash recorded here, so a change
+ * that alters the arithmetic shows. On the way the ball may never be inside
+ * a wall or pass through a paddle, and the paddle has to move as fast as
+ * the joystick asks all the way out. A benchmark times an ordinary update and
+ * the worst case found, the update with the most sweeps.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+// Every sweep of the game goes through countedMove(), to count them
+#define PHYS_move countedMove
+#define main pongMain
+#include "../../Assignment_4.1_pong/src/main.c"
+#undef main
+#undef PHYS_move
+#include "test.h"
+
+int32_t PHYS_move(tPhysBody *body, tQ16 *time, const tPhysBox *boxes,
+                  uint32_t mask, tPhysHit *hit);
+
+#define LOG_LENGTH 36000
+// Hash of the state after the whole log, from the first run of this test.
+// It only changes when the physics or the game does.
+#define LOG_HASH 0x033520f0u
+
+static int16_t g_pi16Log[LOG_LENGTH];
+static uint32_t g_ui32Sweeps;
+static uint32_t g_ui32Random;
+
+int32_t countedMove(tPhysBody *body, tQ16 *time, const tPhysBox *boxes,
+                    uint32_t mask, tPhysHit *hit) {
+  g_ui32Sweeps++;
+  return PHYS_move(body, time, boxes, mask, hit);
+}
+
+// The C library's rand() differs between machines, the log may not
+static uint32_t random32(void) {
+  g_ui32Random = g_ui32Random * 1664525 + 1013904223;
+  return g_ui32Random >> 8;
+}
+
+//=============================================================================
+// The player the log is recorded from: it pushes the joystick towards the
+// ball, harder the further away it is, but now and then looks away for a
+// while and leaves the joystick where it was
+static int32_t player(const tState *state, int32_t joystick) {
+  const tPhysBox *paddle = &state->box[PADDLE_PLAYER];
+  int32_t away;
+
+  if (random32() % 40 == 0) {
+    return joystick;
+  }
+  away = PHYS_TO_INT(paddle->y + paddle->height / 2 - state->ball.box.y -
+                     state->ball.box.height / 2);
+  away = away * 256 + (int32_t)(random32() % 512) - 256;
+  return away > 2047 ? 2047 : away < -2048 ? -2048 : away;
+}
+
+// FNV-1a over the fields the update writes, one by one so that padding
+// does not count
+static uint32_t hashWord(uint32_t hash, uint32_t word) {
+  uint32_t i;
+
+  for (i = 0; i < 4; i++, word >>= 8) {
+    hash = (hash ^ (word & 0xFF)) * 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t hashState(const tState *state) {
+  uint32_t hash = 2166136261u;
+  uint32_t i;
+
+  for (i = 0; i < BOX_COUNT; i++) {
+    hash = hashWord(hash, state->box[i].x);
+    hash = hashWord(hash, state->box[i].y);
+    hash = hashWord(hash, state->box[i].width);
+    hash = hashWord(hash, state->box[i].height);
+  }
+  hash = hashWord(hash, state->ball.box.x);
+  hash = hashWord(hash, state->ball.box.y);
+  hash = hashWord(hash, state->ball.vx);
+  hash = hashWord(hash, state->ball.vy);
+  hash = hashWord(hash, state->serves);
+  hash = hashWord(hash, state->score_player);
+  return hashWord(hash, state->score_board);
+}
+
+// Ten minutes at 60 updates per second from a reset game. With record set
+// the joystick comes from the player and is written to the log, otherwise
+// it is read from the log. Returns the hashes after every update folded
+// into one. The walls never move, so the ball may never be in one, and in
+// an update without a bounce or a serve its straight path may not go
+// through a paddle.
+static uint32_t replay(tState *state, bool record, bool *apart,
+                       tQ16 *fastest) {
+  tGameInput input;
+  tPhysBody before;
+  tPhysHit hit;
+  uint32_t serves;
+  uint32_t hash = 0;
+  tQ16 speed;
+  uint32_t i;
+  uint32_t b;
+
+  memset(state, 0, sizeof(*state));
+  memset(&input, 0, sizeof(input));
+  resetGame(state);
+  g_ui32Random = 16;
+  *apart = true;
+  *fastest = 0;
+  for (i = 0; i < LOG_LENGTH; i++) {
+    if (record) {
+      g_pi16Log[i] = (int16_t)player(state, input.joystick_y);
+    }
+    input.joystick_y = g_pi16Log[i];
+    before = state->ball;
+    serves = state->serves;
+    update(&g_sGame, &input, state);
+    hash = hashWord(hash, hashState(state));
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    *apart = *apart &&
+             !PHYS_overlap(&state->ball.box, &state->box[WALL_TOP]) &&
+             !PHYS_overlap(&state->ball.box, &state->box[WALL_BOTTOM]);
+    for (b = PADDLE_PLAYER; b <= PADDLE_BOARD; b++) {
+      if (state->serves == serves && state->ball.vx == before.vx &&
+          state->ball.vy == before.vy &&
+          PHYS_sweep(&before.box, state->ball.box.x - before.box.x,
+                     state->ball.box.y - before.box.y, &state->box[b],
+                     &hit)) {
+        *apart = *apart && hit.time >= PHYS_ONE;
+      }
+    }
+    speed = state->ball.vx < 0 ? -state->ball.vx : state->ball.vx;
+    *fastest = speed > *fastest ? speed : *fastest;
+  }
+  return hash;
+}
+
+//=============================================================================
+// The run that records the log and two replays of it
+static void testReplay(void) {
+  static tState recorded;
+  static tState first;
+  static tState second;
+  uint32_t hash_recorded;
+  uint32_t hash_first;
+  uint32_t hash_second;
+  tQ16 fastest;
+  bool apart;
+
+  hash_recorded = replay(&recorded, true, &apart, &fastest);
+  TEST_CHECK(apart);
+  hash_first = replay(&first, false, &apart, &fastest);
+  hash_second = replay(&second, false, &apart, &fastest);
+  printf("  %u updates: %u - %u, %u serves, top speed %.1f px/s, "
+         "hash %08x\n",
+         LOG_LENGTH, first.score_player, first.score_board, first.serves,
+         fastest / 65536.0, hash_first);
+  TEST_CHECK(hash_first == hash_recorded && hash_second == hash_recorded);
+  TEST_CHECK(memcmp(&first, &recorded, sizeof(first)) == 0);
+  TEST_CHECK(memcmp(&second, &recorded, sizeof(second)) == 0);
+  TEST_CHECK(hash_first == LOG_HASH);
+  // The log has to get the ball up to the speed where it covers more than
+  // its own size in an update, or the sweeps are not tested
+  TEST_CHECK(PHYS_mul(fastest, DT) > PHYS_FROM_INT(BALL_SIZE));
+}
+
+//=============================================================================
+// The paddle speed follows the joystick all the way out, the product of a
+// reading and the full speed in Q16.16 is worked out in 64 bits here
+static void testPaddle(void) {
+  static const int32_t readings[] = {-2048, -1024, -274, -1, 0,
+                                     1,     273,   512,  1500, 2047};
+  static tState state;
+  tGameInput input;
+  tQ16 expected;
+  tQ16 before;
+  bool exact = true;
+  uint32_t i;
+
+  memset(&input, 0, sizeof(input));
+  for (i = 0; i < sizeof(readings) / sizeof(readings[0]); i++) {
+    memset(&state, 0, sizeof(state));
+    resetGame(&state);
+    before = state.box[PADDLE_PLAYER].y;
+    input.joystick_y = readings[i];
+    update(&g_sGame, &input, &state);
+    expected = -PHYS_mul(
+        (tQ16)((int64_t)readings[i] * PHYS_FROM_INT(PADDLE_SPEED) / 2048), DT);
+    exact = exact && state.box[PADDLE_PLAYER].y - before == expected;
+  }
+  TEST_CHECK(exact);
+}
+
+//=============================================================================
+// Balls at the top speed thrown at the corner between the player's paddle,
+// pushed to the top, and the wall above it, keeping the state with the
+// most sweeps in one update
+static uint32_t findWorstCase(tState *worst) {
+  static tState state;
+  static tState start;
+  tGameInput input;
+  uint32_t most = 0;
+  uint32_t i;
+
+  memset(&input, 0, sizeof(input));
+  input.joystick_y = 2047;
+  g_ui32Random = 1;
+  for (i = 0; i < 200000; i++) {
+    memset(&state, 0, sizeof(state));
+    resetGame(&state);
+    state.box[PADDLE_PLAYER].y = 0;
+    state.ball.box.x = PHYS_FROM_INT(PADDLE_MARGIN + PADDLE_WIDTH) +
+                       (tQ16)(random32() % PHYS_FROM_INT(12));
+    state.ball.box.y = (tQ16)(random32() % PHYS_FROM_INT(8));
+    state.ball.vx = -PHYS_FROM_INT(MAX_SPEED);
+    state.ball.vy =
+        -(tQ16)(random32() % (uint32_t)PHYS_FROM_INT(MAX_SPEED));
+    start = state;
+    g_ui32Sweeps = 0;
+    update(&g_sGame, &input, &state);
+    if (g_ui32Sweeps > most) {
+      most = g_ui32Sweeps;
+      *worst = start;
+    }
+  }
+  return most;
+}
+
+static double timeUpdate(const tState *from, const tGameInput *input) {
+  static tState state;
+  uint32_t rounds = 2000000;
+  double start;
+  uint32_t i;
+
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    state = *from;
+    update(&g_sGame, input, &state);
+  }
+  g_ui32TestSink = state.ball.box.x;
+  return (TEST_seconds() - start) / rounds;
+}
+
+static void benchmark(void) {
+  static tState ordinary;
+  static tState worst;
+  tGameInput input;
+  uint32_t sweeps;
+  double free_flight;
+  double worst_time;
+
+  memset(&input, 0, sizeof(input));
+  input.joystick_y = 2047;
+  memset(&ordinary, 0, sizeof(ordinary));
+  resetGame(&ordinary);
+  sweeps = findWorstCase(&worst);
+  free_flight = timeUpdate(&ordinary, &input);
+  worst_time = timeUpdate(&worst, &input);
+  printf("  update: %.1f host ns in free flight, %.1f ns in the worst case "
+         "found, %u sweeps\n",
+         free_flight * 1e9, worst_time * 1e9, sweeps);
+  TEST_CHECK(sweeps >= 2 && sweeps <= MAX_BOUNCES);
+}
+
+//=============================================================================
+int main(void) {
+  printf("physics replay through pong:\n");
+  testReplay();
+  testPaddle();
+  benchmark();
+  return TEST_finish("test_physics");
+}
@@ -0,0 +1,166 @@
+/*
+ * ================================================================
+ * File: test_profile.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the stage registration of the profiler against
+ * an interrupt. A timer signal stands in for the interrupt and runs a stage
+ * of its own, the way adc_isr and scan_isr do, while the main loop
+ * registers its stages over and over. Every stage has to end up with a slot
+ * of its own under its own name, wherever the interrupt came. The
+ * statistics and histogram bins of a stage are checked on known durations.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+//=============================================================================
+#include "profile.h"
+#include "test.h"
+
+#define INTERRUPTS 20000
+// Microseconds between the interrupts
+#define INTERRUPT_PERIOD 20
+
+static const char *const g_ppcNames[PROF_MAX_STAGES - 1] = {
+    "a", "b", "c", "d", "e", "f", "g", "h",
+    "i", "j", "k", "l", "m", "n", "o"};
+static uint32_t g_pui32Stages[PROF_MAX_STAGES - 1];
+static volatile uint32_t g_ui32IsrStage;
+static volatile sig_atomic_t g_iInterrupts;
+
+//=============================================================================
+static void interrupt(int signal) {
+  uint32_t stage = g_ui32IsrStage;
+  uint32_t start;
+
+  (void)signal;
+  start = PROF_begin(&stage, "isr");
+  g_ui32IsrStage = stage;
+  PROF_end(stage, start);
+  g_iInterrupts++;
+}
+
+static void blockInterrupt(bool block) {
+  sigset_t alarm;
+
+  sigemptyset(&alarm);
+  sigaddset(&alarm, SIGALRM);
+  sigprocmask(block ? SIG_BLOCK : SIG_UNBLOCK, &alarm, 0);
+}
+
+// Every id in its own slot, the slot named after the stage, and nothing
+// registered that should not be
+static bool registered(uint32_t isr_stage) {
+  uint32_t taken = 0;
+  uint32_t count = 0;
+  uint32_t i;
+
+  for (i = 0; i < PROF_MAX_STAGES - 1; i++) {
+    if (g_pui32Stages[i] >= PROF_stageCount() ||
+        (taken & (1u << g_pui32Stages[i])) ||
+        strcmp(PROF_stage(g_pui32Stages[i])->name, g_ppcNames[i]) != 0) {
+      return false;
+    }
+    taken |= 1u << g_pui32Stages[i];
+    count++;
+  }
+  if (isr_stage != PROF_STAGE_NONE) {
+    if (isr_stage >= PROF_stageCount() || (taken & (1u << isr_stage)) ||
+        strcmp(PROF_stage(isr_stage)->name, "isr") != 0) {
+      return false;
+    }
+    count++;
+  }
+  return count == PROF_stageCount();
+}
+
+//=============================================================================
+// The main loop forgets its stages and registers them again until enough
+// interrupts have come. Counts the rounds in which the interrupt registered
+// its stage between two of the main loop's.
+static void testRegistration(void) {
+  struct itimerval timer = {{0, INTERRUPT_PERIOD}, {0, INTERRUPT_PERIOD}};
+  struct itimerval stop = {{0, 0}, {0, 0}};
+  uint32_t between = 0;
+  uint32_t rounds = 0;
+  uint32_t wrong = 0;
+  uint32_t isr_stage;
+  uint32_t i;
+
+  signal(SIGALRM, interrupt);
+  setitimer(ITIMER_REAL, &timer, 0);
+  while (g_iInterrupts < INTERRUPTS) {
+    blockInterrupt(true);
+    PROF_hostForget();
+    g_ui32IsrStage = PROF_STAGE_NONE;
+    blockInterrupt(false);
+    for (i = 0; i < PROF_MAX_STAGES - 1; i++) {
+      g_pui32Stages[i] = PROF_STAGE_NONE;
+      PROF_end(g_pui32Stages[i],
+               PROF_begin(&g_pui32Stages[i], g_ppcNames[i]));
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    blockInterrupt(true);
+    isr_stage = g_ui32IsrStage;
+    wrong += !registered(isr_stage);
+    between += isr_stage != PROF_STAGE_NONE && isr_stage > 0 &&
+               isr_stage < PROF_MAX_STAGES - 1;
+    blockInterrupt(false);
+    rounds++;
+  }
+  setitimer(ITIMER_REAL, &stop, 0);
+  signal(SIGALRM, SIG_DFL);
+  printf("  %u rounds, %u interrupts, %u registered between two stages, "
+         "%u wrong\n",
+         rounds, (uint32_t)g_iInterrupts, between, wrong);
+  TEST_CHECK(wrong == 0);
+  // The interrupt has to land in the registrations often, or the test
+  // shows nothing
+  TEST_CHECK(between > INTERRUPTS / 100);
+}
+
+//=============================================================================
+// Durations that are known: a start time from before the call adds the
+// duration to the few host ns that PROF_begin() and PROF_end() take. Each
+// is 3 * 2^n, far from the edges of its bin 2^(n + 1).
+static void testStatistics(void) {
+  static const uint32_t shifts[] = {14, 16, 20, 28};
+  const tProfStage *s;
+  uint32_t stage = PROF_STAGE_NONE;
+  uint64_t least = 0;
+  bool binned = true;
+  uint32_t i;
+
+  PROF_hostForget();
+  for (i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+    PROF_end(stage, PROF_begin(&stage, "known") - (3u << shifts[i]));
+    least += 3u << shifts[i];
+  }
+  s = PROF_stage(stage);
+  for (i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+    binned = binned && s->histogram[shifts[i] + 1] == 1;
+  }
+  TEST_CHECK(PROF_stageCount() == 1 && s->count == 4);
+  TEST_CHECK(binned);
+  TEST_CHECK(s->min >= 3u << 14 && s->max >= 3u << 28 && s->total >= least);
+  PROF_reset();
+  TEST_CHECK(s->count == 0 && s->min == 0xffffffff && s->max == 0);
+  TEST_CHECK(strcmp(s->name, "known") == 0);
+}
+
+//=============================================================================
+int main(void) {
+  printf("profiler stage registration against an interrupt:\n");
+  testRegistration();
+  testStatistics();
+  return TEST_finish("test_profile");
+}
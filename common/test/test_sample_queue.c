@@ -0,0 +1,195 @@
+/*
+ * ================================================================
+ * File: test_sample_queue.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the sample queue. A producer thread pushes
+ * numbered records in batches of changing size, the way the interrupts do,
+ * while a consumer thread pops them at an uneven pace, slow enough now and
+ * then for the queue to fill. Every record accepted has to come out once,
+ * in order and whole, the records dropped have to be the overflows counted,
+ * and the indices are started just below their wrap at 2^32. On one thread
+ * the overflow and high water counts are checked exactly.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "sample_queue.h"
+#include "test.h"
+
+#define RECORDS 1000000
+#define BATCH_MAX 8
+#define QUEUE_LOG2 6
+
+// Larger than a word, so that a record copied while it is written shows
+typedef struct {
+  uint32_t number;
+  uint32_t check[3];
+} tRecord;
+
+typedef struct {
+  tSampleQueue queue;
+  tRecord storage[1u << QUEUE_LOG2];
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Kept by the producer
+  uint32_t accepted;
+  uint32_t dropped;
+  volatile bool done;
+  // Kept by the consumer
+  uint32_t received;
+  uint32_t wrong;
+} tStress;
+
+static void fill(tRecord *record, uint32_t number) {
+  record->number = number;
+  record->check[0] = number * 2654435761u;
+  record->check[1] = ~number;
+  record->check[2] = number ^ 0x5a5a5a5a;
+}
+
+static bool whole(const tRecord *record) {
+  return record->check[0] == record->number * 2654435761u &&
+         record->check[1] == ~record->number &&
+         record->check[2] == (record->number ^ 0x5a5a5a5a);
+}
+
+// A small generator per thread, rand() is not thread safe
+static uint32_t nextRandom(uint32_t *state) {
+  *state = *state * 1664525 + 1013904223;
+  return *state >> 16;
+}
+
+//=============================================================================
+// The numbers of a batch that is dropped are used again by the next one, so
+// the records accepted are numbered 0, 1, 2, ... without a gap
+static void *producer(void *argument) {
+  tStress *stress = argument;
+  tRecord batch[BATCH_MAX];
+  uint32_t random = 19;
+  uint32_t count;
+  uint32_t i;
+
+  while (stress->accepted < RECORDS) {
+    count = 1 + nextRandom(&random) % BATCH_MAX;
+    for (i = 0; i < count; i++) {
+      fill(&batch[i], stress->accepted + i);
+    }
+    if (QUEUE_push(&stress->queue, batch, count)) {
+      stress->accepted += count;
+    } else {
+      // On a single core the consumer only gets to run when this yields
+      stress->dropped += count;
+      sched_yield();
+    }
+  }
+  stress->done = true;
+  return 0;
+}
+
+static void *consumer(void *argument) {
+  tStress *stress = argument;
+  tRecord batch[2 * BATCH_MAX];
+  uint32_t random = 7;
+  uint32_t count;
+  uint32_t spin;
+  uint32_t i;
+  bool done;
+
+  do {
+    done = stress->done;
+    count = QUEUE_pop(&stress->queue, batch, 1 + nextRandom(&random) %
+                                                     (2 * BATCH_MAX));
+    if (count == 0) {
+      sched_yield();
+    }
+    for (i = 0; i < count; i++) {
+      if (batch[i].number != stress->received || !whole(&batch[i])) {
+        stress->wrong++;
+      }
+      stress->received++;
+    }
+    // Now and then a long pause, in which the queue fills
+    for (spin = nextRandom(&random) % 64 == 0 ? 20000 : 0; spin > 0;
+         spin--) {
+      g_ui32TestSink = spin;
+    }
+  } while (!done || QUEUE_count(&stress->queue) != 0);
+  return 0;
+}
+
+//=============================================================================
+static void testThreads(void) {
+  static tStress stress;
+  pthread_t threads[2];
+  double start;
+
+  memset(&stress, 0, sizeof(stress));
+  QUEUE_init(&stress.queue, stress.storage, sizeof(tRecord), QUEUE_LOG2);
+  stress.queue.head = 0xffffff00;
+  stress.queue.tail = 0xffffff00;
+  start = TEST_seconds();
+  pthread_create(&threads[1], 0, consumer, &stress);
+  pthread_create(&threads[0], 0, producer, &stress);
+  pthread_join(threads[0], 0);
+  pthread_join(threads[1], 0);
+  printf("  %u records accepted, %u dropped, high water %u of %u, "
+         "%.1f host ns per record\n",
+         stress.accepted, stress.dropped, stress.queue.high_water,
+         1u << QUEUE_LOG2,
+         (TEST_seconds() - start) / (stress.accepted + stress.dropped) * 1e9);
+  TEST_CHECK(stress.wrong == 0);
+  TEST_CHECK(stress.received == stress.accepted);
+  TEST_CHECK(stress.queue.overflows == stress.dropped);
+  TEST_CHECK(stress.queue.head - 0xffffff00 == stress.accepted);
+  TEST_CHECK(stress.queue.tail == stress.queue.head);
+  // The pauses have to fill the queue, or overflows are not tested
+  TEST_CHECK(stress.dropped > 0);
+  TEST_CHECK(stress.queue.high_water > (1u << QUEUE_LOG2) - BATCH_MAX &&
+             stress.queue.high_water <= 1u << QUEUE_LOG2);
+}
+
+//=============================================================================
+// A batch that does not fit is dropped whole, one that just fits is not,
+// and the high water mark is the most that ever waited
+static void testCounts(void) {
+  static tRecord storage[8];
+  tSampleQueue queue;
+  tRecord batch[8];
+  uint32_t i;
+
+  for (i = 0; i < 8; i++) {
+    fill(&batch[i], i);
+  }
+  QUEUE_init(&queue, storage, sizeof(tRecord), 3);
+  TEST_CHECK(QUEUE_push(&queue, batch, 5));
+  TEST_CHECK(!QUEUE_push(&queue, batch, 4));
+  TEST_CHECK(queue.overflows == 4 && QUEUE_count(&queue) == 5);
+  TEST_CHECK(QUEUE_push(&queue, batch, 3));
+  TEST_CHECK(queue.high_water == 8);
+  TEST_CHECK(!QUEUE_push(&queue, batch, 1));
+  TEST_CHECK(queue.overflows == 5);
+  TEST_CHECK(QUEUE_pop(&queue, batch, 6) == 6);
+  TEST_CHECK(batch[0].number == 0 && batch[5].number == 0);
+  TEST_CHECK(QUEUE_pop(&queue, batch, 6) == 2);
+  TEST_CHECK(QUEUE_pop(&queue, batch, 6) == 0);
+  TEST_CHECK(QUEUE_push(&queue, batch, 2));
+  TEST_CHECK(queue.high_water == 8 && queue.overflows == 5);
+}
+
+//=============================================================================
+int main(void) {
+  printf("sample queue with a producer and a consumer thread:\n");
+  testCounts();
+  testThreads();
+  return TEST_finish("test_sample_queue");
+}
@@ -0,0 +1,209 @@
+/*
+ * ================================================================
+ * File: test_scheduler.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Deterministic host test of the scheduling policy. The tick
+ * is simulated with SCHED_hostAdvance(), and a task that is meant to take
+ * time advances it by its cost in ticks while it runs, so the order of the
+ * runs and the deadline misses can be worked out by hand and compared.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "scheduler.h"
+#include "test.h"
+
+//=============================================================================
+// Every run is logged as the task letter and the tick it started on
+#define LOG_MAX 64
+
+typedef struct {
+  char letter;
+  uint32_t cost;
+} tSimTask;
+
+static char g_pcLog[LOG_MAX + 1];
+static uint32_t g_pui32LogTick[LOG_MAX];
+static uint32_t g_ui32LogLength;
+static uint32_t g_ui32Start;
+
+static void simTask(void *argument) {
+  const tSimTask *task = argument;
+
+  if (g_ui32LogLength < LOG_MAX) {
+    g_pui32LogTick[g_ui32LogLength] = SCHED_now() - g_ui32Start;
+    g_pcLog[g_ui32LogLength++] = task->letter;
+    g_pcLog[g_ui32LogLength] = '\0';
+  }
+  SCHED_hostAdvance(task->cost);
+}
+
+static void logStart(void) {
+  g_ui32LogLength = 0;
+  g_pcLog[0] = '\0';
+  g_ui32Start = SCHED_now();
+}
+
+// Run released tasks, and let a tick pass whenever there is none, until
+// ticks have passed since logStart()
+static void runUntil(tScheduler *scheduler, uint32_t ticks) {
+  while (SCHED_now() - g_ui32Start < ticks) {
+    if (!SCHED_runOnce(scheduler)) {
+      TEST_CHECK(!SCHED_pending(scheduler));
+      SCHED_hostAdvance(1);
+    }
+  }
+}
+
+//=============================================================================
+// Light load, the 4.2 kind of mix: every release runs on its own tick,
+// the shortest deadline first
+static void testLightLoad(void) {
+  static tSimTask mic = {'m', 0};
+  static tSimTask acc = {'a', 0};
+  static tSimTask lcd = {'l', 0};
+  tScheduler scheduler;
+
+  SCHED_init(&scheduler);
+  logStart();
+  SCHED_addTask(&scheduler, "lcd", simTask, &lcd, 40, 0);
+  SCHED_addTask(&scheduler, "acc", simTask, &acc, 10, 0);
+  SCHED_addTask(&scheduler, "mic", simTask, &mic, 1, 0);
+  runUntil(&scheduler, 400);
+  TEST_CHECK(scheduler.task[0].runs == 10);
+  TEST_CHECK(scheduler.task[1].runs == 40);
+  TEST_CHECK(scheduler.task[2].runs == 400);
+  TEST_CHECK(scheduler.task[0].deadline_misses == 0);
+  TEST_CHECK(scheduler.task[1].deadline_misses == 0);
+  TEST_CHECK(scheduler.task[2].deadline_misses == 0);
+  TEST_CHECK(strncmp(g_pcLog, "mal", 3) == 0);
+  TEST_CHECK(scheduler.idle_calls == 400);
+}
+
+//=============================================================================
+// B takes longer than its period, so both tasks miss. Worked out by hand:
+//   0: A, B runs 0..9 (deadline 8, miss)
+//   9: A of 4 (deadline 8, miss), A of 8, B of 8 runs 9..18 (16, miss)
+//  18: A of 12 (deadline 16, miss), A of 16, B of 16 runs 18..27 (24, miss)
+static void testOverload(void) {
+  static tSimTask a = {'A', 0};
+  static tSimTask b = {'B', 9};
+  static const uint32_t ticks[] = {0, 0, 9, 9, 9, 18, 18, 18};
+  tScheduler scheduler;
+
+  SCHED_init(&scheduler);
+  logStart();
+  SCHED_addTask(&scheduler, "A", simTask, &a, 4, 0);
+  SCHED_addTask(&scheduler, "B", simTask, &b, 8, 0);
+  runUntil(&scheduler, 20);
+  TEST_CHECK(strcmp(g_pcLog, "ABAABAAB") == 0);
+  TEST_CHECK(memcmp(g_pui32LogTick, ticks, sizeof(ticks)) == 0);
+  TEST_CHECK(scheduler.task[0].runs == 5);
+  TEST_CHECK(scheduler.task[0].deadline_misses == 2);
+  TEST_CHECK(scheduler.task[1].runs == 3);
+  TEST_CHECK(scheduler.task[1].deadline_misses == 3);
+}
+
+//=============================================================================
+// A long run of D holds C off for several of its releases. The first late
+// one runs, the ones that passed in the meantime are skipped and counted as
+// misses, and C is back on its own ticks after that:
+//   0: C, D runs 0..5
+//   5: C of 1 (deadline 2, miss), releases 2, 3 and 4 skipped, C of 5
+//   6, 7, 8, 9: C
+static void testSkippedReleases(void) {
+  static tSimTask c = {'C', 0};
+  static tSimTask d = {'D', 5};
+  static const uint32_t ticks[] = {0, 0, 5, 5, 6, 7, 8, 9};
+  tScheduler scheduler;
+
+  SCHED_init(&scheduler);
+  logStart();
+  SCHED_addTask(&scheduler, "C", simTask, &c, 1, 0);
+  SCHED_addTask(&scheduler, "D", simTask, &d, 20, 0);
+  runUntil(&scheduler, 10);
+  TEST_CHECK(strcmp(g_pcLog, "CDCCCCCC") == 0);
+  TEST_CHECK(memcmp(g_pui32LogTick, ticks, sizeof(ticks)) == 0);
+  TEST_CHECK(scheduler.task[0].runs == 7);
+  TEST_CHECK(scheduler.task[0].deadline_misses == 4);
+  // Every release either ran or was skipped
+  TEST_CHECK(scheduler.task[0].runs + 3 == 10);
+  TEST_CHECK(scheduler.task[1].runs == 1);
+  TEST_CHECK(scheduler.task[1].deadline_misses == 0);
+}
+
+//=============================================================================
+// Equal deadlines go to the task added first, and offsets spread tasks of
+// the same period
+static void testTiesAndOffsets(void) {
+  static tSimTask x = {'X', 0};
+  static tSimTask y = {'Y', 0};
+  static tSimTask z = {'Z', 0};
+  static const uint32_t ticks[] = {0, 0, 2, 4, 4, 6};
+  tScheduler scheduler;
+
+  SCHED_init(&scheduler);
+  logStart();
+  SCHED_addTask(&scheduler, "Y", simTask, &y, 4, 0);
+  SCHED_addTask(&scheduler, "X", simTask, &x, 4, 0);
+  SCHED_addTask(&scheduler, "Z", simTask, &z, 4, 2);
+  runUntil(&scheduler, 8);
+  TEST_CHECK(strcmp(g_pcLog, "YXZYXZ") == 0);
+  TEST_CHECK(memcmp(g_pui32LogTick, ticks, sizeof(ticks)) == 0);
+}
+
+//=============================================================================
+// The tick counter wraps in the middle of the run
+static void testWrap(void) {
+  static tSimTask p = {'p', 0};
+  static tSimTask q = {'q', 0};
+  tScheduler scheduler;
+
+  SCHED_hostAdvance(0xfffffff0u - SCHED_now());
+  SCHED_init(&scheduler);
+  logStart();
+  SCHED_addTask(&scheduler, "p", simTask, &p, 4, 0);
+  SCHED_addTask(&scheduler, "q", simTask, &q, 7, 0);
+  runUntil(&scheduler, 64);
+  TEST_CHECK(SCHED_now() < 0x100);
+  TEST_CHECK(scheduler.task[0].runs == 16);
+  TEST_CHECK(scheduler.task[1].runs == 10);
+  TEST_CHECK(scheduler.task[0].deadline_misses == 0);
+  TEST_CHECK(scheduler.task[1].deadline_misses == 0);
+}
+
+//=============================================================================
+static void testTaskLimit(void) {
+  static tSimTask t = {'t', 0};
+  tScheduler scheduler;
+  uint32_t i;
+
+  SCHED_init(&scheduler);
+  for (i = 0; i < SCHED_MAX_TASKS; i++) {
+    TEST_CHECK(SCHED_addTask(&scheduler, "t", simTask, &t, 1, 0) == i);
+  }
+  TEST_CHECK(SCHED_addTask(&scheduler, "t", simTask, &t, 1, 0) ==
+             SCHED_MAX_TASKS);
+  TEST_CHECK(scheduler.task_count == SCHED_MAX_TASKS);
+  TEST_CHECK(scheduler.idle_calls == 0);
+}
+
+//=============================================================================
+int main(void) {
+  testLightLoad();
+  testOverload();
+  testSkippedReleases();
+  testTiesAndOffsets();
+  testWrap();
+  testTaskLimit();
+  return TEST_finish("test_scheduler");
+}
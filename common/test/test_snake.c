@@ -0,0 +1,203 @@
+/*
+ * ================================================================
+ * File: test_snake.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the 4.1 snake, compiled from its main.c with
+ * the stand-ins of board/. The snake is run around a cycle through every
+ * cell of the grid, where it never hits itself, to show that a step costs
+ * the same whatever its length. The food search is checked on a nearly
+ * full board, and the lowest bit helper against a plain loop.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#define main snakeMain
+#include "../../Assignment_4.1_snake/src/main.c"
+#undef main
+#include "test.h"
+
+// A cycle through every cell: right along row 0, then back and forth along
+// the rows leaving out column 0, and up column 0 back to the start
+static uint16_t g_pui16Cycle[GRID_CELLS];
+
+static void makeCycle(void) {
+  uint32_t n = 0;
+  uint32_t row;
+  uint32_t i;
+
+  for (row = 0; row < GRID_ROWS; row++) {
+    for (i = 0; i < GRID_COLUMNS - 1; i++) {
+      g_pui16Cycle[n++] = row * GRID_COLUMNS +
+                          (row & 1 ? GRID_COLUMNS - 1 - i : i + 1);
+    }
+  }
+  for (row = GRID_ROWS; row > 0; row--) {
+    g_pui16Cycle[n++] = (row - 1) * GRID_COLUMNS;
+  }
+}
+
+static tDirection directionTo(uint32_t from, uint32_t to) {
+  int32_t dx = (int32_t)(to % GRID_COLUMNS) - (int32_t)(from % GRID_COLUMNS);
+  int32_t dy = (int32_t)(to / GRID_COLUMNS) - (int32_t)(from / GRID_COLUMNS);
+
+  return dx == 1 ? RIGHT : dx == -1 ? LEFT : dy == 1 ? DOWN : UP;
+}
+
+// A snake of the given length on the cycle with its head at position head.
+// The food is put where the snake never gets, so it keeps its length.
+static void cycleSnake(tState *state, uint32_t length, uint32_t head) {
+  uint32_t i;
+
+  memset(state, 0, sizeof(*state));
+  for (i = 0; i < length; i++) {
+    state->body[i] = g_pui16Cycle[(head + GRID_CELLS - length + 1 + i) %
+                                  GRID_CELLS];
+    occupy(state, state->body[i], true);
+  }
+  state->head = length - 1;
+  state->length = length;
+  state->food = GRID_CELLS;
+  state->random = 1;
+}
+
+//=============================================================================
+static void testLowestBit(void) {
+  uint32_t x;
+  uint32_t n;
+  uint32_t i;
+  bool same = true;
+
+  srand(15);
+  for (i = 0; i < 100000; i++) {
+    x = i < 32 ? 1u << i : (uint32_t)rand() << 16 ^ (uint32_t)rand();
+    if (x == 0) {
+      continue;
+    }
+    for (n = 0; !(x & (1u << n)); n++) {
+    }
+    same = same && lowestBit(x) == n;
+  }
+  TEST_CHECK(same);
+}
+
+//=============================================================================
+// With one free cell left the food goes there, with none the board is full
+static void testFoodOnFullBoard(void) {
+  static tState state;
+  uint32_t free_cell;
+  uint32_t cell;
+
+  for (free_cell = 0; free_cell < GRID_CELLS; free_cell += 37) {
+    memset(&state, 0, sizeof(state));
+    state.random = free_cell + 1;
+    for (cell = 0; cell < GRID_CELLS; cell++) {
+      occupy(&state, cell, cell != free_cell);
+    }
+    TEST_CHECK(placeFood(&state));
+    TEST_CHECK(state.food == free_cell);
+    occupy(&state, free_cell, true);
+    TEST_CHECK(!placeFood(&state));
+  }
+}
+
+//=============================================================================
+// The snake goes round the cycle twice at every length without a reset, and
+// the time per step is the same for a short and a nearly full snake
+static void testFlatStep(void) {
+  static const uint32_t lengths[] = {4, 64, 256, GRID_CELLS - 4};
+  static tState state;
+  double best[sizeof(lengths) / sizeof(lengths[0])];
+  double start;
+  double seconds;
+  bool followed;
+  uint32_t steps = 2 * GRID_CELLS;
+  uint32_t head;
+  uint32_t run;
+  uint32_t l;
+  uint32_t i;
+
+  makeCycle();
+  for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    best[l] = 1e9;
+    for (run = 0; run < 20; run++) {
+      head = lengths[l] - 1;
+      cycleSnake(&state, lengths[l], head);
+      followed = true;
+      start = TEST_seconds();
+      for (i = 0; i < steps; i++) {
+        state.direction = directionTo(g_pui16Cycle[head % GRID_CELLS],
+                                      g_pui16Cycle[(head + 1) % GRID_CELLS]);
+        state.pending_count = 0;
+        step(&state);
+        head++;
+        followed = followed && state.body[state.head] ==
+                                   g_pui16Cycle[head % GRID_CELLS];
+      }
+      seconds = (TEST_seconds() - start) / steps;
+      best[l] = seconds < best[l] ? seconds : best[l];
+      TEST_CHECK(followed);
+      TEST_CHECK(state.length == lengths[l]);
+      TEST_CHECK(state.score == 0 && !state.redraw);
+    }
+    printf("  length %4u: %6.1f host ns per step\n", lengths[l],
+           best[l] * 1e9);
+  }
+  // The step does not walk the body, a long snake costs no more than a
+  // short one beyond timing noise
+  TEST_CHECK(best[3] < 3 * best[0] + 20e-9);
+}
+
+//=============================================================================
+// The food search on a board with a single free cell, after the random
+// tries have missed, against an empty board
+static void benchmarkFood(void) {
+  static tState state;
+  uint32_t rounds = 200000;
+  double start;
+  double empty;
+  double full;
+  uint32_t cell;
+  uint32_t i;
+
+  memset(&state, 0, sizeof(state));
+  state.random = 1;
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    state.pending_count = 0;
+    placeFood(&state);
+  }
+  empty = (TEST_seconds() - start) / rounds;
+  for (cell = 0; cell < GRID_CELLS; cell++) {
+    occupy(&state, cell, cell != GRID_CELLS - 1);
+  }
+  start = TEST_seconds();
+  for (i = 0; i < rounds; i++) {
+    state.pending_count = 0;
+    placeFood(&state);
+  }
+  full = (TEST_seconds() - start) / rounds;
+  g_ui32TestSink = state.food;
+  printf("  food placed in %.1f host ns on an empty board, %.1f ns with one "
+         "free cell\n",
+         empty * 1e9, full * 1e9);
+}
+
+//=============================================================================
+int main(void) {
+  printf("snake:\n");
+  testLowestBit();
+  testFoodOnFullBoard();
+  testFlatStep();
+  benchmarkFood();
+  return TEST_finish("test_snake");
+}
@@ -0,0 +1,207 @@
+/*
+ * ================================================================
+ * File: test_sound_meter.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the sound meter with synthetic 12-bit input at
+ * METER_SAMPLE_RATE around the microphone bias:
+ *  - sines, flat and A-weighted, against their known RMS and peak and the
+ *    A-weighting curve of IEC 61672 at the third octave frequencies
+ *  - white noise, against its RMS and the power of the A-weighting curve
+ *    over 0 Hz to the Nyquist frequency
+ * and a benchmark of the time spent per sample.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+//=============================================================================
+#include "sound_meter.h"
+#include "test.h"
+
+#define BIAS 2048.0
+#define BLOCK 64
+// Two seconds for the DC tracker and the filter to settle, then one second
+// that is measured. The windows are one second long, so the third one is
+// the one measured.
+#define SETTLE (2 * METER_SAMPLE_RATE)
+#define WINDOW METER_SAMPLE_RATE
+#define DB(level) ((level) / 256.0)
+
+typedef double (*tSignal)(uint32_t n, void *argument);
+
+//=============================================================================
+// The A-weighting of IEC 61672 in dB
+static double aWeighting(double f) {
+  double f2 = f * f;
+  double ra = 12194.0 * 12194.0 * f2 * f2 /
+              ((f2 + 20.6 * 20.6) *
+               sqrt((f2 + 107.7 * 107.7) * (f2 + 737.9 * 737.9)) *
+               (f2 + 12194.0 * 12194.0));
+
+  return 20.0 * log10(ra) + 2.0;
+}
+
+static double sine(uint32_t n, void *argument) {
+  const double *p = argument;
+
+  return p[1] * sin(2 * M_PI * p[0] * n / METER_SAMPLE_RATE);
+}
+
+// Gaussian noise with the deviation given
+static double noise(uint32_t n, void *argument) {
+  double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+  (void)n;
+  return *(const double *)argument * sqrt(-2.0 * log(u1)) *
+         cos(2 * M_PI * u2);
+}
+
+//=============================================================================
+// Run SETTLE + WINDOW samples of the signal, quantized to 12 bits around
+// the bias, through a meter
+static void measure(tSoundMeter *meter, bool a_weighting, tSignal signal,
+                    void *argument) {
+  uint32_t samples[BLOCK];
+  double value;
+  uint32_t n = 0;
+  uint32_t i;
+
+  METER_init(meter, a_weighting, WINDOW, WINDOW, 0);
+  while (n < SETTLE + WINDOW) {
+    for (i = 0; i < BLOCK; i++, n++) {
+      value = floor(BIAS + signal(n, argument) + 0.5);
+      samples[i] = value < 0 ? 0 : value > 4095 ? 4095 : (uint32_t)value;
+    }
+    METER_pushBlock(meter, samples, BLOCK);
+  }
+}
+
+//=============================================================================
+// A flat sine has an RMS of amplitude / sqrt(2) and a peak of amplitude,
+// the rounding to counts adds about 0.3 count of noise
+static void testFlatSine(void) {
+  double p[2] = {1000.0, 1000.0};
+  tSoundMeter meter;
+  double rms;
+  double peak;
+
+  measure(&meter, false, sine, p);
+  rms = meter.rms / 256.0;
+  peak = meter.peak / 256.0;
+  printf("  flat 1 kHz sine of 1000: rms %.2f (%.2f dB), peak %.2f\n", rms,
+         DB(meter.rms_db), peak);
+  TEST_CHECK(meter.rms_windows == 3 && meter.peak_windows == 3);
+  TEST_CHECK(fabs(rms - 1000.0 / sqrt(2)) < 0.5);
+  TEST_CHECK(fabs(peak - 1000.0) < 1.0);
+  TEST_CHECK(fabs(DB(meter.rms_db) - 20 * log10(1000.0 / sqrt(2))) < 0.02);
+  TEST_CHECK(fabs(DB(meter.peak_db) - 60.0) < 0.02);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A constant input is removed by the DC tracker
+  p[1] = 0;
+  measure(&meter, false, sine, p);
+  TEST_CHECK(meter.rms < 256 && meter.peak < 256);
+}
+
+//=============================================================================
+// The A-weighted level of a sine minus its flat level is the gain of the
+// weighting at that frequency, within 0.12 dB of the standard curve (see
+// sound_meter.h). Without the section for the poles at 12194 Hz it would be
+// 0.46 dB high at 3150 Hz.
+static void testAWeightingCurve(void) {
+  static const double frequency[] = {31.5, 63,   125,  250,  500,
+                                     1000, 2000, 2500, 3150, 3500};
+  double p[2];
+  tSoundMeter flat;
+  tSoundMeter weighted;
+  double gain;
+  double error;
+  double worst = 0;
+  uint32_t i;
+
+  printf("  A-weighting, meter against IEC 61672:\n");
+  for (i = 0; i < sizeof(frequency) / sizeof(frequency[0]); i++) {
+    p[0] = frequency[i];
+    p[1] = 1500.0;
+    measure(&flat, false, sine, p);
+    measure(&weighted, true, sine, p);
+    gain = DB(weighted.rms_db - flat.rms_db);
+    error = gain - aWeighting(frequency[i]);
+    printf("    %6.1f Hz: %7.2f dB, standard %7.2f dB\n", frequency[i], gain,
+           aWeighting(frequency[i]));
+    worst = fmax(worst, fabs(error));
+  }
+  TEST_CHECK(worst < 0.12);
+}
+
+//=============================================================================
+// White noise: the flat RMS is the deviation, and the A-weighted RMS is that
+// times the RMS of the A-weighting gain over 0 Hz to the Nyquist frequency.
+static void testNoise(void) {
+  double deviation = 200.0;
+  tSoundMeter flat;
+  tSoundMeter weighted;
+  double power = 0;
+  double expected;
+  double gain;
+  double f;
+  uint32_t i;
+
+  for (i = 1; i <= 4000; i++) {
+    f = (i - 0.5) * (METER_SAMPLE_RATE / 2) / 4000.0;
+    power += pow(10.0, aWeighting(f) / 10.0) / 4000.0;
+  }
+  expected = 10.0 * log10(power);
+  srand(5);
+  measure(&flat, false, noise, &deviation);
+  srand(5);
+  measure(&weighted, true, noise, &deviation);
+  gain = DB(weighted.rms_db - flat.rms_db);
+  printf("  white noise of %.0f: flat rms %.2f (%.2f dB), A-weighted %+.2f dB "
+         "(%+.2f dB expected)\n",
+         deviation, flat.rms / 256.0, DB(flat.rms_db), gain, expected);
+  TEST_CHECK(fabs(flat.rms / 256.0 - deviation) < deviation * 0.02);
+  TEST_CHECK(fabs(gain - expected) < 0.15);
+}
+
+//=============================================================================
+static void benchmark(bool a_weighting) {
+  double p[2] = {440.0, 800.0};
+  uint32_t samples[BLOCK];
+  tSoundMeter meter;
+  double start;
+  uint32_t blocks = 200000;
+  uint32_t i;
+
+  for (i = 0; i < BLOCK; i++) {
+    samples[i] = (uint32_t)(BIAS + sine(i, p));
+  }
+  METER_init(&meter, a_weighting, 1000, 8000, 0);
+  start = TEST_seconds();
+  for (i = 0; i < blocks; i++) {
+    METER_pushBlock(&meter, samples, BLOCK);
+  }
+  printf("  %s: %.2f host ns per sample\n",
+         a_weighting ? "A-weighted" : "flat      ",
+         (TEST_seconds() - start) / ((double)blocks * BLOCK) * 1e9);
+  g_ui32TestSink = meter.rms;
+}
+
+//=============================================================================
+int main(void) {
+  printf("sound meter on synthetic input:\n");
+  testFlatSine();
+  testAWeightingCurve();
+  testNoise();
+  benchmark(false);
+  benchmark(true);
+  return TEST_finish("test_sound_meter");
+}
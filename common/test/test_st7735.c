@@ -0,0 +1,253 @@
+/*
+ * ================================================================
+ * File: test_st7735.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the ST7735S orientations and scrolling on the
+ * emulated controller, and of the 4.1 flappy bird that scrolls with them,
+ * compiled from its main.c with the stand-ins of board/:
+ *  - a picture sent turned is the upright picture turned a quarter turn,
+ *    every pixel on the panel, so the offsets of the two orientations put
+ *    it on the same 128 x 128 pixels of the controller memory
+ *  - a picture scrolled by any offset shows every pixel moved by it, in
+ *    both orientations
+ *  - through a long game the LCD equals a picture drawn here from the game
+ *    state after every frame, and the bytes of each frame stay within what
+ *    the new columns and the bird's rectangle need
+ * The emulation follows the datasheet, these tests do not replace a look at
+ * the real panel.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#define main flappyMain
+#include "../../Assignment_4.1_flappy_bird/src/main.c"
+#undef main
+#include "test.h"
+
+#define TICKS_PER_SECOND 1200000
+#define STEP (TICKS_PER_SECOND / UPDATE_RATE)
+#define FRAMES 60000
+// Window commands are 15 bytes, each rectangle is sent in at most two
+// parts, and the scroll is 3 bytes
+#define COMMAND_BYTES (2 * 2 * 15 + 3)
+
+// A different color for every pixel of the panel
+static uint16_t pattern(uint32_t x, uint32_t y) {
+  return (uint16_t)(y * ST7735_WIDTH + x + 1);
+}
+
+static void sendPattern(void) {
+  uint16_t line[ST7735_WIDTH];
+  uint32_t x;
+  uint32_t y;
+
+  ST7735_setWindow(0, 0, ST7735_WIDTH - 1, ST7735_HEIGHT - 1);
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      line[x] = pattern(x, y);
+    }
+    ST7735_writePixels(line, ST7735_WIDTH);
+  }
+}
+
+//=============================================================================
+// Turned, x runs down the upright picture and y from its right edge to the
+// left: the picture is turned a quarter turn clockwise. A wrong offset
+// would move it by a pixel and leave a row or column of the pattern out.
+static void testOrientation(void) {
+  bool turned = true;
+  bool upright = true;
+  uint32_t x;
+  uint32_t y;
+
+  ST7735_init(120000000);
+  sendPattern();
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      upright = upright && ST7735_hostPixel(x, y) == pattern(x, y);
+    }
+  }
+  TEST_CHECK(upright);
+  ST7735_setOrientation(ST7735_LEFT);
+  sendPattern();
+  ST7735_setOrientation(ST7735_UP);
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      turned = turned &&
+               ST7735_hostPixel(ST7735_WIDTH - 1 - y, x) == pattern(x, y);
+    }
+  }
+  TEST_CHECK(turned);
+}
+
+// What was sent to position p along the scan lines shows at p - offset
+static void testScroll(tST7735Orientation orientation) {
+  static const uint32_t offsets[] = {0, 1, 37, 127, 128, 129, 1000};
+  bool moved = true;
+  uint32_t p;
+  uint32_t i;
+  uint32_t x;
+  uint32_t y;
+
+  ST7735_init(120000000);
+  ST7735_setOrientation(orientation);
+  sendPattern();
+  for (i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+    ST7735_scroll(offsets[i]);
+    for (y = 0; y < ST7735_HEIGHT; y++) {
+      for (x = 0; x < ST7735_WIDTH; x++) {
+        p = ((orientation == ST7735_LEFT ? x : y) + offsets[i]) %
+            ST7735_HEIGHT;
+        moved = moved &&
+                ST7735_hostPixel(x, y) == (orientation == ST7735_LEFT
+                                               ? pattern(p, y)
+                                               : pattern(x, p));
+      }
+    }
+  }
+  TEST_CHECK(moved);
+}
+
+//=============================================================================
+// The game as it should look: the world from the camera on, the bird on
+// top
+static bool lcdShowsGame(const tState *state) {
+  int32_t camera = PHYS_TO_INT(state->camera);
+  int32_t bird_y = PHYS_TO_INT(state->bird.box.y);
+  uint16_t color;
+  int32_t x;
+  int32_t y;
+
+  for (y = 0; y < GAME_HEIGHT; y++) {
+    for (x = 0; x < GAME_WIDTH; x++) {
+      color = x >= BIRD_X && x < BIRD_X + BIRD_SIZE && y >= bird_y &&
+                      y < bird_y + BIRD_SIZE
+                  ? COLOR_BIRD
+                  : background(state, camera + x, y);
+      if (ST7735_hostPixel(x, y) != color) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Flap when the bird is low for the gap of the next pipe, or low on the
+// screen when there is none. Now and then it stops for a second, and dies.
+static bool autopilot(const tState *state) {
+  static uint32_t lapse;
+  const tPhysBox *box;
+  tQ16 target = PHYS_FROM_INT(GROUND_Y / 2);
+  tQ16 nearest = PHYS_FROM_INT(2 * GAME_WIDTH);
+  uint32_t i;
+
+  if (lapse > 0 || rand() % 3000 == 0) {
+    lapse = lapse > 0 ? lapse - 1 : UPDATE_RATE;
+    return false;
+  }
+  for (i = 0; i < PHYS_POOL_SIZE; i++) {
+    box = &state->pipes.box[i];
+    if ((state->pipes.active & (1u << i)) && box->y != 0 &&
+        box->x + box->width > state->bird.box.x && box->x < nearest) {
+      nearest = box->x;
+      target = box->y - PHYS_FROM_INT(10);
+    }
+  }
+  return state->bird.box.y + state->bird.box.height > target &&
+         state->bird.vy >= 0;
+}
+
+static void testGame(void) {
+  static tGame game;
+  uint64_t flying_bytes = 0;
+  uint32_t flying_frames = 0;
+  uint32_t largest = 0;
+  uint32_t redraws = 0;
+  uint32_t wraps = 0;
+  bool bytes_ok = true;
+  bool lcd_ok = true;
+  uint32_t now = 0;
+  tPhase phase;
+  int32_t camera;
+  int32_t bird_y;
+  int32_t columns;
+  int32_t rows;
+  uint32_t bytes;
+  uint32_t frame;
+
+  srand(17);
+  ST7735_init(120000000);
+  ST7735_setOrientation(ST7735_LEFT);
+  memset(&g_sState, 0, sizeof(g_sState));
+  g_sState.random = 1;
+  resetGame(&g_sState);
+  GAME_init(&game, TICKS_PER_SECOND, UPDATE_RATE, update, render, &g_sState);
+  GAME_frame(&game, now);
+  TEST_CHECK(lcdShowsGame(&g_sState));
+  for (frame = 0; frame < FRAMES; frame++) {
+    GAME_hostInput(&game, 0, 0,
+                   g_sState.phase != FLYING || autopilot(&g_sState)
+                       ? GAME_BUTTON_S1
+                       : 0);
+    GAME_hostInput(&game, 0, 0, 0);
+    phase = g_sState.phase;
+    camera = PHYS_TO_INT(g_sState.camera);
+    bird_y = PHYS_TO_INT(g_sState.bird.box.y);
+    bytes = ST7735_bytesSent();
+    // Mostly one update per frame, now and then two
+    now += frame % 7 == 0 ? 2 * STEP : STEP;
+    GAME_frame(&game, now);
+    bytes = ST7735_bytesSent() - bytes;
+    lcd_ok = lcd_ok && lcdShowsGame(&g_sState);
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // A new game after a crash draws everything again
+    if (phase == DEAD && g_sState.phase != DEAD) {
+      redraws++;
+      continue;
+    }
+    wraps += PHYS_TO_INT(g_sState.camera) < camera;
+    columns = (PHYS_TO_INT(g_sState.camera) - camera + CAMERA_WRAP) %
+              CAMERA_WRAP;
+    rows = abs(PHYS_TO_INT(g_sState.bird.box.y) - bird_y);
+    bytes_ok = bytes_ok &&
+               bytes <= 2 * (columns * GAME_HEIGHT +
+                             (columns + BIRD_SIZE) * (rows + BIRD_SIZE)) +
+                            COMMAND_BYTES;
+    if (g_sState.phase == FLYING) {
+      flying_bytes += bytes;
+      flying_frames++;
+      largest = bytes > largest ? bytes : largest;
+    }
+  }
+  printf("  %u frames, %u full redraws, %u camera wraps, best score %u, "
+         "score %u\n",
+         FRAMES, redraws, wraps, g_sState.best, g_sState.score);
+  printf("  flying: %.1f bytes per frame on average, %u at most, a full "
+         "frame is %u\n",
+         (double)flying_bytes / flying_frames, largest,
+         2 * GAME_WIDTH * GAME_HEIGHT);
+  TEST_CHECK(lcd_ok);
+  TEST_CHECK(bytes_ok);
+  TEST_CHECK(wraps > 0 && redraws > 0 && g_sState.best > 0);
+  TEST_CHECK(flying_frames > FRAMES / 2);
+}
+
+//=============================================================================
+int main(void) {
+  printf("ST7735S orientation and scrolling:\n");
+  testOrientation();
+  testScroll(ST7735_UP);
+  testScroll(ST7735_LEFT);
+  testGame();
+  return TEST_finish("test_st7735");
+}
@@ -0,0 +1,292 @@
+/*
+ * ================================================================
+ * File: test_telemetry.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host loopback test of the telemetry stream. Records go in
+ * with TELEM_add(), come out of the console TX ring through the UART
+ * stand-in, are split on 0x00 and decoded with TELEM_decodeFrame(), with
+ * and without corrupted and dropped bytes on the way.
+ *
+ * A simulated UART that drains the ring at the rate of the wire then gives
+ * the sustained sensor frames (records) per second at 115200 baud and
+ * higher rates.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "telemetry.h"
+#include "test.h"
+#include "uart_console.h"
+
+//=============================================================================
+// Receiving side: bytes are collected until a 0x00 ends the frame, which is
+// then decoded. Every record is checked against the values it was sent with.
+typedef struct {
+  uint8_t frame[TELEM_FRAME_MAX + 1];
+  uint32_t length;
+  bool overlong;
+  uint32_t frames;
+  uint32_t bad_frames;
+  uint32_t records;
+  uint32_t wrong_records;
+  uint32_t next_sequence;
+  uint32_t lost_records;
+} tReceiver;
+
+// The values of record n, so the receiver knows what was sent
+static void recordValues(uint32_t n, uint16_t *values) {
+  uint32_t i;
+
+  for (i = 0; i < TELEM_CHANNELS; i++) {
+    values[i] = (n * 7 + i * 1000) & 0xfff;
+  }
+  // Zero values make the COBS encoding do some work
+  if (n % 5 == 0) {
+    values[n % TELEM_CHANNELS] = 0;
+  }
+}
+
+static uint32_t recordTime(uint32_t n) { return n * 125 + 0x01000000; }
+
+static void receiverInit(tReceiver *receiver) {
+  memset(receiver, 0, sizeof(*receiver));
+}
+
+// The sequence is 16 bits, the receiver follows the full count
+static void receiverFrame(tReceiver *receiver) {
+  tTelemRecord records[TELEM_BATCH];
+  uint16_t values[TELEM_CHANNELS];
+  uint32_t n;
+  int32_t count;
+  int32_t r;
+
+  receiver->frames++;
+  count = TELEM_decodeFrame(receiver->frame, receiver->length, records,
+                            TELEM_BATCH);
+  if (receiver->overlong || count < 0) {
+    receiver->bad_frames++;
+    return;
+  }
+  for (r = 0; r < count; r++) {
+    n = receiver->next_sequence +
+        (uint16_t)(records[r].sequence - receiver->next_sequence);
+    receiver->lost_records += n - receiver->next_sequence;
+    receiver->next_sequence = n + 1;
+    recordValues(n, values);
+    if (records[r].timestamp != recordTime(n) ||
+        memcmp(records[r].value, values, sizeof(values)) != 0) {
+      receiver->wrong_records++;
+    }
+    receiver->records++;
+  }
+}
+
+static void receiverByte(tReceiver *receiver, uint8_t byte) {
+  if (byte == 0) {
+    receiverFrame(receiver);
+    receiver->length = 0;
+    receiver->overlong = false;
+    return;
+  }
+  if (receiver->length < sizeof(receiver->frame)) {
+    receiver->frame[receiver->length++] = byte;
+  } else {
+    receiver->overlong = true;
+  }
+}
+
+//=============================================================================
+// Everything sent arrives as it was
+static void testLoopback(void) {
+  tTelemetry telemetry;
+  tReceiver receiver;
+  uint16_t values[TELEM_CHANNELS];
+  uint8_t wire[CONSOLE_TX_SIZE];
+  uint32_t length;
+  uint32_t n;
+  uint32_t i;
+
+  TELEM_init(&telemetry);
+  receiverInit(&receiver);
+  // More than 2^16 records so the sequence wraps
+  for (n = 0; n < 70003; n++) {
+    recordValues(n, values);
+    TELEM_add(&telemetry, recordTime(n), values);
+    length = CONSOLE_hostTransmit((char *)wire, sizeof(wire));
+    for (i = 0; i < length; i++) {
+      receiverByte(&receiver, wire[i]);
+    }
+  }
+  TEST_CHECK(TELEM_flush(&telemetry));
+  length = CONSOLE_hostTransmit((char *)wire, sizeof(wire));
+  for (i = 0; i < length; i++) {
+    receiverByte(&receiver, wire[i]);
+  }
+  TEST_CHECK(telemetry.records_dropped == 0);
+  TEST_CHECK(telemetry.records_sent == 70003);
+  TEST_CHECK(receiver.records == 70003);
+  TEST_CHECK(receiver.bad_frames == 0);
+  TEST_CHECK(receiver.wrong_records == 0);
+  TEST_CHECK(receiver.lost_records == 0);
+  TEST_CHECK(receiver.frames == telemetry.frames_sent);
+  // A flush with nothing collected sends nothing
+  TEST_CHECK(!TELEM_flush(&telemetry));
+}
+
+//=============================================================================
+// Bit errors and lost bytes on the wire. The frame they hit is rejected, or
+// in the worst case loses records, but no record is ever accepted with
+// wrong values and the frames after it are received again.
+static void testDamage(bool drop) {
+  tTelemetry telemetry;
+  tReceiver receiver;
+  uint16_t values[TELEM_CHANNELS];
+  uint8_t wire[CONSOLE_TX_SIZE];
+  uint32_t length;
+  uint32_t damaged = 0;
+  uint32_t n;
+  uint32_t i;
+
+  srand(drop ? 3 : 4);
+  TELEM_init(&telemetry);
+  receiverInit(&receiver);
+  for (n = 0; n < 80000; n++) {
+    recordValues(n, values);
+    if (!TELEM_add(&telemetry, recordTime(n), values)) {
+      continue;
+    }
+    length = CONSOLE_hostTransmit((char *)wire, sizeof(wire));
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Every fourth frame is hit somewhere, the delimiter included, except
+    // the last so that the receiver sees how many records came before it
+    if (rand() % 4 == 0 && n != 80000 - 1) {
+      i = rand() % length;
+      if (drop) {
+        memmove(wire + i, wire + i + 1, length - i - 1);
+        length--;
+      } else {
+        wire[i] ^= 1 << (rand() % 8);
+      }
+      damaged++;
+    }
+    for (i = 0; i < length; i++) {
+      receiverByte(&receiver, wire[i]);
+    }
+  }
+  printf("  %s: %u of %u frames damaged, %u rejected, %u records lost, "
+         "%u wrong\n",
+         drop ? "dropped bytes" : "bit errors  ", damaged,
+         telemetry.frames_sent, receiver.bad_frames, receiver.lost_records,
+         receiver.wrong_records);
+  TEST_CHECK(receiver.wrong_records == 0);
+  TEST_CHECK(receiver.bad_frames >= damaged * 9 / 10);
+  TEST_CHECK(receiver.records + receiver.lost_records == 80000);
+  TEST_CHECK(receiver.lost_records <= (damaged + 1) * 2 * TELEM_BATCH);
+}
+
+//=============================================================================
+// Malformed input to the decoders
+static void testMalformed(void) {
+  static const uint8_t zero_inside[] = {3, 1, 0, 2};
+  static const uint8_t short_block[] = {5, 1, 2};
+  uint8_t payload[600];
+  uint8_t encoded[600 + 600 / 254 + 1];
+  uint8_t decoded[600];
+  tTelemRecord records[TELEM_BATCH];
+  uint32_t length;
+  uint32_t i;
+
+  TEST_CHECK(TELEM_cobsDecode(zero_inside, sizeof(zero_inside), decoded) ==
+             -1);
+  TEST_CHECK(TELEM_cobsDecode(short_block, sizeof(short_block), decoded) ==
+             -1);
+  TEST_CHECK(TELEM_decodeFrame(encoded, 0, records, TELEM_BATCH) == -1);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Runs of more than 254 non-zero bytes, which need codes of their own,
+  // round trip
+  for (i = 0; i < sizeof(payload); i++) {
+    payload[i] = i < 400 ? i % 255 + 1 : i % 3;
+  }
+  length = TELEM_cobsEncode(payload, sizeof(payload), encoded);
+  TEST_CHECK(length <= sizeof(encoded));
+  TEST_CHECK(memchr(encoded, 0, length) == 0);
+  TEST_CHECK(TELEM_cobsDecode(encoded, length, decoded) ==
+             (int32_t)sizeof(payload));
+  TEST_CHECK(memcmp(decoded, payload, sizeof(payload)) == 0);
+}
+
+//=============================================================================
+// The UART sends baud / 10 bytes a second (8N1). Records are offered at
+// offered per second, as long as the TX ring takes them, for one second of
+// simulated time in 100 us steps.
+static void sustained(uint32_t baud, uint32_t offered) {
+  tTelemetry telemetry;
+  tReceiver receiver;
+  uint16_t values[TELEM_CHANNELS];
+  uint8_t wire[CONSOLE_TX_SIZE];
+  uint64_t bits = 0;
+  uint32_t offered_so_far = 0;
+  uint32_t length;
+  uint32_t step;
+  uint32_t n = 0;
+  uint32_t i;
+
+  TELEM_init(&telemetry);
+  receiverInit(&receiver);
+  // Start with an empty ring
+  while (CONSOLE_hostTransmit((char *)wire, sizeof(wire)) != 0) {
+  }
+  for (step = 1; step <= 10000; step++) {
+    for (; offered_so_far < (uint64_t)offered * step / 10000;
+         offered_so_far++) {
+      recordValues(n, values);
+      TELEM_add(&telemetry, recordTime(n), values);
+      n++;
+    }
+    bits += baud / 10000;
+    length = CONSOLE_hostTransmit((char *)wire, bits / 10);
+    bits -= length * 10;
+    for (i = 0; i < length; i++) {
+      receiverByte(&receiver, wire[i]);
+    }
+  }
+  TEST_CHECK(receiver.wrong_records == 0);
+  TEST_CHECK(receiver.bad_frames == 0);
+  printf("  %7u baud: %6u records/s (%4u frames/s) received of %6u offered, "
+         "%6u dropped\n",
+         baud, receiver.records, receiver.frames, offered,
+         telemetry.records_dropped);
+}
+
+//=============================================================================
+int main(void) {
+  CONSOLE_init(0);
+  printf("telemetry loopback:\n");
+  testLoopback();
+  testDamage(false);
+  testDamage(true);
+  testMalformed();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Offered far above what any of the rates can carry, so what arrives is
+  // the sustained rate of the link
+  printf("sustained rate, %u byte frames of %u records:\n",
+         TELEM_FRAME_MAX, TELEM_BATCH);
+  sustained(115200, 50000);
+  sustained(230400, 50000);
+  sustained(460800, 50000);
+  sustained(921600, 50000);
+  // The 4.2 scan delivers 1000 averaged frames a second
+  sustained(115200, 1000);
+  sustained(230400, 1000);
+  return TEST_finish("test_telemetry");
+}
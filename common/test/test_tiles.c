@@ -0,0 +1,252 @@
+/*
+ * ================================================================
+ * File: test_tiles.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the tile renderer on the emulated LCD. After
+ * every render the LCD has to equal a full frame drawn here from the map
+ * and the sprites, pixel for pixel, through random tile changes and sprite
+ * moves, partly off the screen included. A benchmark compares the tiles and
+ * bytes sent and the time per frame with a full redraw.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//=============================================================================
+#include "st7735.h"
+#include "test.h"
+#include "tiles.h"
+
+#define ATLAS_SIZE 4
+#define SPRITE_IMAGES 3
+
+static tTileImage g_ppui16Atlas[ATLAS_SIZE];
+static tTileImage g_ppui16Sprite[SPRITE_IMAGES];
+static uint16_t g_pui16Reference[ST7735_HEIGHT][ST7735_WIDTH];
+
+//=============================================================================
+// Tiles with a pattern in every pixel, and sprites with transparent corners
+// and a hole, so that a pixel in the wrong place shows
+static void makeImages(void) {
+  uint32_t i;
+  uint32_t p;
+  uint32_t x;
+  uint32_t y;
+
+  for (i = 0; i < ATLAS_SIZE; i++) {
+    for (p = 0; p < TILE_PIXELS; p++) {
+      g_ppui16Atlas[i][p] = (uint16_t)(i * 0x1000 + p * 3 + 1);
+    }
+  }
+  for (i = 0; i < SPRITE_IMAGES; i++) {
+    for (p = 0; p < TILE_PIXELS; p++) {
+      x = p % TILE_SIZE;
+      y = p / TILE_SIZE;
+      g_ppui16Sprite[i][p] =
+          (x + y < 2) || (x == 4 && y == 4) || (x + y > 12 - i)
+              ? TILE_TRANSPARENT
+              : (uint16_t)(0x8000 + i * 0x800 + p);
+    }
+  }
+}
+
+//=============================================================================
+// The whole frame drawn the plain way: every tile, then every visible
+// sprite in order, clipped to the screen
+static void drawReference(const tTileMap *tiles) {
+  const tTileSprite *sprite;
+  uint16_t color;
+  int32_t x;
+  int32_t y;
+  uint32_t i;
+
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      g_pui16Reference[y][x] =
+          tiles->atlas[tiles->map[y / TILE_SIZE][x / TILE_SIZE]]
+                      [(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+    }
+  }
+  for (i = 0; i < tiles->sprite_count; i++) {
+    sprite = &tiles->sprite[i];
+    if (!sprite->visible) {
+      continue;
+    }
+    for (y = 0; y < TILE_SIZE; y++) {
+      for (x = 0; x < TILE_SIZE; x++) {
+        color = sprite->image[y * TILE_SIZE + x];
+        if (color != TILE_TRANSPARENT && sprite->x + x >= 0 &&
+            sprite->x + x < ST7735_WIDTH && sprite->y + y >= 0 &&
+            sprite->y + y < ST7735_HEIGHT) {
+          g_pui16Reference[sprite->y + y][sprite->x + x] = color;
+        }
+      }
+    }
+  }
+}
+
+static bool lcdShowsReference(const tTileMap *tiles) {
+  uint32_t x;
+  uint32_t y;
+
+  drawReference(tiles);
+  for (y = 0; y < ST7735_HEIGHT; y++) {
+    for (x = 0; x < ST7735_WIDTH; x++) {
+      if (ST7735_hostPixel(x, y) != g_pui16Reference[y][x]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The LCD filled with a color no tile or sprite has, so that a tile that is
+// not sent shows
+static void scribble(void) {
+  ST7735_setWindow(0, 0, ST7735_WIDTH - 1, ST7735_HEIGHT - 1);
+  ST7735_writeColor(0x0001, ST7735_WIDTH * ST7735_HEIGHT);
+}
+
+//=============================================================================
+static void testRandomFrames(void) {
+  static tTileMap tiles;
+  uint32_t sprites[TILE_MAX_SPRITES];
+  uint32_t bytes;
+  uint32_t sent;
+  bool lcd_ok = true;
+  bool bytes_ok = true;
+  uint32_t frame;
+  uint32_t change;
+  uint32_t i;
+
+  srand(14);
+  ST7735_init(120000000);
+  scribble();
+  TILE_init(&tiles, g_ppui16Atlas);
+  for (i = 0; i < 5; i++) {
+    sprites[i] = TILE_addSprite(&tiles, g_ppui16Sprite[i % SPRITE_IMAGES]);
+  }
+  TEST_CHECK(TILE_render(&tiles) == TILE_ROWS * TILE_COLUMNS);
+  TEST_CHECK(lcdShowsReference(&tiles));
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  for (frame = 0; frame < 2000; frame++) {
+    for (change = rand() % 6; change > 0; change--) {
+      switch (rand() % 4) {
+      case 0:
+        TILE_set(&tiles, rand() % TILE_COLUMNS, rand() % TILE_ROWS,
+                 rand() % ATLAS_SIZE);
+        break;
+      case 1:
+        TILE_showSprite(&tiles, sprites[rand() % 5], rand() % 4 != 0);
+        break;
+      default:
+        // Small moves mostly, now and then a jump, up to 8 pixels off the
+        // screen on every side
+        i = rand() % 5;
+        TILE_moveSprite(
+            &tiles, sprites[i],
+            rand() % 8 == 0 ? rand() % 144 - 8
+                            : tiles.sprite[i].x + rand() % 5 - 2,
+            rand() % 8 == 0 ? rand() % 144 - 8
+                            : tiles.sprite[i].y + rand() % 5 - 2,
+            g_ppui16Sprite[rand() % 16 == 0 ? rand() % SPRITE_IMAGES
+                                            : i % SPRITE_IMAGES]);
+        break;
+      }
+    }
+    bytes = ST7735_bytesSent();
+    sent = TILE_render(&tiles);
+    lcd_ok = lcd_ok && lcdShowsReference(&tiles);
+    // Each tile is 128 bytes of pixels, each run of tiles 15 bytes of
+    // window commands
+    bytes = ST7735_bytesSent() - bytes;
+    bytes_ok = bytes_ok && bytes >= sent * 2 * TILE_PIXELS &&
+               bytes <= sent * (2 * TILE_PIXELS + 15);
+  }
+  TEST_CHECK(lcd_ok);
+  TEST_CHECK(bytes_ok);
+  TEST_CHECK(tiles.frames == 2001);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Nothing changed, nothing sent
+  TEST_CHECK(TILE_render(&tiles) == 0);
+  TILE_moveSprite(&tiles, sprites[0], tiles.sprite[0].x, tiles.sprite[0].y,
+                  tiles.sprite[0].image);
+  TILE_set(&tiles, 3, 3, TILE_get(&tiles, 3, 3));
+  TEST_CHECK(TILE_render(&tiles) == 0);
+}
+
+//=============================================================================
+// Only TILE_MAX_SPRITES sprites fit, a sprite number past them is ignored
+static void testSpriteLimit(void) {
+  static tTileMap tiles;
+  uint32_t sprite;
+  uint32_t i;
+
+  TILE_init(&tiles, g_ppui16Atlas);
+  TILE_render(&tiles);
+  for (i = 0; i < TILE_MAX_SPRITES; i++) {
+    TEST_CHECK(TILE_addSprite(&tiles, g_ppui16Sprite[0]) == i);
+  }
+  sprite = TILE_addSprite(&tiles, g_ppui16Sprite[0]);
+  TEST_CHECK(sprite == TILE_MAX_SPRITES);
+  TEST_CHECK(tiles.sprite_count == TILE_MAX_SPRITES);
+  TILE_showSprite(&tiles, sprite, true);
+  TILE_moveSprite(&tiles, sprite, 40, 40, g_ppui16Sprite[1]);
+  TEST_CHECK(TILE_render(&tiles) == 0);
+}
+
+//=============================================================================
+// Two sprites moving a pixel per frame over a static map, like the pacman
+// game, against redrawing every tile
+static void benchmark(bool full) {
+  static tTileMap tiles;
+  uint32_t frames = 5000;
+  uint32_t bytes;
+  uint64_t sent = 0;
+  double start;
+  double host;
+  uint32_t i;
+
+  ST7735_init(120000000);
+  TILE_init(&tiles, g_ppui16Atlas);
+  TILE_addSprite(&tiles, g_ppui16Sprite[0]);
+  TILE_addSprite(&tiles, g_ppui16Sprite[1]);
+  TILE_showSprite(&tiles, 0, true);
+  TILE_showSprite(&tiles, 1, true);
+  TILE_render(&tiles);
+  bytes = ST7735_bytesSent();
+  start = TEST_seconds();
+  for (i = 0; i < frames; i++) {
+    TILE_moveSprite(&tiles, 0, i % 120, 16, g_ppui16Sprite[0]);
+    TILE_moveSprite(&tiles, 1, 64, i % 120, g_ppui16Sprite[1]);
+    if (full) {
+      TILE_invalidate(&tiles);
+    }
+    sent += TILE_render(&tiles);
+  }
+  host = (TEST_seconds() - start) / frames;
+  bytes = (ST7735_bytesSent() - bytes) / frames;
+  printf("  %s: %5.1f tiles, %5u SPI bytes per frame, %6.1f host us, "
+         "%5.0f frames/s the SPI allows\n",
+         full ? "full redraw " : "dirty tiles ", (double)sent / frames, bytes,
+         host * 1e6, ST7735_SPI_RATE / (bytes * 8.0));
+}
+
+//=============================================================================
+int main(void) {
+  makeImages();
+  printf("tile renderer against full frames:\n");
+  testRandomFrames();
+  testSpriteLimit();
+  benchmark(true);
+  benchmark(false);
+  return TEST_finish("test_tiles");
+}
@@ -0,0 +1,192 @@
+/*
+ * ================================================================
+ * File: test_uart_console.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host test of the console line assembly, the echo and the
+ * overflow behaviour of the RX ring, the TX ring and the line buffer,
+ * through the UART stand-in.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+//=============================================================================
+#include "test.h"
+#include "uart_console.h"
+
+//=============================================================================
+// Everything queued for transmission, as a string
+static char g_pcSent[4 * CONSOLE_TX_SIZE];
+
+static const char *sent(void) {
+  uint32_t length = CONSOLE_hostTransmit(g_pcSent, sizeof(g_pcSent) - 1);
+
+  g_pcSent[length] = '\0';
+  return g_pcSent;
+}
+
+static void receive(const char *text) {
+  CONSOLE_hostReceive(text, strlen(text));
+}
+
+//=============================================================================
+static void testLines(void) {
+  char line[CONSOLE_LINE_MAX + 1];
+
+  TEST_CHECK(!CONSOLE_getLine(line, sizeof(line)));
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A line comes in over several polls and is echoed as it is typed
+  receive("he");
+  TEST_CHECK(!CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(sent(), "he") == 0);
+  receive("llo\r");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "hello") == 0);
+  TEST_CHECK(strcmp(sent(), "llo\r\n") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The \n of \r\n is not a second, empty line, a \n on its own is a line
+  receive("\n42\n\n");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "42") == 0);
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "") == 0);
+  TEST_CHECK(!CONSOLE_getLine(line, sizeof(line)));
+  sent();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Backspace and delete take back a character, also on the terminal, and
+  // do nothing on an empty line
+  receive("\b12x\b3\x7f" "4\r");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "124") == 0);
+  TEST_CHECK(strcmp(sent(), "12x\b \b3\b \b4\r\n") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Two lines in one poll come out one at a time
+  receive("a\rb\r");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "a") == 0);
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strcmp(line, "b") == 0);
+  TEST_CHECK(CONSOLE_rxPending() == 0);
+  sent();
+}
+
+//=============================================================================
+static void testLineOverflow(void) {
+  char text[CONSOLE_LINE_MAX + 11];
+  char line[CONSOLE_LINE_MAX + 1];
+  char small[5];
+  uint32_t overflows = CONSOLE_stats()->line_overflows;
+  uint32_t i;
+
+  // A line longer than the assembler keeps is cut and the rest counted,
+  // feeding it in pieces so that the RX ring never fills
+  for (i = 0; i < sizeof(text) - 1; i++) {
+    text[i] = 'a' + i % 26;
+  }
+  text[sizeof(text) - 1] = '\0';
+  for (i = 0; i < sizeof(text) - 1; i += 16) {
+    CONSOLE_hostReceive(text + i, strlen(text + i) < 16 ? strlen(text + i)
+                                                        : 16);
+    TEST_CHECK(!CONSOLE_getLine(line, sizeof(line)));
+  }
+  receive("\r");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strlen(line) == CONSOLE_LINE_MAX);
+  TEST_CHECK(strncmp(line, text, CONSOLE_LINE_MAX) == 0);
+  TEST_CHECK(CONSOLE_stats()->line_overflows - overflows == 10);
+  sent();
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A caller buffer shorter than the line gets size - 1 characters, and one
+  // with no room at all gets nothing and leaves the line waiting
+  receive("abcdefgh\r");
+  TEST_CHECK(!CONSOLE_getLine(small, 0));
+  TEST_CHECK(CONSOLE_rxPending() == 9);
+  TEST_CHECK(CONSOLE_getLine(small, sizeof(small)));
+  TEST_CHECK(strcmp(small, "abcd") == 0);
+  sent();
+}
+
+//=============================================================================
+// Bytes that arrive while the RX ring is full are dropped and counted, the
+// ones already in it are kept
+static void testRxOverflow(void) {
+  char text[CONSOLE_RX_SIZE + 20];
+  char line[CONSOLE_LINE_MAX + 1];
+  uint32_t overflows = CONSOLE_stats()->rx_overflows;
+
+  memset(text, 'x', sizeof(text));
+  CONSOLE_hostReceive(text, sizeof(text));
+  TEST_CHECK(CONSOLE_rxPending() == CONSOLE_RX_SIZE);
+  TEST_CHECK(CONSOLE_stats()->rx_overflows - overflows == 20);
+  TEST_CHECK(!CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(CONSOLE_rxPending() == 0);
+  receive("\r");
+  TEST_CHECK(CONSOLE_getLine(line, sizeof(line)));
+  TEST_CHECK(strlen(line) == CONSOLE_RX_SIZE);
+  sent();
+}
+
+//=============================================================================
+static void testTx(void) {
+  static char text[CONSOLE_TX_SIZE + 100];
+  uint8_t raw[16];
+  uint32_t overflows = CONSOLE_stats()->tx_overflows;
+
+  // \n goes out as \r\n
+  TEST_CHECK(CONSOLE_write("a\nb", 3) == 3);
+  TEST_CHECK(CONSOLE_txPending() == 4);
+  TEST_CHECK(strcmp(sent(), "a\r\nb") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // A write larger than the ring returns at once with what fit
+  memset(text, 'y', sizeof(text));
+  TEST_CHECK(CONSOLE_write(text, sizeof(text)) == CONSOLE_TX_SIZE);
+  TEST_CHECK(CONSOLE_txFree() == 0);
+  TEST_CHECK(CONSOLE_stats()->tx_overflows - overflows == 100);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Raw data goes in whole or not at all
+  memset(raw, 0, sizeof(raw));
+  TEST_CHECK(!CONSOLE_writeRaw(raw, sizeof(raw)));
+  TEST_CHECK(CONSOLE_stats()->tx_overflows - overflows == 116);
+  TEST_CHECK(strlen(sent()) == CONSOLE_TX_SIZE);
+  TEST_CHECK(CONSOLE_writeRaw(raw, sizeof(raw)));
+  TEST_CHECK(CONSOLE_hostTransmit(text, sizeof(text)) == sizeof(raw));
+  TEST_CHECK(memcmp(text, raw, sizeof(raw)) == 0);
+}
+
+//=============================================================================
+// The formatting of ustdlib: strings padded after them, numbers before
+static void testPrintf(void) {
+  char expected[CONSOLE_PRINTF_MAX];
+  uint32_t i;
+
+  CONSOLE_printf("%d%% %u %5u|%4d|%05d %x %X %c %s|%6s|\n", -7, 42u, 9u, -1,
+                 -12, 0xbeefu, 0xbeefu, 'z', "ok", "ab");
+  TEST_CHECK(strcmp(sent(),
+                    "-7% 42     9|  -1|-0012 beef BEEF z ok|ab    |\r\n") == 0);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Output longer than CONSOLE_PRINTF_MAX is cut
+  for (i = 0; i < sizeof(expected) - 1; i++) {
+    expected[i] = 'a';
+  }
+  expected[i] = '\0';
+  CONSOLE_printf("%s%s", expected, "tail");
+  TEST_CHECK(strcmp(sent(), expected) == 0);
+}
+
+//=============================================================================
+int main(void) {
+  CONSOLE_init(0);
+  testLines();
+  testLineOverflow();
+  testRxOverflow();
+  testTx();
+  testPrintf();
+  return TEST_finish("test_uart_console");
+}
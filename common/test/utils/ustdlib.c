@@ -0,0 +1,140 @@
+/*
+ * ================================================================
+ * File: ustdlib.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the formatting of TivaWare utils/ustdlib.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+//=============================================================================
+#include "ustdlib.h"
+
+//=============================================================================
+// Store c if there is room for it and the terminator, count it either way
+static void uput(char *s, size_t n, size_t *length, char c) {
+  if (*length + 1 < n) {
+    s[*length] = c;
+  }
+  (*length)++;
+}
+
+//=============================================================================
+int uvsnprintf(char *s, size_t n, const char *format, va_list arg) {
+  size_t length = 0;
+  uint32_t value;
+  uint32_t base;
+  uint32_t width;
+  uint32_t digits;
+  uint32_t divisor;
+  const char *string;
+  const char *hex;
+  char fill;
+  int negative;
+
+  for (; *format != '\0'; format++) {
+    if (*format != '%') {
+      uput(s, n, &length, *format);
+      continue;
+    }
+    format++;
+    fill = ' ';
+    width = 0;
+    if (*format == '0') {
+      fill = '0';
+    }
+    while (*format >= '0' && *format <= '9') {
+      width = width * 10 + *format++ - '0';
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    negative = 0;
+    hex = "0123456789abcdef";
+    switch (*format) {
+    case 'c':
+      uput(s, n, &length, (char)va_arg(arg, int));
+      continue;
+    case 's':
+      string = va_arg(arg, const char *);
+      for (digits = 0; string[digits] != '\0'; digits++) {
+        uput(s, n, &length, string[digits]);
+      }
+      for (; digits < width; digits++) {
+        uput(s, n, &length, ' ');
+      }
+      continue;
+    case '%':
+      uput(s, n, &length, '%');
+      continue;
+    case 'd':
+    case 'i':
+      value = va_arg(arg, int32_t);
+      if ((int32_t)value < 0) {
+        value = -value;
+        negative = 1;
+      }
+      base = 10;
+      break;
+    case 'u':
+      value = va_arg(arg, uint32_t);
+      base = 10;
+      break;
+    case 'X':
+      hex = "0123456789ABCDEF";
+      // Fall through
+    case 'x':
+    case 'p':
+      value = va_arg(arg, uint32_t);
+      base = 16;
+      break;
+    default:
+      string = "ERROR";
+      while (*string != '\0') {
+        uput(s, n, &length, *string++);
+      }
+      if (*format == '\0') {
+        format--;
+      }
+      continue;
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // A number, the sign counts towards the width and goes before zeros but
+    // after spaces
+    for (digits = 1, divisor = 1; value / divisor >= base; digits++) {
+      divisor *= base;
+    }
+    if (negative && fill == '0') {
+      uput(s, n, &length, '-');
+    }
+    for (; digits + negative < width; width--) {
+      uput(s, n, &length, fill);
+    }
+    if (negative && fill == ' ') {
+      uput(s, n, &length, '-');
+    }
+    for (; divisor != 0; divisor /= base) {
+      uput(s, n, &length, hex[(value / divisor) % base]);
+    }
+  }
+  if (n != 0) {
+    s[length < n ? length : n - 1] = '\0';
+  }
+  return length;
+}
+
+//=============================================================================
+int usnprintf(char *s, size_t n, const char *format, ...) {
+  va_list arguments;
+  int length;
+
+  va_start(arguments, format);
+  length = uvsnprintf(s, n, format, arguments);
+  va_end(arguments);
+  return length;
+}
@@ -0,0 +1,28 @@
+/*
+ * ================================================================
+ * File: ustdlib.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Host stand-in for the formatting of TivaWare utils/ustdlib,
+ * so that text formatted on the host comes out as it does on the target.
+ * Like ustdlib it knows %c, %d, %i, %p, %s, %u, %x, %X and %%, with a width
+ * that is filled with spaces or, when it starts with 0, zeros. A string
+ * shorter than the width is padded after it, numbers before them.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef USTDLIB_H_
+#define USTDLIB_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+//=============================================================================
+// Both return the length of the whole output, even when it did not fit in
+// the n bytes of s
+int uvsnprintf(char *s, size_t n, const char *format, va_list arg);
+int usnprintf(char *s, size_t n, const char *format, ...);
+
+#endif // USTDLIB_H_
@@ -0,0 +1,226 @@
+/*
+ * ================================================================
+ * File: tiles.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Tile map and sprite renderer with dirty tile tracking.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+//=============================================================================
+#include "cycles.h"
+#include "tiles.h"
+
+//=============================================================================
+// One row of tiles, built here before it is sent
+static uint16_t g_pui16Strip[TILE_COLUMNS * TILE_PIXELS];
+
+//=============================================================================
+// Tile holding pixel p, rounding down also for pixels left of or above the
+// screen
+static inline int32_t TILE_of(int32_t p) {
+  return p >= 0 ? p / TILE_SIZE : -((TILE_SIZE - 1 - p) / TILE_SIZE);
+}
+
+//=============================================================================
+// Mark the tiles under an 8 x 8 area with its corner at x, y
+static void TILE_markArea(tTileMap *tiles, int32_t x, int32_t y) {
+  int32_t column0 = TILE_of(x);
+  int32_t column1 = TILE_of(x + TILE_SIZE - 1);
+  int32_t row0 = TILE_of(y);
+  int32_t row1 = TILE_of(y + TILE_SIZE - 1);
+  int32_t row;
+  int32_t column;
+
+  for (row = row0; row <= row1; row++) {
+    if (row < 0 || row >= TILE_ROWS) {
+      continue;
+    }
+    for (column = column0; column <= column1; column++) {
+      if (column >= 0 && column < TILE_COLUMNS) {
+        tiles->dirty[row] |= 1u << column;
+      }
+    }
+  }
+}
+
+//=============================================================================
+void TILE_init(tTileMap *tiles, const tTileImage *atlas) {
+  memset(tiles, 0, sizeof(*tiles));
+  tiles->atlas = atlas;
+  TILE_invalidate(tiles);
+  CYCLES_init();
+}
+
+//=============================================================================
+void TILE_invalidate(tTileMap *tiles) {
+  uint32_t row;
+
+  for (row = 0; row < TILE_ROWS; row++) {
+    tiles->dirty[row] = (1u << TILE_COLUMNS) - 1;
+  }
+}
+
+//=============================================================================
+void TILE_set(tTileMap *tiles, uint32_t column, uint32_t row, uint8_t tile) {
+  if (tiles->map[row][column] == tile) {
+    return;
+  }
+  tiles->map[row][column] = tile;
+  tiles->dirty[row] |= 1u << column;
+}
+
+//=============================================================================
+uint32_t TILE_addSprite(tTileMap *tiles, const uint16_t *image) {
+  tTileSprite *sprite;
+
+  if (tiles->sprite_count == TILE_MAX_SPRITES) {
+    return TILE_MAX_SPRITES;
+  }
+  sprite = &tiles->sprite[tiles->sprite_count];
+  sprite->image = image;
+  sprite->x = 0;
+  sprite->y = 0;
+  sprite->visible = false;
+  return tiles->sprite_count++;
+}
+
+//=============================================================================
+void TILE_moveSprite(tTileMap *tiles, uint32_t number, int32_t x, int32_t y,
+                     const uint16_t *image) {
+  tTileSprite *sprite;
+
+  if (number >= tiles->sprite_count) {
+    return;
+  }
+  sprite = &tiles->sprite[number];
+  if (sprite->x == x && sprite->y == y && sprite->image == image) {
+    return;
+  }
+  if (sprite->visible) {
+    TILE_markArea(tiles, sprite->x, sprite->y);
+    TILE_markArea(tiles, x, y);
+  }
+  sprite->x = x;
+  sprite->y = y;
+  sprite->image = image;
+}
+
+//=============================================================================
+void TILE_showSprite(tTileMap *tiles, uint32_t number, bool visible) {
+  tTileSprite *sprite;
+
+  if (number >= tiles->sprite_count) {
+    return;
+  }
+  sprite = &tiles->sprite[number];
+  if (sprite->visible != visible) {
+    sprite->visible = visible;
+    TILE_markArea(tiles, sprite->x, sprite->y);
+  }
+}
+
+//=============================================================================
+void TILE_compose(const tTileMap *tiles, uint32_t column, uint32_t row,
+                  uint16_t *pixels, uint32_t stride) {
+  const uint16_t *source = tiles->atlas[tiles->map[row][column]];
+  int32_t tile_x = column * TILE_SIZE;
+  int32_t tile_y = row * TILE_SIZE;
+  int32_t x0;
+  int32_t x1;
+  int32_t y0;
+  int32_t y1;
+  int32_t x;
+  int32_t y;
+  uint16_t color;
+  uint32_t i;
+
+  for (y = 0; y < TILE_SIZE; y++) {
+    memcpy(pixels + y * stride, source + y * TILE_SIZE,
+           TILE_SIZE * sizeof(uint16_t));
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Only the part of each sprite that falls inside this tile, in tile
+  // coordinates
+  for (i = 0; i < tiles->sprite_count; i++) {
+    const tTileSprite *sprite = &tiles->sprite[i];
+    if (!sprite->visible) {
+      continue;
+    }
+    x0 = sprite->x - tile_x;
+    y0 = sprite->y - tile_y;
+    x1 = x0 + TILE_SIZE;
+    y1 = y0 + TILE_SIZE;
+    if (x1 <= 0 || y1 <= 0 || x0 >= TILE_SIZE || y0 >= TILE_SIZE) {
+      continue;
+    }
+    for (y = y0 < 0 ? 0 : y0; y < (y1 > TILE_SIZE ? TILE_SIZE : y1); y++) {
+      for (x = x0 < 0 ? 0 : x0; x < (x1 > TILE_SIZE ? TILE_SIZE : x1); x++) {
+        color = sprite->image[(y - y0) * TILE_SIZE + (x - x0)];
+        if (color != TILE_TRANSPARENT) {
+          pixels[y * stride + x] = color;
+        }
+      }
+    }
+  }
+}
+
+//=============================================================================
+uint32_t TILE_render(tTileMap *tiles) {
+  uint32_t start = CYCLES_now();
+  uint32_t sent = 0;
+  uint32_t row;
+  uint32_t first;
+  uint32_t last;
+  uint32_t stride;
+  uint32_t column;
+  uint16_t dirty;
+
+  for (row = 0; row < TILE_ROWS; row++) {
+    dirty = tiles->dirty[row];
+    tiles->dirty[row] = 0;
+    first = 0;
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Neighbouring dirty tiles go out as one window, which saves the window
+    // commands for each tile after the first
+    while (dirty != 0) {
+      while (!(dirty & (1u << first))) {
+        first++;
+      }
+      last = first;
+      while (last + 1 < TILE_COLUMNS && (dirty & (1u << (last + 1)))) {
+        last++;
+      }
+      stride = (last - first + 1) * TILE_SIZE;
+      for (column = first; column <= last; column++) {
+        TILE_compose(tiles, column, row,
+                     g_pui16Strip + (column - first) * TILE_SIZE, stride);
+        dirty &= ~(1u << column);
+      }
+      ST7735_setWindow(first * TILE_SIZE, row * TILE_SIZE,
+                       (last + 1) * TILE_SIZE - 1, (row + 1) * TILE_SIZE - 1);
+      ST7735_writePixels(g_pui16Strip, stride * TILE_SIZE);
+      sent += last - first + 1;
+      first = last + 1;
+    }
+  }
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  tiles->render_ticks_last = CYCLES_now() - start;
+  if (tiles->render_ticks_last > tiles->render_ticks_max) {
+    tiles->render_ticks_max = tiles->render_ticks_last;
+  }
+  tiles->frames++;
+  tiles->tiles_sent_last = sent;
+  tiles->tiles_sent_total += sent;
+  if (sent > tiles->tiles_sent_max) {
+    tiles->tiles_sent_max = sent;
+  }
+  return sent;
+}
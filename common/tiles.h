@@ -0,0 +1,105 @@
+/*
+ * ================================================================
+ * File: tiles.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Tile map and sprite renderer for the ST7735S. The 128 x 128
+ * screen is a map of 16 x 16 tiles, each 8 x 8 pixels and taken from an
+ * atlas kept in flash. Sprites are drawn over the map, but only in the
+ * tiles they overlap.
+ *
+ * Nothing is kept in a framebuffer. Changing a tile or moving a sprite only
+ * marks the tiles involved as dirty, and rendering builds those tiles one
+ * row at a time and sends them. A maze where a couple of sprites move is a
+ * handful of tiles per frame instead of the whole screen.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef TILES_H_
+#define TILES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "st7735.h"
+
+//=============================================================================
+#define TILE_SIZE 8
+#define TILE_PIXELS (TILE_SIZE * TILE_SIZE)
+#define TILE_COLUMNS (ST7735_WIDTH / TILE_SIZE)
+#define TILE_ROWS (ST7735_HEIGHT / TILE_SIZE)
+#define TILE_MAX_SPRITES 8
+// Sprite pixels of this color (magenta) are not drawn
+#define TILE_TRANSPARENT 0xF81F
+
+//=============================================================================
+// One 8 x 8 tile or sprite image, RGB565 row by row
+typedef uint16_t tTileImage[TILE_PIXELS];
+
+typedef struct {
+  const uint16_t *image;
+  // Top left corner in pixels, may be partly off the screen
+  int32_t x;
+  int32_t y;
+  bool visible;
+} tTileSprite;
+
+typedef struct {
+  const tTileImage *atlas;
+  uint8_t map[TILE_ROWS][TILE_COLUMNS];
+  // One bit per column for each row of tiles
+  uint16_t dirty[TILE_ROWS];
+  tTileSprite sprite[TILE_MAX_SPRITES];
+  uint32_t sprite_count;
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Statistics, per call to TILE_render()
+  uint32_t frames;
+  uint32_t tiles_sent_last;
+  uint32_t tiles_sent_max;
+  uint64_t tiles_sent_total;
+  uint32_t render_ticks_last;
+  uint32_t render_ticks_max;
+} tTileMap;
+
+//=============================================================================
+// Start with every tile set to tile 0 of the atlas and everything dirty, so
+// that the first render draws the whole screen
+void TILE_init(tTileMap *tiles, const tTileImage *atlas);
+
+// Change one tile of the map. Marks it dirty only if it changed.
+void TILE_set(tTileMap *tiles, uint32_t column, uint32_t row, uint8_t tile);
+
+static inline uint8_t TILE_get(const tTileMap *tiles, uint32_t column,
+                               uint32_t row) {
+  return tiles->map[row][column];
+}
+
+// Mark every tile dirty
+void TILE_invalidate(tTileMap *tiles);
+
+//=============================================================================
+// Sprites are drawn in the order they were added, the last one on top.
+// Returns the number of the sprite, it starts hidden at 0, 0. When all
+// TILE_MAX_SPRITES are taken nothing is added and TILE_MAX_SPRITES is
+// returned, which the functions below ignore.
+uint32_t TILE_addSprite(tTileMap *tiles, const uint16_t *image);
+
+// Move a sprite and change its image. The tiles under the old and the new
+// position are marked dirty, when nothing changed nothing is.
+void TILE_moveSprite(tTileMap *tiles, uint32_t sprite, int32_t x, int32_t y,
+                     const uint16_t *image);
+
+void TILE_showSprite(tTileMap *tiles, uint32_t sprite, bool visible);
+
+//=============================================================================
+// Build the 8 x 8 pixels of one tile with the sprites on top
+void TILE_compose(const tTileMap *tiles, uint32_t column, uint32_t row,
+                  uint16_t *pixels, uint32_t stride);
+
+// Send the dirty tiles to the LCD and clear them. Returns the number of
+// tiles sent.
+uint32_t TILE_render(tTileMap *tiles);
+
+#endif // TILES_H_
@@ -0,0 +1,266 @@
+/*
+ * ================================================================
+ * File: uart_console.c
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Interrupt driven UART console with RX/TX ring buffers.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+
+/*================================================================*/
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+//=============================================================================
+#include "uart_console.h"
+// uvsnprintf() formats the way UARTprintf() does and keeps newlib stdio out
+// of the image
+#include "utils/ustdlib.h"
+
+#ifndef HOST_BUILD
+//=============================================================================
+#include "driverlib/uart.h"
+#endif
+
+//=============================================================================
+// The indices only ever increase, the position in the buffer is the index
+// masked with the size. The interrupt handler owns rx_head and tx_tail, the
+// main loop owns rx_tail and tx_head.
+static volatile uint8_t g_pui8RxBuffer[CONSOLE_RX_SIZE];
+static volatile uint32_t g_ui32RxHead;
+static volatile uint32_t g_ui32RxTail;
+static volatile uint8_t g_pui8TxBuffer[CONSOLE_TX_SIZE];
+static volatile uint32_t g_ui32TxHead;
+static volatile uint32_t g_ui32TxTail;
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Line assembler
+static char g_pcLine[CONSOLE_LINE_MAX];
+static uint32_t g_ui32LineLength;
+static bool g_bLastWasCR;
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static uint32_t g_ui32UARTBase;
+static tConsoleStats g_sStats;
+
+//=============================================================================
+// Called from the interrupt handler for every received byte
+static void CONSOLE_rxPush(uint8_t c) {
+  if (g_ui32RxHead - g_ui32RxTail >= CONSOLE_RX_SIZE) {
+    g_sStats.rx_overflows++;
+    return;
+  }
+  g_pui8RxBuffer[g_ui32RxHead & (CONSOLE_RX_SIZE - 1)] = c;
+  g_ui32RxHead++;
+}
+
+//=============================================================================
+// Next byte to transmit, false when the TX ring is empty
+static bool CONSOLE_txPop(uint8_t *c) {
+  if (g_ui32TxTail == g_ui32TxHead) {
+    return false;
+  }
+  *c = g_pui8TxBuffer[g_ui32TxTail & (CONSOLE_TX_SIZE - 1)];
+  g_ui32TxTail++;
+  return true;
+}
+
+//=============================================================================
+static bool CONSOLE_txPush(uint8_t c) {
+  if (g_ui32TxHead - g_ui32TxTail >= CONSOLE_TX_SIZE) {
+    return false;
+  }
+  g_pui8TxBuffer[g_ui32TxHead & (CONSOLE_TX_SIZE - 1)] = c;
+  g_ui32TxHead++;
+  return true;
+}
+
+#ifndef HOST_BUILD
+//=============================================================================
+// Fill the hardware FIFO from the TX ring. The TX interrupt is only enabled
+// while there is something left to send.
+static void CONSOLE_txFill(void) {
+  uint8_t c;
+
+  while (UARTSpaceAvail(g_ui32UARTBase)) {
+    if (!CONSOLE_txPop(&c)) {
+      UARTIntDisable(g_ui32UARTBase, UART_INT_TX);
+      return;
+    }
+    UARTCharPutNonBlocking(g_ui32UARTBase, c);
+  }
+  UARTIntEnable(g_ui32UARTBase, UART_INT_TX);
+}
+
+//=============================================================================
+void CONSOLE_intHandler(void) {
+  uint32_t status = UARTIntStatus(g_ui32UARTBase, true);
+
+  UARTIntClear(g_ui32UARTBase, status);
+  while (UARTCharsAvail(g_ui32UARTBase)) {
+    CONSOLE_rxPush(UARTCharGetNonBlocking(g_ui32UARTBase));
+  }
+  if (status & UART_INT_TX) {
+    CONSOLE_txFill();
+  }
+}
+
+//=============================================================================
+void CONSOLE_init(uint32_t uart_base) {
+  g_ui32UARTBase = uart_base;
+  UARTFIFOEnable(uart_base);
+  UARTFIFOLevelSet(uart_base, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+  UARTIntRegister(uart_base, CONSOLE_intHandler);
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // The receive timeout catches the characters that do not fill the FIFO up
+  // to the interrupt level, which is every key typed by hand
+  UARTIntEnable(uart_base, UART_INT_RX | UART_INT_RT);
+}
+
+//=============================================================================
+// Start sending from the main loop. The TX interrupt is held off while the
+// FIFO is filled so that the handler does not fill it at the same time.
+static void CONSOLE_txStart(void) {
+  UARTIntDisable(g_ui32UARTBase, UART_INT_TX);
+  CONSOLE_txFill();
+}
+
+#else
+//=============================================================================
+// Host stand-in for the UART
+void CONSOLE_intHandler(void) {}
+
+void CONSOLE_init(uint32_t uart_base) { g_ui32UARTBase = uart_base; }
+
+static void CONSOLE_txStart(void) {}
+
+//=============================================================================
+void CONSOLE_hostReceive(const char *data, uint32_t length) {
+  uint32_t i;
+
+  for (i = 0; i < length; i++) {
+    CONSOLE_rxPush(data[i]);
+  }
+}
+
+//=============================================================================
+uint32_t CONSOLE_hostTransmit(char *data, uint32_t size) {
+  uint32_t i;
+  uint8_t c;
+
+  for (i = 0; i < size && CONSOLE_txPop(&c); i++) {
+    data[i] = c;
+  }
+  return i;
+}
+#endif
+
+//=============================================================================
+bool CONSOLE_getLine(char *line, uint32_t size) {
+  uint32_t i;
+  uint8_t c;
+
+  if (size == 0) {
+    return false;
+  }
+  while (g_ui32RxTail != g_ui32RxHead) {
+    c = g_pui8RxBuffer[g_ui32RxTail & (CONSOLE_RX_SIZE - 1)];
+    g_ui32RxTail++;
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // "\r\n" is one line ending, not an empty line after the first one
+    if (c == '\n' && g_bLastWasCR) {
+      g_bLastWasCR = false;
+      continue;
+    }
+    g_bLastWasCR = c == '\r';
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    if (c == '\r' || c == '\n') {
+      for (i = 0; i < g_ui32LineLength && i < size - 1; i++) {
+        line[i] = g_pcLine[i];
+      }
+      line[i] = '\0';
+      g_ui32LineLength = 0;
+      CONSOLE_write("\n", 1);
+      return true;
+    }
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Backspace and delete remove the last character, also on the terminal
+    if (c == '\b' || c == 0x7f) {
+      if (g_ui32LineLength > 0) {
+        g_ui32LineLength--;
+        CONSOLE_write("\b \b", 3);
+      }
+      continue;
+    }
+    if (g_ui32LineLength < CONSOLE_LINE_MAX) {
+      g_pcLine[g_ui32LineLength++] = c;
+      CONSOLE_write((const char *)&c, 1);
+    } else {
+      g_sStats.line_overflows++;
+    }
+  }
+  return false;
+}
+
+//=============================================================================
+uint32_t CONSOLE_write(const char *data, uint32_t length) {
+  uint32_t i;
+
+  for (i = 0; i < length; i++) {
+    if (data[i] == '\n' && !CONSOLE_txPush('\r')) {
+      break;
+    }
+    if (!CONSOLE_txPush(data[i])) {
+      break;
+    }
+  }
+  g_sStats.tx_overflows += length - i;
+  CONSOLE_txStart();
+  return i;
+}
+
+//=============================================================================
+bool CONSOLE_writeRaw(const uint8_t *data, uint32_t length) {
+  uint32_t i;
+
+  if (length > CONSOLE_txFree()) {
+    g_sStats.tx_overflows += length;
+    return false;
+  }
+  for (i = 0; i < length; i++) {
+    CONSOLE_txPush(data[i]);
+  }
+  CONSOLE_txStart();
+  return true;
+}
+
+//=============================================================================
+void CONSOLE_printf(const char *format, ...) {
+  char buffer[CONSOLE_PRINTF_MAX];
+  va_list arguments;
+  int length;
+
+  va_start(arguments, format);
+  length = uvsnprintf(buffer, sizeof(buffer), format, arguments);
+  va_end(arguments);
+  if (length < 0) {
+    return;
+  }
+  if (length > (int)sizeof(buffer) - 1) {
+    length = sizeof(buffer) - 1;
+  }
+  CONSOLE_write(buffer, length);
+}
+
+//=============================================================================
+uint32_t CONSOLE_txPending(void) { return g_ui32TxHead - g_ui32TxTail; }
+
+//=============================================================================
+uint32_t CONSOLE_rxPending(void) { return g_ui32RxHead - g_ui32RxTail; }
+
+//=============================================================================
+uint32_t CONSOLE_txFree(void) { return CONSOLE_TX_SIZE - CONSOLE_txPending(); }
+
+//=============================================================================
+const tConsoleStats *CONSOLE_stats(void) { return &g_sStats; }
@@ -0,0 +1,90 @@
+/*
+ * ================================================================
+ * File: uart_console.h
+ * Author: Pontus Svensson
+ * Date: 2026-10-16
+ * Description: Non-blocking UART console. The UART interrupt moves bytes
+ * between the hardware FIFOs and two ring buffers, so printing returns as
+ * soon as the text is queued and reading a line never waits for the user.
+ * The main loop polls CONSOLE_getLine(), which assembles and echoes the
+ * characters received so far and reports a line once Enter is pressed.
+ *
+ * ConfigureUART() is still what sets up the pins and the baud rate,
+ * CONSOLE_init() is called after it and takes over the interrupt.
+ *
+ * With HOST_BUILD defined the UART is replaced by CONSOLE_hostReceive() and
+ * CONSOLE_hostTransmit(), which feed and drain the ring buffers the same way
+ * the interrupt handler does.
+ *
+ * License: This code is distributed under the MIT License. visit
+ * https://opensource.org/licenses/MIT for more information.
+ * ================================================================
+ */
+#ifndef UART_CONSOLE_H_
+#define UART_CONSOLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// Ring buffer sizes, both have to be powers of two
+#define CONSOLE_RX_SIZE 64
+#define CONSOLE_TX_SIZE 1024
+// Longest line the assembler keeps, longer lines are cut
+#define CONSOLE_LINE_MAX 64
+// Longest single CONSOLE_printf() output
+#define CONSOLE_PRINTF_MAX 128
+
+//=============================================================================
+typedef struct {
+  // Bytes received while the RX ring was full
+  uint32_t rx_overflows;
+  // Bytes dropped because the TX ring was full
+  uint32_t tx_overflows;
+  // Characters cut from lines longer than CONSOLE_LINE_MAX
+  uint32_t line_overflows;
+} tConsoleStats;
+
+//=============================================================================
+void CONSOLE_init(uint32_t uart_base);
+
+// Returns true and copies the line (without the line ending) into line when
+// Enter has been received. Longer lines are truncated to size - 1. With a
+// size of 0 nothing is read and false is returned.
+bool CONSOLE_getLine(char *line, uint32_t size);
+
+// Queue length bytes for transmission, "\n" is sent as "\r\n" as uartstdio
+// does. Returns the number of bytes queued.
+uint32_t CONSOLE_write(const char *data, uint32_t length);
+
+// Formatted with uvsnprintf() of utils/ustdlib, which has the conversions
+// of UARTprintf(): %c, %d, %i, %p, %s, %u, %x, %X and %%. A string shorter
+// than its width is padded after it.
+void CONSOLE_printf(const char *format, ...);
+
+// Queue binary data exactly as it is. Either all length bytes are queued or,
+// when the TX ring does not have room for them, none are and false is
+// returned.
+bool CONSOLE_writeRaw(const uint8_t *data, uint32_t length);
+
+// Number of bytes still waiting to be sent
+uint32_t CONSOLE_txPending(void);
+
+// Number of received bytes CONSOLE_getLine() has not looked at yet
+uint32_t CONSOLE_rxPending(void);
+
+// Room left in the TX ring
+uint32_t CONSOLE_txFree(void);
+
+const tConsoleStats *CONSOLE_stats(void);
+
+void CONSOLE_intHandler(void);
+
+#ifdef HOST_BUILD
+// Receive bytes as if they arrived on the wire
+void CONSOLE_hostReceive(const char *data, uint32_t length);
+// Send up to size queued bytes into data, returns how many were sent
+uint32_t CONSOLE_hostTransmit(char *data, uint32_t size);
+#endif
+
+#endif // UART_CONSOLE_H_